@@ -0,0 +1,791 @@
+///////////////////////////////////////////////////////////////////////////////
+// antialiasing.cpp
+// ============
+// multisampled, fast approximate and temporal anti-aliasing of the scene
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AntiAliasing.h"
+#include "GPUProfiler.h"
+#include "ShaderCompiler.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	const char* g_ModeNames[AntiAliasing::aa_count] = {
+		"none", "msaa", "fxaa", "taa" };
+
+	// GPU profiler scope of the pass of each mode
+	const char* g_PassScopeNames[AntiAliasing::aa_count] = {
+		NULL, "MSAA Resolve", "FXAA", "TAA" };
+
+	// length of the jitter sequence - eight positions cover a
+	// pixel evenly without the pattern being visible
+	const unsigned int JITTER_SAMPLES = 8;
+
+	// texture units the passes bind
+	const int PASS_TEXTURE_UNITS = 3;
+
+	// full screen triangle, with texture coordinates that are
+	// 0 to 1 over the viewport
+	const char* FULLSCREEN_VERTEX_SOURCE =
+		"#version 330 core\n"
+		"out vec2 texCoord;\n"
+		"void main()\n"
+		"{\n"
+		"	vec2 corner = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));\n"
+		"	texCoord = corner;\n"
+		"	gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);\n"
+		"}\n";
+
+	// FXAA - the luma of the four diagonal neighbors gives the
+	// direction across the edge, and the image is blurred along
+	// it over up to eight texels.  The wider blur is only kept
+	// when its luma stays within that of the neighborhood, so
+	// thin details are not washed out
+	const char* FXAA_FRAGMENT_SOURCE =
+		"#version 330 core\n"
+		"in vec2 texCoord;\n"
+		"out vec4 fragmentColor;\n"
+		"uniform sampler2D sceneColor;\n"
+		"uniform vec2 uvScale;\n"
+		"uniform vec2 texelSize;\n"
+		"const float SPAN_MAX = 8.0;\n"
+		"const float REDUCE_MUL = 1.0 / 8.0;\n"
+		"const float REDUCE_MIN = 1.0 / 128.0;\n"
+		"vec3 Fetch(vec2 uv)\n"
+		"{\n"
+		"	vec2 lowest = 0.5 * texelSize;\n"
+		"	vec2 highest = uvScale - 0.5 * texelSize;\n"
+		"	return(texture(sceneColor, clamp(uv, lowest, highest)).rgb);\n"
+		"}\n"
+		"float Luma(vec3 color)\n"
+		"{\n"
+		"	return(dot(color, vec3(0.299, 0.587, 0.114)));\n"
+		"}\n"
+		"void main()\n"
+		"{\n"
+		"	vec2 uv = texCoord * uvScale;\n"
+		"	float lumaCenter = Luma(Fetch(uv));\n"
+		"	float lumaNW = Luma(Fetch(uv + vec2(-1.0, 1.0) * texelSize));\n"
+		"	float lumaNE = Luma(Fetch(uv + vec2(1.0, 1.0) * texelSize));\n"
+		"	float lumaSW = Luma(Fetch(uv + vec2(-1.0, -1.0) * texelSize));\n"
+		"	float lumaSE = Luma(Fetch(uv + vec2(1.0, -1.0) * texelSize));\n"
+		"	float lumaMin = min(lumaCenter, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));\n"
+		"	float lumaMax = max(lumaCenter, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));\n"
+		"	vec2 direction = vec2(-((lumaNW + lumaNE) - (lumaSW + lumaSE)), (lumaNW + lumaSW) - (lumaNE + lumaSE));\n"
+		"	float reduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * 0.25 * REDUCE_MUL, REDUCE_MIN);\n"
+		"	float scale = 1.0 / (min(abs(direction.x), abs(direction.y)) + reduce);\n"
+		"	direction = clamp(direction * scale, -SPAN_MAX, SPAN_MAX) * texelSize;\n"
+		"	vec3 inner = 0.5 * (Fetch(uv + direction * (1.0 / 3.0 - 0.5)) + Fetch(uv + direction * (2.0 / 3.0 - 0.5)));\n"
+		"	vec3 outer = inner * 0.5 + 0.25 * (Fetch(uv - direction * 0.5) + Fetch(uv + direction * 0.5));\n"
+		"	float lumaOuter = Luma(outer);\n"
+		"	vec3 color = ((lumaOuter < lumaMin) || (lumaOuter > lumaMax)) ? inner : outer;\n"
+		"	fragmentColor = vec4(color, 1.0);\n"
+		"}\n";
+
+	// TAA - the depth of the pixel gives its position, which the
+	// reprojection matrix takes to where it was in the previous
+	// frame.  The history read there is clamped to the colors
+	// around the pixel in this frame, then blended with it
+	const char* TAA_FRAGMENT_SOURCE =
+		"#version 330 core\n"
+		"in vec2 texCoord;\n"
+		"out vec4 fragmentColor;\n"
+		"uniform sampler2D sceneColor;\n"
+		"uniform sampler2D sceneDepth;\n"
+		"uniform sampler2D historyColor;\n"
+		"uniform vec2 uvScale;\n"
+		"uniform vec2 texelSize;\n"
+		"uniform ivec2 lastPixel;\n"
+		"uniform mat4 reprojection;\n"
+		"uniform bool zeroToOneDepth;\n"
+		"uniform float blend;\n"
+		"vec3 Load(ivec2 pixel)\n"
+		"{\n"
+		"	return(texelFetch(sceneColor, clamp(pixel, ivec2(0), lastPixel), 0).rgb);\n"
+		"}\n"
+		"void main()\n"
+		"{\n"
+		"	ivec2 pixel = ivec2(gl_FragCoord.xy);\n"
+		"	vec3 current = Load(pixel);\n"
+		"	vec3 lowest = current;\n"
+		"	vec3 highest = current;\n"
+		"	for (int y = -1; y <= 1; y++)\n"
+		"	{\n"
+		"		for (int x = -1; x <= 1; x++)\n"
+		"		{\n"
+		"			vec3 neighbor = Load(pixel + ivec2(x, y));\n"
+		"			lowest = min(lowest, neighbor);\n"
+		"			highest = max(highest, neighbor);\n"
+		"		}\n"
+		"	}\n"
+		"	float depth = texelFetch(sceneDepth, pixel, 0).r;\n"
+		"	vec3 position = vec3(texCoord, depth) * 2.0 - 1.0;\n"
+		"	if (zeroToOneDepth)\n"
+		"	{\n"
+		"		position.z = depth;\n"
+		"	}\n"
+		"	vec4 previous = reprojection * vec4(position, 1.0);\n"
+		"	vec2 previousUV = texCoord;\n"
+		"	if (abs(previous.w) > 0.000001)\n"
+		"	{\n"
+		"		previousUV = previous.xy / previous.w * 0.5 + 0.5;\n"
+		"	}\n"
+		"	float weight = blend;\n"
+		"	if (any(lessThan(previousUV, vec2(0.0))) || any(greaterThan(previousUV, vec2(1.0))))\n"
+		"	{\n"
+		"		weight = 1.0;\n"
+		"	}\n"
+		"	vec2 uv = clamp(previousUV * uvScale, 0.5 * texelSize, uvScale - 0.5 * texelSize);\n"
+		"	vec3 history = clamp(texture(historyColor, uv).rgb, lowest, highest);\n"
+		"	fragmentColor = vec4(mix(history, current, weight), 1.0);\n"
+		"}\n";
+
+	// bindings a pass changes, put back afterwards since the
+	// scene keeps its textures bound between frames
+	struct PASS_STATE
+	{
+		GLint program;
+		GLint activeUnit;
+		GLint textures[PASS_TEXTURE_UNITS];
+		GLint samplers[PASS_TEXTURE_UNITS];
+		GLboolean bDepthTest;
+	};
+
+	/***********************************************************
+	 *  SavePassState()
+	 *
+	 *  Reads the bindings a pass is about to change.
+	 ***********************************************************/
+	void SavePassState(PASS_STATE& state)
+	{
+		glGetIntegerv(GL_CURRENT_PROGRAM, &state.program);
+		glGetIntegerv(GL_ACTIVE_TEXTURE, &state.activeUnit);
+		for (int i = 0; i < PASS_TEXTURE_UNITS; i++)
+		{
+			glActiveTexture(GL_TEXTURE0 + i);
+			glGetIntegerv(GL_TEXTURE_BINDING_2D, &state.textures[i]);
+			glGetIntegerv(GL_SAMPLER_BINDING, &state.samplers[i]);
+		}
+		state.bDepthTest = glIsEnabled(GL_DEPTH_TEST);
+	}
+
+	/***********************************************************
+	 *  RestorePassState()
+	 *
+	 *  Puts back the bindings read by SavePassState().
+	 ***********************************************************/
+	void RestorePassState(const PASS_STATE& state)
+	{
+		for (int i = 0; i < PASS_TEXTURE_UNITS; i++)
+		{
+			glActiveTexture(GL_TEXTURE0 + i);
+			glBindTexture(GL_TEXTURE_2D, (GLuint)state.textures[i]);
+			glBindSampler(i, (GLuint)state.samplers[i]);
+		}
+		glActiveTexture((GLenum)state.activeUnit);
+		glUseProgram((GLuint)state.program);
+		if (state.bDepthTest == GL_TRUE)
+		{
+			glEnable(GL_DEPTH_TEST);
+		}
+	}
+
+	/***********************************************************
+	 *  Halton()
+	 *
+	 *  Returns the element of the Halton sequence of a base,
+	 *  between 0 and 1.  Bases 2 and 3 together spread points
+	 *  evenly over a square for any number of them.
+	 ***********************************************************/
+	float Halton(unsigned int index, unsigned int base)
+	{
+		float result = 0.0f;
+		float fraction = 1.0f / (float)base;
+		while (index > 0)
+		{
+			result += fraction * (float)(index % base);
+			index /= base;
+			fraction /= (float)base;
+		}
+		return(result);
+	}
+}
+
+/***********************************************************
+ *  AntiAliasing()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+AntiAliasing::AntiAliasing()
+{
+	m_settings.mode = aa_none;
+	m_settings.msaaSamples = 4;
+	m_settings.taaBlend = 0.1f;
+	m_settings.bZeroToOneDepth = false;
+	m_mode = aa_none;
+	m_fxaaProgram = 0;
+	m_taaProgram = 0;
+	m_vertexArray = 0;
+	m_sampler = 0;
+	m_fxaaUvScaleLocation = -1;
+	m_fxaaTexelSizeLocation = -1;
+	m_taaUvScaleLocation = -1;
+	m_taaTexelSizeLocation = -1;
+	m_taaLastPixelLocation = -1;
+	m_taaReprojectionLocation = -1;
+	m_taaZeroToOneDepthLocation = -1;
+	m_taaBlendLocation = -1;
+	m_pHistory = NULL;
+	m_historyWidth = 0;
+	m_historyHeight = 0;
+	m_previousViewProjection = glm::mat4(1.0f);
+	m_jitterIndex = 0;
+	m_lastSampleFrame = -1;
+	m_modeFrame = 0;
+	ResetStats();
+}
+
+/***********************************************************
+ *  ~AntiAliasing()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+AntiAliasing::~AntiAliasing()
+{
+	Shutdown();
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for building the FXAA and TAA
+ *  programs and the sampler they read the scene with.  The
+ *  MSAA samples are limited to what the driver offers for
+ *  textures.
+ ***********************************************************/
+bool AntiAliasing::Initialize(const ANTIALIASING_SETTINGS& settings)
+{
+	Shutdown();
+
+	m_settings = settings;
+	m_settings.taaBlend = std::min(std::max(m_settings.taaBlend, 0.01f), 1.0f);
+
+	GLint maxColorSamples = 1;
+	GLint maxDepthSamples = 1;
+	glGetIntegerv(GL_MAX_COLOR_TEXTURE_SAMPLES, &maxColorSamples);
+	glGetIntegerv(GL_MAX_DEPTH_TEXTURE_SAMPLES, &maxDepthSamples);
+	int maxSamples = std::max((int)std::min(maxColorSamples, maxDepthSamples), 1);
+	if (m_settings.msaaSamples > maxSamples)
+	{
+		std::cout << "INFO: MSAA is limited to " << maxSamples << " samples" << std::endl;
+	}
+	m_settings.msaaSamples = std::min(std::max(m_settings.msaaSamples, 1), maxSamples);
+
+	std::string log;
+	m_fxaaProgram = ShaderCompiler::BuildProgram(FULLSCREEN_VERTEX_SOURCE, FXAA_FRAGMENT_SOURCE, log);
+	if (m_fxaaProgram == 0)
+	{
+		std::cout << "Could not build the FXAA program:" << log << std::endl;
+		return(false);
+	}
+	m_fxaaUvScaleLocation = glGetUniformLocation(m_fxaaProgram, "uvScale");
+	m_fxaaTexelSizeLocation = glGetUniformLocation(m_fxaaProgram, "texelSize");
+
+	m_taaProgram = ShaderCompiler::BuildProgram(FULLSCREEN_VERTEX_SOURCE, TAA_FRAGMENT_SOURCE, log);
+	if (m_taaProgram == 0)
+	{
+		std::cout << "Could not build the TAA program:" << log << std::endl;
+		Shutdown();
+		return(false);
+	}
+	m_taaUvScaleLocation = glGetUniformLocation(m_taaProgram, "uvScale");
+	m_taaTexelSizeLocation = glGetUniformLocation(m_taaProgram, "texelSize");
+	m_taaLastPixelLocation = glGetUniformLocation(m_taaProgram, "lastPixel");
+	m_taaReprojectionLocation = glGetUniformLocation(m_taaProgram, "reprojection");
+	m_taaZeroToOneDepthLocation = glGetUniformLocation(m_taaProgram, "zeroToOneDepth");
+	m_taaBlendLocation = glGetUniformLocation(m_taaProgram, "blend");
+
+	// the texture units of the TAA inputs never change
+	GLint previousProgram = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+	glUseProgram(m_taaProgram);
+	glUniform1i(glGetUniformLocation(m_taaProgram, "sceneColor"), 0);
+	glUniform1i(glGetUniformLocation(m_taaProgram, "sceneDepth"), 1);
+	glUniform1i(glGetUniformLocation(m_taaProgram, "historyColor"), 2);
+	glUseProgram((GLuint)previousProgram);
+
+	// the triangle is made from the vertex index alone, but the
+	// core profile still needs a vertex array bound
+	glGenVertexArrays(1, &m_vertexArray);
+
+	glGenSamplers(1, &m_sampler);
+	glSamplerParameteri(m_sampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glSamplerParameteri(m_sampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glSamplerParameteri(m_sampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glSamplerParameteri(m_sampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	SetMode(m_settings.mode);
+	return(true);
+}
+
+/***********************************************************
+ *  Shutdown()
+ *
+ *  This method is used for freeing the programs and the
+ *  sampler.  The targets belong to the pool.
+ ***********************************************************/
+void AntiAliasing::Shutdown()
+{
+	if (m_fxaaProgram != 0)
+	{
+		glDeleteProgram(m_fxaaProgram);
+		m_fxaaProgram = 0;
+	}
+	if (m_taaProgram != 0)
+	{
+		glDeleteProgram(m_taaProgram);
+		m_taaProgram = 0;
+	}
+	if (m_vertexArray != 0)
+	{
+		glDeleteVertexArrays(1, &m_vertexArray);
+		m_vertexArray = 0;
+	}
+	if (m_sampler != 0)
+	{
+		glDeleteSamplers(1, &m_sampler);
+		m_sampler = 0;
+	}
+	m_frameTargets.clear();
+	m_pHistory = NULL;
+}
+
+/***********************************************************
+ *  GetModeName()
+ *
+ *  Returns the name of a mode.
+ ***********************************************************/
+const char* AntiAliasing::GetModeName(int mode)
+{
+	if ((mode < 0) || (mode >= aa_count))
+	{
+		return(g_ModeNames[aa_none]);
+	}
+	return(g_ModeNames[mode]);
+}
+
+/***********************************************************
+ *  FindMode()
+ *
+ *  Returns the mode with the passed in name.
+ ***********************************************************/
+int AntiAliasing::FindMode(const std::string& name)
+{
+	for (int mode = 0; mode < aa_count; mode++)
+	{
+		if (name == g_ModeNames[mode])
+		{
+			return(mode);
+		}
+	}
+	return(-1);
+}
+
+/***********************************************************
+ *  SetMode()
+ *
+ *  This method is used for switching to another mode from
+ *  the next frame on.  Pass times measured before the switch
+ *  are not counted for the new mode.
+ ***********************************************************/
+void AntiAliasing::SetMode(int mode)
+{
+	m_mode = ((mode >= 0) && (mode < aa_count)) ? mode : aa_none;
+	m_modeFrame = GPUProfiler::Get().GetFrameIndex();
+	m_jitterIndex = 0;
+}
+
+/***********************************************************
+ *  GetSceneSamples()
+ *
+ *  This method is used for getting the samples per pixel
+ *  the scene must be drawn with.
+ ***********************************************************/
+int AntiAliasing::GetSceneSamples() const
+{
+	return((m_mode == aa_msaa) ? m_settings.msaaSamples : 1);
+}
+
+/***********************************************************
+ *  GetSettleFrames()
+ *
+ *  This method is used for getting how many frames must be
+ *  drawn after the view stops before the image stops
+ *  changing.  Only TAA needs any: every position of the
+ *  jitter sequence must be seen, and the history must blend
+ *  until what is left of the old frames is below one step of
+ *  an 8 bit color.
+ ***********************************************************/
+int AntiAliasing::GetSettleFrames() const
+{
+	if (m_mode != aa_taa)
+	{
+		return(0);
+	}
+
+	float blend = std::min(std::max(m_settings.taaBlend, 0.01f), 1.0f);
+	int frames = (int)JITTER_SAMPLES;
+	if (blend < 1.0f)
+	{
+		frames = std::max(frames, (int)std::ceil(std::log(1.0f / 256.0f) / std::log(1.0f - blend)));
+	}
+	return(frames);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for adding the latest pass time of
+ *  the mode to its statistics and for stepping through the
+ *  jitter sequence.  The jitter is up to half a pixel of the
+ *  size the scene is drawn with either way.
+ ***********************************************************/
+glm::vec2 AntiAliasing::BeginFrame(int renderWidth, int renderHeight)
+{
+	const char* scopeName = g_PassScopeNames[m_mode];
+	double gpuMs = 0.0;
+	int sampleFrame = 0;
+	if ((NULL != scopeName) &&
+		(GPUProfiler::Get().GetLatestScopeTime(scopeName, gpuMs, sampleFrame) == true) &&
+		(sampleFrame > m_lastSampleFrame) && (sampleFrame >= m_modeFrame))
+	{
+		m_lastSampleFrame = sampleFrame;
+		m_passMsSum[m_mode] += gpuMs;
+		m_passCount[m_mode]++;
+	}
+
+	if ((m_mode != aa_taa) || (renderWidth <= 0) || (renderHeight <= 0))
+	{
+		return(glm::vec2(0.0f));
+	}
+
+	// the sequence starts at one, since its first element is
+	// the corner of the pixel
+	unsigned int index = (m_jitterIndex % JITTER_SAMPLES) + 1;
+	m_jitterIndex++;
+	return(glm::vec2(
+		(Halton(index, 2) - 0.5f) * 2.0f / (float)renderWidth,
+		(Halton(index, 3) - 0.5f) * 2.0f / (float)renderHeight));
+}
+
+/***********************************************************
+ *  Resolve()
+ *
+ *  This method is used for running the pass of the mode over
+ *  the scene.  When a pass cannot run the scene target is
+ *  returned as it is.
+ ***********************************************************/
+RenderTarget* AntiAliasing::Resolve(RenderTargetPool& pool, RenderTarget& scene,
+	int renderWidth, int renderHeight, const glm::mat4& viewProjection)
+{
+	if (m_mode != aa_taa)
+	{
+		DropHistory();
+	}
+
+	RenderTarget* pResult = NULL;
+	switch (m_mode)
+	{
+	case aa_msaa:
+		pResult = ResolveMultisample(pool, scene, renderWidth, renderHeight);
+		break;
+	case aa_fxaa:
+		pResult = ApplyFxaa(pool, scene, renderWidth, renderHeight);
+		break;
+	case aa_taa:
+		pResult = ApplyTaa(pool, scene, renderWidth, renderHeight, viewProjection);
+		break;
+	default:
+		break;
+	}
+	return((NULL != pResult) ? pResult : &scene);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for giving the pool back the targets
+ *  of this frame's passes, so later passes and frames can
+ *  draw into them.
+ ***********************************************************/
+void AntiAliasing::EndFrame(RenderTargetPool& pool)
+{
+	for (size_t i = 0; i < m_frameTargets.size(); i++)
+	{
+		pool.Release(m_frameTargets[i]);
+	}
+	m_frameTargets.clear();
+}
+
+/***********************************************************
+ *  AcquireColorTarget()
+ *
+ *  This method is used for taking a single sampled color
+ *  target, given back at the end of the frame.  It keeps the
+ *  color format of the scene, which a multisample resolve
+ *  needs and which keeps floating point colors for the post
+ *  effects.
+ ***********************************************************/
+RenderTarget* AntiAliasing::AcquireColorTarget(RenderTargetPool& pool, const RenderTarget& scene)
+{
+	RenderTargetPool::TARGET_DESC desc;
+	desc.width = scene.GetWidth();
+	desc.height = scene.GetHeight();
+	desc.colorFormat = scene.GetColorFormat();
+	desc.depthFormat = 0;
+	desc.samples = 1;
+	return(pool.Acquire(desc));
+}
+
+/***********************************************************
+ *  DrawFullScreen()
+ *
+ *  This method is used for drawing the triangle covering the
+ *  viewport with the program that is bound.
+ ***********************************************************/
+void AntiAliasing::DrawFullScreen() const
+{
+	glBindVertexArray(m_vertexArray);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  ResolveMultisample()
+ *
+ *  This method is used for averaging the samples of each
+ *  pixel into a single sampled target, which the copy to the
+ *  window, the upscale and any later pass can then read.
+ ***********************************************************/
+RenderTarget* AntiAliasing::ResolveMultisample(RenderTargetPool& pool, RenderTarget& scene, int renderWidth, int renderHeight)
+{
+	if (scene.GetSamples() <= 1)
+	{
+		return(NULL);
+	}
+	RenderTarget* pOutput = AcquireColorTarget(pool, scene);
+	if (NULL == pOutput)
+	{
+		return(NULL);
+	}
+	m_frameTargets.push_back(pOutput);
+
+	GPUProfiler& profiler = GPUProfiler::Get();
+	profiler.BeginScope(g_PassScopeNames[aa_msaa]);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, scene.GetFramebuffer());
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, pOutput->GetFramebuffer());
+	glBlitFramebuffer(0, 0, renderWidth, renderHeight, 0, 0, renderWidth, renderHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	pOutput->Bind(renderWidth, renderHeight);
+	profiler.EndScope();
+
+	return(pOutput);
+}
+
+/***********************************************************
+ *  ApplyFxaa()
+ *
+ *  This method is used for drawing the scene through the
+ *  FXAA filter into a new target.
+ ***********************************************************/
+RenderTarget* AntiAliasing::ApplyFxaa(RenderTargetPool& pool, RenderTarget& scene, int renderWidth, int renderHeight)
+{
+	if ((m_fxaaProgram == 0) || (scene.GetSamples() > 1) || (scene.GetColorTexture() == 0))
+	{
+		return(NULL);
+	}
+	RenderTarget* pOutput = AcquireColorTarget(pool, scene);
+	if (NULL == pOutput)
+	{
+		return(NULL);
+	}
+	m_frameTargets.push_back(pOutput);
+
+	GPUProfiler& profiler = GPUProfiler::Get();
+	profiler.BeginScope(g_PassScopeNames[aa_fxaa]);
+	PASS_STATE state;
+	SavePassState(state);
+
+	pOutput->Bind(renderWidth, renderHeight);
+	glDisable(GL_DEPTH_TEST);
+	glUseProgram(m_fxaaProgram);
+	glUniform2f(m_fxaaUvScaleLocation,
+		(float)renderWidth / (float)scene.GetWidth(),
+		(float)renderHeight / (float)scene.GetHeight());
+	glUniform2f(m_fxaaTexelSizeLocation, 1.0f / (float)scene.GetWidth(), 1.0f / (float)scene.GetHeight());
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, scene.GetColorTexture());
+	glBindSampler(0, m_sampler);
+	DrawFullScreen();
+
+	RestorePassState(state);
+	profiler.EndScope();
+
+	return(pOutput);
+}
+
+/***********************************************************
+ *  ApplyTaa()
+ *
+ *  This method is used for blending the jittered scene into
+ *  the history of the earlier frames.  The result becomes
+ *  the history of the next frame, so it stays out of the
+ *  pool until then.  The history starts over whenever the
+ *  size the scene is drawn with changes.
+ ***********************************************************/
+RenderTarget* AntiAliasing::ApplyTaa(RenderTargetPool& pool, RenderTarget& scene,
+	int renderWidth, int renderHeight, const glm::mat4& viewProjection)
+{
+	if ((m_taaProgram == 0) || (scene.GetSamples() > 1) ||
+		(scene.GetColorTexture() == 0) || (scene.GetDepthTexture() == 0))
+	{
+		DropHistory();
+		return(NULL);
+	}
+
+	bool bHistory = (NULL != m_pHistory) &&
+		(m_pHistory->GetWidth() == scene.GetWidth()) && (m_pHistory->GetHeight() == scene.GetHeight()) &&
+		(m_historyWidth == renderWidth) && (m_historyHeight == renderHeight);
+	if (bHistory == false)
+	{
+		DropHistory();
+	}
+
+	RenderTarget* pOutput = AcquireColorTarget(pool, scene);
+	if (NULL == pOutput)
+	{
+		DropHistory();
+		return(NULL);
+	}
+
+	GPUProfiler& profiler = GPUProfiler::Get();
+	profiler.BeginScope(g_PassScopeNames[aa_taa]);
+	PASS_STATE state;
+	SavePassState(state);
+
+	// takes a position of this frame to the clip space of the
+	// last one - neither has the jitter, so a still camera
+	// reads the history at the same pixel
+	glm::mat4 reprojection = m_previousViewProjection * glm::inverse(viewProjection);
+
+	pOutput->Bind(renderWidth, renderHeight);
+	glDisable(GL_DEPTH_TEST);
+	glUseProgram(m_taaProgram);
+	glUniform2f(m_taaUvScaleLocation,
+		(float)renderWidth / (float)scene.GetWidth(),
+		(float)renderHeight / (float)scene.GetHeight());
+	glUniform2f(m_taaTexelSizeLocation, 1.0f / (float)scene.GetWidth(), 1.0f / (float)scene.GetHeight());
+	glUniform2i(m_taaLastPixelLocation, renderWidth - 1, renderHeight - 1);
+	glUniformMatrix4fv(m_taaReprojectionLocation, 1, GL_FALSE, glm::value_ptr(reprojection));
+	glUniform1i(m_taaZeroToOneDepthLocation, (m_settings.bZeroToOneDepth == true) ? 1 : 0);
+	glUniform1f(m_taaBlendLocation, (bHistory == true) ? m_settings.taaBlend : 1.0f);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, scene.GetColorTexture());
+	glBindSampler(0, 0);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, scene.GetDepthTexture());
+	glBindSampler(1, 0);
+	glActiveTexture(GL_TEXTURE2);
+	glBindTexture(GL_TEXTURE_2D, (bHistory == true) ? m_pHistory->GetColorTexture() : scene.GetColorTexture());
+	glBindSampler(2, m_sampler);
+	DrawFullScreen();
+
+	RestorePassState(state);
+	profiler.EndScope();
+
+	// the old history has been read and can go back to the pool
+	DropHistory();
+	m_pHistory = pOutput;
+	m_historyWidth = renderWidth;
+	m_historyHeight = renderHeight;
+	m_previousViewProjection = viewProjection;
+
+	return(pOutput);
+}
+
+/***********************************************************
+ *  DropHistory()
+ *
+ *  This method is used for letting the pool have the TAA
+ *  history back at the end of the frame.
+ ***********************************************************/
+void AntiAliasing::DropHistory()
+{
+	if (NULL != m_pHistory)
+	{
+		m_frameTargets.push_back(m_pHistory);
+		m_pHistory = NULL;
+	}
+}
+
+/***********************************************************
+ *  GetPassTime()
+ *
+ *  This method is used for getting the average GPU time of
+ *  the pass of a mode since the statistics were reset.
+ ***********************************************************/
+bool AntiAliasing::GetPassTime(int mode, double& durationMs) const
+{
+	if ((mode < 0) || (mode >= aa_count) || (m_passCount[mode] == 0))
+	{
+		return(false);
+	}
+	durationMs = m_passMsSum[mode] / (double)m_passCount[mode];
+	return(true);
+}
+
+/***********************************************************
+ *  ResetStats()
+ *
+ *  This method is used for forgetting the measured pass
+ *  times of every mode.
+ ***********************************************************/
+void AntiAliasing::ResetStats()
+{
+	for (int mode = 0; mode < aa_count; mode++)
+	{
+		m_passMsSum[mode] = 0.0;
+		m_passCount[mode] = 0;
+	}
+}
+
+/***********************************************************
+ *  PrintStats()
+ *
+ *  This method is used for printing the average GPU time of
+ *  the pass of each mode that was measured.
+ ***********************************************************/
+void AntiAliasing::PrintStats() const
+{
+	for (int mode = 0; mode < aa_count; mode++)
+	{
+		double durationMs = 0.0;
+		if (GetPassTime(mode, durationMs) == true)
+		{
+			std::cout << "INFO: Anti-aliasing " << GetModeName(mode);
+			if (mode == aa_msaa)
+			{
+				std::cout << " x" << m_settings.msaaSamples;
+			}
+			std::cout << ": " << durationMs << " ms per pass over "
+				<< m_passCount[mode] << " frames" << std::endl;
+		}
+	}
+}
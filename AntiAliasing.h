@@ -0,0 +1,163 @@
+///////////////////////////////////////////////////////////////////////////////
+// antialiasing.h
+// ============
+// multisampled, fast approximate and temporal anti-aliasing of the scene
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderTarget.h"
+#include "RenderTargetPool.h"
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  AntiAliasing
+ *
+ *  This class smooths the edges of the scene, which is drawn
+ *  into an offscreen target, in one of three ways:
+ *
+ *  MSAA draws the scene into a multisampled target, so the
+ *  edges of triangles are covered by several samples, and
+ *  averages them into a single sampled target.  It costs the
+ *  most memory and bandwidth and leaves shading aliasing.
+ *
+ *  FXAA finds edges in the finished image by their contrast
+ *  and blurs along them.  It costs one full screen pass and
+ *  softens texture detail a little.
+ *
+ *  TAA moves the projection by a different part of a pixel
+ *  every frame and blends each frame into a history that is
+ *  reprojected with the depth buffer.  History colors outside
+ *  the range of the current pixel's neighbors are clamped to
+ *  it, which keeps moving objects from leaving trails.
+ *
+ *  Each pass runs in a GPU profiler scope of its own, and the
+ *  measured times are collected per mode so the cost of the
+ *  modes can be compared.
+ ***********************************************************/
+class AntiAliasing
+{
+public:
+	enum AA_MODE
+	{
+		aa_none = 0,
+		aa_msaa,
+		aa_fxaa,
+		aa_taa,
+		aa_count
+	};
+
+	struct ANTIALIASING_SETTINGS
+	{
+		int mode;
+		// samples per pixel of the MSAA scene target
+		int msaaSamples;
+		// weight of the current frame in the TAA history
+		float taaBlend;
+		// true when depth is mapped to the zero to one clip range,
+		// as reverse depth does
+		bool bZeroToOneDepth;
+	};
+
+	// constructor
+	AntiAliasing();
+	// destructor
+	~AntiAliasing();
+
+	// build the FXAA and TAA programs - false when they cannot
+	// be built
+	bool Initialize(const ANTIALIASING_SETTINGS& settings);
+	// free the programs and samplers
+	void Shutdown();
+
+	// name of a mode, and the mode with a name or -1
+	static const char* GetModeName(int mode);
+	static int FindMode(const std::string& name);
+
+	void SetMode(int mode);
+	int GetMode() const { return(m_mode); }
+	// samples per pixel the scene target needs for the mode
+	int GetSceneSamples() const;
+	int GetMsaaSamples() const { return(m_settings.msaaSamples); }
+	// frames the mode must keep drawing after the last change
+	// before its result stops changing
+	int GetSettleFrames() const;
+
+	// collect the latest pass time and choose the projection
+	// jitter of the next frame, in normalized device units, for
+	// the size the scene is drawn with - zero unless TAA
+	glm::vec2 BeginFrame(int renderWidth, int renderHeight);
+	// anti-alias the lower left corner of the scene target and
+	// return the target holding the result in the same corner,
+	// which is the scene target itself when there is nothing to
+	// do - the view projection is the one without jitter
+	RenderTarget* Resolve(RenderTargetPool& pool, RenderTarget& scene,
+		int renderWidth, int renderHeight, const glm::mat4& viewProjection);
+	// give back the targets Resolve() took from the pool this
+	// frame, keeping the TAA history
+	void EndFrame(RenderTargetPool& pool);
+
+	// average GPU time of the pass of a mode - false when none
+	// was measured
+	bool GetPassTime(int mode, double& durationMs) const;
+	// forget the measured pass times
+	void ResetStats();
+	// print the average pass time of every mode that ran
+	void PrintStats() const;
+
+private:
+	ANTIALIASING_SETTINGS m_settings;
+	int m_mode;
+
+	GLuint m_fxaaProgram;
+	GLuint m_taaProgram;
+	GLuint m_vertexArray;
+	GLuint m_sampler;
+	GLint m_fxaaUvScaleLocation;
+	GLint m_fxaaTexelSizeLocation;
+	GLint m_taaUvScaleLocation;
+	GLint m_taaTexelSizeLocation;
+	GLint m_taaLastPixelLocation;
+	GLint m_taaReprojectionLocation;
+	GLint m_taaZeroToOneDepthLocation;
+	GLint m_taaBlendLocation;
+
+	// targets taken from the pool during the frame
+	std::vector<RenderTarget*> m_frameTargets;
+	// anti-aliased image of the last TAA frame, kept out of the
+	// pool until the next frame has read it
+	RenderTarget* m_pHistory;
+	int m_historyWidth;
+	int m_historyHeight;
+	glm::mat4 m_previousViewProjection;
+	// frames since the jitter sequence began
+	unsigned int m_jitterIndex;
+
+	// the latest profiler frame read, and the first frame drawn
+	// in the current mode
+	int m_lastSampleFrame;
+	int m_modeFrame;
+	// sums of the measured pass times of each mode
+	double m_passMsSum[aa_count];
+	int m_passCount[aa_count];
+
+	// take a single sampled color target from the pool, with
+	// the size and color format of the scene
+	RenderTarget* AcquireColorTarget(RenderTargetPool& pool, const RenderTarget& scene);
+	// draw a full screen triangle with the bound program
+	void DrawFullScreen() const;
+	// the passes of the modes
+	RenderTarget* ResolveMultisample(RenderTargetPool& pool, RenderTarget& scene, int renderWidth, int renderHeight);
+	RenderTarget* ApplyFxaa(RenderTargetPool& pool, RenderTarget& scene, int renderWidth, int renderHeight);
+	RenderTarget* ApplyTaa(RenderTargetPool& pool, RenderTarget& scene,
+		int renderWidth, int renderHeight, const glm::mat4& viewProjection);
+	// let the pool have the TAA history back
+	void DropHistory();
+};
@@ -0,0 +1,672 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmark.cpp
+// ============
+// deterministic benchmark runs - fixed timestep, scripted camera, JSON report
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Benchmark.h"
+#include "AntiAliasing.h"
+#include "JobSystem.h"
+#include "SamplerCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// declaration of global variables
+namespace
+{
+	// number of timer queries in flight - results are read
+	// this many frames later so the CPU never waits on them
+	const int GPU_QUERY_COUNT = 4;
+
+	typedef std::chrono::steady_clock BenchmarkClock;
+
+	/***********************************************************
+	 *  ElapsedMs()
+	 *
+	 *  Milliseconds between two clock readings.
+	 ***********************************************************/
+	double ElapsedMs(BenchmarkClock::time_point start, BenchmarkClock::time_point end)
+	{
+		return(std::chrono::duration<double, std::milli>(end - start).count());
+	}
+
+	/***********************************************************
+	 *  EscapeJson()
+	 *
+	 *  Escapes a string for writing between quotes in a JSON
+	 *  report, so paths with backslashes stay valid.
+	 ***********************************************************/
+	std::string EscapeJson(const std::string& text)
+	{
+		std::string escaped;
+		escaped.reserve(text.size());
+		for (size_t i = 0; i < text.size(); i++)
+		{
+			unsigned char c = (unsigned char)text[i];
+			if ((c == '"') || (c == '\\'))
+			{
+				escaped += '\\';
+				escaped += (char)c;
+			}
+			else if (c < 0x20)
+			{
+				char code[8];
+				snprintf(code, sizeof(code), "\\u%04x", c);
+				escaped += code;
+			}
+			else
+			{
+				escaped += (char)c;
+			}
+		}
+		return(escaped);
+	}
+
+	/***********************************************************
+	 *  WriteOutput()
+	 *
+	 *  Writes a report to a file, or to the console when no
+	 *  file name is given.
+	 ***********************************************************/
+	bool WriteOutput(const std::string& filename, const std::string& report)
+	{
+		if (filename.size() == 0)
+		{
+			std::cout << report;
+			return(true);
+		}
+
+		std::ofstream file(filename.c_str());
+		if (!file.is_open())
+		{
+			std::cout << "Could not write benchmark report:" << filename << std::endl;
+			return(false);
+		}
+		file << report;
+
+		std::cout << "INFO: Benchmark report written to " << filename << std::endl;
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  WriteSummary()
+	 *
+	 *  Writes min/avg/median/p95/p99/max of a series as a JSON
+	 *  object.
+	 ***********************************************************/
+	void WriteSummary(std::ostream& out, const char* name, std::vector<double> values)
+	{
+		out << "    \"" << name << "\": {";
+		if (values.size() == 0)
+		{
+			out << "}";
+			return;
+		}
+
+		std::sort(values.begin(), values.end());
+		double total = 0.0;
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			total += values[i];
+		}
+
+		size_t last = values.size() - 1;
+		out << "\"min\": " << values[0]
+			<< ", \"avg\": " << total / values.size()
+			<< ", \"median\": " << values[last / 2]
+			<< ", \"p95\": " << values[(last * 95) / 100]
+			<< ", \"p99\": " << values[(last * 99) / 100]
+			<< ", \"max\": " << values[last] << "}";
+	}
+}
+
+/***********************************************************
+ *  Benchmark()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+Benchmark::Benchmark(const BENCHMARK_SETTINGS& settings)
+{
+	m_settings = settings;
+}
+
+/***********************************************************
+ *  ~Benchmark()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+Benchmark::~Benchmark()
+{
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for running the warm-up and measured
+ *  frames.  Vsync is disabled for the run so the results are
+ *  not clamped to the display refresh rate.
+ ***********************************************************/
+bool Benchmark::Run(
+	GLFWwindow* pWindow,
+	ViewManager* pViewManager,
+	SceneManager* pSceneManager,
+	const std::function<void()>& renderFrame)
+{
+	if ((NULL == pWindow) || (NULL == pViewManager) || (NULL == pSceneManager))
+	{
+		return(false);
+	}
+
+	// load the recorded path, or script an orbit long enough
+	// to cover every frame of the run
+	if (m_settings.pathFile.size() > 0)
+	{
+		if (m_path.Load(m_settings.pathFile.c_str()) == false)
+		{
+			return(false);
+		}
+	}
+	else
+	{
+		float duration = m_settings.timestep * (m_settings.warmupFrames + m_settings.measuredFrames);
+		m_path.CreateOrbit(duration, 12.0f, 5.0f);
+	}
+
+	m_renderer = (const char*)glGetString(GL_RENDERER);
+	m_samples.clear();
+	m_samples.reserve(m_settings.measuredFrames);
+
+	pViewManager->SetFixedTimestep(m_settings.timestep);
+	pViewManager->SetPlaybackPath(&m_path);
+	glfwSwapInterval(0);
+
+	GLuint queries[GPU_QUERY_COUNT];
+	glGenQueries(GPU_QUERY_COUNT, queries);
+
+	std::cout << "INFO: Benchmark " << m_settings.warmupFrames << " warm-up + "
+		<< m_settings.measuredFrames << " measured frames" << std::endl;
+
+	int totalFrames = m_settings.warmupFrames + m_settings.measuredFrames;
+	int frame = 0;
+	for (frame = 0; (frame < totalFrames) && !glfwWindowShouldClose(pWindow); frame++)
+	{
+		BenchmarkClock::time_point frameStart = BenchmarkClock::now();
+
+		pSceneManager->ResetRenderStats();
+
+		glBeginQuery(GL_TIME_ELAPSED, queries[frame % GPU_QUERY_COUNT]);
+		renderFrame();
+		glEndQuery(GL_TIME_ELAPSED);
+
+		BenchmarkClock::time_point submitEnd = BenchmarkClock::now();
+
+		glfwSwapBuffers(pWindow);
+		glfwPollEvents();
+
+		BenchmarkClock::time_point frameEnd = BenchmarkClock::now();
+
+		if (frame >= m_settings.warmupFrames)
+		{
+			FRAME_SAMPLE sample;
+			sample.cpuFrameMs = ElapsedMs(frameStart, frameEnd);
+			sample.cpuSubmitMs = ElapsedMs(frameStart, submitEnd);
+			sample.gpuMs = 0.0;
+			sample.stats = pSceneManager->GetRenderStats();
+			m_samples.push_back(sample);
+		}
+
+		// the oldest query in the ring belongs to a frame that
+		// was submitted GPU_QUERY_COUNT - 1 frames ago
+		int resultFrame = frame - (GPU_QUERY_COUNT - 1);
+		if (resultFrame >= m_settings.warmupFrames)
+		{
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(queries[resultFrame % GPU_QUERY_COUNT], GL_QUERY_RESULT, &elapsed);
+			m_samples[resultFrame - m_settings.warmupFrames].gpuMs = elapsed / 1000000.0;
+		}
+	}
+
+	// collect the results still in flight
+	for (int resultFrame = std::max(frame - (GPU_QUERY_COUNT - 1), m_settings.warmupFrames); resultFrame < frame; resultFrame++)
+	{
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(queries[resultFrame % GPU_QUERY_COUNT], GL_QUERY_RESULT, &elapsed);
+		m_samples[resultFrame - m_settings.warmupFrames].gpuMs = elapsed / 1000000.0;
+	}
+
+	glDeleteQueries(GPU_QUERY_COUNT, queries);
+	pViewManager->SetPlaybackPath(NULL);
+	pViewManager->SetFixedTimestep(0.0f);
+	glfwSwapInterval(1);
+
+	if ((int)m_samples.size() < m_settings.measuredFrames)
+	{
+		std::cout << "Benchmark interrupted after " << m_samples.size() << " measured frames" << std::endl;
+	}
+
+	return(m_samples.size() > 0);
+}
+
+/***********************************************************
+ *  BuildReport()
+ *
+ *  This method is used for building the JSON report of the
+ *  last run, optionally with every measured frame.
+ ***********************************************************/
+std::string Benchmark::BuildReport(bool bIncludeFrames) const
+{
+	std::vector<double> cpuFrame;
+	std::vector<double> cpuSubmit;
+	std::vector<double> gpu;
+	std::vector<double> build;
+	std::vector<double> submit;
+	std::vector<double> draws;
+	std::vector<double> culled;
+	std::vector<double> stateChanges;
+
+	for (size_t i = 0; i < m_samples.size(); i++)
+	{
+		const FRAME_SAMPLE& sample = m_samples[i];
+		cpuFrame.push_back(sample.cpuFrameMs);
+		cpuSubmit.push_back(sample.cpuSubmitMs);
+		gpu.push_back(sample.gpuMs);
+		build.push_back(sample.stats.buildMs);
+		submit.push_back(sample.stats.submitMs);
+		draws.push_back(sample.stats.drawCalls);
+		culled.push_back(sample.stats.culledObjects);
+		stateChanges.push_back(
+			sample.stats.transformChanges +
+			sample.stats.textureChanges +
+			sample.stats.materialChanges +
+			sample.stats.colorChanges +
+			sample.stats.programChanges +
+			sample.stats.samplerChanges);
+	}
+
+	std::ostringstream out;
+	out << "{\n";
+	out << "  \"renderer\": \"" << EscapeJson(m_renderer) << "\",\n";
+	out << "  \"path\": \"" << EscapeJson(m_settings.pathFile.size() > 0 ? m_settings.pathFile : "orbit") << "\",\n";
+	out << "  \"timestep\": " << m_settings.timestep << ",\n";
+	out << "  \"warmup_frames\": " << m_settings.warmupFrames << ",\n";
+	out << "  \"measured_frames\": " << m_samples.size() << ",\n";
+	out << "  \"summary\": {\n";
+	WriteSummary(out, "cpu_frame_ms", cpuFrame);
+	out << ",\n";
+	WriteSummary(out, "cpu_submit_ms", cpuSubmit);
+	out << ",\n";
+	WriteSummary(out, "gpu_ms", gpu);
+	out << ",\n";
+	WriteSummary(out, "build_ms", build);
+	out << ",\n";
+	WriteSummary(out, "scene_submit_ms", submit);
+	out << ",\n";
+	WriteSummary(out, "draw_calls", draws);
+	out << ",\n";
+	WriteSummary(out, "culled_objects", culled);
+	out << ",\n";
+	WriteSummary(out, "state_changes", stateChanges);
+	out << "\n  }";
+
+	if (bIncludeFrames == true)
+	{
+		out << ",\n  \"frames\": [\n";
+		for (size_t i = 0; i < m_samples.size(); i++)
+		{
+			const FRAME_SAMPLE& sample = m_samples[i];
+			out << "    {\"cpu_frame_ms\": " << sample.cpuFrameMs
+				<< ", \"cpu_submit_ms\": " << sample.cpuSubmitMs
+				<< ", \"gpu_ms\": " << sample.gpuMs
+				<< ", \"build_ms\": " << sample.stats.buildMs
+				<< ", \"scene_submit_ms\": " << sample.stats.submitMs
+				<< ", \"draw_calls\": " << sample.stats.drawCalls
+				<< ", \"culled_objects\": " << sample.stats.culledObjects
+				<< ", \"transform_changes\": " << sample.stats.transformChanges
+				<< ", \"texture_changes\": " << sample.stats.textureChanges
+				<< ", \"material_changes\": " << sample.stats.materialChanges
+				<< ", \"color_changes\": " << sample.stats.colorChanges
+				<< ", \"program_changes\": " << sample.stats.programChanges
+				<< ", \"sampler_changes\": " << sample.stats.samplerChanges << "}"
+				<< ((i + 1 < m_samples.size()) ? ",\n" : "\n");
+		}
+		out << "  ]";
+	}
+	out << "\n}";
+
+	return(out.str());
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  This method is used for writing the results of the last
+ *  run as JSON, to the report file or to the console.
+ ***********************************************************/
+bool Benchmark::WriteReport() const
+{
+	return(WriteOutput(m_settings.outputFile, BuildReport(true) + "\n"));
+}
+
+/***********************************************************
+ *  RunSceneSweep()
+ *
+ *  This method is used for benchmarking generated scenes of
+ *  each requested object count with the same settings and
+ *  seed, writing a single report that shows how the build
+ *  (culling and transforms), submission and GPU time scale
+ *  with the scene size.
+ ***********************************************************/
+bool Benchmark::RunSceneSweep(
+	const BENCHMARK_SETTINGS& settings,
+	const std::vector<int>& objectCounts,
+	unsigned int seed,
+	GLFWwindow* pWindow,
+	ViewManager* pViewManager,
+	SceneManager* pSceneManager,
+	const std::function<void()>& renderFrame)
+{
+	std::ostringstream out;
+	out << "{\n\"seed\": " << seed << ",\n\"sweep\": [\n";
+
+	bool bResult = true;
+	for (size_t i = 0; (i < objectCounts.size()) && (bResult == true); i++)
+	{
+		pSceneManager->GenerateScene(objectCounts[i], seed);
+
+		Benchmark benchmark(settings);
+		bResult = benchmark.Run(pWindow, pViewManager, pSceneManager, renderFrame);
+
+		out << "{\"object_count\": " << objectCounts[i]
+			<< ", \"result\": " << benchmark.BuildReport(false) << "}"
+			<< ((i + 1 < objectCounts.size()) ? ",\n" : "\n");
+	}
+	out << "]\n}\n";
+
+	// restore the built-in scene
+	pSceneManager->GenerateScene(0, seed);
+
+	if (bResult == false)
+	{
+		return(false);
+	}
+	return(WriteOutput(settings.outputFile, out.str()));
+}
+
+/***********************************************************
+ *  RunFilterSweep()
+ *
+ *  This method is used for benchmarking the scene with every
+ *  material forced to each texture filter in turn.  Without
+ *  mipmaps a minified surface fetches texels spread far
+ *  apart, which misses the texture cache on almost every
+ *  sample; there is no portable counter for texture cache
+ *  traffic, so the GPU time of the same frames is the
+ *  measure, reported next to that of the first filter.
+ ***********************************************************/
+bool Benchmark::RunFilterSweep(
+	const BENCHMARK_SETTINGS& settings,
+	const std::vector<int>& filters,
+	SamplerCache* pSamplerCache,
+	GLFWwindow* pWindow,
+	ViewManager* pViewManager,
+	SceneManager* pSceneManager,
+	const std::function<void()>& renderFrame)
+{
+	if ((NULL == pSamplerCache) || (filters.size() == 0))
+	{
+		std::cout << "Could not run the filter sweep without sampler objects" << std::endl;
+		return(false);
+	}
+
+	std::ostringstream out;
+	out << "{\n\"max_anisotropy\": " << pSamplerCache->GetMaxAnisotropy() << ",\n\"filter_sweep\": [\n";
+
+	bool bResult = true;
+	double baselineGpuMs = 0.0;
+	for (size_t i = 0; (i < filters.size()) && (bResult == true); i++)
+	{
+		pSamplerCache->SetOverrideFilter(filters[i]);
+		pSceneManager->MarkSceneChanged();
+
+		Benchmark benchmark(settings);
+		bResult = benchmark.Run(pWindow, pViewManager, pSceneManager, renderFrame);
+
+		double gpuMs = 0.0;
+		const std::vector<FRAME_SAMPLE>& samples = benchmark.GetSamples();
+		for (size_t j = 0; j < samples.size(); j++)
+		{
+			gpuMs += samples[j].gpuMs;
+		}
+		if (samples.size() > 0)
+		{
+			gpuMs /= (double)samples.size();
+		}
+		if (i == 0)
+		{
+			baselineGpuMs = gpuMs;
+		}
+
+		out << "{\"filter\": \"" << EscapeJson(SamplerCache::GetFilterName(filters[i])) << "\""
+			<< ", \"mean_gpu_ms\": " << gpuMs
+			<< ", \"gpu_time_ratio\": " << ((baselineGpuMs > 0.0) ? gpuMs / baselineGpuMs : 0.0)
+			<< ", \"result\": " << benchmark.BuildReport(false) << "}"
+			<< ((i + 1 < filters.size()) ? ",\n" : "\n");
+	}
+	out << "]\n}\n";
+
+	// let the materials choose again
+	pSamplerCache->SetOverrideFilter(SceneManager::filter_default);
+	pSceneManager->MarkSceneChanged();
+
+	if (bResult == false)
+	{
+		return(false);
+	}
+	return(WriteOutput(settings.outputFile, out.str()));
+}
+
+/***********************************************************
+ *  RunAntiAliasingSweep()
+ *
+ *  This method is used for benchmarking the scene with each
+ *  anti-aliasing mode in turn.  The GPU time of the frames is
+ *  reported next to that of the first mode, which includes
+ *  the cost of drawing the scene multisampled, and the time
+ *  of the mode's own pass is read from its profiler scope.
+ ***********************************************************/
+bool Benchmark::RunAntiAliasingSweep(
+	const BENCHMARK_SETTINGS& settings,
+	const std::vector<int>& modes,
+	AntiAliasing* pAntiAliasing,
+	GLFWwindow* pWindow,
+	ViewManager* pViewManager,
+	SceneManager* pSceneManager,
+	const std::function<void()>& renderFrame)
+{
+	if ((NULL == pAntiAliasing) || (modes.size() == 0))
+	{
+		std::cout << "Could not run the anti-aliasing sweep without its passes" << std::endl;
+		return(false);
+	}
+
+	std::ostringstream out;
+	out << "{\n\"msaa_samples\": " << pAntiAliasing->GetMsaaSamples() << ",\n\"aa_sweep\": [\n";
+
+	int startMode = pAntiAliasing->GetMode();
+	bool bResult = true;
+	double baselineGpuMs = 0.0;
+	for (size_t i = 0; (i < modes.size()) && (bResult == true); i++)
+	{
+		pAntiAliasing->SetMode(modes[i]);
+		pAntiAliasing->ResetStats();
+		pSceneManager->MarkSceneChanged();
+
+		Benchmark benchmark(settings);
+		bResult = benchmark.Run(pWindow, pViewManager, pSceneManager, renderFrame);
+
+		double gpuMs = 0.0;
+		const std::vector<FRAME_SAMPLE>& samples = benchmark.GetSamples();
+		for (size_t j = 0; j < samples.size(); j++)
+		{
+			gpuMs += samples[j].gpuMs;
+		}
+		if (samples.size() > 0)
+		{
+			gpuMs /= (double)samples.size();
+		}
+		if (i == 0)
+		{
+			baselineGpuMs = gpuMs;
+		}
+		double passMs = 0.0;
+		pAntiAliasing->GetPassTime(modes[i], passMs);
+
+		out << "{\"mode\": \"" << EscapeJson(AntiAliasing::GetModeName(modes[i])) << "\""
+			<< ", \"mean_gpu_ms\": " << gpuMs
+			<< ", \"gpu_time_ratio\": " << ((baselineGpuMs > 0.0) ? gpuMs / baselineGpuMs : 0.0)
+			<< ", \"mean_pass_ms\": " << passMs
+			<< ", \"result\": " << benchmark.BuildReport(false) << "}"
+			<< ((i + 1 < modes.size()) ? ",\n" : "\n");
+	}
+	out << "]\n}\n";
+
+	pAntiAliasing->SetMode(startMode);
+	pSceneManager->MarkSceneChanged();
+
+	if (bResult == false)
+	{
+		return(false);
+	}
+	return(WriteOutput(settings.outputFile, out.str()));
+}
+
+/***********************************************************
+ *  RunJobSystemBenchmark()
+ *
+ *  This method is used for measuring the job system with
+ *  1, 2, 4, ... workers up to maxWorkers.  For each worker
+ *  count it reports the cost of queueing and running an
+ *  empty job, the latency of a chain of dependent jobs, and
+ *  the time of a transform-like ParallelFor with a coarse
+ *  and a fine grain, including the speedup over one worker.
+ *  No OpenGL context is needed.
+ ***********************************************************/
+bool Benchmark::RunJobSystemBenchmark(int maxWorkers, const std::string& outputFile)
+{
+	const int EMPTY_JOBS = 100000;
+	const int CHAIN_LENGTH = 1000;
+	const int ITEM_COUNT = 1 << 20;
+	const int REPEATS = 5;
+
+	if (maxWorkers <= 0)
+	{
+		maxWorkers = (int)std::thread::hardware_concurrency();
+	}
+	if (maxWorkers <= 0)
+	{
+		maxWorkers = 1;
+	}
+
+	std::vector<int> workerCounts;
+	for (int count = 1; count < maxWorkers; count *= 2)
+	{
+		workerCounts.push_back(count);
+	}
+	workerCounts.push_back(maxWorkers);
+
+	// input and output of the parallel loop - a few dependent
+	// multiply-adds per item stand in for a transform update
+	std::vector<float> input(ITEM_COUNT);
+	std::vector<float> output(ITEM_COUNT);
+	for (int i = 0; i < ITEM_COUNT; i++)
+	{
+		input[i] = (float)(i % 1000) * 0.001f;
+	}
+	auto transformRange = [&input, &output](int begin, int end, int) {
+		for (int i = begin; i < end; i++)
+		{
+			float value = input[i];
+			for (int step = 0; step < 32; step++)
+			{
+				value = value * 0.999f + std::sqrt(value + 1.0f) * 0.001f;
+			}
+			output[i] = value;
+		}
+	};
+
+	std::ostringstream out;
+	out << "{\n\"job_system\": [\n";
+
+	double baseCoarseMs = 0.0;
+	double baseFineMs = 0.0;
+	for (size_t c = 0; c < workerCounts.size(); c++)
+	{
+		JobSystem jobSystem(workerCounts[c]);
+
+		// queue and run empty jobs from the main thread
+		BenchmarkClock::time_point start = BenchmarkClock::now();
+		{
+			JobCounter counter;
+			for (int i = 0; i < EMPTY_JOBS; i++)
+			{
+				jobSystem.Run([](int) {}, &counter);
+			}
+			jobSystem.Wait(&counter);
+		}
+		double emptyJobNs = ElapsedMs(start, BenchmarkClock::now()) * 1000000.0 / EMPTY_JOBS;
+
+		// each job of the chain waits for the one before it
+		start = BenchmarkClock::now();
+		{
+			std::vector<JobCounter> counters(CHAIN_LENGTH);
+			jobSystem.Run([](int) {}, &counters[0]);
+			for (int i = 1; i < CHAIN_LENGTH; i++)
+			{
+				jobSystem.RunAfter(&counters[i - 1], [](int) {}, &counters[i]);
+			}
+			jobSystem.Wait(&counters[CHAIN_LENGTH - 1]);
+		}
+		double chainLinkUs = ElapsedMs(start, BenchmarkClock::now()) * 1000.0 / CHAIN_LENGTH;
+
+		// best of several runs of the parallel loop
+		double coarseMs = 0.0;
+		double fineMs = 0.0;
+		for (int repeat = 0; repeat < REPEATS; repeat++)
+		{
+			start = BenchmarkClock::now();
+			jobSystem.ParallelFor(ITEM_COUNT, 4096, transformRange);
+			double elapsed = ElapsedMs(start, BenchmarkClock::now());
+			coarseMs = ((repeat == 0) || (elapsed < coarseMs)) ? elapsed : coarseMs;
+
+			start = BenchmarkClock::now();
+			jobSystem.ParallelFor(ITEM_COUNT, 64, transformRange);
+			elapsed = ElapsedMs(start, BenchmarkClock::now());
+			fineMs = ((repeat == 0) || (elapsed < fineMs)) ? elapsed : fineMs;
+		}
+		if (c == 0)
+		{
+			baseCoarseMs = coarseMs;
+			baseFineMs = fineMs;
+		}
+
+		out << "  {\"workers\": " << workerCounts[c]
+			<< ", \"empty_job_ns\": " << emptyJobNs
+			<< ", \"dependency_link_us\": " << chainLinkUs
+			<< ", \"parallel_for_grain_4096_ms\": " << coarseMs
+			<< ", \"speedup_grain_4096\": " << ((coarseMs > 0.0) ? baseCoarseMs / coarseMs : 0.0)
+			<< ", \"parallel_for_grain_64_ms\": " << fineMs
+			<< ", \"speedup_grain_64\": " << ((fineMs > 0.0) ? baseFineMs / fineMs : 0.0)
+			<< "}" << ((c + 1 < workerCounts.size()) ? ",\n" : "\n");
+	}
+	out << "],\n\"checksum\": " << output[ITEM_COUNT / 2] << "\n}\n";
+
+	return(WriteOutput(outputFile, out.str()));
+}
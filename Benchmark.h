@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmark.h
+// ============
+// deterministic benchmark runs - fixed timestep, scripted camera, JSON report
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "CameraPath.h"
+
+// GLFW library
+#include "GLFW/glfw3.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class SamplerCache;
+class AntiAliasing;
+
+/***********************************************************
+ *  Benchmark
+ *
+ *  This class runs a reproducible benchmark of the render
+ *  loop.  The camera replays a recorded or scripted path with
+ *  a fixed timestep, a number of warm-up frames are discarded
+ *  and the measured frames report CPU frame time, GPU time
+ *  from timer queries and the draw and state change counts.
+ ***********************************************************/
+class Benchmark
+{
+public:
+	struct BENCHMARK_SETTINGS
+	{
+		int warmupFrames;
+		int measuredFrames;
+		// simulated seconds per frame
+		float timestep;
+		// camera path file, or empty for the scripted orbit
+		std::string pathFile;
+		// JSON report file, or empty to print to the console
+		std::string outputFile;
+	};
+
+	// per-frame measurements
+	struct FRAME_SAMPLE
+	{
+		double cpuFrameMs;
+		double cpuSubmitMs;
+		double gpuMs;
+		SceneManager::RENDER_STATS stats;
+	};
+
+	// constructor
+	Benchmark(const BENCHMARK_SETTINGS& settings);
+	// destructor
+	~Benchmark();
+
+	// run the benchmark - renderFrame draws one complete frame
+	bool Run(
+		GLFWwindow* pWindow,
+		ViewManager* pViewManager,
+		SceneManager* pSceneManager,
+		const std::function<void()>& renderFrame);
+
+	// write the report of the last run
+	bool WriteReport() const;
+	// build the JSON report of the last run
+	std::string BuildReport(bool bIncludeFrames) const;
+
+	// benchmark generated scenes of increasing size and write
+	// one combined report
+	static bool RunSceneSweep(
+		const BENCHMARK_SETTINGS& settings,
+		const std::vector<int>& objectCounts,
+		unsigned int seed,
+		GLFWwindow* pWindow,
+		ViewManager* pViewManager,
+		SceneManager* pSceneManager,
+		const std::function<void()>& renderFrame);
+
+	// benchmark the scene with every material forced to each
+	// texture filter and write one combined report
+	static bool RunFilterSweep(
+		const BENCHMARK_SETTINGS& settings,
+		const std::vector<int>& filters,
+		SamplerCache* pSamplerCache,
+		GLFWwindow* pWindow,
+		ViewManager* pViewManager,
+		SceneManager* pSceneManager,
+		const std::function<void()>& renderFrame);
+
+	// benchmark the scene with each anti-aliasing mode and
+	// write one combined report, with the time of each pass
+	static bool RunAntiAliasingSweep(
+		const BENCHMARK_SETTINGS& settings,
+		const std::vector<int>& modes,
+		AntiAliasing* pAntiAliasing,
+		GLFWwindow* pWindow,
+		ViewManager* pViewManager,
+		SceneManager* pSceneManager,
+		const std::function<void()>& renderFrame);
+
+	// measure the scheduling overhead and core scaling of the
+	// job system from one worker up to maxWorkers
+	static bool RunJobSystemBenchmark(int maxWorkers, const std::string& outputFile);
+
+	// get the measured frames of the last run
+	const std::vector<FRAME_SAMPLE>& GetSamples() const { return(m_samples); }
+
+private:
+	BENCHMARK_SETTINGS m_settings;
+	CameraPath m_path;
+	std::vector<FRAME_SAMPLE> m_samples;
+	std::string m_renderer;
+};
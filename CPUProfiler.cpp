@@ -0,0 +1,147 @@
+///////////////////////////////////////////////////////////////////////////////
+// cpuprofiler.cpp
+// ============
+// lightweight CPU zone timing with Chrome trace / Perfetto export
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "CPUProfiler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+thread_local CPUProfiler::THREAD_BUFFER* CPUProfiler::s_pThreadBuffer = nullptr;
+
+// declaration of global variables
+namespace
+{
+	// every thread buffer ever registered - buffers outlive
+	// their threads so the events of finished workers are kept
+	std::mutex g_RegistryMutex;
+	std::vector<CPUProfiler::THREAD_BUFFER*> g_ThreadBuffers;
+
+	// tick and clock readings taken when the first thread was
+	// registered, used to convert ticks to microseconds
+	uint64_t g_OriginTicks = 0;
+	std::chrono::steady_clock::time_point g_OriginTime;
+}
+
+/***********************************************************
+ *  RegisterThread()
+ *
+ *  This method is used for creating the event buffer of the
+ *  calling thread the first time it records a zone.
+ ***********************************************************/
+CPUProfiler::THREAD_BUFFER* CPUProfiler::RegisterThread()
+{
+	THREAD_BUFFER* pBuffer = new THREAD_BUFFER();
+	pBuffer->pEvents = new ZONE_EVENT[EVENTS_PER_THREAD];
+	pBuffer->count.store(0, std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> lock(g_RegistryMutex);
+	if (g_ThreadBuffers.size() == 0)
+	{
+		g_OriginTicks = ReadTicks();
+		g_OriginTime = std::chrono::steady_clock::now();
+	}
+	pBuffer->threadIndex = (int)g_ThreadBuffers.size() + 1;
+	snprintf(pBuffer->name, sizeof(pBuffer->name), "Thread %d", pBuffer->threadIndex);
+	g_ThreadBuffers.push_back(pBuffer);
+
+	s_pThreadBuffer = pBuffer;
+	return(pBuffer);
+}
+
+/***********************************************************
+ *  SetThreadName()
+ *
+ *  This method is used for naming the calling thread in the
+ *  trace.
+ ***********************************************************/
+void CPUProfiler::SetThreadName(const char* name)
+{
+	THREAD_BUFFER* pBuffer = s_pThreadBuffer;
+	if (pBuffer == nullptr)
+	{
+		pBuffer = RegisterThread();
+	}
+
+	std::lock_guard<std::mutex> lock(g_RegistryMutex);
+	strncpy(pBuffer->name, name, sizeof(pBuffer->name) - 1);
+	pBuffer->name[sizeof(pBuffer->name) - 1] = '\0';
+}
+
+/***********************************************************
+ *  WriteChromeTrace()
+ *
+ *  This method is used for writing the recorded zones of
+ *  every thread as complete events of a Chrome trace.
+ ***********************************************************/
+bool CPUProfiler::WriteChromeTrace(const char* filename)
+{
+#ifndef ENABLE_CPU_PROFILER
+	(void)filename;
+	std::cout << "CPU profiler is not compiled in - define ENABLE_CPU_PROFILER" << std::endl;
+	return(false);
+#else
+	std::lock_guard<std::mutex> lock(g_RegistryMutex);
+
+	if (g_ThreadBuffers.size() == 0)
+	{
+		std::cout << "No CPU zones were recorded" << std::endl;
+		return(false);
+	}
+
+	// measure the tick rate over the whole recording
+	uint64_t elapsedTicks = ReadTicks() - g_OriginTicks;
+	double elapsedUs = std::chrono::duration<double, std::micro>(
+		std::chrono::steady_clock::now() - g_OriginTime).count();
+	double usPerTick = (elapsedTicks > 0) ? elapsedUs / (double)elapsedTicks : 0.0;
+
+	std::ofstream file(filename);
+	if (!file.is_open())
+	{
+		std::cout << "Could not write CPU trace:" << filename << std::endl;
+		return(false);
+	}
+
+	file << "{\"traceEvents\": [\n";
+	bool bFirst = true;
+	for (size_t i = 0; i < g_ThreadBuffers.size(); i++)
+	{
+		const THREAD_BUFFER* pBuffer = g_ThreadBuffers[i];
+		char line[256];
+
+		snprintf(line, sizeof(line),
+			"%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+			bFirst ? "" : ",\n", pBuffer->threadIndex, pBuffer->name);
+		file << line;
+		bFirst = false;
+
+		// the ring holds the most recent events only
+		uint64_t count = pBuffer->count.load(std::memory_order_acquire);
+		uint64_t first = (count > EVENTS_PER_THREAD) ? count - EVENTS_PER_THREAD : 0;
+		for (uint64_t index = first; index < count; index++)
+		{
+			const ZONE_EVENT& event = pBuffer->pEvents[index & (EVENTS_PER_THREAD - 1)];
+			snprintf(line, sizeof(line),
+				",\n{\"name\": \"%s\", \"cat\": \"cpu\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+				event.name,
+				pBuffer->threadIndex,
+				(double)(int64_t)(event.start - g_OriginTicks) * usPerTick,
+				(double)(event.end - event.start) * usPerTick);
+			file << line;
+		}
+	}
+	file << "\n]}\n";
+
+	std::cout << "INFO: CPU trace written to " << filename << std::endl;
+
+	return(true);
+#endif
+}
@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+// cpuprofiler.h
+// ============
+// lightweight CPU zone timing with Chrome trace / Perfetto export
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// the zones are only compiled in when ENABLE_CPU_PROFILER is
+// defined - otherwise CPU_PROFILE_ZONE() expands to nothing
+#ifdef ENABLE_CPU_PROFILER
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CPU_PROFILER_HAS_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CPU_PROFILER_HAS_RDTSC
+#else
+#include <chrono>
+#endif
+
+#endif
+
+/***********************************************************
+ *  CPUProfiler
+ *
+ *  This class records timed zones on every thread.  Each
+ *  thread writes into its own fixed size event ring, so a
+ *  zone costs two timestamp reads and one store with no
+ *  locking.  The rings keep the most recent events and are
+ *  written out as a Chrome trace, which Perfetto also reads.
+ *  The trace should be written once the other threads have
+ *  stopped recording, usually at shutdown.
+ ***********************************************************/
+class CPUProfiler
+{
+public:
+	// a completed zone
+	struct ZONE_EVENT
+	{
+		const char* name;
+		uint64_t start;
+		uint64_t end;
+	};
+
+	// events recorded by one thread
+	struct THREAD_BUFFER
+	{
+		ZONE_EVENT* pEvents;
+		std::atomic<uint64_t> count;
+		char name[32];
+		int threadIndex;
+	};
+
+	// read the current timestamp in profiler ticks
+	static uint64_t ReadTicks()
+	{
+#if defined(CPU_PROFILER_HAS_RDTSC)
+		return(__rdtsc());
+#elif defined(ENABLE_CPU_PROFILER)
+		return((uint64_t)std::chrono::steady_clock::now().time_since_epoch().count());
+#else
+		return(0);
+#endif
+	}
+
+	// record a completed zone on the calling thread
+	static void RecordZone(const char* name, uint64_t start, uint64_t end)
+	{
+		THREAD_BUFFER* pBuffer = s_pThreadBuffer;
+		if (pBuffer == nullptr)
+		{
+			pBuffer = RegisterThread();
+		}
+
+		// only this thread ever writes the buffer - the release
+		// store publishes the event to the trace writer
+		uint64_t index = pBuffer->count.load(std::memory_order_relaxed);
+		ZONE_EVENT& event = pBuffer->pEvents[index & (EVENTS_PER_THREAD - 1)];
+		event.name = name;
+		event.start = start;
+		event.end = end;
+		pBuffer->count.store(index + 1, std::memory_order_release);
+	}
+
+	// name the calling thread in the trace
+	static void SetThreadName(const char* name);
+	// write the recorded zones of every thread to a trace file
+	static bool WriteChromeTrace(const char* filename);
+
+private:
+	// events kept per thread - must be a power of two
+	static const uint64_t EVENTS_PER_THREAD = 1 << 18;
+
+	// buffer of the calling thread, created on first use
+	static thread_local THREAD_BUFFER* s_pThreadBuffer;
+
+	// create and register the buffer of the calling thread
+	static THREAD_BUFFER* RegisterThread();
+};
+
+/***********************************************************
+ *  CPUProfileZone
+ *
+ *  This class times the block it is declared in.
+ ***********************************************************/
+class CPUProfileZone
+{
+public:
+	CPUProfileZone(const char* name)
+	{
+		m_name = name;
+		m_start = CPUProfiler::ReadTicks();
+	}
+	~CPUProfileZone()
+	{
+		CPUProfiler::RecordZone(m_name, m_start, CPUProfiler::ReadTicks());
+	}
+
+private:
+	const char* m_name;
+	uint64_t m_start;
+};
+
+#define CPU_PROFILE_CONCAT_INNER(a, b) a##b
+#define CPU_PROFILE_CONCAT(a, b) CPU_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_CPU_PROFILER
+// time the rest of the enclosing block on the CPU
+#define CPU_PROFILE_ZONE(name) CPUProfileZone CPU_PROFILE_CONCAT(cpuProfileZone, __LINE__)(name)
+// name the calling thread in the trace
+#define CPU_PROFILE_THREAD(name) CPUProfiler::SetThreadName(name)
+#else
+#define CPU_PROFILE_ZONE(name)
+#define CPU_PROFILE_THREAD(name)
+#endif
@@ -0,0 +1,215 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerapath.cpp
+// ============
+// recorded or scripted camera paths for deterministic playback
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "CameraPath.h"
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+/***********************************************************
+ *  CameraPath()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+CameraPath::CameraPath()
+{
+}
+
+/***********************************************************
+ *  Load()
+ *
+ *  This method is used for reading the keyframes from a
+ *  camera path file.
+ ***********************************************************/
+bool CameraPath::Load(const char* filename)
+{
+	std::ifstream file(filename);
+	if (!file.is_open())
+	{
+		std::cout << "Could not open camera path:" << filename << std::endl;
+		return(false);
+	}
+
+	m_keyframes.clear();
+
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+
+		// skip blank lines and comments
+		size_t start = line.find_first_not_of(" \t\r");
+		if ((start == std::string::npos) || (line[start] == '#'))
+		{
+			continue;
+		}
+
+		CAMERA_KEYFRAME keyframe;
+		int ortho = 0;
+		std::istringstream values(line);
+		values >> keyframe.time
+			>> keyframe.position.x >> keyframe.position.y >> keyframe.position.z
+			>> keyframe.front.x >> keyframe.front.y >> keyframe.front.z
+			>> keyframe.zoom >> ortho;
+		if (values.fail())
+		{
+			std::cout << "Invalid camera keyframe at " << filename << ":" << lineNumber << std::endl;
+			return(false);
+		}
+		keyframe.bOrthographic = (ortho != 0);
+
+		AddKeyframe(keyframe);
+	}
+
+	std::cout << "Loaded camera path:" << filename << ", keyframes:" << m_keyframes.size()
+		<< ", duration:" << GetDuration() << "s" << std::endl;
+
+	return(m_keyframes.size() > 0);
+}
+
+/***********************************************************
+ *  Save()
+ *
+ *  This method is used for writing the keyframes to a camera
+ *  path file.
+ ***********************************************************/
+bool CameraPath::Save(const char* filename) const
+{
+	std::ofstream file(filename);
+	if (!file.is_open())
+	{
+		std::cout << "Could not write camera path:" << filename << std::endl;
+		return(false);
+	}
+
+	file << "# time posX posY posZ frontX frontY frontZ zoom ortho\n";
+	for (size_t i = 0; i < m_keyframes.size(); i++)
+	{
+		const CAMERA_KEYFRAME& keyframe = m_keyframes[i];
+		file << keyframe.time << " "
+			<< keyframe.position.x << " " << keyframe.position.y << " " << keyframe.position.z << " "
+			<< keyframe.front.x << " " << keyframe.front.y << " " << keyframe.front.z << " "
+			<< keyframe.zoom << " " << (keyframe.bOrthographic ? 1 : 0) << "\n";
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreateOrbit()
+ *
+ *  This method is used for building the default scripted
+ *  path - one full orbit around the center of the scene.
+ ***********************************************************/
+void CameraPath::CreateOrbit(float duration, float radius, float height)
+{
+	const int KEYFRAME_COUNT = 64;
+	const glm::vec3 target = glm::vec3(0.0f, 2.0f, 0.0f);
+
+	m_keyframes.clear();
+	for (int i = 0; i <= KEYFRAME_COUNT; i++)
+	{
+		float fraction = (float)i / (float)KEYFRAME_COUNT;
+		float angle = fraction * 2.0f * 3.14159265f;
+
+		CAMERA_KEYFRAME keyframe;
+		keyframe.time = fraction * duration;
+		keyframe.position = glm::vec3(radius * std::sin(angle), height, radius * std::cos(angle));
+		keyframe.front = glm::normalize(target - keyframe.position);
+		keyframe.zoom = 80.0f;
+		keyframe.bOrthographic = false;
+
+		m_keyframes.push_back(keyframe);
+	}
+}
+
+/***********************************************************
+ *  AddKeyframe()
+ *
+ *  This method is used for appending a keyframe to the path.
+ ***********************************************************/
+void CameraPath::AddKeyframe(const CAMERA_KEYFRAME& keyframe)
+{
+	if ((m_keyframes.size() > 0) && (keyframe.time < m_keyframes.back().time))
+	{
+		std::cout << "Camera keyframes must be in time order" << std::endl;
+		return;
+	}
+	m_keyframes.push_back(keyframe);
+}
+
+/***********************************************************
+ *  Sample()
+ *
+ *  This method is used for interpolating the camera state at
+ *  the passed in time.  Times outside of the path are clamped
+ *  to the first and last keyframes.
+ ***********************************************************/
+CameraPath::CAMERA_KEYFRAME CameraPath::Sample(float time) const
+{
+	CAMERA_KEYFRAME result;
+	result.time = time;
+	result.position = glm::vec3(0.0f, 5.0f, 12.0f);
+	result.front = glm::vec3(0.0f, -0.5f, -2.0f);
+	result.zoom = 80.0f;
+	result.bOrthographic = false;
+
+	if (m_keyframes.size() == 0)
+	{
+		return(result);
+	}
+	if (time <= m_keyframes.front().time)
+	{
+		return(m_keyframes.front());
+	}
+	if (time >= m_keyframes.back().time)
+	{
+		return(m_keyframes.back());
+	}
+
+	// binary search for the segment that contains the time
+	size_t low = 0;
+	size_t high = m_keyframes.size() - 1;
+	while (high - low > 1)
+	{
+		size_t middle = (low + high) / 2;
+		if (m_keyframes[middle].time <= time)
+			low = middle;
+		else
+			high = middle;
+	}
+
+	const CAMERA_KEYFRAME& from = m_keyframes[low];
+	const CAMERA_KEYFRAME& to = m_keyframes[high];
+	float span = to.time - from.time;
+	float t = (span > 0.0f) ? (time - from.time) / span : 0.0f;
+
+	result.position = glm::mix(from.position, to.position, t);
+	result.front = glm::normalize(glm::mix(from.front, to.front, t));
+	result.zoom = from.zoom + (to.zoom - from.zoom) * t;
+	// projection changes are discrete - hold the earlier one
+	result.bOrthographic = from.bOrthographic;
+
+	return(result);
+}
+
+/***********************************************************
+ *  GetDuration()
+ *
+ *  This method is used for getting the length of the path.
+ ***********************************************************/
+float CameraPath::GetDuration() const
+{
+	if (m_keyframes.size() == 0)
+	{
+		return(0.0f);
+	}
+	return(m_keyframes.back().time);
+}
@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerapath.h
+// ============
+// recorded or scripted camera paths for deterministic playback
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  CameraPath
+ *
+ *  This class holds a list of timed camera keyframes.  A path
+ *  can be recorded from live input, saved to a text file,
+ *  loaded back and sampled at any time for playback.
+ *
+ *  File format - one keyframe per line, '#' starts a comment:
+ *  time posX posY posZ frontX frontY frontZ zoom ortho
+ ***********************************************************/
+class CameraPath
+{
+public:
+	struct CAMERA_KEYFRAME
+	{
+		float time;
+		glm::vec3 position;
+		glm::vec3 front;
+		float zoom;
+		bool bOrthographic;
+	};
+
+	// constructor
+	CameraPath();
+
+	// load keyframes from a path file
+	bool Load(const char* filename);
+	// save keyframes to a path file
+	bool Save(const char* filename) const;
+	// build the default scripted orbit around the scene
+	void CreateOrbit(float duration, float radius, float height);
+
+	// append a keyframe - times must be increasing
+	void AddKeyframe(const CAMERA_KEYFRAME& keyframe);
+	// interpolate the camera state at the passed in time
+	CAMERA_KEYFRAME Sample(float time) const;
+
+	// total length of the path in seconds
+	float GetDuration() const;
+	// number of keyframes in the path
+	int GetKeyframeCount() const { return((int)m_keyframes.size()); }
+
+private:
+	std::vector<CAMERA_KEYFRAME> m_keyframes;
+};
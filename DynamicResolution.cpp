@@ -0,0 +1,323 @@
+///////////////////////////////////////////////////////////////////////////////
+// dynamicresolution.cpp
+// ============
+// scene resolution that follows the GPU frame time, with a sharpening upscale
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "DynamicResolution.h"
+#include "GPUProfiler.h"
+#include "ShaderCompiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// weight of a new GPU time in the smoothed time
+	const double SMOOTHING = 0.3;
+	// the resolution rises while the smoothed time is below
+	// this part of the budget
+	const double HEADROOM = 0.85;
+	// a single frame this far over budget lowers the resolution
+	// without waiting for the smoothed time
+	const double SPIKE = 1.25;
+	// largest rise of the scale per decision - falls are not
+	// limited, since a late frame is worse than a soft one
+	const float MAX_RAISE = 0.05f;
+	// scales are kept to steps of this size
+	const float SCALE_STEP = 1.0f / 64.0f;
+
+	// full screen triangle, with texture coordinates that are
+	// 0 to 1 over the window
+	const char* UPSCALE_VERTEX_SOURCE =
+		"#version 330 core\n"
+		"out vec2 texCoord;\n"
+		"void main()\n"
+		"{\n"
+		"	vec2 corner = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));\n"
+		"	texCoord = corner;\n"
+		"	gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);\n"
+		"}\n";
+
+	// bilinear upscale followed by a contrast adaptive sharpen
+	// over the cross of source texels around the sample - the
+	// negative lobe shrinks where the neighborhood already has
+	// strong contrast, so edges do not ring
+	const char* UPSCALE_FRAGMENT_SOURCE =
+		"#version 330 core\n"
+		"in vec2 texCoord;\n"
+		"out vec4 fragmentColor;\n"
+		"uniform sampler2D sceneColor;\n"
+		"uniform vec2 uvScale;\n"
+		"uniform vec2 texelSize;\n"
+		"uniform float sharpness;\n"
+		"vec3 Fetch(vec2 uv)\n"
+		"{\n"
+		"	vec2 lowest = 0.5 * texelSize;\n"
+		"	vec2 highest = uvScale - 0.5 * texelSize;\n"
+		"	return(texture(sceneColor, clamp(uv, lowest, highest)).rgb);\n"
+		"}\n"
+		"void main()\n"
+		"{\n"
+		"	vec2 uv = texCoord * uvScale;\n"
+		"	vec3 center = Fetch(uv);\n"
+		"	vec3 north = Fetch(uv + vec2(0.0, texelSize.y));\n"
+		"	vec3 south = Fetch(uv - vec2(0.0, texelSize.y));\n"
+		"	vec3 east = Fetch(uv + vec2(texelSize.x, 0.0));\n"
+		"	vec3 west = Fetch(uv - vec2(texelSize.x, 0.0));\n"
+		"	vec3 lowest = min(center, min(min(north, south), min(east, west)));\n"
+		"	vec3 highest = max(center, max(max(north, south), max(east, west)));\n"
+		"	vec3 amount = sqrt(clamp(min(lowest, 1.0 - highest) / max(highest, vec3(0.0001)), 0.0, 1.0));\n"
+		"	vec3 weight = -amount * mix(0.125, 0.2, sharpness);\n"
+		"	vec3 color = (center + (north + south + east + west) * weight) / (1.0 + 4.0 * weight);\n"
+		"	fragmentColor = vec4(clamp(color, 0.0, 1.0), 1.0);\n"
+		"}\n";
+}
+
+/***********************************************************
+ *  DynamicResolution()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+DynamicResolution::DynamicResolution()
+{
+	m_settings.budgetMs = 16.0f;
+	m_settings.minScale = 0.5f;
+	m_settings.maxScale = 1.0f;
+	m_settings.sharpness = 0.5f;
+	m_scale = 1.0f;
+	m_smoothedMs = 0.0;
+	m_lastSampleFrame = -1;
+	m_changeFrame = 0;
+	m_bSettled = false;
+	m_program = 0;
+	m_vertexArray = 0;
+	m_sampler = 0;
+	m_uvScaleLocation = -1;
+	m_texelSizeLocation = -1;
+	m_sharpnessLocation = -1;
+	m_frameCount = 0;
+	m_changeCount = 0;
+	m_scaleSum = 0.0;
+	m_minScaleUsed = 1.0f;
+}
+
+/***********************************************************
+ *  ~DynamicResolution()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+DynamicResolution::~DynamicResolution()
+{
+	Shutdown();
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for building the upscale program and
+ *  the sampler it reads the scene with.  The GPU profiler
+ *  must be enabled for the resolution to follow the load.
+ ***********************************************************/
+bool DynamicResolution::Initialize(const RESOLUTION_SETTINGS& settings)
+{
+	Shutdown();
+
+	m_settings = settings;
+	m_settings.maxScale = std::min(std::max(m_settings.maxScale, 0.1f), 1.0f);
+	m_settings.minScale = std::min(std::max(m_settings.minScale, 0.1f), m_settings.maxScale);
+	m_scale = m_settings.maxScale;
+	m_minScaleUsed = m_scale;
+	m_bSettled = false;
+
+	std::string log;
+	m_program = ShaderCompiler::BuildProgram(UPSCALE_VERTEX_SOURCE, UPSCALE_FRAGMENT_SOURCE, log);
+	if (m_program == 0)
+	{
+		std::cout << "Could not build the upscale program:" << log << std::endl;
+		return(false);
+	}
+	m_uvScaleLocation = glGetUniformLocation(m_program, "uvScale");
+	m_texelSizeLocation = glGetUniformLocation(m_program, "texelSize");
+	m_sharpnessLocation = glGetUniformLocation(m_program, "sharpness");
+
+	// the triangle is made from the vertex index alone, but the
+	// core profile still needs a vertex array bound
+	glGenVertexArrays(1, &m_vertexArray);
+
+	glGenSamplers(1, &m_sampler);
+	glSamplerParameteri(m_sampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glSamplerParameteri(m_sampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glSamplerParameteri(m_sampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glSamplerParameteri(m_sampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Shutdown()
+ *
+ *  This method is used for freeing the upscale program and
+ *  its sampler.
+ ***********************************************************/
+void DynamicResolution::Shutdown()
+{
+	if (m_program != 0)
+	{
+		glDeleteProgram(m_program);
+		m_program = 0;
+	}
+	if (m_vertexArray != 0)
+	{
+		glDeleteVertexArrays(1, &m_vertexArray);
+		m_vertexArray = 0;
+	}
+	if (m_sampler != 0)
+	{
+		glDeleteSamplers(1, &m_sampler);
+		m_sampler = 0;
+	}
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for choosing the scale of the next
+ *  frame.  The cost of a frame is taken to grow with its
+ *  pixel count, so the scale moves by the square root of the
+ *  ratio of the budget to the measured time.
+ ***********************************************************/
+void DynamicResolution::Update(const std::string& scopeName)
+{
+	m_frameCount++;
+	m_scaleSum += m_scale;
+	m_minScaleUsed = std::min(m_minScaleUsed, m_scale);
+
+	GPUProfiler& profiler = GPUProfiler::Get();
+	double gpuMs = 0.0;
+	int sampleFrame = 0;
+	if ((profiler.GetLatestScopeTime(scopeName, gpuMs, sampleFrame) == false) ||
+		(sampleFrame <= m_lastSampleFrame))
+	{
+		return;
+	}
+	m_lastSampleFrame = sampleFrame;
+
+	// the frame was drawn before the last change
+	if ((sampleFrame < m_changeFrame) || (gpuMs <= 0.0))
+	{
+		return;
+	}
+
+	m_smoothedMs = (m_smoothedMs > 0.0) ? m_smoothedMs + SMOOTHING * (gpuMs - m_smoothedMs) : gpuMs;
+
+	double budget = m_settings.budgetMs;
+	float scale = m_scale;
+	if ((m_smoothedMs > budget) || (gpuMs > SPIKE * budget))
+	{
+		double measured = std::max(m_smoothedMs, gpuMs);
+		scale = m_scale * (float)std::sqrt(HEADROOM * budget / measured);
+	}
+	else if (m_smoothedMs < HEADROOM * budget)
+	{
+		scale = std::min(m_scale * (float)std::sqrt(HEADROOM * budget / m_smoothedMs), m_scale + MAX_RAISE);
+	}
+
+	scale = std::floor(scale / SCALE_STEP + 0.5f) * SCALE_STEP;
+	scale = std::min(std::max(scale, m_settings.minScale), m_settings.maxScale);
+	m_bSettled = (scale == m_scale);
+	if (scale != m_scale)
+	{
+		m_scale = scale;
+		m_changeFrame = profiler.GetFrameIndex();
+		m_smoothedMs = 0.0;
+		m_changeCount++;
+	}
+}
+
+/***********************************************************
+ *  GetRenderSize()
+ *
+ *  This method is used for getting the size the scene is
+ *  drawn with for a window size.
+ ***********************************************************/
+void DynamicResolution::GetRenderSize(int outputWidth, int outputHeight, int& width, int& height) const
+{
+	width = std::min(std::max((int)(outputWidth * m_scale + 0.5f), 1), outputWidth);
+	height = std::min(std::max((int)(outputHeight * m_scale + 0.5f), 1), outputHeight);
+}
+
+/***********************************************************
+ *  Upscale()
+ *
+ *  This method is used for drawing the scene over the
+ *  framebuffer that is bound.  A scene drawn at full size is
+ *  only copied.  The program, texture and sampler bindings of
+ *  texture unit 0 are put back afterwards, since the scene
+ *  keeps its textures bound between frames.
+ ***********************************************************/
+void DynamicResolution::Upscale(const RenderTarget& source, int sourceWidth, int sourceHeight, int outputWidth, int outputHeight)
+{
+	GLint framebuffer = 0;
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+	if ((m_program == 0) || ((sourceWidth == outputWidth) && (sourceHeight == outputHeight)))
+	{
+		source.BlitColor(sourceWidth, sourceHeight, (GLuint)framebuffer, outputWidth, outputHeight);
+		return;
+	}
+
+	GLint previousProgram = 0;
+	GLint previousUnit = 0;
+	GLint previousTexture = 0;
+	GLint previousSampler = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+	glGetIntegerv(GL_ACTIVE_TEXTURE, &previousUnit);
+	glActiveTexture(GL_TEXTURE0);
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+	glGetIntegerv(GL_SAMPLER_BINDING, &previousSampler);
+	GLboolean bDepthTest = glIsEnabled(GL_DEPTH_TEST);
+
+	glViewport(0, 0, outputWidth, outputHeight);
+	glDisable(GL_DEPTH_TEST);
+	glUseProgram(m_program);
+	glUniform2f(m_uvScaleLocation,
+		(float)sourceWidth / (float)source.GetWidth(),
+		(float)sourceHeight / (float)source.GetHeight());
+	glUniform2f(m_texelSizeLocation, 1.0f / (float)source.GetWidth(), 1.0f / (float)source.GetHeight());
+	glUniform1f(m_sharpnessLocation, m_settings.sharpness);
+	glBindTexture(GL_TEXTURE_2D, source.GetColorTexture());
+	glBindSampler(0, m_sampler);
+	glBindVertexArray(m_vertexArray);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+
+	glBindSampler(0, (GLuint)previousSampler);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)previousTexture);
+	glActiveTexture((GLenum)previousUnit);
+	glUseProgram((GLuint)previousProgram);
+	if (bDepthTest == GL_TRUE)
+	{
+		glEnable(GL_DEPTH_TEST);
+	}
+}
+
+/***********************************************************
+ *  PrintStats()
+ *
+ *  This method is used for printing the average and lowest
+ *  scale the frames were drawn with.
+ ***********************************************************/
+void DynamicResolution::PrintStats() const
+{
+	if (m_frameCount == 0)
+	{
+		return;
+	}
+
+	std::cout << "INFO: Dynamic resolution: budget " << m_settings.budgetMs << " ms, average scale "
+		<< m_scaleSum / m_frameCount << ", lowest " << m_minScaleUsed << ", "
+		<< m_changeCount << " changes over " << m_frameCount << " frames" << std::endl;
+}
@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////
+// dynamicresolution.h
+// ============
+// scene resolution that follows the GPU frame time, with a sharpening upscale
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderTarget.h"
+
+#include <GL/glew.h>
+
+#include <string>
+
+/***********************************************************
+ *  DynamicResolution
+ *
+ *  This class keeps the GPU time of a frame within a budget
+ *  by changing how many pixels the scene is drawn with.  The
+ *  scene is drawn into the lower left corner of a target of
+ *  the window's size, so a new resolution never allocates
+ *  anything, and then scaled up to the window with bilinear
+ *  filtering and a contrast adaptive sharpening that brings
+ *  back most of the detail the filter blurs.
+ *
+ *  The GPU time comes from the profiler, several frames late.
+ *  After every change the controller waits for a time
+ *  measured at the new resolution before deciding again, so
+ *  it cannot swing back and forth on stale readings.  Frames
+ *  over budget are answered at once; the resolution only
+ *  rises again once there is clear headroom.
+ ***********************************************************/
+class DynamicResolution
+{
+public:
+	struct RESOLUTION_SETTINGS
+	{
+		// GPU milliseconds a frame may take
+		float budgetMs;
+		// smallest and largest part of the window's width and
+		// height the scene is drawn with
+		float minScale;
+		float maxScale;
+		// strength of the sharpening, from 0 to 1
+		float sharpness;
+	};
+
+	// constructor
+	DynamicResolution();
+	// destructor
+	~DynamicResolution();
+
+	// build the upscale program - false when it cannot be built
+	bool Initialize(const RESOLUTION_SETTINGS& settings);
+	// free the program and sampler
+	void Shutdown();
+
+	// read the latest GPU time of a profiler scope and choose
+	// the resolution of the next frame - call before it begins
+	void Update(const std::string& scopeName);
+	// size the scene is drawn with for a window size
+	void GetRenderSize(int outputWidth, int outputHeight, int& width, int& height) const;
+	float GetScale() const { return(m_scale); }
+	// true once a GPU time measured at the current scale left
+	// it unchanged, so frames drawn now keep the same scale
+	bool IsSettled() const { return(m_bSettled); }
+
+	// scale the lower left corner of the source up into the
+	// framebuffer that is bound, over the passed in size
+	void Upscale(const RenderTarget& source, int sourceWidth, int sourceHeight, int outputWidth, int outputHeight);
+
+	// print the resolutions the frames were drawn with
+	void PrintStats() const;
+
+private:
+	RESOLUTION_SETTINGS m_settings;
+	float m_scale;
+	// smoothed GPU frame time
+	double m_smoothedMs;
+	// the latest profiler frame read, and the first frame drawn
+	// at the current scale
+	int m_lastSampleFrame;
+	int m_changeFrame;
+	bool m_bSettled;
+
+	GLuint m_program;
+	GLuint m_vertexArray;
+	GLuint m_sampler;
+	GLint m_uvScaleLocation;
+	GLint m_texelSizeLocation;
+	GLint m_sharpnessLocation;
+
+	// statistics
+	int m_frameCount;
+	int m_changeCount;
+	double m_scaleSum;
+	float m_minScaleUsed;
+};
@@ -0,0 +1,359 @@
+///////////////////////////////////////////////////////////////////////////////
+// filewatcher.cpp
+// ============
+// report changes to watched files from a background thread
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FileWatcher.h"
+#include "CPUProfiler.h"
+
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// how long a file must be quiet before it is reported
+	const std::chrono::milliseconds SETTLE_TIME(50);
+	// how often the polling fallback compares modification times
+	const std::chrono::milliseconds POLL_INTERVAL(250);
+	// longest wait for inotify events while a change settles,
+	// and while nothing happens - the latter bounds how long
+	// Stop() can take
+	const int SETTLE_POLL_MS = 10;
+	const int IDLE_POLL_MS = 200;
+}
+
+/***********************************************************
+ *  FileWatcher()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FileWatcher::FileWatcher()
+{
+	m_bRunning = false;
+	m_notifyDescriptor = -1;
+}
+
+/***********************************************************
+ *  ~FileWatcher()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FileWatcher::~FileWatcher()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  NormalizePath()
+ *
+ *  This method is used for bringing a path into the form
+ *  that changes are reported in, so that paths written
+ *  differently can be compared.
+ ***********************************************************/
+std::string FileWatcher::NormalizePath(const std::string& path)
+{
+	return(std::filesystem::path(path).lexically_normal().generic_string());
+}
+
+/***********************************************************
+ *  WatchFile()
+ *
+ *  This method is used for watching a single file.  Its
+ *  directory is what is really watched, so a file replaced
+ *  by renaming a new one over it is still seen.
+ ***********************************************************/
+void FileWatcher::WatchFile(const std::string& filename)
+{
+	std::filesystem::path path(filename);
+
+	WATCH_ENTRY entry;
+	entry.directory = path.parent_path().generic_string();
+	if (entry.directory.size() == 0)
+	{
+		entry.directory = ".";
+	}
+	entry.filename = path.filename().generic_string();
+	entry.descriptor = -1;
+	m_entries.push_back(entry);
+}
+
+/***********************************************************
+ *  WatchDirectory()
+ *
+ *  This method is used for watching every file directly
+ *  inside a directory.
+ ***********************************************************/
+void FileWatcher::WatchDirectory(const std::string& directory)
+{
+	WATCH_ENTRY entry;
+	entry.directory = directory;
+	entry.descriptor = -1;
+	m_entries.push_back(entry);
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for starting the watcher thread.  The
+ *  inotify watches are added here; if any cannot be added
+ *  the watcher polls instead.
+ ***********************************************************/
+bool FileWatcher::Start(const WAKE_FUNCTION& wake)
+{
+	if (m_bRunning == true)
+	{
+		return(true);
+	}
+	m_wake = wake;
+
+#ifdef __linux__
+	m_notifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	for (size_t i = 0; (m_notifyDescriptor >= 0) && (i < m_entries.size()); i++)
+	{
+		m_entries[i].descriptor = inotify_add_watch(m_notifyDescriptor, m_entries[i].directory.c_str(),
+			IN_CLOSE_WRITE | IN_MOVED_TO);
+		if (m_entries[i].descriptor < 0)
+		{
+			std::cout << "Could not watch " << m_entries[i].directory << " for changes, polling instead" << std::endl;
+			close(m_notifyDescriptor);
+			m_notifyDescriptor = -1;
+		}
+	}
+#endif
+
+	m_bRunning = true;
+	if (m_notifyDescriptor >= 0)
+	{
+		m_thread = std::thread(&FileWatcher::NotifyLoop, this);
+	}
+	else
+	{
+		ScanWriteTimes(false);
+		m_thread = std::thread(&FileWatcher::PollLoop, this);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for stopping the watcher thread.
+ ***********************************************************/
+void FileWatcher::Stop()
+{
+	if (m_bRunning == false)
+	{
+		return;
+	}
+
+	m_bRunning = false;
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+
+#ifdef __linux__
+	if (m_notifyDescriptor >= 0)
+	{
+		close(m_notifyDescriptor);
+		m_notifyDescriptor = -1;
+	}
+#endif
+}
+
+/***********************************************************
+ *  TakeChangedFiles()
+ *
+ *  This method is used for taking the settled changes.
+ ***********************************************************/
+void FileWatcher::TakeChangedFiles(std::vector<std::string>& files)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	files.swap(m_changedFiles);
+	m_changedFiles.clear();
+}
+
+/***********************************************************
+ *  NotifyLoop()
+ *
+ *  This method is the watcher thread when inotify is used.
+ *  It waits for close-after-write and rename events in the
+ *  watched directories and notes the ones for watched files.
+ ***********************************************************/
+void FileWatcher::NotifyLoop()
+{
+	CPU_PROFILE_THREAD("FileWatcher");
+
+#ifdef __linux__
+	alignas(struct inotify_event) char buffer[4096];
+
+	while (m_bRunning == true)
+	{
+		struct pollfd descriptor;
+		descriptor.fd = m_notifyDescriptor;
+		descriptor.events = POLLIN;
+		descriptor.revents = 0;
+		int timeout = (m_settlingFiles.size() > 0) ? SETTLE_POLL_MS : IDLE_POLL_MS;
+		if (poll(&descriptor, 1, timeout) > 0)
+		{
+			ssize_t length = 0;
+			while ((length = read(m_notifyDescriptor, buffer, sizeof(buffer))) > 0)
+			{
+				for (char* pEvent = buffer; pEvent < buffer + length;)
+				{
+					const struct inotify_event* pNotify = (const struct inotify_event*)pEvent;
+					if (pNotify->len > 0)
+					{
+						for (size_t i = 0; i < m_entries.size(); i++)
+						{
+							if ((m_entries[i].descriptor == pNotify->wd) &&
+								((m_entries[i].filename.size() == 0) || (m_entries[i].filename == pNotify->name)))
+							{
+								NoteChange(m_entries[i].directory + "/" + pNotify->name);
+								break;
+							}
+						}
+					}
+					pEvent += sizeof(struct inotify_event) + pNotify->len;
+				}
+			}
+		}
+
+		PublishSettledChanges();
+	}
+#endif
+}
+
+/***********************************************************
+ *  PollLoop()
+ *
+ *  This method is the watcher thread when no notifications
+ *  are available.  It compares the modification times of the
+ *  watched files a few times a second.
+ ***********************************************************/
+void FileWatcher::PollLoop()
+{
+	CPU_PROFILE_THREAD("FileWatcher");
+
+	while (m_bRunning == true)
+	{
+		std::this_thread::sleep_for(POLL_INTERVAL);
+		ScanWriteTimes(true);
+		PublishSettledChanges();
+	}
+}
+
+/***********************************************************
+ *  ScanWriteTimes()
+ *
+ *  This method is used for reading the modification time of
+ *  every watched file.  Errors are ignored; a file that is
+ *  missing for a moment is simply seen on a later scan.
+ ***********************************************************/
+void FileWatcher::ScanWriteTimes(bool bReport)
+{
+	for (size_t i = 0; i < m_entries.size(); i++)
+	{
+		std::vector<std::string> paths;
+		if (m_entries[i].filename.size() > 0)
+		{
+			paths.push_back(m_entries[i].directory + "/" + m_entries[i].filename);
+		}
+		else
+		{
+			std::error_code error;
+			std::filesystem::directory_iterator files(m_entries[i].directory, error);
+			for (; (!error) && (files != std::filesystem::directory_iterator()); files.increment(error))
+			{
+				if (files->is_regular_file(error) == true)
+				{
+					paths.push_back(files->path().generic_string());
+				}
+			}
+		}
+
+		for (size_t j = 0; j < paths.size(); j++)
+		{
+			std::error_code error;
+			std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(paths[j], error);
+			if (error)
+			{
+				continue;
+			}
+
+			std::string path = NormalizePath(paths[j]);
+			std::map<std::string, std::filesystem::file_time_type>::iterator known = m_writeTimes.find(path);
+			if (known == m_writeTimes.end())
+			{
+				m_writeTimes[path] = writeTime;
+				if (bReport == true)
+				{
+					NoteChange(path);
+				}
+			}
+			else if (known->second != writeTime)
+			{
+				known->second = writeTime;
+				if (bReport == true)
+				{
+					NoteChange(path);
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  NoteChange()
+ *
+ *  This method is used for noting a change to a watched
+ *  file.  It is reported once it has settled.
+ ***********************************************************/
+void FileWatcher::NoteChange(const std::string& path)
+{
+	m_settlingFiles.insert(NormalizePath(path));
+	m_lastChangeTime = std::chrono::steady_clock::now();
+}
+
+/***********************************************************
+ *  PublishSettledChanges()
+ *
+ *  This method is used for handing over the noted changes
+ *  once no file has changed for the settle time, and waking
+ *  the owner.
+ ***********************************************************/
+void FileWatcher::PublishSettledChanges()
+{
+	if ((m_settlingFiles.size() == 0) ||
+		(std::chrono::steady_clock::now() - m_lastChangeTime < SETTLE_TIME))
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (std::set<std::string>::const_iterator file = m_settlingFiles.begin(); file != m_settlingFiles.end(); ++file)
+		{
+			if (std::find(m_changedFiles.begin(), m_changedFiles.end(), *file) == m_changedFiles.end())
+			{
+				m_changedFiles.push_back(*file);
+			}
+		}
+	}
+	m_settlingFiles.clear();
+
+	if (m_wake)
+	{
+		m_wake();
+	}
+}
@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////
+// filewatcher.h
+// ============
+// report changes to watched files from a background thread
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  FileWatcher
+ *
+ *  This class watches single files and whole directories for
+ *  changes.  On Linux it blocks on inotify, so a save is seen
+ *  within milliseconds; elsewhere, or when inotify is not
+ *  available, it compares modification times a few times a
+ *  second.
+ *
+ *  Editors often save in several steps, so a changed file is
+ *  only reported once it has been quiet for a short while.
+ *  Changes are collected on the watcher thread and taken by
+ *  the owner with TakeChangedFiles(); the wake function, if
+ *  any, is called on the watcher thread whenever new changes
+ *  are ready.
+ ***********************************************************/
+class FileWatcher
+{
+public:
+	typedef std::function<void()> WAKE_FUNCTION;
+
+	// constructor
+	FileWatcher();
+	// destructor
+	~FileWatcher();
+
+	// watch one file - call before Start()
+	void WatchFile(const std::string& filename);
+	// watch every file in a directory - call before Start()
+	void WatchDirectory(const std::string& directory);
+
+	// start the watcher thread
+	bool Start(const WAKE_FUNCTION& wake);
+	// stop the watcher thread
+	void Stop();
+
+	// changed files since the last call, each listed once, as
+	// normalized paths
+	void TakeChangedFiles(std::vector<std::string>& files);
+
+	// true when changes are notified rather than polled
+	bool IsUsingNotifications() const { return(m_notifyDescriptor >= 0); }
+
+	// the form of a path that changed files are reported in
+	static std::string NormalizePath(const std::string& path);
+
+private:
+	// a watched directory, and the one file of it that is
+	// watched, or empty for every file
+	struct WATCH_ENTRY
+	{
+		std::string directory;
+		std::string filename;
+		int descriptor;
+	};
+
+	std::vector<WATCH_ENTRY> m_entries;
+	WAKE_FUNCTION m_wake;
+	std::thread m_thread;
+	std::atomic<bool> m_bRunning;
+	int m_notifyDescriptor;
+
+	// files that changed, waiting to settle
+	std::set<std::string> m_settlingFiles;
+	std::chrono::steady_clock::time_point m_lastChangeTime;
+	// settled changes, not yet taken
+	std::mutex m_mutex;
+	std::vector<std::string> m_changedFiles;
+
+	// modification times seen by the polling fallback
+	std::map<std::string, std::filesystem::file_time_type> m_writeTimes;
+
+	// thread function with inotify
+	void NotifyLoop();
+	// thread function comparing modification times
+	void PollLoop();
+	// read the modification times of every watched file, and
+	// note the ones that changed when bReport is set
+	void ScanWriteTimes(bool bReport);
+	// note a change to a watched file
+	void NoteChange(const std::string& path);
+	// hand over the changes that have been quiet long enough
+	void PublishSettledChanges();
+};
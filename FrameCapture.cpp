@@ -0,0 +1,505 @@
+///////////////////////////////////////////////////////////////////////////////
+// framecapture.cpp
+// ============
+// asynchronous framebuffer readback - PBO ring, fences, encoding workers
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameCapture.h"
+#include "CPUProfiler.h"
+
+#ifndef STB_IMAGE_WRITE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+#endif
+
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+// declaration of global variables
+namespace
+{
+	// bytes per captured pixel - frames are always read back as RGBA
+	const int CAPTURE_PIXEL_SIZE = 4;
+}
+
+/***********************************************************
+ *  FrameCapture()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameCapture::FrameCapture()
+{
+	m_settings.format = capture_png;
+	m_settings.ringSize = 3;
+	m_settings.workerThreads = 2;
+	m_settings.maxQueuedFrames = 8;
+	m_width = 0;
+	m_height = 0;
+	m_frameIndex = 0;
+	m_encodedFrames = 0;
+	m_stallCount = 0;
+	m_bInitialized = false;
+	m_nextSlot = 0;
+	m_activeJobs = 0;
+	m_bStopWorkers = false;
+	m_pPipe = NULL;
+	m_pJobSystem = NULL;
+	m_bUseJobSystem = false;
+}
+
+/***********************************************************
+ *  ~FrameCapture()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameCapture::~FrameCapture()
+{
+	Shutdown();
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating the ring of pixel buffer
+ *  objects and starting the encoding worker threads.
+ ***********************************************************/
+bool FrameCapture::Initialize(int width, int height, const CAPTURE_SETTINGS& settings)
+{
+	if ((width <= 0) || (height <= 0))
+	{
+		std::cout << "Frame capture needs a valid framebuffer size" << std::endl;
+		return(false);
+	}
+
+	m_settings = settings;
+	if (m_settings.ringSize < 2)
+	{
+		m_settings.ringSize = 2;
+	}
+	if (m_settings.workerThreads < 1)
+	{
+		m_settings.workerThreads = 1;
+	}
+	if (m_settings.maxQueuedFrames < 1)
+	{
+		m_settings.maxQueuedFrames = 1;
+	}
+	// frames written to an encoder process must stay in order
+	if (m_settings.format == capture_pipe)
+	{
+		m_settings.workerThreads = 1;
+		m_pPipe = popen(m_settings.output.c_str(), "wb");
+		if (m_pPipe == NULL)
+		{
+			std::cout << "Could not start frame encoder:" << m_settings.output << std::endl;
+			return(false);
+		}
+	}
+
+	m_width = width;
+	m_height = height;
+	m_frameIndex = 0;
+	m_encodedFrames = 0;
+	m_stallCount = 0;
+	m_nextSlot = 0;
+
+	// allocate the readback ring - the buffers are only ever
+	// written by the GPU and read by the CPU
+	GLsizeiptr frameBytes = (GLsizeiptr)m_width * m_height * CAPTURE_PIXEL_SIZE;
+	m_slots.resize(m_settings.ringSize);
+	for (int i = 0; i < m_settings.ringSize; i++)
+	{
+		glGenBuffers(1, &m_slots[i].pbo);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, m_slots[i].pbo);
+		glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes, NULL, GL_STREAM_READ);
+		m_slots[i].fence = 0;
+		m_slots[i].frameIndex = -1;
+		m_slots[i].bPending = false;
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	// image files can be encoded in any order on the shared
+	// workers, as long as the main thread is not one of them
+	m_bUseJobSystem = (NULL != m_pJobSystem) &&
+		(m_pJobSystem->GetWorkerCount() > 1) &&
+		(m_settings.format != capture_pipe);
+
+	// start the encoding workers
+	m_bStopWorkers = false;
+	if (m_bUseJobSystem == false)
+	{
+		for (int i = 0; i < m_settings.workerThreads; i++)
+		{
+			m_workers.push_back(std::thread(&FrameCapture::WorkerLoop, this));
+		}
+	}
+
+	int encoderCount = (m_bUseJobSystem == true) ?
+		m_pJobSystem->GetWorkerCount() - 1 : m_settings.workerThreads;
+	std::cout << "INFO: Frame capture " << m_width << "x" << m_height
+		<< ", " << m_settings.ringSize << " readback buffers, "
+		<< encoderCount << " encoders"
+		<< ((m_bUseJobSystem == true) ? " (job system)" : "") << std::endl;
+
+	m_bInitialized = true;
+	return(true);
+}
+
+/***********************************************************
+ *  CaptureFrame()
+ *
+ *  This method is used for starting the readback of the
+ *  current read framebuffer.  The copy runs asynchronously
+ *  into the next buffer of the ring; if that buffer still
+ *  holds an older frame, the older frame is retired first.
+ *  Completed buffers are retired opportunistically without
+ *  waiting, oldest first.
+ ***********************************************************/
+void FrameCapture::CaptureFrame()
+{
+	CPU_PROFILE_ZONE("FrameCapture::CaptureFrame");
+
+	if (m_bInitialized == false)
+	{
+		return;
+	}
+
+	// retire the older frames whose copy has already landed,
+	// oldest first so they reach the encoders in order - fences
+	// signal in order, so stop at the first one still pending
+	for (int i = 0; i < m_settings.ringSize; i++)
+	{
+		PBO_SLOT& slot = m_slots[(m_nextSlot + i) % m_settings.ringSize];
+		if ((slot.bPending == true) && (RetireSlot(slot, false) == false))
+		{
+			break;
+		}
+	}
+
+	// the slot about to be reused must be drained - this only
+	// blocks when the GPU is a full ring behind
+	PBO_SLOT& slot = m_slots[m_nextSlot];
+	if (slot.bPending == true)
+	{
+		RetireSlot(slot, true);
+	}
+
+	// issue the asynchronous copy into the pixel buffer
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+	glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.frameIndex = m_frameIndex++;
+	slot.bPending = true;
+
+	m_nextSlot = (m_nextSlot + 1) % m_settings.ringSize;
+}
+
+/***********************************************************
+ *  RetireSlot()
+ *
+ *  This method is used for mapping a pixel buffer whose copy
+ *  has completed and handing its contents to the encoders.
+ *  Returns false when the copy is not done and bWait is false.
+ ***********************************************************/
+bool FrameCapture::RetireSlot(PBO_SLOT& slot, bool bWait)
+{
+	GLuint64 timeout = 0;
+	GLbitfield flags = 0;
+
+	if (bWait == true)
+	{
+		// flush so the fence is guaranteed to signal eventually
+		flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		timeout = GL_TIMEOUT_IGNORED;
+	}
+
+	GLenum result = glClientWaitSync(slot.fence, flags, timeout);
+	if ((result == GL_TIMEOUT_EXPIRED) || (result == GL_WAIT_FAILED))
+	{
+		if (bWait == false)
+		{
+			return(false);
+		}
+		m_stallCount++;
+		while (glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+		{
+		}
+	}
+	glDeleteSync(slot.fence);
+	slot.fence = 0;
+
+	ENCODE_JOB job;
+	job.frameIndex = slot.frameIndex;
+
+	// reuse a buffer already released by the workers if there is one
+	size_t frameBytes = (size_t)m_width * m_height * CAPTURE_PIXEL_SIZE;
+	{
+		std::lock_guard<std::mutex> lock(m_jobMutex);
+		if (m_freeBuffers.empty() == false)
+		{
+			job.pixels.swap(m_freeBuffers.back());
+			m_freeBuffers.pop_back();
+		}
+	}
+	job.pixels.resize(frameBytes);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+	void* pData = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameBytes, GL_MAP_READ_BIT);
+	if (NULL != pData)
+	{
+		memcpy(job.pixels.data(), pData, frameBytes);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	slot.bPending = false;
+
+	if (NULL != pData)
+	{
+		QueueJob(job);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  QueueJob()
+ *
+ *  This method is used for handing a frame to the encoding
+ *  workers.  When the workers are too far behind, the render
+ *  thread waits here so memory use stays bounded.
+ ***********************************************************/
+void FrameCapture::QueueJob(ENCODE_JOB& job)
+{
+	std::unique_lock<std::mutex> lock(m_jobMutex);
+
+	if (m_bUseJobSystem == true)
+	{
+		// frames handed to the job system count as active until
+		// their encode job has finished
+		if (m_activeJobs >= m_settings.maxQueuedFrames)
+		{
+			m_stallCount++;
+			m_jobDone.wait(lock, [this]() {
+				return(m_activeJobs < m_settings.maxQueuedFrames);
+			});
+		}
+		m_activeJobs++;
+		m_encodedFrames++;
+		lock.unlock();
+
+		ENCODE_JOB* pJob = new ENCODE_JOB();
+		pJob->pixels.swap(job.pixels);
+		pJob->frameIndex = job.frameIndex;
+		m_pJobSystem->Run([this, pJob](int) {
+			FinishJob(*pJob);
+			delete pJob;
+		}, NULL, JobSystem::affinity_worker_thread);
+		return;
+	}
+
+	if ((int)m_jobs.size() >= m_settings.maxQueuedFrames)
+	{
+		m_stallCount++;
+		m_jobDone.wait(lock, [this]() {
+			return((int)m_jobs.size() < m_settings.maxQueuedFrames);
+		});
+	}
+
+	m_jobs.push_back(ENCODE_JOB());
+	m_jobs.back().pixels.swap(job.pixels);
+	m_jobs.back().frameIndex = job.frameIndex;
+	m_encodedFrames++;
+
+	lock.unlock();
+	m_jobReady.notify_one();
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method is the entry point of each encoding worker.
+ ***********************************************************/
+void FrameCapture::WorkerLoop()
+{
+	CPU_PROFILE_THREAD("Capture Encoder");
+
+	std::unique_lock<std::mutex> lock(m_jobMutex);
+
+	while (true)
+	{
+		m_jobReady.wait(lock, [this]() {
+			return((m_bStopWorkers == true) || (m_jobs.empty() == false));
+		});
+
+		if (m_jobs.empty() == true)
+		{
+			// only reached when stopping with nothing left to do
+			break;
+		}
+
+		ENCODE_JOB job;
+		job.pixels.swap(m_jobs.front().pixels);
+		job.frameIndex = m_jobs.front().frameIndex;
+		m_jobs.pop_front();
+		m_activeJobs++;
+
+		lock.unlock();
+		FinishJob(job);
+		lock.lock();
+	}
+}
+
+/***********************************************************
+ *  FinishJob()
+ *
+ *  This method is used for encoding a frame taken off the
+ *  queue and returning its buffer for reuse.
+ ***********************************************************/
+void FrameCapture::FinishJob(ENCODE_JOB& job)
+{
+	EncodeFrame(job);
+
+	std::lock_guard<std::mutex> lock(m_jobMutex);
+	m_activeJobs--;
+	m_freeBuffers.push_back(std::vector<unsigned char>());
+	m_freeBuffers.back().swap(job.pixels);
+	m_jobDone.notify_all();
+}
+
+/***********************************************************
+ *  EncodeFrame()
+ *
+ *  This method is used for writing one frame to the output.
+ *  OpenGL rows are stored bottom-up, so they are flipped.
+ ***********************************************************/
+void FrameCapture::EncodeFrame(ENCODE_JOB& job)
+{
+	CPU_PROFILE_ZONE("FrameCapture::EncodeFrame");
+
+	int rowBytes = m_width * CAPTURE_PIXEL_SIZE;
+	const unsigned char* pLastRow = job.pixels.data() + (size_t)(m_height - 1) * rowBytes;
+
+	if (m_settings.format == capture_png)
+	{
+		char filename[512];
+		snprintf(filename, sizeof(filename), "%s/frame_%06d.png", m_settings.output.c_str(), job.frameIndex);
+
+		// a negative stride writes the rows in reverse order
+		if (stbi_write_png(filename, m_width, m_height, CAPTURE_PIXEL_SIZE, pLastRow, -rowBytes) == 0)
+		{
+			std::cout << "Could not write frame:" << filename << std::endl;
+		}
+	}
+	else if (m_settings.format == capture_raw)
+	{
+		char filename[512];
+		snprintf(filename, sizeof(filename), "%s/frame_%06d.raw", m_settings.output.c_str(), job.frameIndex);
+
+		FILE* pFile = fopen(filename, "wb");
+		if (pFile == NULL)
+		{
+			std::cout << "Could not write frame:" << filename << std::endl;
+			return;
+		}
+		for (int row = 0; row < m_height; row++)
+		{
+			fwrite(pLastRow - (size_t)row * rowBytes, 1, rowBytes, pFile);
+		}
+		fclose(pFile);
+	}
+	else if (NULL != m_pPipe)
+	{
+		for (int row = 0; row < m_height; row++)
+		{
+			fwrite(pLastRow - (size_t)row * rowBytes, 1, rowBytes, m_pPipe);
+		}
+	}
+}
+
+/***********************************************************
+ *  Flush()
+ *
+ *  This method is used for retiring every pending readback
+ *  and waiting until the workers have encoded all of them.
+ ***********************************************************/
+void FrameCapture::Flush()
+{
+	if (m_bInitialized == false)
+	{
+		return;
+	}
+
+	// retire the pending slots oldest first so frames stay in order
+	for (int i = 0; i < m_settings.ringSize; i++)
+	{
+		PBO_SLOT& slot = m_slots[(m_nextSlot + i) % m_settings.ringSize];
+		if (slot.bPending == true)
+		{
+			RetireSlot(slot, true);
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(m_jobMutex);
+	m_jobDone.wait(lock, [this]() {
+		return((m_jobs.empty() == true) && (m_activeJobs == 0));
+	});
+}
+
+/***********************************************************
+ *  Shutdown()
+ *
+ *  This method is used for finishing all outstanding frames,
+ *  stopping the workers and freeing the readback ring.
+ ***********************************************************/
+void FrameCapture::Shutdown()
+{
+	if (m_bInitialized == false)
+	{
+		return;
+	}
+
+	Flush();
+
+	{
+		std::lock_guard<std::mutex> lock(m_jobMutex);
+		m_bStopWorkers = true;
+	}
+	m_jobReady.notify_all();
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+	m_freeBuffers.clear();
+
+	for (size_t i = 0; i < m_slots.size(); i++)
+	{
+		if (m_slots[i].fence != 0)
+		{
+			glDeleteSync(m_slots[i].fence);
+		}
+		glDeleteBuffers(1, &m_slots[i].pbo);
+	}
+	m_slots.clear();
+
+	if (NULL != m_pPipe)
+	{
+		pclose(m_pPipe);
+		m_pPipe = NULL;
+	}
+
+	std::cout << "INFO: Frame capture finished, " << m_encodedFrames
+		<< " frames, " << m_stallCount << " stalls" << std::endl;
+
+	m_bInitialized = false;
+}
@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////
+// framecapture.h
+// ============
+// asynchronous framebuffer readback - PBO ring, fences, encoding workers
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include "JobSystem.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  FrameCapture
+ *
+ *  This class reads back rendered frames without stalling
+ *  the pipeline.  Each captured frame is copied into the next
+ *  pixel buffer object of a ring and fenced; the buffer is
+ *  only mapped once its fence has signaled, several frames
+ *  later.  The mapped pixels are then handed to a pool of
+ *  worker threads that encode them while rendering continues.
+ *  When a job system is set, image files are encoded on its
+ *  workers instead of on threads of their own.
+ ***********************************************************/
+class FrameCapture
+{
+public:
+	// constructor
+	FrameCapture();
+	// destructor
+	~FrameCapture();
+
+	enum CAPTURE_FORMAT
+	{
+		capture_png,
+		capture_raw,
+		capture_pipe
+	};
+
+	struct CAPTURE_SETTINGS
+	{
+		CAPTURE_FORMAT format;
+		// output directory for png/raw, or the encoder command
+		// line for pipe (raw RGBA frames are written to its stdin)
+		std::string output;
+		// number of pixel buffers in the readback ring
+		int ringSize;
+		// number of encoding worker threads
+		int workerThreads;
+		// maximum encoded frames waiting before the render
+		// thread is made to wait for the workers
+		int maxQueuedFrames;
+	};
+
+	// encode image files on this job system - must be set
+	// before Initialize(), null uses the capture's own threads
+	void SetJobSystem(JobSystem* pJobSystem) { m_pJobSystem = pJobSystem; }
+	// create the readback ring and start the encoding workers
+	bool Initialize(int width, int height, const CAPTURE_SETTINGS& settings);
+	// start the readback of the current read framebuffer
+	void CaptureFrame();
+	// wait for every outstanding readback and encode to finish
+	void Flush();
+	// stop the workers and free the readback ring
+	void Shutdown();
+
+	// number of frames handed to the encoders so far
+	int GetEncodedFrameCount() const { return(m_encodedFrames); }
+	// number of times the render thread had to wait
+	int GetStallCount() const { return(m_stallCount); }
+
+private:
+	struct PBO_SLOT
+	{
+		GLuint pbo;
+		GLsync fence;
+		int frameIndex;
+		bool bPending;
+	};
+
+	struct ENCODE_JOB
+	{
+		std::vector<unsigned char> pixels;
+		int frameIndex;
+	};
+
+	CAPTURE_SETTINGS m_settings;
+	int m_width;
+	int m_height;
+	int m_frameIndex;
+	int m_encodedFrames;
+	int m_stallCount;
+	bool m_bInitialized;
+
+	// readback ring
+	std::vector<PBO_SLOT> m_slots;
+	int m_nextSlot;
+
+	// encoding worker pool
+	std::vector<std::thread> m_workers;
+	std::deque<ENCODE_JOB> m_jobs;
+	std::vector<std::vector<unsigned char>> m_freeBuffers;
+	std::mutex m_jobMutex;
+	std::condition_variable m_jobReady;
+	std::condition_variable m_jobDone;
+	int m_activeJobs;
+	bool m_bStopWorkers;
+
+	// external encoder process for pipe output
+	FILE* m_pPipe;
+	// shared workers that encode image files, if any
+	JobSystem* m_pJobSystem;
+	bool m_bUseJobSystem;
+
+	// map a completed slot and queue its pixels for encoding
+	bool RetireSlot(PBO_SLOT& slot, bool bWait);
+	// queue a frame for the encoding workers
+	void QueueJob(ENCODE_JOB& job);
+	// worker thread entry point
+	void WorkerLoop();
+	// encode a queued frame and release its buffer
+	void FinishJob(ENCODE_JOB& job);
+	// encode a single frame into the configured output
+	void EncodeFrame(ENCODE_JOB& job);
+};
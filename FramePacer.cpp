@@ -0,0 +1,390 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepacer.cpp
+// ============
+// presentation modes, frame rate cap, frames in flight and latency tracking
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FramePacer.h"
+#include "CPUProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+// declaration of global variables
+namespace
+{
+	// samples kept for the statistics
+	const size_t MAX_SAMPLES = 4096;
+
+	// starting and largest spin time after a sleep, in seconds
+	const double INITIAL_SPIN_MARGIN = 0.002;
+	const double MAX_SPIN_MARGIN = 0.004;
+
+	/***********************************************************
+	 *  PrintSeries()
+	 *
+	 *  Prints avg/p50/p99/max of a series of milliseconds.
+	 ***********************************************************/
+	void PrintSeries(const char* name, std::vector<double> values)
+	{
+		if (values.size() == 0)
+		{
+			std::cout << "  " << name << ": no samples" << std::endl;
+			return;
+		}
+
+		std::sort(values.begin(), values.end());
+		double total = 0.0;
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			total += values[i];
+		}
+
+		std::cout << "  " << name
+			<< ": avg " << total / (double)values.size()
+			<< " ms, p50 " << values[values.size() / 2]
+			<< " ms, p99 " << values[(values.size() * 99) / 100]
+			<< " ms, max " << values.back()
+			<< " ms (" << values.size() << " samples)" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  FramePacer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FramePacer::FramePacer()
+{
+	m_pWindow = NULL;
+	m_settings.mode = present_vsync;
+	m_settings.frameRateCap = 0.0f;
+	m_settings.maxFramesInFlight = 2;
+	m_bInitialized = false;
+	m_nextSlot = 0;
+	m_nextFrameTime = 0.0;
+	m_spinMargin = INITIAL_SPIN_MARGIN;
+	m_lastFrameStart = 0.0;
+}
+
+/***********************************************************
+ *  ~FramePacer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FramePacer::~FramePacer()
+{
+	Shutdown();
+}
+
+/***********************************************************
+ *  NowSeconds()
+ *
+ *  This method is used for reading the steady clock in
+ *  seconds.
+ ***********************************************************/
+double FramePacer::NowSeconds()
+{
+	return(std::chrono::duration<double>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for setting the swap interval of the
+ *  selected mode and creating the ring of frame fences.
+ ***********************************************************/
+bool FramePacer::Initialize(GLFWwindow* pWindow, const PACER_SETTINGS& settings)
+{
+	m_pWindow = pWindow;
+	m_settings = settings;
+
+	if (m_settings.maxFramesInFlight < 1)
+	{
+		m_settings.maxFramesInFlight = 1;
+	}
+	if ((m_settings.mode == present_capped) && (m_settings.frameRateCap <= 0.0f))
+	{
+		std::cout << "Frame rate cap must be above zero" << std::endl;
+		return(false);
+	}
+
+	const char* modeName = "vsync";
+	int swapInterval = 1;
+	if (m_settings.mode == present_adaptive)
+	{
+		// a negative interval tears late frames instead of
+		// waiting a whole extra refresh for them
+		if ((glfwExtensionSupported("WGL_EXT_swap_control_tear") == GLFW_TRUE) ||
+			(glfwExtensionSupported("GLX_EXT_swap_control_tear") == GLFW_TRUE))
+		{
+			swapInterval = -1;
+			modeName = "adaptive vsync";
+		}
+		else
+		{
+			std::cout << "Adaptive vsync is not supported, using vsync" << std::endl;
+		}
+	}
+	else if (m_settings.mode == present_uncapped)
+	{
+		swapInterval = 0;
+		modeName = "uncapped";
+	}
+	else if (m_settings.mode == present_capped)
+	{
+		swapInterval = 0;
+		modeName = "capped";
+	}
+	glfwSwapInterval(swapInterval);
+
+	m_slots.resize(m_settings.maxFramesInFlight);
+	for (size_t i = 0; i < m_slots.size(); i++)
+	{
+		m_slots[i].fence = 0;
+		m_slots[i].inputTime = 0.0;
+	}
+	m_nextSlot = 0;
+	m_nextFrameTime = NowSeconds();
+	m_lastFrameStart = 0.0;
+	m_frameMs.clear();
+	m_fenceWaitMs.clear();
+	m_latencyMs.clear();
+
+	std::cout << "INFO: Presenting " << modeName;
+	if (m_settings.mode == present_capped)
+	{
+		std::cout << " at " << m_settings.frameRateCap << " fps";
+	}
+	std::cout << ", " << m_settings.maxFramesInFlight << " frames in flight" << std::endl;
+
+	m_bInitialized = true;
+	return(true);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for waiting until the next frame may
+ *  start.  The fence of the frame submitted maxFramesInFlight
+ *  frames ago must have signaled, which bounds the queue of
+ *  frames between the CPU and the GPU, and in capped mode
+ *  the frame must not start before its scheduled time.
+ ***********************************************************/
+void FramePacer::BeginFrame()
+{
+	CPU_PROFILE_ZONE("FramePacer::BeginFrame");
+
+	if (m_bInitialized == false)
+	{
+		return;
+	}
+
+	// note every earlier frame that has reached the display
+	double now = NowSeconds();
+	for (size_t i = 0; i < m_slots.size(); i++)
+	{
+		FRAME_SLOT& slot = m_slots[i];
+		if ((slot.fence != 0) &&
+			(glClientWaitSync(slot.fence, 0, 0) != GL_TIMEOUT_EXPIRED))
+		{
+			RetireSlot(slot, now);
+		}
+	}
+
+	// the slot about to be reused must be finished
+	FRAME_SLOT& slot = m_slots[m_nextSlot];
+	if (slot.fence != 0)
+	{
+		CPU_PROFILE_ZONE("FramePacer::WaitForGPU");
+
+		double waitStart = NowSeconds();
+		while (glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+		{
+		}
+		now = NowSeconds();
+		AddSample(m_fenceWaitMs, (now - waitStart) * 1000.0);
+		RetireSlot(slot, now);
+	}
+
+	if (m_settings.mode == present_capped)
+	{
+		CPU_PROFILE_ZONE("FramePacer::WaitForCap");
+
+		double frameTime = 1.0 / (double)m_settings.frameRateCap;
+		m_nextFrameTime += frameTime;
+
+		// after a long frame start a new schedule rather than
+		// rushing out frames to catch up
+		now = NowSeconds();
+		if (now - m_nextFrameTime > frameTime)
+		{
+			m_nextFrameTime = now;
+		}
+		WaitUntil(m_nextFrameTime);
+	}
+
+	now = NowSeconds();
+	if (m_lastFrameStart > 0.0)
+	{
+		AddSample(m_frameMs, (now - m_lastFrameStart) * 1000.0);
+	}
+	m_lastFrameStart = now;
+}
+
+/***********************************************************
+ *  Present()
+ *
+ *  This method is used for swapping the buffers and fencing
+ *  the frame so its completion can be waited on and timed.
+ ***********************************************************/
+void FramePacer::Present(double inputTime)
+{
+	CPU_PROFILE_ZONE("FramePacer::Present");
+
+	glfwSwapBuffers(m_pWindow);
+
+	if (m_bInitialized == false)
+	{
+		return;
+	}
+
+	FRAME_SLOT& slot = m_slots[m_nextSlot];
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.inputTime = inputTime;
+	m_nextSlot = (m_nextSlot + 1) % (int)m_slots.size();
+}
+
+/***********************************************************
+ *  SkipFrame()
+ *
+ *  This method is used when the loop is about to idle instead
+ *  of drawing a frame.  The frames still in flight are waited
+ *  for and retired now, so the idle time does not end up in
+ *  their latency.
+ ***********************************************************/
+void FramePacer::SkipFrame()
+{
+	if (m_bInitialized == false)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < m_slots.size(); i++)
+	{
+		FRAME_SLOT& slot = m_slots[i];
+		if (slot.fence != 0)
+		{
+			while (glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+			{
+			}
+			RetireSlot(slot, NowSeconds());
+		}
+	}
+
+	m_lastFrameStart = 0.0;
+	m_nextFrameTime = NowSeconds();
+}
+
+/***********************************************************
+ *  WaitUntil()
+ *
+ *  This method is used for waiting until the passed in time.
+ *  Most of the wait is slept away; the last part is spun
+ *  because sleeps can overshoot by a millisecond or more.
+ *  The spin margin follows the overshoot that was seen.
+ ***********************************************************/
+void FramePacer::WaitUntil(double time)
+{
+	double now = NowSeconds();
+	double sleepTime = time - now - m_spinMargin;
+	if (sleepTime > 0.0)
+	{
+		std::this_thread::sleep_for(std::chrono::duration<double>(sleepTime));
+
+		double overshoot = NowSeconds() - (now + sleepTime);
+		m_spinMargin = m_spinMargin * 0.9 + overshoot * 1.5 * 0.1;
+		m_spinMargin = std::min(std::max(m_spinMargin, 0.0002), MAX_SPIN_MARGIN);
+	}
+
+	while (NowSeconds() < time)
+	{
+		std::this_thread::yield();
+	}
+}
+
+/***********************************************************
+ *  RetireSlot()
+ *
+ *  This method is used for freeing the fence of a finished
+ *  frame and recording its input-to-photon latency.
+ ***********************************************************/
+void FramePacer::RetireSlot(FRAME_SLOT& slot, double now)
+{
+	if (slot.inputTime > 0.0)
+	{
+		AddSample(m_latencyMs, (now - slot.inputTime) * 1000.0);
+	}
+
+	glDeleteSync(slot.fence);
+	slot.fence = 0;
+	slot.inputTime = 0.0;
+}
+
+/***********************************************************
+ *  AddSample()
+ *
+ *  This method is used for adding a sample, dropping the
+ *  oldest half of the list when it is full.
+ ***********************************************************/
+void FramePacer::AddSample(std::vector<double>& samples, double value)
+{
+	if (samples.size() >= MAX_SAMPLES)
+	{
+		samples.erase(samples.begin(), samples.begin() + MAX_SAMPLES / 2);
+	}
+	samples.push_back(value);
+}
+
+/***********************************************************
+ *  PrintStats()
+ *
+ *  This method is used for printing the frame time, the time
+ *  spent waiting for the GPU and the input latency.
+ ***********************************************************/
+void FramePacer::PrintStats() const
+{
+	std::cout << "\nFrame pacing:" << std::endl;
+	PrintSeries("frame time", m_frameMs);
+	PrintSeries("GPU wait", m_fenceWaitMs);
+	PrintSeries("input to photon", m_latencyMs);
+}
+
+/***********************************************************
+ *  Shutdown()
+ *
+ *  This method is used for freeing the frame fences.
+ ***********************************************************/
+void FramePacer::Shutdown()
+{
+	if (m_bInitialized == false)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < m_slots.size(); i++)
+	{
+		if (m_slots[i].fence != 0)
+		{
+			glDeleteSync(m_slots[i].fence);
+			m_slots[i].fence = 0;
+		}
+	}
+	m_slots.clear();
+
+	m_bInitialized = false;
+}
@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepacer.h
+// ============
+// presentation modes, frame rate cap, frames in flight and latency tracking
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include "GLFW/glfw3.h"
+
+#include <vector>
+
+/***********************************************************
+ *  FramePacer
+ *
+ *  This class controls when frames are started and how they
+ *  are presented.  The swap interval follows the selected
+ *  mode, a frame rate cap sleeps for most of the remaining
+ *  frame time and spins for the rest, and a fence placed
+ *  after every swap keeps the CPU from running more than a
+ *  set number of frames ahead of the GPU.
+ *
+ *  The same fences give the input-to-photon latency: a frame
+ *  is tagged with the time of the oldest input it shows, and
+ *  once its fence has signaled the frame has been handed to
+ *  the display.  Fences are polled once per frame, so each
+ *  latency sample may read up to one frame late.
+ ***********************************************************/
+class FramePacer
+{
+public:
+	enum PRESENT_MODE
+	{
+		// wait for vertical blank on every swap
+		present_vsync,
+		// wait for vertical blank unless the frame is late, when
+		// the driver supports it - otherwise vsync
+		present_adaptive,
+		// swap immediately
+		present_uncapped,
+		// swap immediately, but never faster than the cap
+		present_capped
+	};
+
+	struct PACER_SETTINGS
+	{
+		PRESENT_MODE mode;
+		// frames per second of present_capped
+		float frameRateCap;
+		// frames the CPU may submit before waiting for the GPU
+		int maxFramesInFlight;
+	};
+
+	// constructor
+	FramePacer();
+	// destructor
+	~FramePacer();
+
+	// apply the presentation mode to the current context
+	bool Initialize(GLFWwindow* pWindow, const PACER_SETTINGS& settings);
+	// wait until the next frame may start
+	void BeginFrame();
+	// present the frame - inputTime is the time of the oldest
+	// input shown by the frame, or zero if there was none
+	void Present(double inputTime);
+	// note that no frame is drawn before idling, so the gap is
+	// not counted as frame time or latency and the cap schedule
+	// starts over
+	void SkipFrame();
+	// free the fences
+	void Shutdown();
+
+	// print frame time, wait time and latency statistics
+	void PrintStats() const;
+
+	// seconds on the steady clock - the clock used for input
+	// timestamps and for pacing
+	static double NowSeconds();
+
+private:
+	// a presented frame whose fence has not signaled yet
+	struct FRAME_SLOT
+	{
+		GLsync fence;
+		double inputTime;
+	};
+
+	GLFWwindow* m_pWindow;
+	PACER_SETTINGS m_settings;
+	bool m_bInitialized;
+	std::vector<FRAME_SLOT> m_slots;
+	int m_nextSlot;
+
+	// capped mode scheduling
+	double m_nextFrameTime;
+	// time left for spinning after a sleep, tuned to how much
+	// the sleeps of this system overshoot
+	double m_spinMargin;
+
+	double m_lastFrameStart;
+	std::vector<double> m_frameMs;
+	std::vector<double> m_fenceWaitMs;
+	std::vector<double> m_latencyMs;
+
+	// sleep then spin until the passed in time
+	void WaitUntil(double time);
+	// record the latency of a slot whose fence has signaled
+	void RetireSlot(FRAME_SLOT& slot, double now);
+	// keep the sample lists bounded
+	static void AddSample(std::vector<double>& samples, double value);
+};
@@ -0,0 +1,420 @@
+///////////////////////////////////////////////////////////////////////////////
+// gpuprofiler.cpp
+// ============
+// GPU timing of render passes and object groups with timestamp queries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GPUProfiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// number of frames whose queries can be in flight - results
+	// are read back this many frames after they were issued
+	const int FRAME_RING_SIZE = 5;
+	// number of durations kept per scope for the statistics
+	const int HISTORY_SIZE = 240;
+	// upper bound on the events kept for the Chrome trace
+	const size_t MAX_TRACE_EVENTS = 200000;
+}
+
+/***********************************************************
+ *  Get()
+ *
+ *  This method is used for getting the profiler shared by
+ *  the whole application.
+ ***********************************************************/
+GPUProfiler& GPUProfiler::Get()
+{
+	static GPUProfiler profiler;
+	return(profiler);
+}
+
+/***********************************************************
+ *  GPUProfiler()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+GPUProfiler::GPUProfiler()
+{
+	m_bEnabled = false;
+	m_bDebugGroups = false;
+	m_bInFrame = false;
+	m_frameIndex = 0;
+	m_droppedFrames = 0;
+}
+
+/***********************************************************
+ *  ~GPUProfiler()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+GPUProfiler::~GPUProfiler()
+{
+	// the OpenGL context is gone by now - the queries must be
+	// freed by calling Shutdown() before the window is closed
+}
+
+/***********************************************************
+ *  SetEnabled()
+ *
+ *  This method is used for turning the profiler on or off.
+ *  It must be called between frames and with an OpenGL
+ *  context current.
+ ***********************************************************/
+void GPUProfiler::SetEnabled(bool bEnabled)
+{
+	m_bEnabled = bEnabled;
+
+	if ((m_bEnabled == true) && (m_frames.size() == 0))
+	{
+		m_frames.resize(FRAME_RING_SIZE);
+		for (int i = 0; i < FRAME_RING_SIZE; i++)
+		{
+			m_frames[i].usedQueries = 0;
+			m_frames[i].bPending = false;
+			m_frames[i].frameIndex = 0;
+		}
+
+		// debug groups are only pushed when the driver has them
+		m_bDebugGroups = (GLEW_KHR_debug == GL_TRUE);
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting the scopes of a new
+ *  frame.  The ring slot being reused is read back first if
+ *  its queries have completed; otherwise its results are
+ *  dropped rather than waited for.
+ ***********************************************************/
+void GPUProfiler::BeginFrame()
+{
+	if (m_bEnabled == false)
+	{
+		return;
+	}
+
+	FRAME_RECORD& frame = m_frames[m_frameIndex % FRAME_RING_SIZE];
+	if (frame.bPending == true)
+	{
+		GLint available = 0;
+		glGetQueryObjectiv(frame.queries[frame.usedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available != 0)
+		{
+			ResolveFrame(frame);
+		}
+		else
+		{
+			m_droppedFrames++;
+		}
+	}
+
+	frame.usedQueries = 0;
+	frame.scopes.clear();
+	frame.bPending = false;
+	frame.frameIndex = m_frameIndex;
+	m_openScopes.clear();
+	m_bInFrame = true;
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for finishing the scopes of the
+ *  current frame.
+ ***********************************************************/
+void GPUProfiler::EndFrame()
+{
+	if ((m_bEnabled == false) || (m_bInFrame == false))
+	{
+		return;
+	}
+
+	// close any scope that was left open
+	while (m_openScopes.size() > 0)
+	{
+		EndScope();
+	}
+
+	FRAME_RECORD& frame = m_frames[m_frameIndex % FRAME_RING_SIZE];
+	frame.bPending = (frame.scopes.size() > 0);
+
+	m_bInFrame = false;
+	m_frameIndex++;
+}
+
+/***********************************************************
+ *  NextQuery()
+ *
+ *  This method is used for getting the next unused query of
+ *  a frame, creating more queries as they are needed.
+ ***********************************************************/
+GLuint GPUProfiler::NextQuery(FRAME_RECORD& frame)
+{
+	if (frame.usedQueries == (int)frame.queries.size())
+	{
+		GLuint query = 0;
+		glGenQueries(1, &query);
+		frame.queries.push_back(query);
+	}
+
+	return(frame.queries[frame.usedQueries++]);
+}
+
+/***********************************************************
+ *  BeginScope()
+ *
+ *  This method is used for opening a named scope.  The name
+ *  must stay valid until the frame is read back, so string
+ *  literals should be used.
+ ***********************************************************/
+void GPUProfiler::BeginScope(const char* name)
+{
+	if ((m_bEnabled == false) || (m_bInFrame == false))
+	{
+		return;
+	}
+
+	FRAME_RECORD& frame = m_frames[m_frameIndex % FRAME_RING_SIZE];
+
+	SCOPE_RECORD scope;
+	scope.name = name;
+	scope.depth = (int)m_openScopes.size();
+	scope.beginQuery = NextQuery(frame);
+	scope.endQuery = 0;
+	glQueryCounter(scope.beginQuery, GL_TIMESTAMP);
+
+	m_openScopes.push_back((int)frame.scopes.size());
+	frame.scopes.push_back(scope);
+
+	if (m_bDebugGroups == true)
+	{
+		glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+	}
+}
+
+/***********************************************************
+ *  EndScope()
+ *
+ *  This method is used for closing the most recently opened
+ *  scope.
+ ***********************************************************/
+void GPUProfiler::EndScope()
+{
+	if ((m_bEnabled == false) || (m_bInFrame == false) || (m_openScopes.size() == 0))
+	{
+		return;
+	}
+
+	FRAME_RECORD& frame = m_frames[m_frameIndex % FRAME_RING_SIZE];
+
+	SCOPE_RECORD& scope = frame.scopes[m_openScopes.back()];
+	m_openScopes.pop_back();
+
+	scope.endQuery = NextQuery(frame);
+	glQueryCounter(scope.endQuery, GL_TIMESTAMP);
+
+	if (m_bDebugGroups == true)
+	{
+		glPopDebugGroup();
+	}
+}
+
+/***********************************************************
+ *  ResolveFrame()
+ *
+ *  This method is used for reading back the timestamps of a
+ *  completed frame into the scope statistics and the trace.
+ ***********************************************************/
+void GPUProfiler::ResolveFrame(FRAME_RECORD& frame)
+{
+	for (size_t i = 0; i < frame.scopes.size(); i++)
+	{
+		const SCOPE_RECORD& scope = frame.scopes[i];
+
+		GLuint64 start = 0;
+		GLuint64 end = 0;
+		glGetQueryObjectui64v(scope.beginQuery, GL_QUERY_RESULT, &start);
+		glGetQueryObjectui64v(scope.endQuery, GL_QUERY_RESULT, &end);
+		GLuint64 duration = (end > start) ? end - start : 0;
+
+		SCOPE_HISTORY& history = m_history[scope.name];
+		double durationMs = duration / 1000000.0;
+		if ((int)history.samples.size() < HISTORY_SIZE)
+		{
+			history.samples.push_back(durationMs);
+			history.next = 0;
+		}
+		else
+		{
+			history.samples[history.next] = durationMs;
+			history.next = (history.next + 1) % HISTORY_SIZE;
+		}
+		history.latestMs = durationMs;
+		history.latestFrame = frame.frameIndex;
+
+		if (m_trace.size() < MAX_TRACE_EVENTS)
+		{
+			TRACE_EVENT event;
+			event.name = scope.name;
+			event.depth = scope.depth;
+			event.start = start;
+			event.duration = duration;
+			m_trace.push_back(event);
+		}
+	}
+
+	frame.bPending = false;
+}
+
+/***********************************************************
+ *  GetScopeStats()
+ *
+ *  This method is used for getting the min/avg/p99 timing of
+ *  a named scope over the rolling window.
+ ***********************************************************/
+bool GPUProfiler::GetScopeStats(const std::string& name, SCOPE_STATS& stats) const
+{
+	std::map<std::string, SCOPE_HISTORY>::const_iterator found = m_history.find(name);
+	if ((found == m_history.end()) || (found->second.samples.size() == 0))
+	{
+		return(false);
+	}
+
+	std::vector<double> sorted = found->second.samples;
+	std::sort(sorted.begin(), sorted.end());
+
+	double total = 0.0;
+	for (size_t i = 0; i < sorted.size(); i++)
+	{
+		total += sorted[i];
+	}
+
+	stats.minMs = sorted.front();
+	stats.avgMs = total / sorted.size();
+	stats.p99Ms = sorted[((sorted.size() - 1) * 99) / 100];
+	stats.sampleCount = (int)sorted.size();
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetLatestScopeTime()
+ *
+ *  This method is used for getting the duration of a named
+ *  scope in the most recent frame that was read back, for
+ *  reacting to the GPU load.  The frame index tells whether
+ *  the result is new; it lags the current frame by the depth
+ *  of the query ring.
+ ***********************************************************/
+bool GPUProfiler::GetLatestScopeTime(const std::string& name, double& durationMs, int& frameIndex) const
+{
+	std::map<std::string, SCOPE_HISTORY>::const_iterator found = m_history.find(name);
+	if ((found == m_history.end()) || (found->second.samples.size() == 0))
+	{
+		return(false);
+	}
+
+	durationMs = found->second.latestMs;
+	frameIndex = found->second.latestFrame;
+	return(true);
+}
+
+/***********************************************************
+ *  PrintStats()
+ *
+ *  This method is used for printing the timing of every
+ *  scope to the console.
+ ***********************************************************/
+void GPUProfiler::PrintStats() const
+{
+	std::cout << "\n*** GPU PROFILE (ms, last " << HISTORY_SIZE << " frames) ***\n";
+
+	char line[256];
+	snprintf(line, sizeof(line), "%-32s %9s %9s %9s\n", "scope", "min", "avg", "p99");
+	std::cout << line;
+
+	std::map<std::string, SCOPE_HISTORY>::const_iterator scope;
+	for (scope = m_history.begin(); scope != m_history.end(); ++scope)
+	{
+		SCOPE_STATS stats;
+		if (GetScopeStats(scope->first, stats) == true)
+		{
+			snprintf(line, sizeof(line), "%-32s %9.3f %9.3f %9.3f\n",
+				scope->first.c_str(), stats.minMs, stats.avgMs, stats.p99Ms);
+			std::cout << line;
+		}
+	}
+
+	if (m_droppedFrames > 0)
+	{
+		std::cout << "(" << m_droppedFrames << " frames dropped - results not ready in time)\n";
+	}
+	std::cout << std::endl;
+}
+
+/***********************************************************
+ *  WriteChromeTrace()
+ *
+ *  This method is used for writing every recorded scope as
+ *  complete events of a Chrome trace, which can be opened in
+ *  chrome://tracing or Perfetto.
+ ***********************************************************/
+bool GPUProfiler::WriteChromeTrace(const char* filename) const
+{
+	std::ofstream file(filename);
+	if (!file.is_open())
+	{
+		std::cout << "Could not write GPU trace:" << filename << std::endl;
+		return(false);
+	}
+
+	GLuint64 origin = (m_trace.size() > 0) ? m_trace.front().start : 0;
+
+	file << "{\"traceEvents\": [\n";
+	file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"GPU\"}}";
+	for (size_t i = 0; i < m_trace.size(); i++)
+	{
+		const TRACE_EVENT& event = m_trace[i];
+		char line[256];
+		snprintf(line, sizeof(line),
+			",\n{\"name\": \"%s\", \"cat\": \"gpu\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": %.3f, \"dur\": %.3f}",
+			event.name,
+			(event.start - origin) / 1000.0,
+			event.duration / 1000.0);
+		file << line;
+	}
+	file << "\n]}\n";
+
+	std::cout << "INFO: GPU trace written to " << filename << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Shutdown()
+ *
+ *  This method is used for freeing the timer queries.  It
+ *  must be called while the OpenGL context is still current.
+ ***********************************************************/
+void GPUProfiler::Shutdown()
+{
+	for (size_t i = 0; i < m_frames.size(); i++)
+	{
+		if (m_frames[i].queries.size() > 0)
+		{
+			glDeleteQueries((GLsizei)m_frames[i].queries.size(), m_frames[i].queries.data());
+		}
+	}
+	m_frames.clear();
+	m_bEnabled = false;
+	m_bInFrame = false;
+}
@@ -0,0 +1,148 @@
+///////////////////////////////////////////////////////////////////////////////
+// gpuprofiler.h
+// ============
+// GPU timing of render passes and object groups with timestamp queries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  GPUProfiler
+ *
+ *  This class measures how long the GPU spends in named
+ *  scopes.  Each scope writes a GL_TIMESTAMP query at its
+ *  start and end.  The queries of a frame are read back only
+ *  after several more frames have been submitted, so the CPU
+ *  never waits for the GPU.  Scopes are also pushed as
+ *  KHR_debug groups so they show up in graphics debuggers.
+ *
+ *  Results are kept per scope as a rolling window, printed
+ *  as min/avg/p99, and can be saved as a Chrome trace.
+ ***********************************************************/
+class GPUProfiler
+{
+public:
+	// get the profiler shared by the whole application
+	static GPUProfiler& Get();
+
+	// turn the profiler on or off - scopes cost nothing when off
+	void SetEnabled(bool bEnabled);
+	bool IsEnabled() const { return(m_bEnabled); }
+
+	// mark the start and end of a frame
+	void BeginFrame();
+	void EndFrame();
+
+	// open and close a named scope - scopes may be nested
+	void BeginScope(const char* name);
+	void EndScope();
+
+	// per-scope timing over the rolling window
+	struct SCOPE_STATS
+	{
+		double minMs;
+		double avgMs;
+		double p99Ms;
+		int sampleCount;
+	};
+	// get the timing of a named scope
+	bool GetScopeStats(const std::string& name, SCOPE_STATS& stats) const;
+	// get the duration of a named scope in the latest frame
+	// read back, and the index of that frame
+	bool GetLatestScopeTime(const std::string& name, double& durationMs, int& frameIndex) const;
+	// index the next frame begun will have
+	int GetFrameIndex() const { return(m_frameIndex); }
+
+	// print the timing of every scope to the console
+	void PrintStats() const;
+	// write every recorded scope to a Chrome trace file
+	bool WriteChromeTrace(const char* filename) const;
+
+	// free the timer queries
+	void Shutdown();
+
+private:
+	// constructor
+	GPUProfiler();
+	// destructor
+	~GPUProfiler();
+
+	// a scope recorded during a frame
+	struct SCOPE_RECORD
+	{
+		const char* name;
+		int depth;
+		GLuint beginQuery;
+		GLuint endQuery;
+	};
+
+	// queries and scopes of one frame in the ring
+	struct FRAME_RECORD
+	{
+		std::vector<GLuint> queries;
+		int usedQueries;
+		std::vector<SCOPE_RECORD> scopes;
+		bool bPending;
+		int frameIndex;
+	};
+
+	// a completed scope kept for the Chrome trace
+	struct TRACE_EVENT
+	{
+		const char* name;
+		int depth;
+		GLuint64 start;
+		GLuint64 duration;
+	};
+
+	// rolling window of durations for one scope
+	struct SCOPE_HISTORY
+	{
+		std::vector<double> samples;
+		int next;
+		// the latest duration and the frame it was measured in
+		double latestMs;
+		int latestFrame;
+	};
+
+	bool m_bEnabled;
+	bool m_bDebugGroups;
+	bool m_bInFrame;
+	int m_frameIndex;
+	int m_droppedFrames;
+	std::vector<FRAME_RECORD> m_frames;
+	// indices of the open scopes of the current frame
+	std::vector<int> m_openScopes;
+	std::map<std::string, SCOPE_HISTORY> m_history;
+	std::vector<TRACE_EVENT> m_trace;
+
+	// get the next free query of the current frame
+	GLuint NextQuery(FRAME_RECORD& frame);
+	// read back the scopes of a frame whose queries completed
+	void ResolveFrame(FRAME_RECORD& frame);
+};
+
+/***********************************************************
+ *  GPUProfileScope
+ *
+ *  This class opens a profiler scope when it is created and
+ *  closes it when it goes out of scope.
+ ***********************************************************/
+class GPUProfileScope
+{
+public:
+	GPUProfileScope(const char* name) { GPUProfiler::Get().BeginScope(name); }
+	~GPUProfileScope() { GPUProfiler::Get().EndScope(); }
+};
+
+#define GPU_PROFILE_CONCAT_INNER(a, b) a##b
+#define GPU_PROFILE_CONCAT(a, b) GPU_PROFILE_CONCAT_INNER(a, b)
+// time the rest of the enclosing block on the GPU
+#define GPU_PROFILE_SCOPE(name) GPUProfileScope GPU_PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
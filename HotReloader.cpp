@@ -0,0 +1,310 @@
+///////////////////////////////////////////////////////////////////////////////
+// hotreloader.cpp
+// ============
+// reload changed scene files, textures and shaders while the program runs
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "HotReloader.h"
+#include "SceneFile.h"
+#include "ShaderCache.h"
+#include "ShaderCompiler.h"
+#include "ShaderVariants.h"
+#include "CPUProfiler.h"
+
+#include <chrono>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	/***********************************************************
+	 *  NowMilliseconds()
+	 *
+	 *  Reads the steady clock in milliseconds.
+	 ***********************************************************/
+	double NowMilliseconds()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+}
+
+/***********************************************************
+ *  HotReloader()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+HotReloader::HotReloader(ShaderManager* pShaderManager, SceneManager* pSceneManager, JobSystem* pJobSystem)
+{
+	m_pShaderManager = pShaderManager;
+	m_pSceneManager = pSceneManager;
+	m_pJobSystem = pJobSystem;
+	m_pShaderCache = NULL;
+	m_bRunning = false;
+}
+
+/***********************************************************
+ *  ~HotReloader()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+HotReloader::~HotReloader()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for watching the scene file, the
+ *  texture directory and the shader files.
+ ***********************************************************/
+bool HotReloader::Start(const RELOAD_SETTINGS& settings, const FileWatcher::WAKE_FUNCTION& wake)
+{
+	m_settings = settings;
+	m_settings.sceneFile = FileWatcher::NormalizePath(settings.sceneFile);
+	m_settings.vertexShaderFile = FileWatcher::NormalizePath(settings.vertexShaderFile);
+	m_settings.fragmentShaderFile = FileWatcher::NormalizePath(settings.fragmentShaderFile);
+	m_wake = wake;
+
+	if (settings.sceneFile.size() > 0)
+	{
+		m_watcher.WatchFile(settings.sceneFile);
+	}
+	if (settings.textureDirectory.size() > 0)
+	{
+		m_watcher.WatchDirectory(settings.textureDirectory);
+	}
+	if (settings.vertexShaderFile.size() > 0)
+	{
+		m_watcher.WatchFile(settings.vertexShaderFile);
+	}
+	if (settings.fragmentShaderFile.size() > 0)
+	{
+		m_watcher.WatchFile(settings.fragmentShaderFile);
+	}
+
+	if (m_watcher.Start(wake) == false)
+	{
+		return(false);
+	}
+	m_bRunning = true;
+
+	std::cout << "INFO: Hot reload is watching for changes"
+		<< ((m_watcher.IsUsingNotifications() == true) ? "" : " by polling") << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for stopping the watcher and waiting
+ *  for the background jobs, whose results are dropped.
+ ***********************************************************/
+void HotReloader::Stop()
+{
+	if (m_bRunning == false)
+	{
+		return;
+	}
+
+	m_watcher.Stop();
+	for (size_t i = 0; i < m_tasks.size(); i++)
+	{
+		if (NULL != m_pJobSystem)
+		{
+			m_pJobSystem->Wait(&m_tasks[i]->counter);
+		}
+		FreeTask(m_tasks[i]);
+	}
+	m_tasks.clear();
+
+	m_bRunning = false;
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for turning the changed files into
+ *  reloads and applying the reloads that have loaded.  They
+ *  are applied in the order they were started, so when a
+ *  file is saved twice in a row the later version wins.
+ ***********************************************************/
+void HotReloader::Update()
+{
+	if (m_bRunning == false)
+	{
+		return;
+	}
+
+	m_watcher.TakeChangedFiles(m_changedFiles);
+	bool bShadersChanged = false;
+	for (size_t i = 0; i < m_changedFiles.size(); i++)
+	{
+		const std::string& filename = m_changedFiles[i];
+		if (filename == m_settings.sceneFile)
+		{
+			StartTask(reload_scene, filename);
+		}
+		else if ((filename == m_settings.vertexShaderFile) || (filename == m_settings.fragmentShaderFile))
+		{
+			bShadersChanged = true;
+		}
+		else if (m_pSceneManager->UsesTextureFile(filename) == true)
+		{
+			StartTask(reload_texture, filename);
+		}
+	}
+	m_changedFiles.clear();
+
+	// both stages are built together, so saving both files
+	// only compiles once
+	if (bShadersChanged == true)
+	{
+		StartTask(reload_shaders, m_settings.vertexShaderFile + " and " + m_settings.fragmentShaderFile);
+	}
+
+	size_t finished = 0;
+	while ((finished < m_tasks.size()) && (m_tasks[finished]->bFinished.load(std::memory_order_acquire) == true))
+	{
+		ApplyTask(m_tasks[finished]);
+		FreeTask(m_tasks[finished]);
+		finished++;
+	}
+	m_tasks.erase(m_tasks.begin(), m_tasks.begin() + finished);
+}
+
+/***********************************************************
+ *  StartTask()
+ *
+ *  This method is used for queueing the loading of a changed
+ *  file on a worker thread, so the frames keep coming while
+ *  it loads.  Without worker threads it loads right away.
+ ***********************************************************/
+void HotReloader::StartTask(RELOAD_KIND kind, const std::string& filename)
+{
+	RELOAD_TASK* pTask = new RELOAD_TASK();
+	pTask->kind = kind;
+	pTask->filename = filename;
+	pTask->startTime = NowMilliseconds();
+	pTask->bFinished = false;
+	pTask->bLoaded = false;
+	pTask->pSceneFile = NULL;
+	pTask->image.pixels = NULL;
+	m_tasks.push_back(pTask);
+
+	if ((NULL != m_pJobSystem) && (m_pJobSystem->GetWorkerCount() > 1))
+	{
+		m_pJobSystem->Run([this, pTask](int) {
+			LoadTask(pTask);
+			pTask->bFinished.store(true, std::memory_order_release);
+			// let an idle main loop apply the result
+			if (m_wake)
+			{
+				m_wake();
+			}
+		}, &pTask->counter, JobSystem::affinity_worker_thread);
+	}
+	else
+	{
+		LoadTask(pTask);
+		pTask->bFinished = true;
+	}
+}
+
+/***********************************************************
+ *  LoadTask()
+ *
+ *  This method is used for doing the slow part of a reload
+ *  off the OpenGL thread.
+ ***********************************************************/
+void HotReloader::LoadTask(RELOAD_TASK* pTask)
+{
+	CPU_PROFILE_ZONE("HotReloader::LoadTask");
+
+	switch (pTask->kind)
+	{
+	case reload_scene:
+		pTask->pSceneFile = new SceneFile();
+		pTask->bLoaded = pTask->pSceneFile->Load(pTask->filename.c_str());
+		break;
+	case reload_texture:
+		pTask->bLoaded = SceneManager::DecodeTextureImage(pTask->filename.c_str(), pTask->image);
+		break;
+	case reload_shaders:
+		pTask->bLoaded =
+			(ShaderCompiler::ReadSourceFile(m_settings.vertexShaderFile, pTask->vertexSource) == true) &&
+			(ShaderCompiler::ReadSourceFile(m_settings.fragmentShaderFile, pTask->fragmentSource) == true);
+		break;
+	}
+}
+
+/***********************************************************
+ *  ApplyTask()
+ *
+ *  This method is used for swapping a loaded file in.  A
+ *  file that failed to load, or shaders that fail to build,
+ *  leave the scene as it was.
+ ***********************************************************/
+void HotReloader::ApplyTask(RELOAD_TASK* pTask)
+{
+	CPU_PROFILE_ZONE("HotReloader::ApplyTask");
+
+	if (pTask->bLoaded == false)
+	{
+		std::cout << "Could not reload " << pTask->filename << ", keeping the previous version" << std::endl;
+		return;
+	}
+
+	switch (pTask->kind)
+	{
+	case reload_scene:
+		m_pSceneManager->UseSceneFile(pTask->pSceneFile);
+		pTask->pSceneFile = NULL;
+		break;
+	case reload_texture:
+		m_pSceneManager->ReplaceTexture(pTask->image);
+		break;
+	case reload_shaders:
+	{
+		std::string log;
+		GLuint program = (NULL != m_pShaderCache) ?
+			m_pShaderCache->BuildProgram(pTask->vertexSource, pTask->fragmentSource, log) :
+			ShaderCompiler::BuildProgram(pTask->vertexSource, pTask->fragmentSource, log);
+		if (program == 0)
+		{
+			std::cout << "Could not reload shaders, keeping the previous program:\n" << log << std::endl;
+			return;
+		}
+
+		glDeleteProgram(m_pShaderManager->m_programID);
+		m_pShaderManager->m_programID = program;
+		m_pShaderManager->use();
+		// the variants are built again from the new sources
+		if (NULL != m_pSceneManager->GetShaderVariants())
+		{
+			m_pSceneManager->GetShaderVariants()->SetSources(pTask->vertexSource, pTask->fragmentSource);
+		}
+		m_pSceneManager->RestoreShaderState();
+		break;
+	}
+	}
+
+	std::cout << "INFO: Reloaded " << pTask->filename << " in "
+		<< NowMilliseconds() - pTask->startTime << " ms" << std::endl;
+}
+
+/***********************************************************
+ *  FreeTask()
+ *
+ *  This method is used for freeing a task and anything it
+ *  loaded that was not swapped in.
+ ***********************************************************/
+void HotReloader::FreeTask(RELOAD_TASK* pTask)
+{
+	delete pTask->pSceneFile;
+	SceneManager::FreeTextureImage(pTask->image);
+	delete pTask;
+}
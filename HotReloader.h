@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////////////
+// hotreloader.h
+// ============
+// reload changed scene files, textures and shaders while the program runs
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FileWatcher.h"
+#include "JobSystem.h"
+#include "SceneManager.h"
+#include "ShaderManager.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+class SceneFile;
+class ShaderCache;
+
+/***********************************************************
+ *  HotReloader
+ *
+ *  This class watches the files the scene was built from and
+ *  reloads whichever one changes.  Reading, parsing and
+ *  decoding run as background jobs; the result is swapped in
+ *  on the OpenGL thread between two frames, so a frame never
+ *  sees half of a change.  Only the changed file is reloaded:
+ *  an edited image replaces its texture, an edited scene file
+ *  replaces the objects, materials and lights, and an edited
+ *  shader is compiled into a new program that only replaces
+ *  the current one once it has compiled and linked.
+ ***********************************************************/
+class HotReloader
+{
+public:
+	// the files to watch - empty names are not watched
+	struct RELOAD_SETTINGS
+	{
+		std::string sceneFile;
+		std::string textureDirectory;
+		std::string vertexShaderFile;
+		std::string fragmentShaderFile;
+	};
+
+	// constructor
+	HotReloader(ShaderManager* pShaderManager, SceneManager* pSceneManager, JobSystem* pJobSystem);
+	// destructor
+	~HotReloader();
+
+	// start watching - the wake function is called from other
+	// threads when there is something for Update() to do
+	bool Start(const RELOAD_SETTINGS& settings, const FileWatcher::WAKE_FUNCTION& wake);
+	// stop watching and drop unfinished reloads
+	void Stop();
+	// build reloaded shaders through the cache, so an edited
+	// program starts from its binary on the next run
+	void SetShaderCache(ShaderCache* pShaderCache) { m_pShaderCache = pShaderCache; }
+
+	// start the reloads of changed files and swap in finished
+	// ones - call between frames on the OpenGL thread
+	void Update();
+
+private:
+	enum RELOAD_KIND
+	{
+		reload_scene,
+		reload_texture,
+		reload_shaders
+	};
+
+	// one reload, loaded in the background and applied on the
+	// OpenGL thread
+	struct RELOAD_TASK
+	{
+		RELOAD_KIND kind;
+		std::string filename;
+		JobCounter counter;
+		// set once loaded - the counter only drops after the
+		// owner has been woken, so it cannot be used for this
+		std::atomic<bool> bFinished;
+		double startTime;
+		bool bLoaded;
+		SceneFile* pSceneFile;
+		SceneManager::TEXTURE_IMAGE image;
+		std::string vertexSource;
+		std::string fragmentSource;
+	};
+
+	ShaderManager* m_pShaderManager;
+	SceneManager* m_pSceneManager;
+	JobSystem* m_pJobSystem;
+	ShaderCache* m_pShaderCache;
+	RELOAD_SETTINGS m_settings;
+	FileWatcher m_watcher;
+	FileWatcher::WAKE_FUNCTION m_wake;
+	bool m_bRunning;
+	// reloads in the order they were started
+	std::vector<RELOAD_TASK*> m_tasks;
+	std::vector<std::string> m_changedFiles;
+
+	// queue the loading of a changed file
+	void StartTask(RELOAD_KIND kind, const std::string& filename);
+	// read, parse or decode the file - safe on any thread
+	void LoadTask(RELOAD_TASK* pTask);
+	// swap the loaded file in on the OpenGL thread
+	void ApplyTask(RELOAD_TASK* pTask);
+	// free whatever a task still holds
+	void FreeTask(RELOAD_TASK* pTask);
+};
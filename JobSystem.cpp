@@ -0,0 +1,665 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.cpp
+// ============
+// work-stealing worker threads for parallel scene and asset work
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JobSystem.h"
+#include "CPUProfiler.h"
+
+#include <cstdio>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// index of the calling thread in its job system, -1 if it
+	// is not a worker
+	thread_local int g_WorkerIndex = -1;
+
+	// finished job objects kept per thread for reuse
+	const size_t MAX_CACHED_JOBS = 1024;
+
+	// times an idle worker looks for work before it sleeps
+	const int IDLE_SPIN_COUNT = 64;
+}
+
+/***********************************************************
+ *  WORK_DEQUE()
+ *
+ *  The constructor for the deque
+ ***********************************************************/
+JobSystem::WORK_DEQUE::WORK_DEQUE()
+{
+	top.store(0, std::memory_order_relaxed);
+	bottom.store(0, std::memory_order_relaxed);
+	for (int64_t i = 0; i < CAPACITY; i++)
+	{
+		jobs[i].store(NULL, std::memory_order_relaxed);
+	}
+}
+
+/***********************************************************
+ *  Push()
+ *
+ *  This method is used by the owning worker for adding a
+ *  job to the bottom of its deque.
+ ***********************************************************/
+bool JobSystem::WORK_DEQUE::Push(JOB* pJob)
+{
+	int64_t b = bottom.load(std::memory_order_relaxed);
+	int64_t t = top.load(std::memory_order_acquire);
+	if (b - t >= CAPACITY)
+	{
+		return(false);
+	}
+
+	// the release store publishes the job to thieves
+	jobs[b & (CAPACITY - 1)].store(pJob, std::memory_order_relaxed);
+	bottom.store(b + 1, std::memory_order_release);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Pop()
+ *
+ *  This method is used by the owning worker for taking the
+ *  newest job from the bottom of its deque.  Only the last
+ *  job can be contended by a thief, which is settled with a
+ *  compare-and-swap on the top index.
+ ***********************************************************/
+JobSystem::JOB* JobSystem::WORK_DEQUE::Pop()
+{
+	int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+	bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t t = top.load(std::memory_order_relaxed);
+
+	if (t > b)
+	{
+		// the deque was empty
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return(NULL);
+	}
+
+	JOB* pJob = jobs[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+	if (t == b)
+	{
+		// last job - race any thief for it
+		if (!top.compare_exchange_strong(t, t + 1,
+			std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			pJob = NULL;
+		}
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	return(pJob);
+}
+
+/***********************************************************
+ *  Steal()
+ *
+ *  This method is used by any thread for taking the oldest
+ *  job from the top of a deque.  It returns null when the
+ *  deque is empty or another thread won the job.
+ ***********************************************************/
+JobSystem::JOB* JobSystem::WORK_DEQUE::Steal()
+{
+	int64_t t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t b = bottom.load(std::memory_order_acquire);
+
+	if (t >= b)
+	{
+		return(NULL);
+	}
+
+	JOB* pJob = jobs[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+	if (!top.compare_exchange_strong(t, t + 1,
+		std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return(NULL);
+	}
+
+	return(pJob);
+}
+
+/***********************************************************
+ *  JobSystem()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+JobSystem::JobSystem(int threadCount)
+{
+	if (threadCount <= 0)
+	{
+		threadCount = (int)std::thread::hardware_concurrency();
+	}
+	if (threadCount <= 0)
+	{
+		threadCount = 1;
+	}
+
+	m_workerCount = threadCount;
+	m_pendingJobs.store(0);
+	m_sleepingWorkers.store(0);
+	m_dependentCount.store(0);
+	m_bStop = false;
+
+	for (int i = 0; i < m_workerCount; i++)
+	{
+		m_deques.push_back(new WORK_DEQUE());
+	}
+
+	// worker 0 is the calling thread - only the others get threads
+	g_WorkerIndex = 0;
+	for (int i = 1; i < m_workerCount; i++)
+	{
+		m_threads.push_back(std::thread(&JobSystem::WorkerLoop, this, i));
+	}
+
+	std::cout << "INFO: Job system started with " << m_workerCount << " workers" << std::endl;
+}
+
+/***********************************************************
+ *  ~JobSystem()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_bStop = true;
+	}
+	m_wake.notify_all();
+
+	for (size_t i = 0; i < m_threads.size(); i++)
+	{
+		m_threads[i].join();
+	}
+
+	// main thread jobs that were never run are dropped
+	for (size_t i = 0; i < m_mainThreadJobs.size(); i++)
+	{
+		delete m_mainThreadJobs[i];
+	}
+	for (size_t i = 0; i < m_dependentJobs.size(); i++)
+	{
+		delete m_dependentJobs[i].pJob;
+	}
+	for (size_t i = 0; i < m_workerThreadJobs.size(); i++)
+	{
+		delete m_workerThreadJobs[i];
+	}
+	for (size_t i = 0; i < m_deques.size(); i++)
+	{
+		delete m_deques[i];
+	}
+
+	g_WorkerIndex = -1;
+}
+
+/***********************************************************
+ *  GetCurrentWorkerIndex()
+ *
+ *  This method is used for getting the worker index of the
+ *  calling thread.
+ ***********************************************************/
+int JobSystem::GetCurrentWorkerIndex()
+{
+	return(g_WorkerIndex);
+}
+
+/***********************************************************
+ *  AllocateJob()
+ *
+ *  This method is used for getting a job object.  Finished
+ *  jobs are cached by the thread that ran them, so steady
+ *  state scheduling does not touch the heap.
+ ***********************************************************/
+JobSystem::JOB* JobSystem::AllocateJob()
+{
+	std::vector<JOB*>& cache = JobCache();
+	if (cache.empty())
+	{
+		return(new JOB());
+	}
+
+	JOB* pJob = cache.back();
+	cache.pop_back();
+	return(pJob);
+}
+
+/***********************************************************
+ *  FreeJob()
+ *
+ *  This method is used for returning a finished job object
+ *  to the cache of the calling thread.
+ ***********************************************************/
+void JobSystem::FreeJob(JOB* pJob)
+{
+	// release whatever the function captured right away
+	pJob->function = nullptr;
+
+	std::vector<JOB*>& cache = JobCache();
+	if (cache.size() < MAX_CACHED_JOBS)
+	{
+		cache.push_back(pJob);
+	}
+	else
+	{
+		delete pJob;
+	}
+}
+
+/***********************************************************
+ *  JobCache()
+ *
+ *  This method is used for getting the job object cache of
+ *  the calling thread.
+ ***********************************************************/
+std::vector<JobSystem::JOB*>& JobSystem::JobCache()
+{
+	struct JOB_CACHE
+	{
+		std::vector<JOB*> jobs;
+		~JOB_CACHE()
+		{
+			for (size_t i = 0; i < jobs.size(); i++)
+			{
+				delete jobs[i];
+			}
+		}
+	};
+	static thread_local JOB_CACHE cache;
+
+	return(cache.jobs);
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for queueing a job.  The counter is
+ *  raised now and lowered when the job has finished.
+ ***********************************************************/
+void JobSystem::Run(
+	const JOB_FUNCTION& function,
+	JobCounter* pCounter,
+	JOB_AFFINITY affinity)
+{
+	JOB* pJob = AllocateJob();
+	pJob->function = function;
+	pJob->pCounter = pCounter;
+	pJob->affinity = affinity;
+
+	if (NULL != pCounter)
+	{
+		pCounter->m_value.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	Schedule(pJob);
+}
+
+/***********************************************************
+ *  RunAfter()
+ *
+ *  This method is used for queueing a job that must not start
+ *  before every job counted by the dependency has finished.
+ *  The job is parked until the dependency reaches zero.
+ ***********************************************************/
+void JobSystem::RunAfter(
+	JobCounter* pDependency,
+	const JOB_FUNCTION& function,
+	JobCounter* pCounter,
+	JOB_AFFINITY affinity)
+{
+	if ((NULL == pDependency) || pDependency->IsDone())
+	{
+		Run(function, pCounter, affinity);
+		return;
+	}
+
+	JOB* pJob = AllocateJob();
+	pJob->function = function;
+	pJob->pCounter = pCounter;
+	pJob->affinity = affinity;
+
+	if (NULL != pCounter)
+	{
+		pCounter->m_value.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_dependentMutex);
+		DEPENDENT_JOB dependent;
+		dependent.pDependency = pDependency;
+		dependent.pJob = pJob;
+		m_dependentJobs.push_back(dependent);
+		m_dependentCount.fetch_add(1);
+	}
+
+	// the dependency may have finished while the job was parked
+	if (pDependency->IsDone())
+	{
+		ReleaseDependents();
+	}
+}
+
+/***********************************************************
+ *  ReleaseDependents()
+ *
+ *  This method is used for scheduling every parked job whose
+ *  dependency has reached zero.
+ ***********************************************************/
+void JobSystem::ReleaseDependents()
+{
+	std::vector<JOB*> readyJobs;
+	{
+		std::lock_guard<std::mutex> lock(m_dependentMutex);
+		size_t kept = 0;
+		for (size_t i = 0; i < m_dependentJobs.size(); i++)
+		{
+			if (m_dependentJobs[i].pDependency->IsDone())
+			{
+				readyJobs.push_back(m_dependentJobs[i].pJob);
+			}
+			else
+			{
+				m_dependentJobs[kept++] = m_dependentJobs[i];
+			}
+		}
+		m_dependentJobs.resize(kept);
+		m_dependentCount.store((int)kept);
+	}
+
+	for (size_t i = 0; i < readyJobs.size(); i++)
+	{
+		Schedule(readyJobs[i]);
+	}
+}
+
+/***********************************************************
+ *  Schedule()
+ *
+ *  This method is used for handing a ready job to a queue.
+ *  Workers push onto their own deque; other threads, and
+ *  workers whose deque is full, use the shared inject queue.
+ *  Jobs kept off the main thread have a queue of their own.
+ ***********************************************************/
+void JobSystem::Schedule(JOB* pJob)
+{
+	if (pJob->affinity == affinity_main_thread)
+	{
+		std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+		m_mainThreadJobs.push_back(pJob);
+		return;
+	}
+
+	// count the job before it becomes visible so an idle worker
+	// never sleeps while it is queued
+	m_pendingJobs.fetch_add(1);
+
+	int workerIndex = g_WorkerIndex;
+	if (pJob->affinity == affinity_worker_thread)
+	{
+		std::lock_guard<std::mutex> lock(m_injectMutex);
+		m_workerThreadJobs.push_back(pJob);
+	}
+	else if ((workerIndex < 0) || (workerIndex >= m_workerCount) ||
+		(m_deques[workerIndex]->Push(pJob) == false))
+	{
+		std::lock_guard<std::mutex> lock(m_injectMutex);
+		m_injectedJobs.push_back(pJob);
+	}
+
+	if (m_sleepingWorkers.load() > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_wakeMutex);
+		}
+		m_wake.notify_one();
+	}
+}
+
+/***********************************************************
+ *  FindJob()
+ *
+ *  This method is used for finding a job to run: first the
+ *  newest job of the worker's own deque, then the oldest job
+ *  of another worker, then the inject queue and, except on
+ *  the main thread, the background queue.
+ ***********************************************************/
+JobSystem::JOB* JobSystem::FindJob(int workerIndex)
+{
+	JOB* pJob = NULL;
+
+	if (m_pendingJobs.load(std::memory_order_relaxed) <= 0)
+	{
+		return(NULL);
+	}
+
+	if ((workerIndex >= 0) && (workerIndex < m_workerCount))
+	{
+		pJob = m_deques[workerIndex]->Pop();
+	}
+
+	int start = (workerIndex >= 0) ? workerIndex : 0;
+	for (int i = 1; (NULL == pJob) && (i <= m_workerCount); i++)
+	{
+		int victim = (start + i) % m_workerCount;
+		if (victim != workerIndex)
+		{
+			pJob = m_deques[victim]->Steal();
+		}
+	}
+
+	if (NULL == pJob)
+	{
+		std::lock_guard<std::mutex> lock(m_injectMutex);
+		if (m_injectedJobs.empty() == false)
+		{
+			pJob = m_injectedJobs.front();
+			m_injectedJobs.pop_front();
+		}
+		else if ((workerIndex > 0) && (m_workerThreadJobs.empty() == false))
+		{
+			pJob = m_workerThreadJobs.front();
+			m_workerThreadJobs.pop_front();
+		}
+	}
+
+	if (NULL != pJob)
+	{
+		m_pendingJobs.fetch_sub(1);
+	}
+
+	return(pJob);
+}
+
+/***********************************************************
+ *  Execute()
+ *
+ *  This method is used for running a job, lowering its
+ *  counter and releasing the jobs that were waiting for the
+ *  counter to reach zero.
+ ***********************************************************/
+void JobSystem::Execute(JOB* pJob, int workerIndex)
+{
+	pJob->function(workerIndex);
+
+	JobCounter* pCounter = pJob->pCounter;
+	FreeJob(pJob);
+
+	if ((NULL != pCounter) &&
+		(pCounter->m_value.fetch_sub(1, std::memory_order_acq_rel) == 1) &&
+		(m_dependentCount.load() > 0))
+	{
+		ReleaseDependents();
+	}
+}
+
+/***********************************************************
+ *  Wait()
+ *
+ *  This method is used for waiting until a counter reaches
+ *  zero.  Workers run other jobs meanwhile and the main
+ *  thread also runs main thread jobs.  Threads that are not
+ *  workers only yield.
+ ***********************************************************/
+void JobSystem::Wait(JobCounter* pCounter)
+{
+	CPU_PROFILE_ZONE("JobSystem::Wait");
+
+	int workerIndex = g_WorkerIndex;
+
+	while (pCounter->IsDone() == false)
+	{
+		JOB* pJob = NULL;
+
+		if (workerIndex == 0)
+		{
+			std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+			if (m_mainThreadJobs.empty() == false)
+			{
+				pJob = m_mainThreadJobs.front();
+				m_mainThreadJobs.pop_front();
+			}
+		}
+		if ((NULL == pJob) && (workerIndex >= 0))
+		{
+			pJob = FindJob(workerIndex);
+		}
+
+		if (NULL != pJob)
+		{
+			Execute(pJob, workerIndex);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+/***********************************************************
+ *  RunMainThreadJobs()
+ *
+ *  This method is used by the main thread for running the
+ *  main thread jobs queued so far.  Jobs queued while these
+ *  run are left for the next call.
+ ***********************************************************/
+void JobSystem::RunMainThreadJobs()
+{
+	if (g_WorkerIndex != 0)
+	{
+		return;
+	}
+
+	std::deque<JOB*> jobs;
+	{
+		std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+		jobs.swap(m_mainThreadJobs);
+	}
+
+	for (size_t i = 0; i < jobs.size(); i++)
+	{
+		Execute(jobs[i], 0);
+	}
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method is the entry point of each worker thread.
+ ***********************************************************/
+void JobSystem::WorkerLoop(int workerIndex)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "Job Worker %d", workerIndex);
+	CPU_PROFILE_THREAD(name);
+
+	g_WorkerIndex = workerIndex;
+
+	int idleSpins = 0;
+	while (true)
+	{
+		JOB* pJob = FindJob(workerIndex);
+		if (NULL != pJob)
+		{
+			Execute(pJob, workerIndex);
+			idleSpins = 0;
+			continue;
+		}
+
+		// stay awake briefly - more work often follows soon
+		if (idleSpins < IDLE_SPIN_COUNT)
+		{
+			idleSpins++;
+			std::this_thread::yield();
+			continue;
+		}
+		idleSpins = 0;
+
+		// sleep until more jobs are queued
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_sleepingWorkers.fetch_add(1);
+		m_wake.wait(lock, [this]() {
+			return((m_bStop == true) || (m_pendingJobs.load() > 0));
+		});
+		m_sleepingWorkers.fetch_sub(1);
+		if (m_bStop == true)
+		{
+			break;
+		}
+	}
+
+	g_WorkerIndex = -1;
+}
+
+/***********************************************************
+ *  ParallelFor()
+ *
+ *  This method is used for splitting a range into slices of
+ *  at most grainSize items and running them on every worker.
+ *  The slices are pushed onto the caller's deque, idle
+ *  workers steal them and the caller works through the rest
+ *  until all are done.  It must be called from a worker.
+ ***********************************************************/
+void JobSystem::ParallelFor(int count, int grainSize, const RANGE_FUNCTION& function)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+	if (grainSize < 1)
+	{
+		grainSize = 1;
+	}
+
+	int workerIndex = (g_WorkerIndex >= 0) ? g_WorkerIndex : 0;
+
+	// small ranges are not worth handing to other threads
+	int sliceCount = (count + grainSize - 1) / grainSize;
+	if ((sliceCount == 1) || (m_workerCount == 1))
+	{
+		function(0, count, workerIndex);
+		return;
+	}
+
+	JobCounter counter;
+	for (int slice = 0; slice < sliceCount; slice++)
+	{
+		int begin = slice * grainSize;
+		int end = (begin + grainSize < count) ? begin + grainSize : count;
+
+		Run([&function, begin, end](int index) {
+			function(begin, end, index);
+		}, &counter);
+	}
+
+	Wait(&counter);
+}
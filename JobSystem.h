@@ -0,0 +1,177 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.h
+// ============
+// work-stealing worker threads for parallel scene and asset work
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  JobCounter
+ *
+ *  This class counts the unfinished jobs of a group.  Jobs
+ *  can be made to wait for a counter to reach zero before
+ *  they start, which is how dependencies are expressed.
+ ***********************************************************/
+class JobCounter
+{
+public:
+	// constructor
+	JobCounter() : m_value(0) {}
+
+	// true once every job of the group has finished
+	bool IsDone() const { return(m_value.load(std::memory_order_acquire) == 0); }
+
+private:
+	friend class JobSystem;
+
+	std::atomic<int> m_value;
+};
+
+/***********************************************************
+ *  JobSystem
+ *
+ *  This class runs jobs on a pool of worker threads.  Every
+ *  worker owns a lock-free Chase-Lev deque: the owner pushes
+ *  and pops at the bottom while idle workers steal from the
+ *  top.  The thread that creates the job system is worker 0
+ *  and takes part whenever it waits.
+ *
+ *  Jobs that touch OpenGL must run on the thread that owns
+ *  the context.  They are given main thread affinity and are
+ *  only run by worker 0, from Wait() or RunMainThreadJobs().
+ *  Long background jobs are kept off the main thread instead.
+ ***********************************************************/
+class JobSystem
+{
+public:
+	// a job receives the index of the worker running it
+	typedef std::function<void(int workerIndex)> JOB_FUNCTION;
+	// a range job receives a [begin, end) slice of the range
+	typedef std::function<void(int begin, int end, int workerIndex)> RANGE_FUNCTION;
+
+	enum JOB_AFFINITY
+	{
+		// any worker may run the job
+		affinity_any,
+		// only the main thread (worker 0) may run the job
+		affinity_main_thread,
+		// never run on the main thread - for long jobs that would
+		// hold up a frame, needs at least two workers
+		affinity_worker_thread
+	};
+
+	// constructor - zero threads means one per hardware core
+	JobSystem(int threadCount);
+	// destructor
+	~JobSystem();
+
+	// total number of workers, including the main thread
+	int GetWorkerCount() const { return(m_workerCount); }
+	// index of the calling worker, or -1 for other threads
+	static int GetCurrentWorkerIndex();
+
+	// queue a job - the counter, if any, is raised until it ends
+	void Run(
+		const JOB_FUNCTION& function,
+		JobCounter* pCounter = NULL,
+		JOB_AFFINITY affinity = affinity_any);
+	// queue a job that only starts once the dependency is zero
+	void RunAfter(
+		JobCounter* pDependency,
+		const JOB_FUNCTION& function,
+		JobCounter* pCounter = NULL,
+		JOB_AFFINITY affinity = affinity_any);
+	// run other jobs until the counter reaches zero
+	void Wait(JobCounter* pCounter);
+	// run every queued main thread job - call once per frame
+	void RunMainThreadJobs();
+
+	// split [0, count) into slices of at most grainSize items,
+	// run them on all workers and wait for them to finish
+	void ParallelFor(int count, int grainSize, const RANGE_FUNCTION& function);
+
+private:
+	// a queued unit of work
+	struct JOB
+	{
+		JOB_FUNCTION function;
+		JobCounter* pCounter;
+		JOB_AFFINITY affinity;
+	};
+
+	// Chase-Lev work-stealing deque of fixed capacity
+	struct WORK_DEQUE
+	{
+		static const int64_t CAPACITY = 4096;
+
+		alignas(64) std::atomic<int64_t> top;
+		alignas(64) std::atomic<int64_t> bottom;
+		std::atomic<JOB*> jobs[CAPACITY];
+
+		WORK_DEQUE();
+		// owner only - false when the deque is full
+		bool Push(JOB* pJob);
+		// owner only - newest job, or null
+		JOB* Pop();
+		// any thread - oldest job, or null
+		JOB* Steal();
+	};
+
+	int m_workerCount;
+	std::vector<WORK_DEQUE*> m_deques;
+	std::vector<std::thread> m_threads;
+
+	// jobs queued by threads that are not workers, and jobs
+	// that must stay off the main thread
+	std::mutex m_injectMutex;
+	std::deque<JOB*> m_injectedJobs;
+	std::deque<JOB*> m_workerThreadJobs;
+	// jobs that must run on the main thread
+	std::mutex m_mainThreadMutex;
+	std::deque<JOB*> m_mainThreadJobs;
+
+	// jobs waiting for a counter to reach zero
+	struct DEPENDENT_JOB
+	{
+		JobCounter* pDependency;
+		JOB* pJob;
+	};
+	std::mutex m_dependentMutex;
+	std::vector<DEPENDENT_JOB> m_dependentJobs;
+	std::atomic<int> m_dependentCount;
+
+	// sleeping and waking of idle workers
+	std::mutex m_wakeMutex;
+	std::condition_variable m_wake;
+	std::atomic<int> m_pendingJobs;
+	std::atomic<int> m_sleepingWorkers;
+	std::atomic<bool> m_bStop;
+
+	// get a job object, reusing finished ones where possible
+	JOB* AllocateJob();
+	// return a finished job object for reuse
+	void FreeJob(JOB* pJob);
+	// hand a ready job to a queue
+	void Schedule(JOB* pJob);
+	// find a job for a worker - own deque, then steal
+	JOB* FindJob(int workerIndex);
+	// run a job and release the jobs waiting on its counter
+	void Execute(JOB* pJob, int workerIndex);
+	// schedule the parked jobs whose dependency reached zero
+	void ReleaseDependents();
+	// cache of finished job objects of the calling thread
+	static std::vector<JOB*>& JobCache();
+	// worker thread entry point
+	void WorkerLoop(int workerIndex);
+};
@@ -0,0 +1,385 @@
+///////////////////////////////////////////////////////////////////////////////
+// jsonparser.cpp
+// ============
+// parse JSON text into a tree of values
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JsonParser.h"
+
+#include <cstdlib>
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// deepest nesting of arrays and objects
+	const int MAX_JSON_DEPTH = 64;
+
+	// position of the JSON parser in the text
+	struct JSON_READER
+	{
+		const char* pText;
+		const char* pEnd;
+		int line;
+		std::string error;
+	};
+
+	/***********************************************************
+	 *  Fail()
+	 *
+	 *  Records the first parse error and returns false.
+	 ***********************************************************/
+	bool Fail(JSON_READER& reader, const std::string& message)
+	{
+		if (reader.error.size() == 0)
+		{
+			reader.error = "line " + std::to_string(reader.line) + ": " + message;
+		}
+		return(false);
+	}
+
+	/***********************************************************
+	 *  SkipSpace()
+	 *
+	 *  Skips white space and // comments, which are allowed so
+	 *  that scenes can be annotated by hand.
+	 ***********************************************************/
+	void SkipSpace(JSON_READER& reader)
+	{
+		while (reader.pText < reader.pEnd)
+		{
+			char c = *reader.pText;
+			if (c == '\n')
+			{
+				reader.line++;
+				reader.pText++;
+			}
+			else if ((c == ' ') || (c == '\t') || (c == '\r'))
+			{
+				reader.pText++;
+			}
+			else if ((c == '/') && (reader.pText + 1 < reader.pEnd) && (reader.pText[1] == '/'))
+			{
+				while ((reader.pText < reader.pEnd) && (*reader.pText != '\n'))
+				{
+					reader.pText++;
+				}
+			}
+			else
+			{
+				return;
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  AppendUTF8()
+	 *
+	 *  Appends a code point from a \u escape as UTF-8.
+	 ***********************************************************/
+	void AppendUTF8(std::string& text, unsigned int codePoint)
+	{
+		if (codePoint < 0x80)
+		{
+			text += (char)codePoint;
+		}
+		else if (codePoint < 0x800)
+		{
+			text += (char)(0xC0 | (codePoint >> 6));
+			text += (char)(0x80 | (codePoint & 0x3F));
+		}
+		else
+		{
+			text += (char)(0xE0 | (codePoint >> 12));
+			text += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+			text += (char)(0x80 | (codePoint & 0x3F));
+		}
+	}
+
+	/***********************************************************
+	 *  ReadString()
+	 *
+	 *  Reads a quoted string, resolving its escapes.
+	 ***********************************************************/
+	bool ReadString(JSON_READER& reader, std::string& text)
+	{
+		// skip the opening quote
+		reader.pText++;
+		text.clear();
+
+		while (reader.pText < reader.pEnd)
+		{
+			char c = *reader.pText++;
+			if (c == '"')
+			{
+				return(true);
+			}
+			if ((unsigned char)c < 0x20)
+			{
+				return(Fail(reader, "unterminated string"));
+			}
+			if (c != '\\')
+			{
+				text += c;
+				continue;
+			}
+
+			if (reader.pText >= reader.pEnd)
+			{
+				break;
+			}
+			c = *reader.pText++;
+			switch (c)
+			{
+			case '"': text += '"'; break;
+			case '\\': text += '\\'; break;
+			case '/': text += '/'; break;
+			case 'b': text += '\b'; break;
+			case 'f': text += '\f'; break;
+			case 'n': text += '\n'; break;
+			case 'r': text += '\r'; break;
+			case 't': text += '\t'; break;
+			case 'u':
+			{
+				if (reader.pEnd - reader.pText < 4)
+				{
+					return(Fail(reader, "incomplete \\u escape"));
+				}
+				char digits[5] = { reader.pText[0], reader.pText[1], reader.pText[2], reader.pText[3], '\0' };
+				char* pDigitsEnd = NULL;
+				unsigned long codePoint = strtoul(digits, &pDigitsEnd, 16);
+				if (pDigitsEnd != digits + 4)
+				{
+					return(Fail(reader, "invalid \\u escape"));
+				}
+				AppendUTF8(text, (unsigned int)codePoint);
+				reader.pText += 4;
+				break;
+			}
+			default:
+				return(Fail(reader, std::string("invalid escape \\") + c));
+			}
+		}
+
+		return(Fail(reader, "unterminated string"));
+	}
+
+	/***********************************************************
+	 *  ReadNumber()
+	 *
+	 *  Reads a number.  The text is copied out first because
+	 *  the mapped file is not null terminated.
+	 ***********************************************************/
+	bool ReadNumber(JSON_READER& reader, double& number)
+	{
+		char digits[64];
+		size_t length = 0;
+		while ((reader.pText < reader.pEnd) && (length < sizeof(digits) - 1) &&
+			(strchr("+-0123456789.eE", *reader.pText) != NULL))
+		{
+			digits[length++] = *reader.pText++;
+		}
+		digits[length] = '\0';
+
+		char* pNumberEnd = NULL;
+		number = strtod(digits, &pNumberEnd);
+		if ((length == 0) || (pNumberEnd != digits + length))
+		{
+			return(Fail(reader, std::string("invalid number ") + digits));
+		}
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ReadWord()
+	 *
+	 *  Reads one of the literals true, false or null.
+	 ***********************************************************/
+	bool ReadWord(JSON_READER& reader, const char* word)
+	{
+		size_t length = strlen(word);
+		if (((size_t)(reader.pEnd - reader.pText) < length) ||
+			(memcmp(reader.pText, word, length) != 0))
+		{
+			return(Fail(reader, "unexpected character"));
+		}
+		reader.pText += length;
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ReadValue()
+	 *
+	 *  Reads any JSON value, recursing into arrays and objects.
+	 ***********************************************************/
+	bool ReadValue(JSON_READER& reader, JSON_VALUE& value, int depth)
+	{
+		SkipSpace(reader);
+		value.type = json_null;
+		value.number = 0.0;
+		value.line = reader.line;
+
+		if (reader.pText >= reader.pEnd)
+		{
+			return(Fail(reader, "unexpected end of file"));
+		}
+		if (depth > MAX_JSON_DEPTH)
+		{
+			return(Fail(reader, "nested too deeply"));
+		}
+
+		char c = *reader.pText;
+		if (c == '{')
+		{
+			value.type = json_object;
+			reader.pText++;
+			SkipSpace(reader);
+			if ((reader.pText < reader.pEnd) && (*reader.pText == '}'))
+			{
+				reader.pText++;
+				return(true);
+			}
+			while (true)
+			{
+				SkipSpace(reader);
+				if ((reader.pText >= reader.pEnd) || (*reader.pText != '"'))
+				{
+					return(Fail(reader, "expected a member name"));
+				}
+				value.keys.push_back(std::string());
+				if (ReadString(reader, value.keys.back()) == false)
+				{
+					return(false);
+				}
+				SkipSpace(reader);
+				if ((reader.pText >= reader.pEnd) || (*reader.pText != ':'))
+				{
+					return(Fail(reader, "expected ':'"));
+				}
+				reader.pText++;
+				value.items.push_back(JSON_VALUE());
+				if (ReadValue(reader, value.items.back(), depth + 1) == false)
+				{
+					return(false);
+				}
+				SkipSpace(reader);
+				if ((reader.pText < reader.pEnd) && (*reader.pText == ','))
+				{
+					reader.pText++;
+					continue;
+				}
+				if ((reader.pText < reader.pEnd) && (*reader.pText == '}'))
+				{
+					reader.pText++;
+					return(true);
+				}
+				return(Fail(reader, "expected ',' or '}'"));
+			}
+		}
+		if (c == '[')
+		{
+			value.type = json_array;
+			reader.pText++;
+			SkipSpace(reader);
+			if ((reader.pText < reader.pEnd) && (*reader.pText == ']'))
+			{
+				reader.pText++;
+				return(true);
+			}
+			while (true)
+			{
+				value.items.push_back(JSON_VALUE());
+				if (ReadValue(reader, value.items.back(), depth + 1) == false)
+				{
+					return(false);
+				}
+				SkipSpace(reader);
+				if ((reader.pText < reader.pEnd) && (*reader.pText == ','))
+				{
+					reader.pText++;
+					continue;
+				}
+				if ((reader.pText < reader.pEnd) && (*reader.pText == ']'))
+				{
+					reader.pText++;
+					return(true);
+				}
+				return(Fail(reader, "expected ',' or ']'"));
+			}
+		}
+		if (c == '"')
+		{
+			value.type = json_string;
+			return(ReadString(reader, value.text));
+		}
+		if (c == 't')
+		{
+			value.type = json_bool;
+			value.number = 1.0;
+			return(ReadWord(reader, "true"));
+		}
+		if (c == 'f')
+		{
+			value.type = json_bool;
+			return(ReadWord(reader, "false"));
+		}
+		if (c == 'n')
+		{
+			return(ReadWord(reader, "null"));
+		}
+
+		value.type = json_number;
+		return(ReadNumber(reader, value.number));
+	}
+}
+
+/***********************************************************
+ *  Parse()
+ *
+ *  This method is used for parsing a whole JSON document.
+ ***********************************************************/
+bool JsonParser::Parse(const char* pText, size_t length, JSON_VALUE& root, std::string& error)
+{
+	JSON_READER reader;
+	reader.pText = pText;
+	reader.pEnd = pText + length;
+	reader.line = 1;
+
+	// skip a UTF-8 byte order mark
+	if ((reader.pEnd - reader.pText >= 3) && (memcmp(reader.pText, "\xEF\xBB\xBF", 3) == 0))
+	{
+		reader.pText += 3;
+	}
+
+	bool bResult = ReadValue(reader, root, 0);
+	if (bResult == true)
+	{
+		SkipSpace(reader);
+		if (reader.pText != reader.pEnd)
+		{
+			bResult = Fail(reader, "unexpected text after the document");
+		}
+	}
+
+	error = reader.error;
+	return(bResult);
+}
+
+/***********************************************************
+ *  FindMember()
+ *
+ *  This method is used for getting the member of an object
+ *  with the passed in name.
+ ***********************************************************/
+const JSON_VALUE* JsonParser::FindMember(const JSON_VALUE& object, const char* name)
+{
+	for (size_t i = 0; i < object.keys.size(); i++)
+	{
+		if (object.keys[i] == name)
+		{
+			return(&object.items[i]);
+		}
+	}
+	return(NULL);
+}
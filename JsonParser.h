@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////////////////////
+// jsonparser.h
+// ============
+// parse JSON text into a tree of values
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// kinds of JSON values
+enum JSON_TYPE
+{
+	json_null,
+	json_bool,
+	json_number,
+	json_string,
+	json_array,
+	json_object
+};
+
+// a parsed JSON value
+struct JSON_VALUE
+{
+	JSON_TYPE type;
+	// number, or 1 and 0 for true and false
+	double number;
+	std::string text;
+	// array elements, or object member values
+	std::vector<JSON_VALUE> items;
+	// object member names, parallel to the items
+	std::vector<std::string> keys;
+	// line the value starts on, for error messages
+	int line;
+};
+
+/***********************************************************
+ *  JsonParser
+ *
+ *  This class parses JSON text, as used by the scene files
+ *  and the imported glTF meshes, into a tree of values.
+ *  The text does not need to be null terminated, so mapped
+ *  files are parsed in place.  Besides plain JSON, // line
+ *  comments are allowed so files can be annotated by hand.
+ ***********************************************************/
+class JsonParser
+{
+public:
+	// parse a whole document - a UTF-8 byte order mark is
+	// skipped, and nothing but white space may follow the
+	// value; the error names the line
+	static bool Parse(const char* pText, size_t length, JSON_VALUE& root, std::string& error);
+	// the member of an object with the passed in name, or null
+	// when it is missing
+	static const JSON_VALUE* FindMember(const JSON_VALUE& object, const char* name);
+};
@@ -1,196 +1,1590 @@
-///////////////////////////////////////////////////////////////////////////////
-// maincode.cpp
-// ============
-// gets called when application is launched - initializes GLEW, GLFW
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include <iostream>         // error handling and output
-#include <cstdlib>          // EXIT_FAILURE
-
-#include <GL/glew.h>        // GLEW library
-#include "GLFW/glfw3.h"     // GLFW library
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
-#include "SceneManager.h"
-#include "ViewManager.h"
-#include "ShapeMeshes.h"
-#include "ShaderManager.h"
-
-// Namespace for declaring global variables
-namespace
-{
-	// Macro for window title
-	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
-
-	// Main GLFW window
-	GLFWwindow* g_Window = nullptr;
-
-	// scene manager object for managing the 3D scene prepare and render
-	SceneManager* g_SceneManager = nullptr;
-	// shader manager object for dynamic interaction with the shader code
-	ShaderManager* g_ShaderManager = nullptr;
-	// view manager object for managing the 3D view setup and projection to 2D
-	ViewManager* g_ViewManager = nullptr;
-}
-
-// Function declarations - all functions that are called manually
-// need to be pre-declared at the beginning of the source code.
-bool InitializeGLFW();
-bool InitializeGLEW();
-
-
-/***********************************************************
- *  main(int, char*)
- *
- *  This function gets called after the application has been
- *  launched.
- ***********************************************************/
-int main(int argc, char* argv[])
-{
-	// if GLFW fails initialization, then terminate the application
-	if (InitializeGLFW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// try to create a new shader manager object
-	g_ShaderManager = new ShaderManager();
-	// try to create a new view manager object
-	g_ViewManager = new ViewManager(
-		g_ShaderManager);
-
-	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
-
-	// if GLEW fails initialization, then terminate the application
-	if (InitializeGLEW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// load the shader code from the external GLSL files
-	g_ShaderManager->LoadShaders(
-		"../../Utilities/shaders/vertexShader.glsl",
-		"../../Utilities/shaders/fragmentShader.glsl");
-	g_ShaderManager->use();
-
-	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
-	g_SceneManager->PrepareScene();
-
-	//Added from OpenGLSample
-	std::cout << "\n*** KEY FUNCTIONS: ***\n";
-	std::cout << "ESC - close the window and exit\n";
-	std::cout << "W - zoom in\t" << "S - zoom out\n";
-	std::cout << "A - pan left\t" << "D - pan right\n";
-	std::cout << "Q - pan up\t" << "E - pan down\n";
-	std::cout << "O - front view (ortho)\n";
-	std::cout << "P - perspective view\n";
-
-
-	// loop will keep running until the application is closed 
-	// or until an error has occurred
-	while (!glfwWindowShouldClose(g_Window))
-	{
-		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
-
-		// Clear the frame and z buffers
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
-
-		// refresh the 3D scene
-		g_SceneManager->RenderScene();
-
-
-		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
-
-		// query the latest GLFW events
-		glfwPollEvents();
-	}
-
-	// clear the allocated manager objects from memory
-	if (NULL != g_SceneManager)
-	{
-		delete g_SceneManager;
-		g_SceneManager = NULL;
-	}
-	if (NULL != g_ViewManager)
-	{
-		delete g_ViewManager;
-		g_ViewManager = NULL;
-	}
-	if (NULL != g_ShaderManager)
-	{
-		delete g_ShaderManager;
-		g_ShaderManager = NULL;
-	}
-
-	// Terminates the program successfully
-	exit(EXIT_SUCCESS); 
-}
-
-/***********************************************************
- *	InitializeGLFW()
- * 
- *  This function is used to initialize the GLFW library.   
- ***********************************************************/
-bool InitializeGLFW()
-{
-	// GLFW: initialize and configure library
-	// --------------------------------------
-	glfwInit();
-
-#ifdef __APPLE__
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#else
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#endif
-	// GLFW: end -------------------------------
-
-	return(true);
-}
-
-/***********************************************************
- *	InitializeGLEW()
- *
- *  This function is used to initialize the GLEW library.
- ***********************************************************/
-bool InitializeGLEW()
-{
-	// GLEW: initialize
-	// -----------------------------------------
-	GLenum GLEWInitResult = GLEW_OK;
-
-	// try to initialize the GLEW library
-	GLEWInitResult = glewInit();
-	if (GLEW_OK != GLEWInitResult)
-	{
-		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
-		return false;
-	}
-	// GLEW: end -------------------------------
-
-	// Displays a successful OpenGL initialization message
-	std::cout << "INFO: OpenGL Successfully Initialized\n";
-	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
-
-	return(true);
-}
\ No newline at end of file
+///////////////////////////////////////////////////////////////////////////////
+// maincode.cpp
+// ============
+// gets called when application is launched - initializes GLEW, GLFW
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>         // error handling and output
+#include <cstdlib>          // EXIT_FAILURE
+#include <cstring>          // strcmp
+#include <algorithm>        // std::min, std::max
+
+#include <GL/glew.h>        // GLEW library
+#include "GLFW/glfw3.h"     // GLFW library
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "SceneManager.h"
+#include "SceneFile.h"
+#include "ViewManager.h"
+#include "ShapeMeshes.h"
+#include "ShaderManager.h"
+#include "FrameCapture.h"
+#include "CameraPath.h"
+#include "Benchmark.h"
+#include "GPUProfiler.h"
+#include "CPUProfiler.h"
+#include "JobSystem.h"
+#include "FramePacer.h"
+#include "HotReloader.h"
+#include "ShaderCache.h"
+#include "ShaderVariants.h"
+#include "TextureStreamer.h"
+#include "TextureAtlas.h"
+#include "SamplerCache.h"
+#include "MeshLibrary.h"
+#include "MeshImporter.h"
+#include "RenderTargetPool.h"
+#include "DynamicResolution.h"
+#include "AntiAliasing.h"
+#include "PostEffects.h"
+
+// Namespace for declaring global variables
+namespace
+{
+	// Macro for window title
+	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
+
+	// Main GLFW window
+	GLFWwindow* g_Window = nullptr;
+
+	// scene manager object for managing the 3D scene prepare and render
+	SceneManager* g_SceneManager = nullptr;
+	// shader manager object for dynamic interaction with the shader code
+	ShaderManager* g_ShaderManager = nullptr;
+	// view manager object for managing the 3D view setup and projection to 2D
+	ViewManager* g_ViewManager = nullptr;
+	// frame capture object for asynchronous readback of rendered frames
+	FrameCapture* g_FrameCapture = nullptr;
+	// job system object for spreading frame work across the cores
+	JobSystem* g_JobSystem = nullptr;
+
+	// command line options
+	bool g_bHeadless = false;
+	bool g_bCapture = false;
+	int g_MaxFrames = 0;
+	FrameCapture::CAPTURE_SETTINGS g_CaptureSettings = {
+		FrameCapture::capture_png, ".", 3, 2, 8 };
+	bool g_bBenchmark = false;
+	Benchmark::BENCHMARK_SETTINGS g_BenchmarkSettings = {
+		60, 600, 1.0f / 60.0f, "", "" };
+	std::string g_RecordPathFile;
+	int g_GeneratedObjects = 0;
+	unsigned int g_SceneSeed = 1;
+	std::string g_SceneFile;
+	std::string g_SaveSceneFile;
+	std::string g_CompileSceneInput;
+	std::string g_CompileSceneOutput;
+	std::vector<int> g_SweepCounts;
+	bool g_bGPUProfile = false;
+	std::string g_GPUTraceFile;
+	std::string g_CPUTraceFile;
+	int g_ThreadCount = 0;
+	bool g_bBenchmarkJobs = false;
+	float g_SimulationRate = 120.0f;
+	FramePacer::PACER_SETTINGS g_PacerSettings = {
+		FramePacer::present_vsync, 0.0f, 2 };
+	bool g_bIdleRendering = true;
+	bool g_bHotReload = true;
+	bool g_bShaderCache = true;
+	std::string g_ShaderCacheDirectory = "shadercache";
+
+	bool g_bShaderVariants = true;
+
+	// program binaries saved from earlier runs
+	ShaderCache g_ShaderCache;
+	// shader sources, read once for the main program and the variants
+	std::string g_VertexShaderSource;
+	std::string g_FragmentShaderSource;
+	// specialized programs for each combination of draw state
+	ShaderVariants* g_ShaderVariants = nullptr;
+	// streams texture mip levels within a video memory budget
+	TextureStreamer* g_TextureStreamer = nullptr;
+	bool g_bTextureStreaming = true;
+	int g_TextureBudgetMB = 256;
+	// packs the small textures into shared atlas pages
+	TextureAtlas* g_TextureAtlas = nullptr;
+	bool g_bTextureAtlas = true;
+	// sampler objects for the texture filtering presets
+	SamplerCache* g_SamplerCache = nullptr;
+	int g_TextureFilter = SceneManager::filter_anisotropic;
+	float g_MaxAnisotropy = 8.0f;
+	bool g_bFilterSweep = false;
+	// imported meshes drawn besides the basic shapes
+	MeshLibrary* g_MeshLibrary = nullptr;
+	std::string g_MeshPackFile;
+	std::string g_ImportMeshOutput;
+	std::vector<std::string> g_ImportMeshInputs;
+	// generated basic shapes, cached on disk
+	bool g_bPrimitiveLibrary = true;
+	PrimitiveLibrary::PRIMITIVE_SETTINGS g_PrimitiveSettings = PrimitiveLibrary::GetDefaultSettings();
+	std::string g_MeshCacheDirectory = "meshcache";
+	// the camera and the orthographic front view side by side,
+	// drawn from one culled and sorted list
+	bool g_bSplitScreen = false;
+	std::vector<SceneManager::SCENE_VIEW> g_SceneViews;
+	// reverse depth into a floating point depth buffer, which
+	// the window cannot have, so the scene is drawn offscreen
+	bool g_bReverseDepth = false;
+	bool g_bInfiniteFar = false;
+	float g_FarPlane = 100.0f;
+	bool g_bDepthTestScene = false;
+	// render targets for the offscreen passes, and whether the
+	// scene is drawn offscreen because reverse depth, dynamic
+	// resolution, anti-aliasing or post effects need it
+	RenderTargetPool* g_RenderTargetPool = nullptr;
+	bool g_bOffscreenScene = false;
+	GLenum g_SceneDepthFormat = GL_DEPTH_COMPONENT24;
+	GLenum g_SceneColorFormat = GL_RGBA8;
+	// scene resolution that follows the GPU frame time
+	DynamicResolution* g_DynamicResolution = nullptr;
+	bool g_bDynamicResolution = false;
+	DynamicResolution::RESOLUTION_SETTINGS g_ResolutionSettings = { 16.0f, 0.5f, 1.0f, 0.5f };
+	// anti-aliasing of the offscreen scene
+	AntiAliasing* g_AntiAliasing = nullptr;
+	AntiAliasing::ANTIALIASING_SETTINGS g_AntiAliasingSettings = {
+		AntiAliasing::aa_none, 4, 0.1f, false };
+	bool g_bAntiAliasingSweep = false;
+	// tonemapping, bloom, color grading and vignette
+	PostEffects* g_PostEffects = nullptr;
+	PostEffects::POST_SETTINGS g_PostSettings = {
+		0, 1.0f, 1.0f, 0.2f, 1.1f, 1.05f, 0.35f };
+	// launch time, for reporting the time to the first frame
+	double g_LaunchTime = 0.0;
+
+	// shader source files, also watched by the hot reload
+	const char* g_VertexShaderFile = "../../Utilities/shaders/vertexShader.glsl";
+	const char* g_FragmentShaderFile = "../../Utilities/shaders/fragmentShader.glsl";
+	// directory of the texture image files
+	const char* g_TextureDirectory = "textures";
+
+	// longest time the loop sleeps while idle before checking
+	// for changes made without any window event
+	const double IDLE_WAIT_SECONDS = 0.25;
+	// most frames drawn after the last change while waiting for
+	// the dynamic resolution to settle, in case its GPU times
+	// never arrive
+	const int MAX_SETTLE_FRAMES = 120;
+}
+
+// Function declarations - all functions that are called manually
+// need to be pre-declared at the beginning of the source code.
+bool InitializeGLFW();
+bool InitializeGLEW();
+bool InitializeReverseDepth();
+bool ParseCommandLine(int argc, char* argv[]);
+bool LoadStartupShaders();
+bool IsFrameSettled(int framesSinceChange);
+void RenderFrame();
+
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function gets called after the application has been
+ *  launched.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	g_LaunchTime = FramePacer::NowSeconds();
+
+	// if the command line is not valid, then terminate the application
+	if (ParseCommandLine(argc, argv) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// the job system benchmark needs no window or OpenGL context
+	if (g_bBenchmarkJobs == true)
+	{
+		bool bResult = Benchmark::RunJobSystemBenchmark(g_ThreadCount, g_BenchmarkSettings.outputFile);
+		return((bResult == true) ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	// importing meshes is done offline, without a window
+	if (g_ImportMeshOutput.size() > 0)
+	{
+		MeshImporter importer;
+		bool bResult = true;
+		for (size_t i = 0; (bResult == true) && (i < g_ImportMeshInputs.size()); i++)
+		{
+			bResult = importer.ImportFile(g_ImportMeshInputs[i].c_str());
+		}
+		if (bResult == true)
+		{
+			bResult = importer.SavePack(g_ImportMeshOutput.c_str());
+		}
+		return((bResult == true) ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	// compiling or decompiling a scene file needs no window either
+	if (g_CompileSceneInput.size() > 0)
+	{
+		// the mesh names of the pack are resolved without uploading it
+		MeshLibrary meshLibrary;
+		if (g_MeshPackFile.size() > 0)
+		{
+			if (meshLibrary.Load(g_MeshPackFile.c_str()) == false)
+			{
+				return(EXIT_FAILURE);
+			}
+			SceneFile::SetMeshLibrary(&meshLibrary);
+		}
+		SceneFile sceneFile;
+		bool bResult = sceneFile.Load(g_CompileSceneInput.c_str());
+		if (bResult == true)
+		{
+			bResult = sceneFile.Save(g_CompileSceneOutput.c_str());
+		}
+		if (bResult == true)
+		{
+			std::cout << "INFO: Compiled " << g_CompileSceneInput << " into " << g_CompileSceneOutput << std::endl;
+		}
+		return((bResult == true) ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	// if GLFW fails initialization, then terminate the application
+	if (InitializeGLFW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// in headless mode the window is never shown and only
+	// provides the OpenGL context to render into
+	if (g_bHeadless == true)
+	{
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	}
+
+	// try to create a new shader manager object
+	g_ShaderManager = new ShaderManager();
+	// try to create a new view manager object
+	g_ViewManager = new ViewManager(
+		g_ShaderManager);
+
+	// try to create the main display window
+	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+
+	// if GLEW fails initialization, then terminate the application
+	if (InitializeGLEW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	CPU_PROFILE_THREAD("Main");
+
+	// map depth in reverse, falling back to the usual mapping
+	// when the driver cannot
+	if ((g_bReverseDepth == true) && (InitializeReverseDepth() == false))
+	{
+		g_bReverseDepth = false;
+	}
+	g_ViewManager->SetDepthRange(g_bReverseDepth, g_bInfiniteFar, g_FarPlane);
+
+	// draw the scene with fewer pixels while the GPU is over
+	// budget - the budget is checked with the GPU profiler
+	if (g_bDynamicResolution == true)
+	{
+		g_DynamicResolution = new DynamicResolution();
+		if (g_DynamicResolution->Initialize(g_ResolutionSettings) == true)
+		{
+			GPUProfiler::Get().SetEnabled(true);
+		}
+		else
+		{
+			delete g_DynamicResolution;
+			g_DynamicResolution = NULL;
+		}
+	}
+	// smooth the edges of the scene - TAA reprojects the whole
+	// image with the camera, which the split screen's front
+	// view does not follow
+	if ((g_bSplitScreen == true) && (g_AntiAliasingSettings.mode == AntiAliasing::aa_taa))
+	{
+		std::cout << "INFO: TAA cannot follow the split screen views, using FXAA" << std::endl;
+		g_AntiAliasingSettings.mode = AntiAliasing::aa_fxaa;
+	}
+	if ((g_AntiAliasingSettings.mode != AntiAliasing::aa_none) || (g_bAntiAliasingSweep == true))
+	{
+		g_AntiAliasingSettings.bZeroToOneDepth = g_bReverseDepth;
+		g_AntiAliasing = new AntiAliasing();
+		if (g_AntiAliasing->Initialize(g_AntiAliasingSettings) == false)
+		{
+			delete g_AntiAliasing;
+			g_AntiAliasing = NULL;
+		}
+	}
+	// the post effects may need the scene in floating point
+	if (g_PostSettings.effects != 0)
+	{
+		g_PostEffects = new PostEffects();
+		if (g_PostEffects->Initialize(g_PostSettings) == true)
+		{
+			g_SceneColorFormat = g_PostEffects->GetSceneColorFormat();
+		}
+		else
+		{
+			delete g_PostEffects;
+			g_PostEffects = NULL;
+		}
+	}
+	g_RenderTargetPool = new RenderTargetPool();
+	g_bOffscreenScene = (g_bReverseDepth == true) || (NULL != g_DynamicResolution) ||
+		(NULL != g_AntiAliasing) || (NULL != g_PostEffects);
+
+	// load the shader program from the cache, or compile it from
+	// the external GLSL files
+	if (LoadStartupShaders() == false)
+	{
+		CPU_PROFILE_ZONE("LoadShaders");
+		g_ShaderManager->LoadShaders(
+			g_VertexShaderFile,
+			g_FragmentShaderFile);
+	}
+	g_ShaderManager->use();
+
+	// try to create a new job system object for the worker threads
+	g_JobSystem = new JobSystem(g_ThreadCount);
+
+	// try to create a new scene manager object and prepare the 3D scene
+	g_SceneManager = new SceneManager(g_ShaderManager);
+	g_SceneManager->SetJobSystem(g_JobSystem);
+	g_SceneManager->SetReverseDepth(g_bReverseDepth);
+
+	// stream the textures in from their mip tails - the texture
+	// objects are rebuilt with direct state access and copied
+	// on the GPU, which needs OpenGL 4.5
+	if (g_bTextureStreaming == true)
+	{
+		if ((GLEW_VERSION_4_5) || ((GLEW_ARB_direct_state_access) && (GLEW_ARB_copy_image)))
+		{
+			g_TextureStreamer = new TextureStreamer((size_t)g_TextureBudgetMB * 1024 * 1024, g_JobSystem);
+			g_TextureStreamer->SetWakeFunction([]() { glfwPostEmptyEvent(); });
+			g_SceneManager->SetTextureStreamer(g_TextureStreamer);
+		}
+		else
+		{
+			std::cout << "INFO: Texture streaming needs OpenGL 4.5, loading every level" << std::endl;
+		}
+	}
+	if (g_bTextureAtlas == true)
+	{
+		g_TextureAtlas = new TextureAtlas();
+		g_SceneManager->SetTextureAtlas(g_TextureAtlas);
+	}
+	g_SamplerCache = new SamplerCache();
+	g_SamplerCache->Initialize();
+	g_SamplerCache->SetDefaultFilter(g_TextureFilter);
+	g_SamplerCache->SetMaxAnisotropy(g_MaxAnisotropy);
+	g_SceneManager->SetSamplerCache(g_SamplerCache);
+	if (g_bPrimitiveLibrary == true)
+	{
+		g_SceneManager->UsePrimitiveLibrary(g_PrimitiveSettings, g_MeshCacheDirectory);
+	}
+	if (g_MeshPackFile.size() > 0)
+	{
+		g_MeshLibrary = new MeshLibrary();
+		if ((g_MeshLibrary->Load(g_MeshPackFile.c_str()) == false) || (g_MeshLibrary->Upload() == false))
+		{
+			return(EXIT_FAILURE);
+		}
+		g_SceneManager->SetMeshLibrary(g_MeshLibrary);
+		SceneFile::SetMeshLibrary(g_MeshLibrary);
+	}
+	g_SceneManager->PrepareScene();
+
+	//Added from OpenGLSample
+	std::cout << "\n*** KEY FUNCTIONS: ***\n";
+	std::cout << "ESC - close the window and exit\n";
+	std::cout << "W - zoom in\t" << "S - zoom out\n";
+	std::cout << "A - pan left\t" << "D - pan right\n";
+	std::cout << "Q - pan up\t" << "E - pan down\n";
+	std::cout << "O - front view (ortho)\n";
+	std::cout << "P - perspective view\n";
+
+	// start the asynchronous readback of rendered frames
+	if (g_bCapture == true)
+	{
+		int framebufferWidth = 0;
+		int framebufferHeight = 0;
+		glfwGetFramebufferSize(g_Window, &framebufferWidth, &framebufferHeight);
+
+		g_FrameCapture = new FrameCapture();
+		g_FrameCapture->SetJobSystem(g_JobSystem);
+		if (g_FrameCapture->Initialize(framebufferWidth, framebufferHeight, g_CaptureSettings) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+		// every captured frame must have the size of the first
+		glfwSetWindowAttrib(g_Window, GLFW_RESIZABLE, GLFW_FALSE);
+	}
+
+	// time the render passes on the GPU when requested
+	if (g_bGPUProfile == true)
+	{
+		GPUProfiler::Get().SetEnabled(true);
+	}
+
+	// replace the built-in scene with a loaded or generated one
+	if (g_SceneFile.size() > 0)
+	{
+		if (g_SceneManager->LoadSceneFile(g_SceneFile.c_str()) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+	}
+	else if (g_bDepthTestScene == true)
+	{
+		g_SceneManager->GenerateDepthTestScene();
+	}
+	else if (g_GeneratedObjects > 0)
+	{
+		g_SceneManager->GenerateScene(g_GeneratedObjects, g_SceneSeed);
+	}
+	if (g_SaveSceneFile.size() > 0)
+	{
+		g_SceneManager->SaveSceneFile(g_SaveSceneFile.c_str());
+	}
+
+	// build the shader variants for the lights of the final scene
+	if ((g_bShaderVariants == true) && (g_FragmentShaderSource.size() > 0))
+	{
+		double startTime = FramePacer::NowSeconds();
+		g_ShaderVariants = new ShaderVariants();
+		if (g_ShaderCache.IsEnabled() == true)
+		{
+			g_ShaderVariants->SetShaderCache(&g_ShaderCache);
+		}
+		g_ShaderVariants->SetSources(g_VertexShaderSource, g_FragmentShaderSource);
+		g_SceneManager->SetShaderVariants(g_ShaderVariants);
+		g_SceneManager->PrewarmShaderVariants();
+		std::cout << "INFO: Built " << g_ShaderVariants->GetProgramCount() << " shader variants in "
+			<< 1000.0 * (FramePacer::NowSeconds() - startTime) << " ms" << std::endl;
+	}
+
+	if (g_bAntiAliasingSweep == true)
+	{
+		// benchmark the same frames with each anti-aliasing mode,
+		// timing the passes on the GPU
+		std::vector<int> modes = {
+			AntiAliasing::aa_none,
+			AntiAliasing::aa_msaa,
+			AntiAliasing::aa_fxaa };
+		if (g_bSplitScreen == false)
+		{
+			modes.push_back(AntiAliasing::aa_taa);
+		}
+		GPUProfiler::Get().SetEnabled(true);
+		Benchmark::RunAntiAliasingSweep(g_BenchmarkSettings, modes, g_AntiAliasing,
+			g_Window, g_ViewManager, g_SceneManager, RenderFrame);
+	}
+	else if (g_bFilterSweep == true)
+	{
+		// benchmark the same frames without mipmaps, with
+		// trilinear and with anisotropic filtering
+		const std::vector<int> filters = {
+			SceneManager::filter_bilinear,
+			SceneManager::filter_trilinear,
+			SceneManager::filter_anisotropic };
+		Benchmark::RunFilterSweep(g_BenchmarkSettings, filters, g_SamplerCache,
+			g_Window, g_ViewManager, g_SceneManager, RenderFrame);
+	}
+	else if (g_SweepCounts.size() > 0)
+	{
+		// benchmark a generated scene at each requested size
+		Benchmark::RunSceneSweep(g_BenchmarkSettings, g_SweepCounts, g_SceneSeed,
+			g_Window, g_ViewManager, g_SceneManager, RenderFrame);
+	}
+	else if (g_bBenchmark == true)
+	{
+		// replay the camera path with a fixed timestep and report
+		// the measured frames
+		Benchmark benchmark(g_BenchmarkSettings);
+		if (benchmark.Run(g_Window, g_ViewManager, g_SceneManager, RenderFrame) == true)
+		{
+			benchmark.WriteReport();
+		}
+	}
+	else
+	{
+		// record the live camera when requested
+		CameraPath recordPath;
+		if (g_RecordPathFile.size() > 0)
+		{
+			g_ViewManager->SetRecordPath(&recordPath);
+		}
+
+		// step input and the camera on their own thread so a slow
+		// frame or a blocking swap does not hold them up
+		if (g_SimulationRate > 0.0f)
+		{
+			g_ViewManager->StartSimulation(g_SimulationRate);
+		}
+
+		// pace and present the frames in the requested mode
+		FramePacer pacer;
+		if (pacer.Initialize(g_Window, g_PacerSettings) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+
+		// reload edited scene, texture and shader files in place
+		HotReloader reloader(g_ShaderManager, g_SceneManager, g_JobSystem);
+		if (g_ShaderCache.IsEnabled() == true)
+		{
+			reloader.SetShaderCache(&g_ShaderCache);
+		}
+		if ((g_bHotReload == true) && (g_bHeadless == false))
+		{
+			HotReloader::RELOAD_SETTINGS reloadSettings;
+			reloadSettings.sceneFile = g_SceneFile;
+			reloadSettings.textureDirectory = g_TextureDirectory;
+			reloadSettings.vertexShaderFile = g_VertexShaderFile;
+			reloadSettings.fragmentShaderFile = g_FragmentShaderFile;
+			reloader.Start(reloadSettings, []() { glfwPostEmptyEvent(); });
+		}
+
+		int frameCount = 0;
+
+		// skip drawing while nothing changes - not when every frame
+		// must be produced for capture or for an unattended run
+		bool bIdle = (g_bIdleRendering == true) && (g_bHeadless == false) &&
+			(g_MaxFrames <= 0) && (NULL == g_FrameCapture);
+		unsigned int drawnChangeCount = g_SceneManager->GetChangeCount();
+		int framesSinceChange = 0;
+		double loopStart = FramePacer::NowSeconds();
+		double idleSeconds = 0.0;
+		int idleWaits = 0;
+
+		// loop will keep running until the application is closed 
+		// or until an error has occurred
+		while (!glfwWindowShouldClose(g_Window))
+		{
+			CPU_PROFILE_ZONE("MainLoop");
+
+			// swap in reloaded files and streamed texture levels
+			// between frames
+			reloader.Update();
+			g_SceneManager->UpdateTextureStreaming();
+
+			// the displayed frame is still correct and has settled,
+			// so keep showing it and sleep until an event arrives
+			// instead of drawing
+			if ((bIdle == true) && ((frameCount == 0) ||
+				(g_SceneManager->GetChangeCount() != drawnChangeCount) ||
+				(g_ViewManager->NeedsRedraw() == true)))
+			{
+				framesSinceChange = 0;
+			}
+			if ((bIdle == true) && (framesSinceChange > 0) &&
+				(IsFrameSettled(framesSinceChange) == true))
+			{
+				CPU_PROFILE_ZONE("Idle");
+
+				pacer.SkipFrame();
+				double idleStart = FramePacer::NowSeconds();
+				glfwWaitEventsTimeout(IDLE_WAIT_SECONDS);
+				idleSeconds += FramePacer::NowSeconds() - idleStart;
+				idleWaits++;
+				continue;
+			}
+			// nothing can be drawn while the window is minimized
+			if (g_ViewManager->IsWindowMinimized() == true)
+			{
+				pacer.SkipFrame();
+				glfwWaitEventsTimeout(IDLE_WAIT_SECONDS);
+				continue;
+			}
+			drawnChangeCount = g_SceneManager->GetChangeCount();
+
+			// wait for the GPU to fall within the in-flight limit
+			// and for the frame rate cap
+			pacer.BeginFrame();
+
+			// draw the complete frame into the back buffer
+			RenderFrame();
+
+			// Flips the the back buffer with the front buffer every frame.
+			pacer.Present(g_ViewManager->GetFrameInputTime());
+			if (frameCount == 0)
+			{
+				std::cout << "INFO: Time to first frame "
+					<< 1000.0 * (FramePacer::NowSeconds() - g_LaunchTime) << " ms" << std::endl;
+			}
+
+			// query the latest GLFW events
+			{
+				CPU_PROFILE_ZONE("PollEvents");
+				glfwPollEvents();
+			}
+
+			// stop after the requested number of frames
+			frameCount++;
+			framesSinceChange++;
+			if ((g_MaxFrames > 0) && (frameCount >= g_MaxFrames))
+			{
+				glfwSetWindowShouldClose(g_Window, true);
+			}
+		}
+
+		reloader.Stop();
+		g_ViewManager->StopSimulation();
+		pacer.PrintStats();
+		pacer.Shutdown();
+
+		if (bIdle == true)
+		{
+			double totalSeconds = FramePacer::NowSeconds() - loopStart;
+			std::cout << "INFO: Idle for "
+				<< ((totalSeconds > 0.0) ? 100.0 * idleSeconds / totalSeconds : 0.0)
+				<< "% of " << totalSeconds << " s, " << frameCount << " frames drawn, "
+				<< idleWaits << " idle waits" << std::endl;
+		}
+
+		if (g_RecordPathFile.size() > 0)
+		{
+			g_ViewManager->SetRecordPath(NULL);
+			recordPath.Save(g_RecordPathFile.c_str());
+		}
+	}
+
+	// report the GPU timing while the context is still current
+	if (g_bGPUProfile == true)
+	{
+		GPUProfiler::Get().PrintStats();
+		if (g_GPUTraceFile.size() > 0)
+		{
+			GPUProfiler::Get().WriteChromeTrace(g_GPUTraceFile.c_str());
+		}
+	}
+	GPUProfiler::Get().Shutdown();
+
+	// finish encoding any frames still in flight
+	if (NULL != g_FrameCapture)
+	{
+		delete g_FrameCapture;
+		g_FrameCapture = NULL;
+	}
+
+	// the encoding workers have stopped, so every zone is final
+	if (g_CPUTraceFile.size() > 0)
+	{
+		CPUProfiler::WriteChromeTrace(g_CPUTraceFile.c_str());
+	}
+
+	if (NULL != g_TextureStreamer)
+	{
+		g_TextureStreamer->PrintStats();
+	}
+	if (NULL != g_DynamicResolution)
+	{
+		g_DynamicResolution->PrintStats();
+	}
+	if (NULL != g_AntiAliasing)
+	{
+		g_AntiAliasing->PrintStats();
+	}
+
+	// clear the allocated manager objects from memory
+	if (NULL != g_SceneManager)
+	{
+		delete g_SceneManager;
+		g_SceneManager = NULL;
+	}
+	if (NULL != g_TextureStreamer)
+	{
+		delete g_TextureStreamer;
+		g_TextureStreamer = NULL;
+	}
+	if (NULL != g_TextureAtlas)
+	{
+		delete g_TextureAtlas;
+		g_TextureAtlas = NULL;
+	}
+	if (NULL != g_SamplerCache)
+	{
+		delete g_SamplerCache;
+		g_SamplerCache = NULL;
+	}
+	if (NULL != g_RenderTargetPool)
+	{
+		g_RenderTargetPool->PrintStats();
+		delete g_RenderTargetPool;
+		g_RenderTargetPool = NULL;
+	}
+	if (NULL != g_DynamicResolution)
+	{
+		delete g_DynamicResolution;
+		g_DynamicResolution = NULL;
+	}
+	if (NULL != g_AntiAliasing)
+	{
+		delete g_AntiAliasing;
+		g_AntiAliasing = NULL;
+	}
+	if (NULL != g_PostEffects)
+	{
+		delete g_PostEffects;
+		g_PostEffects = NULL;
+	}
+	if (NULL != g_MeshLibrary)
+	{
+		SceneFile::SetMeshLibrary(NULL);
+		delete g_MeshLibrary;
+		g_MeshLibrary = NULL;
+	}
+	if (NULL != g_ShaderVariants)
+	{
+		delete g_ShaderVariants;
+		g_ShaderVariants = NULL;
+	}
+	if (NULL != g_ViewManager)
+	{
+		delete g_ViewManager;
+		g_ViewManager = NULL;
+	}
+	if (NULL != g_ShaderManager)
+	{
+		delete g_ShaderManager;
+		g_ShaderManager = NULL;
+	}
+	if (NULL != g_JobSystem)
+	{
+		delete g_JobSystem;
+		g_JobSystem = NULL;
+	}
+
+	// Terminates the program successfully
+	exit(EXIT_SUCCESS); 
+}
+
+/***********************************************************
+ *  IsFrameSettled()
+ *
+ *  This function is used for deciding whether drawing more
+ *  frames of an unchanged view would still change the image.
+ *  TAA keeps converging for a number of frames after the
+ *  view stops, and the dynamic resolution keeps adjusting
+ *  its scale until a GPU time measured at the scale leaves
+ *  it where it is.
+ ***********************************************************/
+bool IsFrameSettled(int framesSinceChange)
+{
+	if ((NULL != g_AntiAliasing) && (framesSinceChange < g_AntiAliasing->GetSettleFrames()))
+	{
+		return(false);
+	}
+	if ((NULL != g_DynamicResolution) && (g_DynamicResolution->IsSettled() == false) &&
+		(framesSinceChange < MAX_SETTLE_FRAMES))
+	{
+		return(false);
+	}
+	return(true);
+}
+
+/***********************************************************
+ *	RenderFrame()
+ *
+ *  This function is used to draw one complete frame of the
+ *  3D scene into the back buffer.
+ ***********************************************************/
+void RenderFrame()
+{
+	CPU_PROFILE_ZONE("RenderFrame");
+
+	int framebufferWidth = 0;
+	int framebufferHeight = 0;
+	g_ViewManager->GetFramebufferSize(framebufferWidth, framebufferHeight);
+
+	// draw into an offscreen target of the window's size, taken
+	// from the pool so a resize creates it anew - with dynamic
+	// resolution only its lower left corner is drawn, and with
+	// MSAA it is multisampled
+	int renderWidth = framebufferWidth;
+	int renderHeight = framebufferHeight;
+	RenderTarget* pSceneTarget = NULL;
+	if ((g_bOffscreenScene == true) && (framebufferWidth > 0) && (framebufferHeight > 0))
+	{
+		RenderTargetPool::TARGET_DESC desc;
+		desc.width = framebufferWidth;
+		desc.height = framebufferHeight;
+		desc.colorFormat = g_SceneColorFormat;
+		desc.depthFormat = g_SceneDepthFormat;
+		desc.samples = (NULL != g_AntiAliasing) ? g_AntiAliasing->GetSceneSamples() : 1;
+		pSceneTarget = g_RenderTargetPool->Acquire(desc);
+		if ((NULL != pSceneTarget) && (NULL != g_DynamicResolution))
+		{
+			g_DynamicResolution->Update("Frame");
+			g_DynamicResolution->GetRenderSize(framebufferWidth, framebufferHeight, renderWidth, renderHeight);
+		}
+	}
+
+	// TAA moves the projection by part of a pixel every frame
+	if (NULL != g_AntiAliasing)
+	{
+		glm::vec2 jitter(0.0f);
+		if (NULL != pSceneTarget)
+		{
+			jitter = g_AntiAliasing->BeginFrame(renderWidth, renderHeight);
+		}
+		g_ViewManager->SetProjectionJitter(jitter);
+	}
+
+	GPUProfiler& profiler = GPUProfiler::Get();
+	profiler.BeginFrame();
+	profiler.BeginScope("Frame");
+
+	if (NULL != pSceneTarget)
+	{
+		pSceneTarget->Bind(renderWidth, renderHeight);
+	}
+	else
+	{
+		glViewport(0, 0, framebufferWidth, framebufferHeight);
+	}
+
+	// Enable z-depth
+	glEnable(GL_DEPTH_TEST);
+
+	// Clear the frame and z buffers
+	profiler.BeginScope("Clear");
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	profiler.EndScope();
+
+	// convert from 3D object space to 2D view
+	profiler.BeginScope("PrepareSceneView");
+	g_ViewManager->PrepareSceneView();
+	g_SceneManager->SetCullingFrustum(
+		g_ViewManager->GetProjectionMatrix() * g_ViewManager->GetViewMatrix());
+	g_SceneManager->SetTextureStreamingView(
+		g_ViewManager->GetViewMatrix(), g_ViewManager->GetProjectionMatrix(), renderHeight);
+	if ((g_bSplitScreen == true) && (renderWidth > 1) && (renderHeight > 0))
+	{
+		// the camera on the left half, the front view on the right
+		int halfWidth = renderWidth / 2;
+		float aspect = (float)halfWidth / (float)renderHeight;
+		g_SceneViews.resize(2);
+		for (int i = 0; i < 2; i++)
+		{
+			SceneManager::SCENE_VIEW& sceneView = g_SceneViews[i];
+			sceneView.x = i * halfWidth;
+			sceneView.y = 0;
+			sceneView.width = (i == 0) ? halfWidth : renderWidth - halfWidth;
+			sceneView.height = renderHeight;
+		}
+		g_ViewManager->GetCameraView(aspect,
+			g_SceneViews[0].view, g_SceneViews[0].projection, g_SceneViews[0].position);
+		g_ViewManager->GetFrontView(aspect,
+			g_SceneViews[1].view, g_SceneViews[1].projection, g_SceneViews[1].position);
+		g_SceneManager->SetSceneViews(g_SceneViews);
+	}
+	profiler.EndScope();
+
+	// refresh the 3D scene
+	profiler.BeginScope("RenderScene");
+	g_SceneManager->RenderScene();
+	profiler.EndScope();
+
+	// anti-alias the offscreen frame and run the post effects,
+	// then copy it into the back buffer, scaling it up when it
+	// was drawn smaller
+	if (NULL != pSceneTarget)
+	{
+		RenderTarget* pImage = pSceneTarget;
+		if (NULL != g_AntiAliasing)
+		{
+			pImage = g_AntiAliasing->Resolve(*g_RenderTargetPool, *pSceneTarget, renderWidth, renderHeight,
+				g_ViewManager->GetUnjitteredProjectionMatrix() * g_ViewManager->GetViewMatrix());
+		}
+		if (NULL != g_PostEffects)
+		{
+			pImage = g_PostEffects->Apply(*g_RenderTargetPool, *pImage, renderWidth, renderHeight);
+		}
+
+		profiler.BeginScope("Copy To Window");
+		if (NULL != g_DynamicResolution)
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			g_DynamicResolution->Upscale(*pImage, renderWidth, renderHeight, framebufferWidth, framebufferHeight);
+		}
+		else
+		{
+			pImage->BlitColor(0, framebufferWidth, framebufferHeight);
+		}
+		profiler.EndScope();
+
+		if (NULL != g_PostEffects)
+		{
+			g_PostEffects->EndFrame(*g_RenderTargetPool);
+		}
+		if (NULL != g_AntiAliasing)
+		{
+			g_AntiAliasing->EndFrame(*g_RenderTargetPool);
+		}
+		g_RenderTargetPool->Release(pSceneTarget);
+	}
+	g_RenderTargetPool->EndFrame();
+
+	// read back the finished frame before it is presented
+	if (NULL != g_FrameCapture)
+	{
+		profiler.BeginScope("Capture");
+		glReadBuffer(GL_BACK);
+		g_FrameCapture->CaptureFrame();
+		profiler.EndScope();
+	}
+
+	profiler.EndScope();
+	profiler.EndFrame();
+}
+
+/***********************************************************
+ *	InitializeGLFW()
+ * 
+ *  This function is used to initialize the GLFW library.   
+ ***********************************************************/
+bool InitializeGLFW()
+{
+	// GLFW: initialize and configure library
+	// --------------------------------------
+	glfwInit();
+
+#ifdef __APPLE__
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#else
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#endif
+	// GLFW: end -------------------------------
+
+	return(true);
+}
+
+/***********************************************************
+ *	InitializeGLEW()
+ *
+ *  This function is used to initialize the GLEW library.
+ ***********************************************************/
+bool InitializeGLEW()
+{
+	// GLEW: initialize
+	// -----------------------------------------
+	GLenum GLEWInitResult = GLEW_OK;
+
+	// try to initialize the GLEW library
+	GLEWInitResult = glewInit();
+	if (GLEW_OK != GLEWInitResult)
+	{
+		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
+		return false;
+	}
+	// GLEW: end -------------------------------
+
+	// Displays a successful OpenGL initialization message
+	std::cout << "INFO: OpenGL Successfully Initialized\n";
+	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
+
+	// let the driver compile shaders on its own threads
+	if (ShaderCompiler::EnableParallelCompile() == true)
+	{
+		std::cout << "INFO: Compiling shaders in parallel" << std::endl;
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *	InitializeReverseDepth()
+ *
+ *  This function is used to map the near plane to a depth of
+ *  one and the far plane to zero.  The clip range becomes
+ *  zero to one, so the precision of a floating point depth
+ *  buffer is not lost around the middle of the range, and
+ *  the depth test and clear value are reversed.  The window
+ *  has no floating point depth buffer, so the scene is drawn
+ *  into a render target.
+ ***********************************************************/
+bool InitializeReverseDepth()
+{
+	if (!(GLEW_VERSION_4_5) && !(GLEW_ARB_clip_control))
+	{
+		std::cout << "INFO: Reverse depth needs glClipControl, using the usual depth mapping" << std::endl;
+		return(false);
+	}
+
+	g_SceneDepthFormat = GL_DEPTH_COMPONENT32F;
+	glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+	glDepthFunc(GL_GREATER);
+	glClearDepth(0.0);
+
+	std::cout << "INFO: Reverse depth into a 32-bit floating point depth buffer"
+		<< ((g_bInfiniteFar == true) ? " with an infinite far plane" : "") << std::endl;
+	return(true);
+}
+
+/***********************************************************
+ *	LoadStartupShaders()
+ *
+ *  This function is used to read the shader sources, and to
+ *  create the shader program from the shader cache or compile
+ *  it and save it there.  It returns false when the program
+ *  should be loaded the usual way instead, which reports its
+ *  own errors.
+ ***********************************************************/
+bool LoadStartupShaders()
+{
+	CPU_PROFILE_ZONE("LoadStartupShaders");
+
+	double startTime = FramePacer::NowSeconds();
+	if ((ShaderCompiler::ReadSourceFile(g_VertexShaderFile, g_VertexShaderSource) == false) ||
+		(ShaderCompiler::ReadSourceFile(g_FragmentShaderFile, g_FragmentShaderSource) == false))
+	{
+		g_VertexShaderSource.clear();
+		g_FragmentShaderSource.clear();
+		return(false);
+	}
+
+	if ((g_bShaderCache == false) ||
+		(g_ShaderCache.Initialize(g_ShaderCacheDirectory) == false))
+	{
+		return(false);
+	}
+
+	std::string log;
+	GLuint program = g_ShaderCache.BuildProgram(g_VertexShaderSource, g_FragmentShaderSource, log);
+	if (program == 0)
+	{
+		std::cout << "Could not build shaders:\n" << log << std::endl;
+		return(false);
+	}
+	g_ShaderManager->m_programID = program;
+
+	std::cout << "INFO: Shaders "
+		<< ((g_ShaderCache.GetHitCount() > 0) ? "loaded from the cache" : "compiled")
+		<< " in " << 1000.0 * (FramePacer::NowSeconds() - startTime) << " ms" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *	ParseCommandLine()
+ *
+ *  This function is used to read the command line options.
+ *
+ *  --headless            render without showing the window
+ *  --frames N            exit after N frames
+ *  --capture DIR         write every frame to DIR as PNG
+ *  --capture-raw DIR     write every frame to DIR as raw RGBA
+ *  --capture-pipe CMD    pipe raw RGBA frames into CMD
+ *  --capture-threads N   number of encoding threads, used for pipe
+ *                        output or when the job system has one worker
+ *  --benchmark           run the deterministic benchmark
+ *  --warmup N            benchmark warm-up frames
+ *  --measure N           benchmark measured frames
+ *  --timestep SECONDS    benchmark fixed timestep
+ *  --camera-path FILE    benchmark camera path to replay
+ *  --benchmark-out FILE  benchmark JSON report file
+ *  --record-path FILE    record the live camera into FILE
+ *  --present MODE        vsync, adaptive, uncapped or capped
+ *  --fps-cap N           cap the frame rate at N, implies capped
+ *  --frames-in-flight N  frames the CPU may run ahead of the GPU
+ *  --no-idle             draw every frame even when nothing changed
+ *  --no-hot-reload       do not reload edited scene, texture and
+ *                        shader files
+ *  --shader-cache DIR    keep program binaries in DIR, by default
+ *                        shadercache
+ *  --no-shader-cache     always compile the shaders from source
+ *  --no-shader-variants  draw everything with the main shader
+ *                        program, branching on the draw state
+ *  --texture-budget MB   video memory for streamed texture levels,
+ *                        256 by default
+ *  --no-texture-streaming
+ *                        upload every level of every texture
+ *  --no-texture-atlas    draw every texture from its own slot
+ *                        instead of packing the small ones
+ *  --texture-filter MODE bilinear, trilinear or anisotropic, for
+ *                        materials that do not choose one
+ *  --anisotropy N        samples of anisotropic filtering, 8 by
+ *                        default
+ *  --sim-rate HZ         input and camera steps per second on the
+ *                        simulation thread, 0 to update them per frame
+ *  --threads N           worker threads, 0 for one per core
+ *  --bench-jobs          benchmark the job system from one worker
+ *                        up to --threads, then exit
+ *  --generate N          replace the scene with N generated objects
+ *  --seed N              random seed of the generated scene
+ *  --scene FILE          load the scene from a text or compiled
+ *                        scene file
+ *  --save-scene FILE     save the generated or loaded scene, as
+ *                        text when FILE ends in .json
+ *  --compile-scene IN OUT
+ *                        convert a scene file to the compiled
+ *                        form, or to text when OUT ends in .json,
+ *                        then exit
+ *  --mesh-pack FILE      draw the meshes of a pack, by their names
+ *                        in scene files
+ *  --mesh-cache DIR      keep the generated basic shapes in DIR, by
+ *                        default meshcache
+ *  --primitive-segments N
+ *                        divisions around the round basic shapes,
+ *                        36 by default
+ *  --no-primitive-library
+ *                        draw the scene objects with the shape meshes
+ *                        instead of the cached generated shapes
+ *  --import-meshes OUT IN,IN,...
+ *                        import OBJ and glTF files into the mesh
+ *                        pack OUT, then exit
+ *  --split-screen        show the camera and the orthographic front
+ *                        view side by side
+ *  --reverse-z           map depth in reverse into a floating point
+ *                        depth buffer, for even precision at any
+ *                        distance
+ *  --infinite-far        put the perspective far plane at infinity,
+ *                        implies --reverse-z
+ *  --far-plane DISTANCE  far plane distance, 100 by default
+ *  --depth-test-scene    replace the scene with panels that show
+ *                        where depth precision runs out
+ *  --dynamic-resolution MS
+ *                        lower the scene resolution while a frame
+ *                        takes more than MS on the GPU
+ *  --min-resolution N    lowest part of the window size the scene
+ *                        is drawn with, 0.5 by default
+ *  --sharpness N         sharpening of the upscaled scene, 0 to 1,
+ *                        0.5 by default
+ *  --aa MODE             anti-aliasing of the scene - none, msaa,
+ *                        fxaa or taa
+ *  --msaa-samples N      samples per pixel for msaa, 4 by default
+ *  --taa-blend N         weight of the new frame in the taa
+ *                        history, 0.1 by default
+ *  --aa-sweep            benchmark the scene with each anti-aliasing
+ *                        mode, with the GPU time of its pass
+ *  --post LIST           post effects, a comma separated list of
+ *                        tonemap, bloom, grading and vignette, or all
+ *  --exposure N          scene exposure before tonemapping, 1 by
+ *                        default
+ *  --bloom-threshold N   brightness the bloom starts at, 1 by default
+ *  --bloom-intensity N   strength of the bloom, 0.2 by default
+ *  --saturation N        color grading saturation, 1.1 by default
+ *  --contrast N          color grading contrast, 1.05 by default
+ *  --vignette N          darkening of the corners, 0 to 1, 0.35 by
+ *                        default
+ *  --sweep N,N,...       benchmark generated scenes of each size
+ *  --filter-sweep        benchmark the scene with bilinear,
+ *                        trilinear and anisotropic filtering
+ *  --gpu-profile         time render passes on the GPU
+ *  --gpu-trace FILE      also save the GPU timing as a Chrome trace
+ *  --cpu-trace FILE      save the CPU zones as a Chrome trace - needs
+ *                        a build with ENABLE_CPU_PROFILER defined
+ ***********************************************************/
+bool ParseCommandLine(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		// every option except the on/off switches takes a value
+		bool bHasValue = (i + 1 < argc);
+
+		if (strcmp(argv[i], "--headless") == 0)
+		{
+			g_bHeadless = true;
+		}
+		else if ((strcmp(argv[i], "--frames") == 0) && bHasValue)
+		{
+			g_MaxFrames = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--capture") == 0) && bHasValue)
+		{
+			g_bCapture = true;
+			g_CaptureSettings.format = FrameCapture::capture_png;
+			g_CaptureSettings.output = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--capture-raw") == 0) && bHasValue)
+		{
+			g_bCapture = true;
+			g_CaptureSettings.format = FrameCapture::capture_raw;
+			g_CaptureSettings.output = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--capture-pipe") == 0) && bHasValue)
+		{
+			g_bCapture = true;
+			g_CaptureSettings.format = FrameCapture::capture_pipe;
+			g_CaptureSettings.output = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--capture-threads") == 0) && bHasValue)
+		{
+			g_CaptureSettings.workerThreads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--benchmark") == 0)
+		{
+			g_bBenchmark = true;
+		}
+		else if ((strcmp(argv[i], "--warmup") == 0) && bHasValue)
+		{
+			g_BenchmarkSettings.warmupFrames = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--measure") == 0) && bHasValue)
+		{
+			g_BenchmarkSettings.measuredFrames = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--timestep") == 0) && bHasValue)
+		{
+			g_BenchmarkSettings.timestep = (float)atof(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--camera-path") == 0) && bHasValue)
+		{
+			g_BenchmarkSettings.pathFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--benchmark-out") == 0) && bHasValue)
+		{
+			g_BenchmarkSettings.outputFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--record-path") == 0) && bHasValue)
+		{
+			g_RecordPathFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--present") == 0) && bHasValue)
+		{
+			const char* mode = argv[++i];
+			if (strcmp(mode, "vsync") == 0)
+			{
+				g_PacerSettings.mode = FramePacer::present_vsync;
+			}
+			else if (strcmp(mode, "adaptive") == 0)
+			{
+				g_PacerSettings.mode = FramePacer::present_adaptive;
+			}
+			else if (strcmp(mode, "uncapped") == 0)
+			{
+				g_PacerSettings.mode = FramePacer::present_uncapped;
+			}
+			else if (strcmp(mode, "capped") == 0)
+			{
+				g_PacerSettings.mode = FramePacer::present_capped;
+			}
+			else
+			{
+				std::cerr << "Unknown --present mode: " << mode << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--fps-cap") == 0) && bHasValue)
+		{
+			g_PacerSettings.mode = FramePacer::present_capped;
+			g_PacerSettings.frameRateCap = (float)atof(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--frames-in-flight") == 0) && bHasValue)
+		{
+			g_PacerSettings.maxFramesInFlight = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--no-idle") == 0)
+		{
+			g_bIdleRendering = false;
+		}
+		else if (strcmp(argv[i], "--no-hot-reload") == 0)
+		{
+			g_bHotReload = false;
+		}
+		else if ((strcmp(argv[i], "--shader-cache") == 0) && bHasValue)
+		{
+			g_ShaderCacheDirectory = argv[++i];
+		}
+		else if (strcmp(argv[i], "--no-shader-cache") == 0)
+		{
+			g_bShaderCache = false;
+		}
+		else if (strcmp(argv[i], "--no-shader-variants") == 0)
+		{
+			g_bShaderVariants = false;
+		}
+		else if ((strcmp(argv[i], "--texture-budget") == 0) && bHasValue)
+		{
+			g_TextureBudgetMB = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--no-texture-streaming") == 0)
+		{
+			g_bTextureStreaming = false;
+		}
+		else if (strcmp(argv[i], "--no-texture-atlas") == 0)
+		{
+			g_bTextureAtlas = false;
+		}
+		else if ((strcmp(argv[i], "--texture-filter") == 0) && bHasValue)
+		{
+			g_TextureFilter = SamplerCache::FindFilter(argv[++i]);
+			if (g_TextureFilter <= SceneManager::filter_default)
+			{
+				std::cerr << "Invalid --texture-filter, use bilinear, trilinear or anisotropic" << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--anisotropy") == 0) && bHasValue)
+		{
+			g_MaxAnisotropy = (float)atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--filter-sweep") == 0)
+		{
+			g_bFilterSweep = true;
+		}
+		else if ((strcmp(argv[i], "--sim-rate") == 0) && bHasValue)
+		{
+			g_SimulationRate = (float)atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--gpu-profile") == 0)
+		{
+			g_bGPUProfile = true;
+		}
+		else if ((strcmp(argv[i], "--gpu-trace") == 0) && bHasValue)
+		{
+			g_bGPUProfile = true;
+			g_GPUTraceFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--cpu-trace") == 0) && bHasValue)
+		{
+			g_CPUTraceFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--threads") == 0) && bHasValue)
+		{
+			g_ThreadCount = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--bench-jobs") == 0)
+		{
+			g_bBenchmarkJobs = true;
+		}
+		else if ((strcmp(argv[i], "--generate") == 0) && bHasValue)
+		{
+			g_GeneratedObjects = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--seed") == 0) && bHasValue)
+		{
+			g_SceneSeed = (unsigned int)strtoul(argv[++i], NULL, 10);
+		}
+		else if ((strcmp(argv[i], "--scene") == 0) && bHasValue)
+		{
+			g_SceneFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--save-scene") == 0) && bHasValue)
+		{
+			g_SaveSceneFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--compile-scene") == 0) && (i + 2 < argc))
+		{
+			g_CompileSceneInput = argv[++i];
+			g_CompileSceneOutput = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--mesh-pack") == 0) && bHasValue)
+		{
+			g_MeshPackFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--mesh-cache") == 0) && bHasValue)
+		{
+			g_MeshCacheDirectory = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--primitive-segments") == 0) && bHasValue)
+		{
+			g_PrimitiveSettings.segments = atoi(argv[++i]);
+			g_PrimitiveSettings.rings = g_PrimitiveSettings.segments / 2;
+			if (g_PrimitiveSettings.segments < 3)
+			{
+				std::cerr << "Invalid --primitive-segments count" << std::endl;
+				return(false);
+			}
+		}
+		else if (strcmp(argv[i], "--no-primitive-library") == 0)
+		{
+			g_bPrimitiveLibrary = false;
+		}
+		else if (strcmp(argv[i], "--split-screen") == 0)
+		{
+			g_bSplitScreen = true;
+		}
+		else if (strcmp(argv[i], "--reverse-z") == 0)
+		{
+			g_bReverseDepth = true;
+		}
+		else if (strcmp(argv[i], "--infinite-far") == 0)
+		{
+			g_bReverseDepth = true;
+			g_bInfiniteFar = true;
+		}
+		else if ((strcmp(argv[i], "--far-plane") == 0) && bHasValue)
+		{
+			g_FarPlane = (float)atof(argv[++i]);
+			if (g_FarPlane <= 0.1f)
+			{
+				std::cerr << "Invalid --far-plane distance" << std::endl;
+				return(false);
+			}
+		}
+		else if (strcmp(argv[i], "--depth-test-scene") == 0)
+		{
+			g_bDepthTestScene = true;
+		}
+		else if ((strcmp(argv[i], "--dynamic-resolution") == 0) && bHasValue)
+		{
+			g_bDynamicResolution = true;
+			g_ResolutionSettings.budgetMs = (float)atof(argv[++i]);
+			if (g_ResolutionSettings.budgetMs <= 0.0f)
+			{
+				std::cerr << "Invalid --dynamic-resolution budget" << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--min-resolution") == 0) && bHasValue)
+		{
+			g_ResolutionSettings.minScale = (float)atof(argv[++i]);
+			if ((g_ResolutionSettings.minScale <= 0.0f) || (g_ResolutionSettings.minScale > 1.0f))
+			{
+				std::cerr << "Invalid --min-resolution scale" << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--sharpness") == 0) && bHasValue)
+		{
+			g_ResolutionSettings.sharpness = std::min(std::max((float)atof(argv[++i]), 0.0f), 1.0f);
+		}
+		else if ((strcmp(argv[i], "--aa") == 0) && bHasValue)
+		{
+			g_AntiAliasingSettings.mode = AntiAliasing::FindMode(argv[++i]);
+			if (g_AntiAliasingSettings.mode < 0)
+			{
+				std::cerr << "Invalid --aa, use none, msaa, fxaa or taa" << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--msaa-samples") == 0) && bHasValue)
+		{
+			g_AntiAliasingSettings.msaaSamples = atoi(argv[++i]);
+			if (g_AntiAliasingSettings.msaaSamples < 2)
+			{
+				std::cerr << "Invalid --msaa-samples, use 2 or more" << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--taa-blend") == 0) && bHasValue)
+		{
+			g_AntiAliasingSettings.taaBlend = (float)atof(argv[++i]);
+			if ((g_AntiAliasingSettings.taaBlend <= 0.0f) || (g_AntiAliasingSettings.taaBlend > 1.0f))
+			{
+				std::cerr << "Invalid --taa-blend, use a weight above 0 and up to 1" << std::endl;
+				return(false);
+			}
+		}
+		else if (strcmp(argv[i], "--aa-sweep") == 0)
+		{
+			g_bAntiAliasingSweep = true;
+		}
+		else if ((strcmp(argv[i], "--post") == 0) && bHasValue)
+		{
+			if (PostEffects::ParseEffects(argv[++i], g_PostSettings.effects) == false)
+			{
+				std::cerr << "Invalid --post, use a list of tonemap, bloom, grading and vignette, or all" << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--exposure") == 0) && bHasValue)
+		{
+			g_PostSettings.exposure = std::max((float)atof(argv[++i]), 0.0f);
+		}
+		else if ((strcmp(argv[i], "--bloom-threshold") == 0) && bHasValue)
+		{
+			g_PostSettings.bloomThreshold = std::max((float)atof(argv[++i]), 0.0f);
+		}
+		else if ((strcmp(argv[i], "--bloom-intensity") == 0) && bHasValue)
+		{
+			g_PostSettings.bloomIntensity = std::max((float)atof(argv[++i]), 0.0f);
+		}
+		else if ((strcmp(argv[i], "--saturation") == 0) && bHasValue)
+		{
+			g_PostSettings.saturation = std::max((float)atof(argv[++i]), 0.0f);
+		}
+		else if ((strcmp(argv[i], "--contrast") == 0) && bHasValue)
+		{
+			g_PostSettings.contrast = std::max((float)atof(argv[++i]), 0.0f);
+		}
+		else if ((strcmp(argv[i], "--vignette") == 0) && bHasValue)
+		{
+			g_PostSettings.vignette = std::min(std::max((float)atof(argv[++i]), 0.0f), 1.0f);
+		}
+		else if ((strcmp(argv[i], "--import-meshes") == 0) && (i + 2 < argc))
+		{
+			// output pack, then a comma separated list of mesh files
+			g_ImportMeshOutput = argv[++i];
+			std::string inputs = argv[++i];
+			size_t start = 0;
+			while (start <= inputs.size())
+			{
+				size_t end = inputs.find(',', start);
+				if (end == std::string::npos)
+				{
+					end = inputs.size();
+				}
+				if (end > start)
+				{
+					g_ImportMeshInputs.push_back(inputs.substr(start, end - start));
+				}
+				start = end + 1;
+			}
+			if (g_ImportMeshInputs.empty() == true)
+			{
+				std::cerr << "Invalid --import-meshes file list" << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--sweep") == 0) && bHasValue)
+		{
+			// comma separated list of object counts
+			char* pCount = argv[++i];
+			while (*pCount != '\0')
+			{
+				int count = (int)strtol(pCount, &pCount, 10);
+				if (count <= 0)
+				{
+					std::cerr << "Invalid --sweep object count" << std::endl;
+					return(false);
+				}
+				g_SweepCounts.push_back(count);
+				if (*pCount == ',')
+				{
+					pCount++;
+				}
+				else if (*pCount != '\0')
+				{
+					std::cerr << "Invalid --sweep object count" << std::endl;
+					return(false);
+				}
+			}
+		}
+		else
+		{
+			std::cerr << "Unknown or incomplete option: " << argv[i] << std::endl;
+			return(false);
+		}
+	}
+
+	// a headless run without a frame limit would never end
+	if ((g_bHeadless == true) && (g_MaxFrames <= 0) && (g_bBenchmark == false) && (g_SweepCounts.size() == 0) &&
+		(g_bFilterSweep == false) && (g_bAntiAliasingSweep == false))
+	{
+		std::cerr << "--headless requires --frames, --benchmark, --sweep, --filter-sweep or --aa-sweep" << std::endl;
+		return(false);
+	}
+	if ((g_BenchmarkSettings.measuredFrames <= 0) || (g_BenchmarkSettings.warmupFrames < 0) ||
+		(g_BenchmarkSettings.timestep <= 0.0f))
+	{
+		std::cerr << "Invalid benchmark frame counts or timestep" << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
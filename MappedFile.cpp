@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+// mappedfile.cpp
+// ============
+// read-only memory mapping of whole files
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MappedFile.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/***********************************************************
+ *  MappedFile()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MappedFile::MappedFile()
+{
+	m_pData = NULL;
+	m_size = 0;
+#ifdef _WIN32
+	m_hFile = INVALID_HANDLE_VALUE;
+	m_hMapping = NULL;
+#else
+	m_fileDescriptor = -1;
+#endif
+}
+
+/***********************************************************
+ *  ~MappedFile()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for mapping a whole file read-only.
+ *  Empty files cannot be mapped and are rejected.  The file
+ *  may be renamed over while it is mapped, as it can be on
+ *  POSIX systems, and the mapping keeps the old contents.
+ ***********************************************************/
+bool MappedFile::Open(const char* filename)
+{
+	Close();
+
+#ifdef _WIN32
+	m_hFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (m_hFile == INVALID_HANDLE_VALUE)
+	{
+		std::cout << "Could not open file:" << filename << std::endl;
+		return(false);
+	}
+
+	LARGE_INTEGER fileSize;
+	if ((GetFileSizeEx((HANDLE)m_hFile, &fileSize) == FALSE) || (fileSize.QuadPart == 0))
+	{
+		std::cout << "Could not map empty file:" << filename << std::endl;
+		Close();
+		return(false);
+	}
+	m_size = (size_t)fileSize.QuadPart;
+
+	m_hMapping = CreateFileMappingA((HANDLE)m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (NULL != m_hMapping)
+	{
+		m_pData = (const unsigned char*)MapViewOfFile((HANDLE)m_hMapping, FILE_MAP_READ, 0, 0, 0);
+	}
+#else
+	m_fileDescriptor = open(filename, O_RDONLY);
+	if (m_fileDescriptor < 0)
+	{
+		std::cout << "Could not open file:" << filename << std::endl;
+		return(false);
+	}
+
+	struct stat fileStatus;
+	if ((fstat(m_fileDescriptor, &fileStatus) != 0) || (fileStatus.st_size == 0))
+	{
+		std::cout << "Could not map empty file:" << filename << std::endl;
+		Close();
+		return(false);
+	}
+	m_size = (size_t)fileStatus.st_size;
+
+	void* pMapping = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+	if (pMapping != MAP_FAILED)
+	{
+		m_pData = (const unsigned char*)pMapping;
+	}
+#endif
+
+	if (NULL == m_pData)
+	{
+		std::cout << "Could not map file:" << filename << std::endl;
+		Close();
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for unmapping the file.
+ ***********************************************************/
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (NULL != m_pData)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+	if (NULL != m_hMapping)
+	{
+		CloseHandle((HANDLE)m_hMapping);
+		m_hMapping = NULL;
+	}
+	if (m_hFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle((HANDLE)m_hFile);
+		m_hFile = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (NULL != m_pData)
+	{
+		munmap((void*)m_pData, m_size);
+	}
+	if (m_fileDescriptor >= 0)
+	{
+		close(m_fileDescriptor);
+		m_fileDescriptor = -1;
+	}
+#endif
+
+	m_pData = NULL;
+	m_size = 0;
+}
@@ -0,0 +1,52 @@
+///////////////////////////////////////////////////////////////////////////////
+// mappedfile.h
+// ============
+// read-only memory mapping of whole files
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+/***********************************************************
+ *  MappedFile
+ *
+ *  This class maps a file into memory for reading, using
+ *  mmap() or MapViewOfFile().  Pages are only read from disk
+ *  when they are first touched, so opening even a very large
+ *  file is nearly free.  The mapping stays valid until the
+ *  file is closed or the object is destroyed.
+ ***********************************************************/
+class MappedFile
+{
+public:
+	// constructor
+	MappedFile();
+	// destructor
+	~MappedFile();
+
+	// map the whole file read-only
+	bool Open(const char* filename);
+	// unmap the file
+	void Close();
+
+	// start of the mapped bytes, or null when nothing is open
+	const unsigned char* GetData() const { return(m_pData); }
+	// number of mapped bytes
+	size_t GetSize() const { return(m_size); }
+
+private:
+	const unsigned char* m_pData;
+	size_t m_size;
+#ifdef _WIN32
+	void* m_hFile;
+	void* m_hMapping;
+#else
+	int m_fileDescriptor;
+#endif
+
+	// mappings cannot be shared between objects
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+};
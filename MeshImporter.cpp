@@ -0,0 +1,1176 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshimporter.cpp
+// ============
+// offline import of OBJ and glTF meshes into optimized mesh packs
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshImporter.h"
+#include "MeshLibrary.h"
+#include "JsonParser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+
+// declaration of global variables
+namespace
+{
+	// vertices the post-transform cache is assumed to hold
+	const int VERTEX_CACHE_SIZE = 16;
+
+	// values of the glTF format
+	const uint32_t GLB_MAGIC = 0x46546C67;
+	const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+	const uint32_t GLB_CHUNK_BIN = 0x004E4942;
+	const int GLTF_UNSIGNED_BYTE = 5121;
+	const int GLTF_UNSIGNED_SHORT = 5123;
+	const int GLTF_UNSIGNED_INT = 5125;
+	const int GLTF_FLOAT = 5126;
+	const int GLTF_TRIANGLES = 4;
+
+	// where the elements of a glTF accessor are in memory
+	struct GLTF_ACCESSOR
+	{
+		const unsigned char* pData;
+		size_t count;
+		int componentType;
+		int components;
+		size_t stride;
+	};
+
+	/***********************************************************
+	 *  AlignOffset()
+	 *
+	 *  Rounds an offset up to the section alignment.
+	 ***********************************************************/
+	uint64_t AlignOffset(uint64_t offset)
+	{
+		return((offset + MeshLibrary::PACK_ALIGNMENT - 1) & ~(MeshLibrary::PACK_ALIGNMENT - 1));
+	}
+
+	/***********************************************************
+	 *  HashBytes()
+	 *
+	 *  Returns the FNV-1a hash of a block of memory.
+	 ***********************************************************/
+	uint64_t HashBytes(const void* pData, size_t size)
+	{
+		const unsigned char* pBytes = (const unsigned char*)pData;
+		uint64_t hash = 14695981039346656037ULL;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ pBytes[i]) * 1099511628211ULL;
+		}
+		return(hash);
+	}
+
+	/***********************************************************
+	 *  FloatToHalf()
+	 *
+	 *  Returns the nearest half float of a float.  Values too
+	 *  large become infinity and values too small become zero.
+	 ***********************************************************/
+	uint16_t FloatToHalf(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		uint32_t sign = (bits >> 16) & 0x8000;
+		uint32_t mantissa = bits & 0x7FFFFF;
+		int exponent = (int)((bits >> 23) & 0xFF) - 127 + 15;
+
+		if (((bits >> 23) & 0xFF) == 0xFF)
+		{
+			return((uint16_t)(sign | 0x7C00 | ((mantissa != 0) ? 0x200 : 0)));
+		}
+		if (exponent >= 31)
+		{
+			return((uint16_t)(sign | 0x7C00));
+		}
+		if (exponent <= 0)
+		{
+			if (exponent < -10)
+			{
+				return((uint16_t)sign);
+			}
+			// denormal - shift in the implicit bit and round
+			mantissa |= 0x800000;
+			int shift = 14 - exponent;
+			uint32_t half = mantissa >> shift;
+			if ((mantissa >> (shift - 1)) & 1)
+			{
+				half++;
+			}
+			return((uint16_t)(sign | half));
+		}
+
+		// a carry out of the mantissa correctly raises the exponent
+		uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+		if (mantissa & 0x1000)
+		{
+			half++;
+		}
+		return((uint16_t)half);
+	}
+
+	/***********************************************************
+	 *  ReadWholeFile()
+	 *
+	 *  Reads the bytes of a file into memory.
+	 ***********************************************************/
+	bool ReadWholeFile(const std::string& filename, std::vector<unsigned char>& data)
+	{
+		std::ifstream file(filename.c_str(), std::ios::binary);
+		if (!file.is_open())
+		{
+			return(false);
+		}
+		data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return(file.bad() == false);
+	}
+
+	/***********************************************************
+	 *  DecodeBase64()
+	 *
+	 *  Decodes base64 text, as found in glTF data URIs.
+	 ***********************************************************/
+	bool DecodeBase64(const char* pText, size_t length, std::vector<unsigned char>& data)
+	{
+		data.clear();
+		data.reserve(length * 3 / 4);
+
+		uint32_t bits = 0;
+		int bitCount = 0;
+		for (size_t i = 0; i < length; i++)
+		{
+			char c = pText[i];
+			int value;
+			if ((c >= 'A') && (c <= 'Z')) value = c - 'A';
+			else if ((c >= 'a') && (c <= 'z')) value = c - 'a' + 26;
+			else if ((c >= '0') && (c <= '9')) value = c - '0' + 52;
+			else if (c == '+') value = 62;
+			else if (c == '/') value = 63;
+			else if (c == '=') break;
+			else return(false);
+
+			bits = (bits << 6) | (uint32_t)value;
+			bitCount += 6;
+			if (bitCount >= 8)
+			{
+				bitCount -= 8;
+				data.push_back((unsigned char)((bits >> bitCount) & 0xFF));
+			}
+		}
+		return(true);
+	}
+
+	/***********************************************************
+	 *  GetNumber()
+	 *
+	 *  Returns a number member of a JSON object, or the passed
+	 *  in value when it is missing.
+	 ***********************************************************/
+	double GetNumber(const JSON_VALUE& object, const char* name, double fallback)
+	{
+		const JSON_VALUE* pValue = JsonParser::FindMember(object, name);
+		if ((NULL == pValue) || (pValue->type != json_number))
+		{
+			return(fallback);
+		}
+		return(pValue->number);
+	}
+
+	/***********************************************************
+	 *  FindArrayItem()
+	 *
+	 *  Returns an element of an array member of a JSON object,
+	 *  or null when the member or the element is missing.
+	 ***********************************************************/
+	const JSON_VALUE* FindArrayItem(const JSON_VALUE& object, const char* name, double index)
+	{
+		const JSON_VALUE* pArray = JsonParser::FindMember(object, name);
+		if ((NULL == pArray) || (pArray->type != json_array) ||
+			(index < 0) || (index >= (double)pArray->items.size()))
+		{
+			return(NULL);
+		}
+		return(&pArray->items[(size_t)index]);
+	}
+
+	/***********************************************************
+	 *  FindAccessor()
+	 *
+	 *  This function is used for finding the elements of a
+	 *  glTF accessor and checking that they lie inside their
+	 *  buffer view.
+	 ***********************************************************/
+	bool FindAccessor(
+		const JSON_VALUE& root,
+		const std::vector<std::vector<unsigned char> >& buffers,
+		double index,
+		GLTF_ACCESSOR& accessor,
+		std::string& error)
+	{
+		const JSON_VALUE* pAccessor = FindArrayItem(root, "accessors", index);
+		if ((NULL == pAccessor) || (pAccessor->type != json_object))
+		{
+			error = "an accessor is missing";
+			return(false);
+		}
+		if (NULL != JsonParser::FindMember(*pAccessor, "sparse"))
+		{
+			error = "sparse accessors are not supported";
+			return(false);
+		}
+		const JSON_VALUE* pView = FindArrayItem(root, "bufferViews", GetNumber(*pAccessor, "bufferView", -1));
+		if ((NULL == pView) || (pView->type != json_object))
+		{
+			error = "an accessor has no buffer view";
+			return(false);
+		}
+		double bufferIndex = GetNumber(*pView, "buffer", -1);
+		if ((bufferIndex < 0) || (bufferIndex >= (double)buffers.size()))
+		{
+			error = "a buffer view has no buffer";
+			return(false);
+		}
+		const std::vector<unsigned char>& buffer = buffers[(size_t)bufferIndex];
+
+		accessor.componentType = (int)GetNumber(*pAccessor, "componentType", 0);
+		accessor.count = (size_t)GetNumber(*pAccessor, "count", 0);
+		const JSON_VALUE* pType = JsonParser::FindMember(*pAccessor, "type");
+		std::string type = (NULL != pType) ? pType->text : "";
+		accessor.components = (type == "SCALAR") ? 1 : (type == "VEC2") ? 2 : (type == "VEC3") ? 3 : (type == "VEC4") ? 4 : 0;
+
+		size_t componentSize = 0;
+		switch (accessor.componentType)
+		{
+		case GLTF_UNSIGNED_BYTE:
+			componentSize = 1;
+			break;
+		case GLTF_UNSIGNED_SHORT:
+			componentSize = 2;
+			break;
+		case GLTF_UNSIGNED_INT:
+		case GLTF_FLOAT:
+			componentSize = 4;
+			break;
+		}
+		if ((componentSize == 0) || (accessor.components == 0))
+		{
+			error = "an accessor has an unsupported type";
+			return(false);
+		}
+
+		size_t elementSize = componentSize * accessor.components;
+		size_t viewOffset = (size_t)GetNumber(*pView, "byteOffset", 0);
+		size_t viewLength = (size_t)GetNumber(*pView, "byteLength", 0);
+		size_t accessorOffset = (size_t)GetNumber(*pAccessor, "byteOffset", 0);
+		accessor.stride = (size_t)GetNumber(*pView, "byteStride", (double)elementSize);
+		if (accessor.stride < elementSize)
+		{
+			accessor.stride = elementSize;
+		}
+
+		size_t used = (accessor.count > 0) ? accessorOffset + (accessor.count - 1) * accessor.stride + elementSize : 0;
+		if ((viewOffset > buffer.size()) || (viewLength > buffer.size() - viewOffset) || (used > viewLength))
+		{
+			error = "an accessor is out of range of its buffer";
+			return(false);
+		}
+		accessor.pData = buffer.data() + viewOffset + accessorOffset;
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ReadFloats()
+	 *
+	 *  Reads float components of an accessor element.
+	 ***********************************************************/
+	void ReadFloats(const GLTF_ACCESSOR& accessor, size_t element, float* pValues, int count)
+	{
+		memcpy(pValues, accessor.pData + element * accessor.stride, count * sizeof(float));
+	}
+
+	/***********************************************************
+	 *  OptimizeVertexCache()
+	 *
+	 *  This function is used for reordering triangles so that
+	 *  consecutive triangles share vertices, with the Tipsify
+	 *  algorithm.  It fans around one vertex at a time and
+	 *  moves on to a neighbour that is still in the simulated
+	 *  cache, or back to a recently used vertex at a dead end.
+	 ***********************************************************/
+	void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+	{
+		size_t triangleCount = indices.size() / 3;
+
+		// the triangles of each vertex, as ranges of one array
+		std::vector<uint32_t> adjacencyStart(vertexCount + 1, 0);
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			adjacencyStart[indices[i] + 1]++;
+		}
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			adjacencyStart[i + 1] += adjacencyStart[i];
+		}
+		std::vector<uint32_t> adjacency(indices.size());
+		std::vector<uint32_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+		}
+
+		// triangles not yet emitted per vertex, and the time each
+		// vertex last entered the cache
+		std::vector<int> liveCount(vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			liveCount[i] = (int)(adjacencyStart[i + 1] - adjacencyStart[i]);
+		}
+		std::vector<int> cacheTime(vertexCount, 0);
+		std::vector<bool> emitted(triangleCount, false);
+		std::vector<uint32_t> deadEnd;
+		std::vector<uint32_t> candidates;
+		std::vector<uint32_t> output;
+		output.reserve(indices.size());
+
+		int time = VERTEX_CACHE_SIZE + 1;
+		size_t cursor = 0;
+		int fan = (vertexCount > 0) ? 0 : -1;
+		while ((fan >= 0) && (liveCount[fan] == 0))
+		{
+			fan = (++cursor < vertexCount) ? (int)cursor : -1;
+		}
+
+		while (fan >= 0)
+		{
+			candidates.clear();
+			for (uint32_t a = adjacencyStart[fan]; a < adjacencyStart[fan + 1]; a++)
+			{
+				uint32_t triangle = adjacency[a];
+				if (emitted[triangle] == true)
+				{
+					continue;
+				}
+				for (int corner = 0; corner < 3; corner++)
+				{
+					uint32_t vertex = indices[triangle * 3 + corner];
+					output.push_back(vertex);
+					deadEnd.push_back(vertex);
+					candidates.push_back(vertex);
+					liveCount[vertex]--;
+					if (time - cacheTime[vertex] > VERTEX_CACHE_SIZE)
+					{
+						cacheTime[vertex] = time;
+						time++;
+					}
+				}
+				emitted[triangle] = true;
+			}
+
+			// prefer the candidate that stays in the cache longest
+			// while its remaining fan is drawn
+			int next = -1;
+			int bestPriority = -1;
+			for (size_t i = 0; i < candidates.size(); i++)
+			{
+				uint32_t vertex = candidates[i];
+				if (liveCount[vertex] > 0)
+				{
+					int priority = 0;
+					if (time - cacheTime[vertex] + 2 * liveCount[vertex] <= VERTEX_CACHE_SIZE)
+					{
+						priority = time - cacheTime[vertex];
+					}
+					if (priority > bestPriority)
+					{
+						bestPriority = priority;
+						next = (int)vertex;
+					}
+				}
+			}
+
+			// at a dead end, go back to a recent vertex, then to the
+			// next one in input order
+			while ((next < 0) && (deadEnd.empty() == false))
+			{
+				uint32_t vertex = deadEnd.back();
+				deadEnd.pop_back();
+				if (liveCount[vertex] > 0)
+				{
+					next = (int)vertex;
+				}
+			}
+			while ((next < 0) && (cursor < vertexCount))
+			{
+				if (liveCount[cursor] > 0)
+				{
+					next = (int)cursor;
+				}
+				else
+				{
+					cursor++;
+				}
+			}
+			fan = next;
+		}
+
+		indices.swap(output);
+	}
+}
+
+/***********************************************************
+ *  MeshImporter()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshImporter::MeshImporter()
+{
+}
+
+/***********************************************************
+ *  ~MeshImporter()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MeshImporter::~MeshImporter()
+{
+}
+
+/***********************************************************
+ *  ImportFile()
+ *
+ *  This method is used for importing the meshes of a file,
+ *  chosen by its extension.
+ ***********************************************************/
+bool MeshImporter::ImportFile(const char* filename)
+{
+	std::filesystem::path path(filename);
+	std::string extension = path.extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	std::string baseName = path.stem().string();
+
+	if (extension == ".obj")
+	{
+		return(ImportOBJ(filename, baseName));
+	}
+	if ((extension == ".gltf") || (extension == ".glb"))
+	{
+		return(ImportGLTF(filename, baseName));
+	}
+
+	std::cout << "Could not import mesh file, the format is not supported:" << filename << std::endl;
+	return(false);
+}
+
+/***********************************************************
+ *  ImportOBJ()
+ *
+ *  This method is used for importing a Wavefront OBJ file.
+ *  Polygons are split into fans of triangles, and faces
+ *  without normals get smoothed ones.
+ ***********************************************************/
+bool MeshImporter::ImportOBJ(const char* filename, const std::string& baseName)
+{
+	std::ifstream file(filename);
+	if (!file.is_open())
+	{
+		std::cout << "Could not import mesh file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec3> normals;
+	std::vector<glm::vec2> texCoords;
+	std::vector<IMPORT_VERTEX> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<uint32_t> face;
+	std::string objectName = baseName;
+	std::string line;
+	std::string error;
+	int lineNumber = 0;
+
+	while ((error.empty() == true) && (std::getline(file, line)))
+	{
+		lineNumber++;
+		std::istringstream tokens(line);
+		std::string keyword;
+		tokens >> keyword;
+
+		if (keyword == "v")
+		{
+			glm::vec3 position(0.0f);
+			tokens >> position.x >> position.y >> position.z;
+			positions.push_back(position);
+		}
+		else if (keyword == "vn")
+		{
+			glm::vec3 normal(0.0f);
+			tokens >> normal.x >> normal.y >> normal.z;
+			normals.push_back(normal);
+		}
+		else if (keyword == "vt")
+		{
+			glm::vec2 texCoord(0.0f);
+			tokens >> texCoord.x >> texCoord.y;
+			texCoords.push_back(texCoord);
+		}
+		else if (keyword == "o")
+		{
+			if ((indices.empty() == false) && (AddMesh(objectName, vertices, indices) == false))
+			{
+				return(false);
+			}
+			vertices.clear();
+			indices.clear();
+			std::getline(tokens >> std::ws, objectName);
+			while ((objectName.empty() == false) && (isspace((unsigned char)objectName.back())))
+			{
+				objectName.pop_back();
+			}
+			if (objectName.empty() == true)
+			{
+				objectName = baseName;
+			}
+		}
+		else if (keyword == "f")
+		{
+			// each corner is position/texture/normal, counted from
+			// one, or from the end when negative
+			face.clear();
+			std::string corner;
+			while ((error.empty() == true) && (tokens >> corner))
+			{
+				IMPORT_VERTEX vertex;
+				vertex.position = glm::vec3(0.0f);
+				vertex.normal = glm::vec3(0.0f);
+				vertex.texCoord = glm::vec2(0.0f);
+
+				int references[3] = { 0, 0, 0 };
+				size_t start = 0;
+				for (int part = 0; (part < 3) && (start <= corner.size()); part++)
+				{
+					size_t end = corner.find('/', start);
+					if (end == std::string::npos)
+					{
+						end = corner.size();
+					}
+					if (end > start)
+					{
+						references[part] = atoi(corner.c_str() + start);
+					}
+					start = end + 1;
+				}
+
+				int counts[3] = { (int)positions.size(), (int)texCoords.size(), (int)normals.size() };
+				int resolved[3] = { -1, -1, -1 };
+				for (int part = 0; part < 3; part++)
+				{
+					if (references[part] > 0)
+					{
+						resolved[part] = references[part] - 1;
+					}
+					else if (references[part] < 0)
+					{
+						resolved[part] = counts[part] + references[part];
+					}
+					if ((resolved[part] >= counts[part]) || ((references[part] != 0) && (resolved[part] < 0)))
+					{
+						error = "a face refers to a missing vertex";
+					}
+				}
+				if ((resolved[0] < 0) && (error.empty() == true))
+				{
+					error = "a face corner has no position";
+				}
+				if (error.empty() == false)
+				{
+					break;
+				}
+
+				vertex.position = positions[resolved[0]];
+				if (resolved[1] >= 0)
+				{
+					vertex.texCoord = texCoords[resolved[1]];
+				}
+				if (resolved[2] >= 0)
+				{
+					vertex.normal = normals[resolved[2]];
+				}
+				face.push_back((uint32_t)vertices.size());
+				vertices.push_back(vertex);
+			}
+
+			if ((error.empty() == true) && (face.size() < 3))
+			{
+				error = "a face has fewer than three corners";
+			}
+			for (size_t i = 2; (error.empty() == true) && (i < face.size()); i++)
+			{
+				indices.push_back(face[0]);
+				indices.push_back(face[i - 1]);
+				indices.push_back(face[i]);
+			}
+		}
+	}
+
+	if (error.empty() == false)
+	{
+		std::cout << "Could not import mesh file " << filename << ", line " << lineNumber << ": " << error << std::endl;
+		return(false);
+	}
+	if ((indices.empty() == false) && (AddMesh(objectName, vertices, indices) == false))
+	{
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  ImportGLTF()
+ *
+ *  This method is used for importing the meshes of a glTF
+ *  file, either JSON with its buffers in separate files or
+ *  data URIs, or a binary .glb.  The triangle primitives of
+ *  a mesh are merged into one mesh; only float positions,
+ *  normals and first texture coordinates are read.
+ ***********************************************************/
+bool MeshImporter::ImportGLTF(const char* filename, const std::string& baseName)
+{
+	std::vector<unsigned char> fileData;
+	if (ReadWholeFile(filename, fileData) == false)
+	{
+		std::cout << "Could not import mesh file:" << filename << std::endl;
+		return(false);
+	}
+
+	// a .glb holds the JSON and then the binary buffer as chunks
+	const char* pJson = (const char*)fileData.data();
+	size_t jsonLength = fileData.size();
+	std::vector<unsigned char> binaryChunk;
+	uint32_t magic = 0;
+	if (fileData.size() >= 4)
+	{
+		memcpy(&magic, fileData.data(), sizeof(magic));
+	}
+	if (magic == GLB_MAGIC)
+	{
+		jsonLength = 0;
+		size_t offset = 12;
+		while (offset + 8 <= fileData.size())
+		{
+			uint32_t chunk[2];
+			memcpy(chunk, fileData.data() + offset, sizeof(chunk));
+			offset += 8;
+			if (chunk[0] > fileData.size() - offset)
+			{
+				break;
+			}
+			if ((chunk[1] == GLB_CHUNK_JSON) && (jsonLength == 0))
+			{
+				pJson = (const char*)fileData.data() + offset;
+				jsonLength = chunk[0];
+			}
+			else if ((chunk[1] == GLB_CHUNK_BIN) && (binaryChunk.empty() == true))
+			{
+				binaryChunk.assign(fileData.begin() + offset, fileData.begin() + offset + chunk[0]);
+			}
+			offset += (chunk[0] + 3) & ~3u;
+		}
+		if (jsonLength == 0)
+		{
+			std::cout << "Could not import mesh file, it has no JSON chunk:" << filename << std::endl;
+			return(false);
+		}
+	}
+
+	JSON_VALUE root;
+	std::string error;
+	if (JsonParser::Parse(pJson, jsonLength, root, error) == false)
+	{
+		std::cout << "Could not import mesh file " << filename << ", " << error << std::endl;
+		return(false);
+	}
+
+	// load every buffer - from a data URI, a file next to this
+	// one, or the binary chunk
+	std::vector<std::vector<unsigned char> > buffers;
+	const JSON_VALUE* pBuffers = JsonParser::FindMember(root, "buffers");
+	if ((NULL != pBuffers) && (pBuffers->type == json_array))
+	{
+		buffers.resize(pBuffers->items.size());
+		for (size_t i = 0; (i < buffers.size()) && (error.empty() == true); i++)
+		{
+			const JSON_VALUE* pUri = JsonParser::FindMember(pBuffers->items[i], "uri");
+			if ((NULL == pUri) || (pUri->type != json_string))
+			{
+				buffers[i] = binaryChunk;
+			}
+			else if (pUri->text.compare(0, 5, "data:") == 0)
+			{
+				size_t comma = pUri->text.find(',');
+				if ((comma == std::string::npos) || (pUri->text.rfind(";base64", comma) == std::string::npos) ||
+					(DecodeBase64(pUri->text.c_str() + comma + 1, pUri->text.size() - comma - 1, buffers[i]) == false))
+				{
+					error = "a buffer has an unsupported data URI";
+				}
+			}
+			else
+			{
+				std::filesystem::path bufferPath = std::filesystem::path(filename).parent_path() / pUri->text;
+				if (ReadWholeFile(bufferPath.string(), buffers[i]) == false)
+				{
+					error = "could not read buffer " + bufferPath.string();
+				}
+			}
+		}
+	}
+
+	const JSON_VALUE* pMeshes = JsonParser::FindMember(root, "meshes");
+	if ((error.empty() == true) && ((NULL == pMeshes) || (pMeshes->type != json_array)))
+	{
+		error = "the file has no meshes";
+	}
+
+	for (size_t m = 0; (error.empty() == true) && (m < pMeshes->items.size()); m++)
+	{
+		const JSON_VALUE& mesh = pMeshes->items[m];
+		const JSON_VALUE* pName = JsonParser::FindMember(mesh, "name");
+		std::string name = ((NULL != pName) && (pName->type == json_string) && (pName->text.empty() == false)) ?
+			pName->text : baseName + "_" + std::to_string(m);
+		if (pMeshes->items.size() == 1)
+		{
+			name = ((NULL != pName) && (pName->type == json_string) && (pName->text.empty() == false)) ?
+				pName->text : baseName;
+		}
+
+		std::vector<IMPORT_VERTEX> vertices;
+		std::vector<uint32_t> indices;
+		const JSON_VALUE* pPrimitives = JsonParser::FindMember(mesh, "primitives");
+		for (size_t p = 0; (NULL != pPrimitives) && (error.empty() == true) && (p < pPrimitives->items.size()); p++)
+		{
+			const JSON_VALUE& primitive = pPrimitives->items[p];
+			if (GetNumber(primitive, "mode", GLTF_TRIANGLES) != GLTF_TRIANGLES)
+			{
+				std::cout << "INFO: Skipping a primitive of mesh " << name << " that is not made of triangles" << std::endl;
+				continue;
+			}
+			const JSON_VALUE* pAttributes = JsonParser::FindMember(primitive, "attributes");
+			if ((NULL == pAttributes) || (NULL == JsonParser::FindMember(*pAttributes, "POSITION")))
+			{
+				error = "a primitive has no positions";
+				break;
+			}
+
+			GLTF_ACCESSOR positions;
+			GLTF_ACCESSOR normals;
+			GLTF_ACCESSOR texCoords;
+			bool bNormals = (NULL != JsonParser::FindMember(*pAttributes, "NORMAL"));
+			bool bTexCoords = (NULL != JsonParser::FindMember(*pAttributes, "TEXCOORD_0"));
+			if ((FindAccessor(root, buffers, GetNumber(*pAttributes, "POSITION", -1), positions, error) == false) ||
+				((bNormals == true) && (FindAccessor(root, buffers, GetNumber(*pAttributes, "NORMAL", -1), normals, error) == false)) ||
+				((bTexCoords == true) && (FindAccessor(root, buffers, GetNumber(*pAttributes, "TEXCOORD_0", -1), texCoords, error) == false)))
+			{
+				break;
+			}
+			if ((positions.componentType != GLTF_FLOAT) || (positions.components != 3) ||
+				((bNormals == true) && ((normals.componentType != GLTF_FLOAT) || (normals.components != 3) || (normals.count != positions.count))) ||
+				((bTexCoords == true) && ((texCoords.componentType != GLTF_FLOAT) || (texCoords.components != 2) || (texCoords.count != positions.count))))
+			{
+				error = "only float positions, normals and texture coordinates are supported";
+				break;
+			}
+
+			uint32_t firstVertex = (uint32_t)vertices.size();
+			for (size_t i = 0; i < positions.count; i++)
+			{
+				IMPORT_VERTEX vertex;
+				vertex.normal = glm::vec3(0.0f);
+				vertex.texCoord = glm::vec2(0.0f);
+				ReadFloats(positions, i, &vertex.position.x, 3);
+				if (bNormals == true)
+				{
+					ReadFloats(normals, i, &vertex.normal.x, 3);
+				}
+				if (bTexCoords == true)
+				{
+					// glTF puts the first texture row at the top
+					ReadFloats(texCoords, i, &vertex.texCoord.x, 2);
+					vertex.texCoord.y = 1.0f - vertex.texCoord.y;
+				}
+				vertices.push_back(vertex);
+			}
+
+			if (NULL == JsonParser::FindMember(primitive, "indices"))
+			{
+				for (size_t i = 0; i < positions.count; i++)
+				{
+					indices.push_back(firstVertex + (uint32_t)i);
+				}
+				continue;
+			}
+
+			GLTF_ACCESSOR primitiveIndices;
+			if (FindAccessor(root, buffers, GetNumber(primitive, "indices", -1), primitiveIndices, error) == false)
+			{
+				break;
+			}
+			if ((primitiveIndices.components != 1) || (primitiveIndices.componentType == GLTF_FLOAT))
+			{
+				error = "a primitive has indices of an unsupported type";
+				break;
+			}
+			for (size_t i = 0; i < primitiveIndices.count; i++)
+			{
+				const unsigned char* pIndex = primitiveIndices.pData + i * primitiveIndices.stride;
+				uint32_t index = 0;
+				if (primitiveIndices.componentType == GLTF_UNSIGNED_BYTE)
+				{
+					index = *pIndex;
+				}
+				else if (primitiveIndices.componentType == GLTF_UNSIGNED_SHORT)
+				{
+					uint16_t value;
+					memcpy(&value, pIndex, sizeof(value));
+					index = value;
+				}
+				else
+				{
+					memcpy(&index, pIndex, sizeof(index));
+				}
+				if (index >= positions.count)
+				{
+					error = "a primitive refers to a missing vertex";
+					break;
+				}
+				indices.push_back(firstVertex + index);
+			}
+		}
+
+		if ((error.empty() == true) && (indices.empty() == false) && (AddMesh(name, vertices, indices) == false))
+		{
+			return(false);
+		}
+	}
+
+	if (error.empty() == false)
+	{
+		std::cout << "Could not import mesh file " << filename << ", " << error << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  AddMesh()
+ *
+ *  This method is used for preparing an imported mesh for
+ *  the pack: missing normals are filled in, equal vertices
+ *  are welded, empty triangles dropped, and the triangles
+ *  and then the vertices are put in cache friendly order.
+ ***********************************************************/
+bool MeshImporter::AddMesh(const std::string& name, std::vector<IMPORT_VERTEX>& vertices, std::vector<uint32_t>& indices)
+{
+	for (size_t i = 0; i < m_meshes.size(); i++)
+	{
+		if (m_meshes[i].name == name)
+		{
+			std::cout << "Could not import mesh " << name << ", the name is already used" << std::endl;
+			return(false);
+		}
+	}
+	indices.resize(indices.size() - indices.size() % 3);
+
+	// smooth normals for the vertices that have none, summed
+	// from the faces around each position
+	bool bMissingNormals = false;
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		if (glm::dot(vertices[i].normal, vertices[i].normal) == 0.0f)
+		{
+			bMissingNormals = true;
+			break;
+		}
+	}
+	if (bMissingNormals == true)
+	{
+		std::unordered_map<uint64_t, glm::vec3> faceNormals;
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const glm::vec3& a = vertices[indices[i]].position;
+			const glm::vec3& b = vertices[indices[i + 1]].position;
+			const glm::vec3& c = vertices[indices[i + 2]].position;
+			// not normalized, so larger faces weigh more
+			glm::vec3 normal = glm::cross(b - a, c - a);
+			for (int corner = 0; corner < 3; corner++)
+			{
+				const glm::vec3& position = vertices[indices[i + corner]].position;
+				faceNormals[HashBytes(&position, sizeof(position))] += normal;
+			}
+		}
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			if (glm::dot(vertices[i].normal, vertices[i].normal) == 0.0f)
+			{
+				glm::vec3 normal = faceNormals[HashBytes(&vertices[i].position, sizeof(glm::vec3))];
+				float length = glm::length(normal);
+				vertices[i].normal = (length > 0.0f) ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+			}
+		}
+	}
+
+	// weld vertices with the same bits into one
+	std::unordered_multimap<uint64_t, uint32_t> welded;
+	std::vector<IMPORT_VERTEX> unique;
+	std::vector<uint32_t> remap(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		uint64_t hash = HashBytes(&vertices[i], sizeof(IMPORT_VERTEX));
+		std::pair<std::unordered_multimap<uint64_t, uint32_t>::iterator,
+			std::unordered_multimap<uint64_t, uint32_t>::iterator> range = welded.equal_range(hash);
+		remap[i] = (uint32_t)unique.size();
+		for (std::unordered_multimap<uint64_t, uint32_t>::iterator it = range.first; it != range.second; ++it)
+		{
+			if (memcmp(&unique[it->second], &vertices[i], sizeof(IMPORT_VERTEX)) == 0)
+			{
+				remap[i] = it->second;
+				break;
+			}
+		}
+		if (remap[i] == unique.size())
+		{
+			welded.insert(std::make_pair(hash, remap[i]));
+			unique.push_back(vertices[i]);
+		}
+	}
+
+	std::vector<uint32_t> triangles;
+	triangles.reserve(indices.size());
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		uint32_t a = remap[indices[i]];
+		uint32_t b = remap[indices[i + 1]];
+		uint32_t c = remap[indices[i + 2]];
+		if ((a != b) && (b != c) && (a != c))
+		{
+			triangles.push_back(a);
+			triangles.push_back(b);
+			triangles.push_back(c);
+		}
+	}
+	if (triangles.empty() == true)
+	{
+		std::cout << "INFO: Skipping mesh " << name << ", it has no triangles" << std::endl;
+		return(true);
+	}
+
+	OptimizeVertexCache(triangles, unique.size());
+
+	// store the vertices in the order the triangles first use
+	// them, which also drops unused ones
+	IMPORT_MESH mesh;
+	mesh.name = name;
+	std::vector<uint32_t> order(unique.size(), UINT32_MAX);
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		uint32_t& target = order[triangles[i]];
+		if (target == UINT32_MAX)
+		{
+			target = (uint32_t)mesh.vertices.size();
+			mesh.vertices.push_back(unique[triangles[i]]);
+		}
+		triangles[i] = target;
+	}
+	mesh.indices.swap(triangles);
+
+	std::cout << "INFO: Imported mesh " << name << ", " << mesh.vertices.size() << " vertices and "
+		<< mesh.indices.size() / 3 << " triangles" << std::endl;
+	m_meshes.push_back(mesh);
+	return(true);
+}
+
+/***********************************************************
+ *  AppendMeshes()
+ *
+ *  This method is used for taking over the meshes of another
+ *  importer, which is left empty.
+ ***********************************************************/
+void MeshImporter::AppendMeshes(MeshImporter& source)
+{
+	for (size_t i = 0; i < source.m_meshes.size(); i++)
+	{
+		m_meshes.push_back(IMPORT_MESH());
+		m_meshes.back().name.swap(source.m_meshes[i].name);
+		m_meshes.back().vertices.swap(source.m_meshes[i].vertices);
+		m_meshes.back().indices.swap(source.m_meshes[i].indices);
+	}
+	source.m_meshes.clear();
+}
+
+/***********************************************************
+ *  SavePack()
+ *
+ *  This method is used for writing the imported meshes as a
+ *  mesh pack.  Positions are quantized to the bounds of their
+ *  mesh, normals are scaled to match, and meshes with few
+ *  enough vertices get 16 bit indices.  The file is written
+ *  under a temporary name and renamed over the old one.
+ ***********************************************************/
+bool MeshImporter::SavePack(const char* filename) const
+{
+	std::string strings;
+	std::vector<MeshLibrary::PACK_MESH> meshes(m_meshes.size());
+	std::vector<MeshLibrary::PACKED_VERTEX> vertices;
+	std::vector<unsigned char> indices;
+
+	for (size_t m = 0; m < m_meshes.size(); m++)
+	{
+		const IMPORT_MESH& source = m_meshes[m];
+		MeshLibrary::PACK_MESH& entry = meshes[m];
+		memset(&entry, 0, sizeof(entry));
+
+		entry.name = (uint32_t)strings.size();
+		strings.append(source.name.c_str(), source.name.size() + 1);
+
+		glm::vec3 boundsMin = source.vertices[0].position;
+		glm::vec3 boundsMax = source.vertices[0].position;
+		for (size_t i = 1; i < source.vertices.size(); i++)
+		{
+			boundsMin = glm::min(boundsMin, source.vertices[i].position);
+			boundsMax = glm::max(boundsMax, source.vertices[i].position);
+		}
+		glm::vec3 extent = boundsMax - boundsMin;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			entry.boundsMin[axis] = boundsMin[axis];
+			entry.boundsMax[axis] = boundsMax[axis];
+			if (extent[axis] <= 0.0f)
+			{
+				extent[axis] = 1.0f;
+			}
+		}
+
+		entry.vertexCount = (uint32_t)source.vertices.size();
+		entry.firstVertex = vertices.size();
+		for (size_t i = 0; i < source.vertices.size(); i++)
+		{
+			const IMPORT_VERTEX& vertex = source.vertices[i];
+			MeshLibrary::PACKED_VERTEX packed;
+			memset(&packed, 0, sizeof(packed));
+
+			glm::vec3 position = glm::clamp((vertex.position - boundsMin) / extent, 0.0f, 1.0f);
+			// the normal matrix of the dequantized model divides by
+			// the extent, so multiply by it here
+			glm::vec3 normal = vertex.normal * extent;
+			float length = glm::length(normal);
+			normal = (length > 0.0f) ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+			for (int axis = 0; axis < 3; axis++)
+			{
+				packed.position[axis] = (uint16_t)std::lround(position[axis] * 65535.0f);
+				packed.normal[axis] = (int8_t)std::lround(normal[axis] * 127.0f);
+			}
+			packed.texCoord[0] = FloatToHalf(vertex.texCoord.x);
+			packed.texCoord[1] = FloatToHalf(vertex.texCoord.y);
+			vertices.push_back(packed);
+		}
+
+		entry.indexSize = (source.vertices.size() <= 65536) ? 2 : 4;
+		entry.indexCount = (uint32_t)source.indices.size();
+		indices.resize((indices.size() + entry.indexSize - 1) & ~(size_t)(entry.indexSize - 1), 0);
+		entry.indexOffset = indices.size();
+		for (size_t i = 0; i < source.indices.size(); i++)
+		{
+			if (entry.indexSize == 2)
+			{
+				uint16_t index = (uint16_t)source.indices[i];
+				indices.insert(indices.end(), (const unsigned char*)&index, (const unsigned char*)&index + 2);
+			}
+			else
+			{
+				uint32_t index = source.indices[i];
+				indices.insert(indices.end(), (const unsigned char*)&index, (const unsigned char*)&index + 4);
+			}
+		}
+	}
+
+	MeshLibrary::PACK_HEADER header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, MeshLibrary::GetPackMagic(), sizeof(header.magic));
+	header.version = MeshLibrary::PACK_VERSION;
+	header.byteOrder = MeshLibrary::PACK_BYTE_ORDER;
+	header.vertexSize = sizeof(MeshLibrary::PACKED_VERTEX);
+	header.meshSize = sizeof(MeshLibrary::PACK_MESH);
+
+	header.strings.offset = AlignOffset(sizeof(header));
+	header.strings.count = strings.size();
+	header.meshes.offset = AlignOffset(header.strings.offset + strings.size());
+	header.meshes.count = meshes.size();
+	header.vertices.offset = AlignOffset(header.meshes.offset + meshes.size() * sizeof(MeshLibrary::PACK_MESH));
+	header.vertices.count = vertices.size();
+	header.indices.offset = AlignOffset(header.vertices.offset + vertices.size() * sizeof(MeshLibrary::PACKED_VERTEX));
+	header.indices.count = indices.size();
+
+	std::string temporaryName = std::string(filename) + ".tmp";
+	std::ofstream file(temporaryName.c_str(), std::ios::binary);
+	if (!file.is_open())
+	{
+		std::cout << "Could not write mesh pack:" << filename << std::endl;
+		return(false);
+	}
+
+	// write each section after the padding up to its offset
+	const char padding[MeshLibrary::PACK_ALIGNMENT] = { 0 };
+	uint64_t position = 0;
+	const MeshLibrary::PACK_SECTION* sections[] = {
+		&header.strings, &header.meshes, &header.vertices, &header.indices };
+	const void* sectionData[] = {
+		strings.data(), meshes.data(), vertices.data(), indices.data() };
+	size_t sectionBytes[] = {
+		strings.size(),
+		meshes.size() * sizeof(MeshLibrary::PACK_MESH),
+		vertices.size() * sizeof(MeshLibrary::PACKED_VERTEX),
+		indices.size() };
+
+	file.write((const char*)&header, sizeof(header));
+	position += sizeof(header);
+	for (int i = 0; i < 4; i++)
+	{
+		file.write(padding, (std::streamsize)(sections[i]->offset - position));
+		if (sectionBytes[i] > 0)
+		{
+			file.write((const char*)sectionData[i], (std::streamsize)sectionBytes[i]);
+		}
+		position = sections[i]->offset + sectionBytes[i];
+	}
+	file.close();
+
+	std::error_code error;
+	if (file.fail() == false)
+	{
+		std::filesystem::rename(temporaryName, filename, error);
+	}
+	if ((file.fail() == true) || (error))
+	{
+		std::cout << "Could not write mesh pack:" << filename << std::endl;
+		std::filesystem::remove(temporaryName, error);
+		return(false);
+	}
+
+	std::cout << "INFO: Wrote " << meshes.size() << " meshes to " << filename << ", "
+		<< vertices.size() << " vertices in " << vertices.size() * sizeof(MeshLibrary::PACKED_VERTEX)
+		<< " bytes and " << indices.size() << " index bytes" << std::endl;
+	return(true);
+}
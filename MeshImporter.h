@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshimporter.h
+// ============
+// offline import of OBJ and glTF meshes into optimized mesh packs
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  MeshImporter
+ *
+ *  This class turns OBJ and glTF files into a mesh pack for
+ *  the MeshLibrary.  All the slow work happens here, once,
+ *  instead of every time the program starts: the triangles
+ *  are welded into indexed vertices, reordered so the
+ *  post-transform vertex cache is reused (Sander et al.,
+ *  "Fast Triangle Reordering for Vertex Locality and Reduced
+ *  Overdraw"), the vertices are reordered into the order the
+ *  indices first fetch them, and finally every vertex is
+ *  quantized to 16 bytes.
+ *
+ *  Each OBJ object and each glTF mesh becomes one mesh of the
+ *  pack, named after the object or mesh, or after the file
+ *  when it has no name.  Materials are not imported, and glTF
+ *  node transforms are ignored - place the meshes from the
+ *  scene file instead.
+ ***********************************************************/
+class MeshImporter
+{
+public:
+	// a vertex before quantization
+	struct IMPORT_VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 texCoord;
+	};
+
+	// constructor
+	MeshImporter();
+	// destructor
+	~MeshImporter();
+
+	// import the meshes of a .obj, .gltf or .glb file
+	bool ImportFile(const char* filename);
+	// weld, optimize and keep a mesh given as indexed triangles
+	// - a zero normal is replaced by the smoothed face normals
+	bool AddMesh(const std::string& name, std::vector<IMPORT_VERTEX>& vertices, std::vector<uint32_t>& indices);
+	// move the meshes of another importer to the end of these,
+	// so meshes can be prepared by one importer per thread
+	void AppendMeshes(MeshImporter& source);
+	// write every imported mesh to a pack
+	bool SavePack(const char* filename) const;
+
+	int GetMeshCount() const { return((int)m_meshes.size()); }
+
+private:
+	struct IMPORT_MESH
+	{
+		std::string name;
+		std::vector<IMPORT_VERTEX> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	std::vector<IMPORT_MESH> m_meshes;
+
+	bool ImportOBJ(const char* filename, const std::string& baseName);
+	bool ImportGLTF(const char* filename, const std::string& baseName);
+};
@@ -0,0 +1,304 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshlibrary.cpp
+// ============
+// load packs of imported meshes by mapping them straight into geometry buffers
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshLibrary.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	/***********************************************************
+	 *  GetPackSection()
+	 *
+	 *  Returns the start of a section of the mapped pack, or
+	 *  null when the section does not fit inside the file.
+	 ***********************************************************/
+	const unsigned char* GetPackSection(const MappedFile& file, const MeshLibrary::PACK_SECTION& section, size_t elementSize)
+	{
+		if ((section.offset % MeshLibrary::PACK_ALIGNMENT != 0) || (section.offset > file.GetSize()) ||
+			(section.count > (file.GetSize() - section.offset) / elementSize))
+		{
+			return(NULL);
+		}
+		return(file.GetData() + section.offset);
+	}
+}
+
+/***********************************************************
+ *  MeshLibrary()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshLibrary::MeshLibrary()
+{
+	m_vertices.offset = 0;
+	m_vertices.count = 0;
+	m_indices.offset = 0;
+	m_indices.count = 0;
+	m_vertexArray = 0;
+	m_vertexBuffer = 0;
+	m_indexBuffer = 0;
+}
+
+/***********************************************************
+ *  ~MeshLibrary()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MeshLibrary::~MeshLibrary()
+{
+	Close();
+}
+
+/***********************************************************
+ *  Load()
+ *
+ *  This method is used for mapping a mesh pack and reading
+ *  the entry of every mesh.  The vertex and index arrays are
+ *  only checked to lie inside the file; they stay mapped
+ *  until Upload() copies them to the GPU.
+ ***********************************************************/
+bool MeshLibrary::Load(const char* filename)
+{
+	Close();
+
+	if (m_file.Open(filename) == false)
+	{
+		return(false);
+	}
+	m_filename = filename;
+
+	PACK_HEADER header;
+	if (m_file.GetSize() < sizeof(header))
+	{
+		std::cout << "Could not load mesh pack, the file is too small:" << filename << std::endl;
+		Close();
+		return(false);
+	}
+	memcpy(&header, m_file.GetData(), sizeof(header));
+
+	if ((memcmp(header.magic, GetPackMagic(), sizeof(header.magic)) != 0) ||
+		(header.byteOrder != PACK_BYTE_ORDER))
+	{
+		std::cout << "Could not load mesh pack, it is not a mesh pack of this machine:" << filename << std::endl;
+		Close();
+		return(false);
+	}
+	if ((header.version != PACK_VERSION) ||
+		(header.vertexSize != sizeof(PACKED_VERTEX)) ||
+		(header.meshSize != sizeof(PACK_MESH)))
+	{
+		std::cout << "Could not load mesh pack, it was written by another version:" << filename << std::endl;
+		Close();
+		return(false);
+	}
+
+	const char* pStrings = (const char*)GetPackSection(m_file, header.strings, 1);
+	const PACK_MESH* pMeshes = (const PACK_MESH*)GetPackSection(m_file, header.meshes, sizeof(PACK_MESH));
+	if ((NULL == pStrings) || (NULL == pMeshes) ||
+		(NULL == GetPackSection(m_file, header.vertices, sizeof(PACKED_VERTEX))) ||
+		(NULL == GetPackSection(m_file, header.indices, 1)))
+	{
+		std::cout << "Could not load mesh pack, a section is out of range:" << filename << std::endl;
+		Close();
+		return(false);
+	}
+
+	m_meshes.resize((size_t)header.meshes.count);
+	for (size_t i = 0; i < m_meshes.size(); i++)
+	{
+		const PACK_MESH& entry = pMeshes[i];
+		LIBRARY_MESH& mesh = m_meshes[i];
+
+		uint64_t indexBytes = (uint64_t)entry.indexCount * entry.indexSize;
+		bool bValid =
+			((entry.indexSize == 2) || (entry.indexSize == 4)) &&
+			(entry.indexOffset % entry.indexSize == 0) &&
+			(entry.indexOffset <= header.indices.count) &&
+			(indexBytes <= header.indices.count - entry.indexOffset) &&
+			(entry.firstVertex <= header.vertices.count) &&
+			(entry.vertexCount <= header.vertices.count - entry.firstVertex) &&
+			(entry.firstVertex <= 0x7FFFFFFF) &&
+			(entry.indexCount <= 0x7FFFFFFF) &&
+			(entry.name < header.strings.count) &&
+			(memchr(pStrings + entry.name, '\0', (size_t)(header.strings.count - entry.name)) != NULL);
+		if (bValid == false)
+		{
+			std::cout << "Could not load mesh pack, mesh " << i << " is out of range:" << filename << std::endl;
+			Close();
+			return(false);
+		}
+
+		mesh.name = pStrings + entry.name;
+		mesh.indexType = (entry.indexSize == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		mesh.indexCount = (GLsizei)entry.indexCount;
+		mesh.baseVertex = (GLint)entry.firstVertex;
+		mesh.indexOffset = (size_t)entry.indexOffset;
+
+		glm::vec3 boundsMin(entry.boundsMin[0], entry.boundsMin[1], entry.boundsMin[2]);
+		glm::vec3 boundsMax(entry.boundsMax[0], entry.boundsMax[1], entry.boundsMax[2]);
+		glm::vec3 extent = boundsMax - boundsMin;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (extent[axis] <= 0.0f)
+			{
+				extent[axis] = 1.0f;
+			}
+		}
+		mesh.dequantization = glm::scale(glm::translate(glm::mat4(1.0f), boundsMin), extent);
+		mesh.center = (boundsMin + boundsMax) * 0.5f;
+		mesh.radius = glm::length(boundsMax - boundsMin) * 0.5f;
+
+		m_meshIndices[mesh.name] = (int)i;
+	}
+
+	m_vertices = header.vertices;
+	m_indices = header.indices;
+	return(true);
+}
+
+/***********************************************************
+ *  Upload()
+ *
+ *  This method is used for creating the geometry buffers of
+ *  the loaded pack.  Both arrays go from the mapping to the
+ *  driver in one copy each, with no parsing in between, and
+ *  the file is unmapped afterwards.
+ ***********************************************************/
+bool MeshLibrary::Upload()
+{
+	if (NULL == m_file.GetData())
+	{
+		return(false);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	glGenVertexArrays(1, &m_vertexArray);
+	glBindVertexArray(m_vertexArray);
+
+	glGenBuffers(1, &m_vertexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER,
+		(GLsizeiptr)(m_vertices.count * sizeof(PACKED_VERTEX)),
+		m_file.GetData() + m_vertices.offset,
+		GL_STATIC_DRAW);
+
+	glGenBuffers(1, &m_indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+		(GLsizeiptr)m_indices.count,
+		m_file.GetData() + m_indices.offset,
+		GL_STATIC_DRAW);
+
+	// same attribute locations as the basic shape meshes
+	GLsizei stride = sizeof(PACKED_VERTEX);
+	glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)offsetof(PACKED_VERTEX, position));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 3, GL_BYTE, GL_TRUE, stride, (void*)offsetof(PACKED_VERTEX, normal));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(PACKED_VERTEX, texCoord));
+	glEnableVertexAttribArray(2);
+
+	glBindVertexArray(0);
+
+	double milliseconds = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start).count();
+	std::cout << "INFO: Uploaded " << m_meshes.size() << " meshes, " << m_vertices.count << " vertices and "
+		<< m_indices.count << " index bytes from " << m_filename << " in " << milliseconds << " ms" << std::endl;
+
+	m_file.Close();
+	return(true);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for deleting the geometry buffers and
+ *  forgetting the meshes of the pack.
+ ***********************************************************/
+void MeshLibrary::Close()
+{
+	if (m_vertexArray != 0)
+	{
+		glDeleteVertexArrays(1, &m_vertexArray);
+		m_vertexArray = 0;
+	}
+	if (m_vertexBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_vertexBuffer);
+		m_vertexBuffer = 0;
+	}
+	if (m_indexBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_indexBuffer);
+		m_indexBuffer = 0;
+	}
+	m_file.Close();
+	m_meshes.clear();
+	m_meshIndices.clear();
+	m_vertices.offset = 0;
+	m_vertices.count = 0;
+	m_indices.offset = 0;
+	m_indices.count = 0;
+}
+
+/***********************************************************
+ *  FindMesh()
+ *
+ *  Returns the index of the mesh with the passed in name,
+ *  or -1 when the pack has no such mesh.
+ ***********************************************************/
+int MeshLibrary::FindMesh(const std::string& name) const
+{
+	std::unordered_map<std::string, int>::const_iterator found = m_meshIndices.find(name);
+	if (found == m_meshIndices.end())
+	{
+		return(-1);
+	}
+	return(found->second);
+}
+
+/***********************************************************
+ *  GetBounds()
+ *
+ *  This method is used for getting the bounding sphere of a
+ *  mesh, around the center of its quantization bounds.
+ ***********************************************************/
+void MeshLibrary::GetBounds(int index, glm::vec3& center, float& radius) const
+{
+	center = m_meshes[index].center;
+	radius = m_meshes[index].radius;
+}
+
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing a mesh of the pack.  All
+ *  meshes share the buffers, so the base vertex picks out
+ *  the vertices of the mesh.
+ ***********************************************************/
+bool MeshLibrary::DrawMesh(int index) const
+{
+	if ((m_vertexArray == 0) || (index < 0) || (index >= (int)m_meshes.size()))
+	{
+		return(false);
+	}
+
+	const LIBRARY_MESH& mesh = m_meshes[index];
+	glBindVertexArray(m_vertexArray);
+	glDrawElementsBaseVertex(GL_TRIANGLES, mesh.indexCount, mesh.indexType,
+		(void*)mesh.indexOffset, mesh.baseVertex);
+	glBindVertexArray(0);
+	return(true);
+}
@@ -0,0 +1,150 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshlibrary.h
+// ============
+// load packs of imported meshes by mapping them straight into geometry buffers
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MappedFile.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  MeshLibrary
+ *
+ *  This class draws the meshes of a mesh pack, as written by
+ *  the MeshImporter.  A pack holds every vertex of every
+ *  mesh in one array and every index in another, already in
+ *  the layout the GPU reads, so loading maps the file and
+ *  hands both arrays to OpenGL as they are - the only work
+ *  per mesh is reading its entry, and none is done per
+ *  vertex.
+ *
+ *  Vertices are quantized to 16 bytes: the position as three
+ *  16 bit fractions of the mesh bounds, the normal as three
+ *  signed bytes and the texture coordinate as two half
+ *  floats.  The shader receives positions between 0 and 1;
+ *  the dequantization matrix of a mesh maps them back to
+ *  model units and is multiplied into the model matrix, so
+ *  the shaders need no change.  The normals were stored
+ *  already scaled for that matrix.
+ ***********************************************************/
+class MeshLibrary
+{
+public:
+	// an array of the pack - the offset is from the start of
+	// the file, the count is in elements
+	struct PACK_SECTION
+	{
+		uint64_t offset;
+		uint64_t count;
+	};
+
+	// header at the start of a pack
+	struct PACK_HEADER
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t byteOrder;
+		uint32_t vertexSize;
+		uint32_t meshSize;
+		// null terminated names, counted in bytes
+		PACK_SECTION strings;
+		PACK_SECTION meshes;
+		PACK_SECTION vertices;
+		// indices, counted in bytes since their size varies
+		PACK_SECTION indices;
+	};
+
+	// a mesh of the pack
+	struct PACK_MESH
+	{
+		uint32_t name;
+		// 2 or 4 bytes per index
+		uint32_t indexSize;
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		// first vertex in the vertex array, and byte offset of
+		// the first index in the index array - indices count
+		// from the first vertex
+		uint64_t firstVertex;
+		uint64_t indexOffset;
+		// bounds the positions are quantized in
+		float boundsMin[3];
+		float boundsMax[3];
+	};
+
+	// a quantized vertex
+	struct PACKED_VERTEX
+	{
+		uint16_t position[4];
+		int8_t normal[4];
+		uint16_t texCoord[2];
+	};
+
+	// newest pack version, and its first bytes
+	static const uint32_t PACK_VERSION = 1;
+	static const char* GetPackMagic() { return("MESHPACK"); }
+	// every section starts on this many bytes
+	static const uint64_t PACK_ALIGNMENT = 16;
+	// written in the native byte order, so it reads back
+	// differently on a machine of the other order
+	static const uint32_t PACK_BYTE_ORDER = 0x01020304;
+
+	// constructor
+	MeshLibrary();
+	// destructor
+	~MeshLibrary();
+
+	// map a pack and read its mesh entries - no OpenGL calls
+	bool Load(const char* filename);
+	// copy the vertices and indices of the loaded pack into
+	// the geometry buffers and unmap it
+	bool Upload();
+	// delete the buffers and forget the meshes
+	void Close();
+
+	// index of a mesh by name, or -1
+	int FindMesh(const std::string& name) const;
+	int GetMeshCount() const { return((int)m_meshes.size()); }
+	const std::string& GetMeshName(int index) const { return(m_meshes[index].name); }
+	// matrix to multiply into the model matrix of the mesh
+	const glm::mat4& GetDequantization(int index) const { return(m_meshes[index].dequantization); }
+	// bounding sphere of the mesh in model units
+	void GetBounds(int index, glm::vec3& center, float& radius) const;
+
+	// draw a mesh - false when it is not uploaded
+	bool DrawMesh(int index) const;
+
+private:
+	struct LIBRARY_MESH
+	{
+		std::string name;
+		GLenum indexType;
+		GLsizei indexCount;
+		GLint baseVertex;
+		size_t indexOffset;
+		glm::mat4 dequantization;
+		glm::vec3 center;
+		float radius;
+	};
+
+	MappedFile m_file;
+	std::string m_filename;
+	std::vector<LIBRARY_MESH> m_meshes;
+	std::unordered_map<std::string, int> m_meshIndices;
+	// where the vertex and index arrays are in the mapped file
+	PACK_SECTION m_vertices;
+	PACK_SECTION m_indices;
+	GLuint m_vertexArray;
+	GLuint m_vertexBuffer;
+	GLuint m_indexBuffer;
+};
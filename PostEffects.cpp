@@ -0,0 +1,384 @@
+///////////////////////////////////////////////////////////////////////////////
+// posteffects.cpp
+// ============
+// tonemapping, bloom, color grading and vignette over the finished scene
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PostEffects.h"
+
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	const char* g_EffectNames[] = {
+		"tonemap", "bloom", "grading", "vignette" };
+	const int EFFECT_COUNT = 4;
+
+	// name of the texture the effects start from, which is also
+	// the name its sampler has in the GLSL
+	const char* SCENE_TEXTURE = "sceneColor";
+	// name of the texture holding the result
+	const char* OUTPUT_TEXTURE = "postColor";
+
+	/***********************************************************
+	 *  BuildDownsampleSource()
+	 *
+	 *  Returns the GLSL of a pass halving a texture.  Four
+	 *  filtered reads a texel of the input away from the center
+	 *  average a block of four by four texels, which keeps the
+	 *  bloom from flickering as the camera moves.  The first
+	 *  pass only keeps the light above the threshold.
+	 ***********************************************************/
+	std::string BuildDownsampleSource(const std::string& function, const std::string& input, bool bThreshold)
+	{
+		std::string source;
+		if (bThreshold == true)
+		{
+			source += "uniform float bloomThreshold;\n";
+		}
+		source +=
+			"vec4 " + function + "(vec2 uv)\n"
+			"{\n"
+			"	vec2 step = " + input + "Step;\n"
+			"	vec3 color = 0.25 * (" + input + "At(uv + vec2(-step.x, -step.y)).rgb + " +
+				input + "At(uv + vec2(step.x, -step.y)).rgb + " +
+				input + "At(uv + vec2(-step.x, step.y)).rgb + " +
+				input + "At(uv + vec2(step.x, step.y)).rgb);\n";
+		if (bThreshold == true)
+		{
+			source +=
+				"	float brightness = max(color.r, max(color.g, color.b));\n"
+				"	color *= max(brightness - bloomThreshold, 0.0) / max(brightness, 0.0001);\n";
+		}
+		source +=
+			"	return(vec4(color, 1.0));\n"
+			"}\n";
+		return(source);
+	}
+
+	/***********************************************************
+	 *  BuildUpsampleSource()
+	 *
+	 *  Returns the GLSL of a pass doubling the blurred light
+	 *  with a three by three tent filter and adding it to the
+	 *  light of the larger size, so every size of glow is kept.
+	 ***********************************************************/
+	std::string BuildUpsampleSource(const std::string& function, const std::string& lower, const std::string& higher)
+	{
+		return(
+			"vec4 " + function + "(vec2 uv)\n"
+			"{\n"
+			"	vec2 step = " + lower + "Step;\n"
+			"	vec3 blurred = 4.0 * " + lower + "At(uv).rgb;\n"
+			"	blurred += 2.0 * (" + lower + "At(uv + vec2(step.x, 0.0)).rgb + " +
+				lower + "At(uv - vec2(step.x, 0.0)).rgb + " +
+				lower + "At(uv + vec2(0.0, step.y)).rgb + " +
+				lower + "At(uv - vec2(0.0, step.y)).rgb);\n"
+			"	blurred += " + lower + "At(uv + step).rgb + " +
+				lower + "At(uv - step).rgb + " +
+				lower + "At(uv + vec2(step.x, -step.y)).rgb + " +
+				lower + "At(uv + vec2(-step.x, step.y)).rgb;\n"
+			"	return(vec4(" + higher + "At(uv).rgb + blurred / 16.0, 1.0));\n"
+			"}\n");
+	}
+
+	// adds the blurred light to the scene
+	const char* BLOOM_ADD_SOURCE =
+		"uniform float bloomIntensity;\n"
+		"vec3 BloomAdd(vec3 color, vec2 uv)\n"
+		"{\n"
+		"	return(color + bloomIntensity * bloomUpHalfAt(uv).rgb);\n"
+		"}\n";
+
+	// fitted ACES filmic curve - a toe that deepens the shadows
+	// and a shoulder that rolls the highlights off to white
+	const char* TONEMAP_SOURCE =
+		"uniform float postExposure;\n"
+		"vec3 Tonemap(vec3 color, vec2 uv)\n"
+		"{\n"
+		"	color *= postExposure;\n"
+		"	return(clamp((color * (2.51 * color + 0.03)) / (color * (2.43 * color + 0.59) + 0.14), 0.0, 1.0));\n"
+		"}\n";
+
+	// saturation around the luma, then contrast around middle
+	// gray
+	const char* COLOR_GRADE_SOURCE =
+		"uniform float gradeSaturation;\n"
+		"uniform float gradeContrast;\n"
+		"vec3 ColorGrade(vec3 color, vec2 uv)\n"
+		"{\n"
+		"	float luma = dot(color, vec3(0.2126, 0.7152, 0.0722));\n"
+		"	color = mix(vec3(luma), color, gradeSaturation);\n"
+		"	color = (color - 0.5) * gradeContrast + 0.5;\n"
+		"	return(max(color, vec3(0.0)));\n"
+		"}\n";
+
+	// darkens with the distance from the center, measured in
+	// the same units across and up so the falloff is round
+	const char* VIGNETTE_SOURCE =
+		"uniform float vignetteStrength;\n"
+		"vec3 Vignette(vec3 color, vec2 uv)\n"
+		"{\n"
+		"	vec2 offset = (uv - 0.5) * vec2(outputSize.x / outputSize.y, 1.0);\n"
+		"	float falloff = smoothstep(0.9, 0.3, length(offset));\n"
+		"	return(color * mix(1.0, falloff, vignetteStrength));\n"
+		"}\n";
+}
+
+/***********************************************************
+ *  PostEffects()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+PostEffects::PostEffects()
+{
+	m_settings.effects = 0;
+	m_settings.exposure = 1.0f;
+	m_settings.bloomThreshold = 1.0f;
+	m_settings.bloomIntensity = 0.2f;
+	m_settings.saturation = 1.0f;
+	m_settings.contrast = 1.0f;
+	m_settings.vignette = 0.0f;
+}
+
+/***********************************************************
+ *  ~PostEffects()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+PostEffects::~PostEffects()
+{
+	Shutdown();
+}
+
+/***********************************************************
+ *  ParseEffects()
+ *
+ *  This method is used for reading the effects named in a
+ *  comma separated list.
+ ***********************************************************/
+bool PostEffects::ParseEffects(const std::string& list, unsigned int& effects)
+{
+	effects = 0;
+	size_t start = 0;
+	while (start <= list.size())
+	{
+		size_t end = list.find(',', start);
+		if (end == std::string::npos)
+		{
+			end = list.size();
+		}
+		std::string name = list.substr(start, end - start);
+		start = end + 1;
+		if (name.size() == 0)
+		{
+			continue;
+		}
+
+		if (name == "all")
+		{
+			effects |= post_all;
+			continue;
+		}
+		int effect = 0;
+		while ((effect < EFFECT_COUNT) && (name != g_EffectNames[effect]))
+		{
+			effect++;
+		}
+		if (effect == EFFECT_COUNT)
+		{
+			return(false);
+		}
+		effects |= (1u << effect);
+	}
+	return(effects != 0);
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for declaring the effects into the
+ *  graph and compiling it for the result texture.
+ ***********************************************************/
+bool PostEffects::Initialize(const POST_SETTINGS& settings)
+{
+	Shutdown();
+
+	m_settings = settings;
+	m_graph.Clear();
+	DeclarePasses();
+	if (m_graph.Compile(OUTPUT_TEXTURE) == false)
+	{
+		return(false);
+	}
+	m_graph.PrintSummary();
+	return(true);
+}
+
+/***********************************************************
+ *  Shutdown()
+ *
+ *  This method is used for freeing the programs of the
+ *  graph.
+ ***********************************************************/
+void PostEffects::Shutdown()
+{
+	m_graph.Shutdown();
+}
+
+/***********************************************************
+ *  GetSceneColorFormat()
+ *
+ *  This method is used for getting the color format of the
+ *  scene target.  Light above one only survives in floating
+ *  point, which the bloom and the tonemap curve need.
+ ***********************************************************/
+GLenum PostEffects::GetSceneColorFormat() const
+{
+	if ((m_settings.effects & (post_tonemap | post_bloom)) != 0)
+	{
+		return(GL_RGBA16F);
+	}
+	return(GL_RGBA8);
+}
+
+/***********************************************************
+ *  DeclarePasses()
+ *
+ *  This method is used for declaring the textures and passes
+ *  of all the effects.  The bloom chain is always enabled,
+ *  and is culled when the pass adding it is turned off.
+ ***********************************************************/
+void PostEffects::DeclarePasses()
+{
+	bool bBloom = ((m_settings.effects & post_bloom) != 0);
+
+	m_graph.ImportTexture(SCENE_TEXTURE);
+	m_graph.CreateTexture("bloomHalf", 2, GL_RGBA16F);
+	m_graph.CreateTexture("bloomQuarter", 4, GL_RGBA16F);
+	m_graph.CreateTexture("bloomEighth", 8, GL_RGBA16F);
+	m_graph.CreateTexture("bloomUpQuarter", 4, GL_RGBA16F);
+	m_graph.CreateTexture("bloomUpHalf", 2, GL_RGBA16F);
+	m_graph.CreateTexture("bloomedColor", 1, GL_RGBA16F);
+	m_graph.CreateTexture("tonemappedColor", 1, GL_RGBA8);
+	m_graph.CreateTexture("gradedColor", 1, GL_RGBA8);
+	m_graph.CreateTexture(OUTPUT_TEXTURE, 1, GL_RGBA8);
+
+	PostProcessGraph::PASS_DESC pass;
+	pass.kind = PostProcessGraph::pass_gather;
+	pass.bEnabled = true;
+
+	pass.name = "Bloom Bright";
+	pass.inputs = { SCENE_TEXTURE };
+	pass.output = "bloomHalf";
+	pass.function = "BloomBright";
+	pass.source = BuildDownsampleSource(pass.function, SCENE_TEXTURE, true);
+	pass.setUniforms = [this](GLuint program)
+	{
+		glUniform1f(glGetUniformLocation(program, "bloomThreshold"), m_settings.bloomThreshold);
+	};
+	m_graph.AddPass(pass);
+
+	pass.name = "Bloom Down 1/4";
+	pass.inputs = { "bloomHalf" };
+	pass.output = "bloomQuarter";
+	pass.function = "BloomDown";
+	pass.source = BuildDownsampleSource(pass.function, "bloomHalf", false);
+	pass.setUniforms = nullptr;
+	m_graph.AddPass(pass);
+
+	pass.name = "Bloom Down 1/8";
+	pass.inputs = { "bloomQuarter" };
+	pass.output = "bloomEighth";
+	pass.source = BuildDownsampleSource(pass.function, "bloomQuarter", false);
+	m_graph.AddPass(pass);
+
+	pass.name = "Bloom Up 1/4";
+	pass.inputs = { "bloomEighth", "bloomQuarter" };
+	pass.output = "bloomUpQuarter";
+	pass.function = "BloomUp";
+	pass.source = BuildUpsampleSource(pass.function, "bloomEighth", "bloomQuarter");
+	m_graph.AddPass(pass);
+
+	pass.name = "Bloom Up 1/2";
+	pass.inputs = { "bloomUpQuarter", "bloomHalf" };
+	pass.output = "bloomUpHalf";
+	pass.source = BuildUpsampleSource(pass.function, "bloomUpQuarter", "bloomHalf");
+	m_graph.AddPass(pass);
+
+	// the per-pixel effects, fused into one pass
+	pass.kind = PostProcessGraph::pass_pixel;
+
+	pass.name = "Bloom Add";
+	pass.inputs = { SCENE_TEXTURE, "bloomUpHalf" };
+	pass.output = "bloomedColor";
+	pass.function = "BloomAdd";
+	pass.source = BLOOM_ADD_SOURCE;
+	pass.setUniforms = [this](GLuint program)
+	{
+		glUniform1f(glGetUniformLocation(program, "bloomIntensity"), m_settings.bloomIntensity);
+	};
+	pass.bEnabled = bBloom;
+	m_graph.AddPass(pass);
+
+	pass.name = "Tonemap";
+	pass.inputs = { "bloomedColor" };
+	pass.output = "tonemappedColor";
+	pass.function = "Tonemap";
+	pass.source = TONEMAP_SOURCE;
+	pass.setUniforms = [this](GLuint program)
+	{
+		glUniform1f(glGetUniformLocation(program, "postExposure"), m_settings.exposure);
+	};
+	pass.bEnabled = ((m_settings.effects & post_tonemap) != 0);
+	m_graph.AddPass(pass);
+
+	pass.name = "Color Grading";
+	pass.inputs = { "tonemappedColor" };
+	pass.output = "gradedColor";
+	pass.function = "ColorGrade";
+	pass.source = COLOR_GRADE_SOURCE;
+	pass.setUniforms = [this](GLuint program)
+	{
+		glUniform1f(glGetUniformLocation(program, "gradeSaturation"), m_settings.saturation);
+		glUniform1f(glGetUniformLocation(program, "gradeContrast"), m_settings.contrast);
+	};
+	pass.bEnabled = ((m_settings.effects & post_grading) != 0);
+	m_graph.AddPass(pass);
+
+	pass.name = "Vignette";
+	pass.inputs = { "gradedColor" };
+	pass.output = OUTPUT_TEXTURE;
+	pass.function = "Vignette";
+	pass.source = VIGNETTE_SOURCE;
+	pass.setUniforms = [this](GLuint program)
+	{
+		glUniform1f(glGetUniformLocation(program, "vignetteStrength"), m_settings.vignette);
+	};
+	pass.bEnabled = ((m_settings.effects & post_vignette) != 0);
+	m_graph.AddPass(pass);
+}
+
+/***********************************************************
+ *  Apply()
+ *
+ *  This method is used for running the effects over the
+ *  scene.
+ ***********************************************************/
+RenderTarget* PostEffects::Apply(RenderTargetPool& pool, RenderTarget& scene, int renderWidth, int renderHeight)
+{
+	return(m_graph.Execute(pool, scene, renderWidth, renderHeight));
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for giving the result target back to
+ *  the pool once it has been copied to the window.
+ ***********************************************************/
+void PostEffects::EndFrame(RenderTargetPool& pool)
+{
+	m_graph.EndFrame(pool);
+}
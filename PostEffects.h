@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////
+// posteffects.h
+// ============
+// tonemapping, bloom, color grading and vignette over the finished scene
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "PostProcessGraph.h"
+#include "RenderTarget.h"
+#include "RenderTargetPool.h"
+
+#include <GL/glew.h>
+
+#include <string>
+
+/***********************************************************
+ *  PostEffects
+ *
+ *  This class declares the post-processing effects as passes
+ *  of a post-processing graph.  Every effect is declared
+ *  whether it is turned on or not, and the graph leaves out
+ *  what the chosen effects do not need:
+ *
+ *  - bloom keeps the light above a threshold at half size,
+ *    blurs it down to an eighth and back up, and adds it to
+ *    the scene so bright highlights glow,
+ *  - tonemapping brings the floating point scene into the
+ *    displayable range with an exposure and a filmic curve,
+ *  - color grading changes saturation and contrast,
+ *  - the vignette darkens the corners of the image.
+ *
+ *  The bloom is added, tonemapped, graded and vignetted in
+ *  one fused pass.  Bloom and tonemapping need the scene in
+ *  a floating point target, or the highlights are clipped
+ *  before they get here.
+ ***********************************************************/
+class PostEffects
+{
+public:
+	enum POST_EFFECT
+	{
+		post_tonemap = 1 << 0,
+		post_bloom = 1 << 1,
+		post_grading = 1 << 2,
+		post_vignette = 1 << 3,
+		post_all = post_tonemap | post_bloom | post_grading | post_vignette
+	};
+
+	struct POST_SETTINGS
+	{
+		// POST_EFFECT flags of the effects turned on
+		unsigned int effects;
+		// scale of the scene color before the tonemap curve
+		float exposure;
+		// brightness the bloom starts at, and how much of it is
+		// added to the scene
+		float bloomThreshold;
+		float bloomIntensity;
+		// color grading, 1 leaves the color unchanged
+		float saturation;
+		float contrast;
+		// how dark the corners get, from 0 to 1
+		float vignette;
+	};
+
+	// constructor
+	PostEffects();
+	// destructor
+	~PostEffects();
+
+	// read a comma separated list of effect names, or all -
+	// false when a name is not known
+	static bool ParseEffects(const std::string& list, unsigned int& effects);
+
+	// declare the effects and compile the graph - false when a
+	// program cannot be built
+	bool Initialize(const POST_SETTINGS& settings);
+	// free the programs of the graph
+	void Shutdown();
+
+	// color format the scene must be drawn in for the effects
+	GLenum GetSceneColorFormat() const;
+
+	// run the effects over the lower left corner of the scene
+	// and return the target holding the result
+	RenderTarget* Apply(RenderTargetPool& pool, RenderTarget& scene, int renderWidth, int renderHeight);
+	// give the result target back to the pool
+	void EndFrame(RenderTargetPool& pool);
+
+private:
+	POST_SETTINGS m_settings;
+	PostProcessGraph m_graph;
+
+	// declare the textures and passes of every effect
+	void DeclarePasses();
+};
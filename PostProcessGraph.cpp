@@ -0,0 +1,779 @@
+///////////////////////////////////////////////////////////////////////////////
+// postprocessgraph.cpp
+// ============
+// full screen post-processing passes, culled, fused and run over pooled targets
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PostProcessGraph.h"
+#include "GPUProfiler.h"
+#include "ShaderCompiler.h"
+
+#include <algorithm>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// most textures one step may read
+	const int MAX_STEP_INPUTS = 4;
+	// pixels a compute work group covers across and up
+	const int GROUP_SIZE = 8;
+
+	// full screen triangle, with texture coordinates that are
+	// 0 to 1 over the viewport
+	const char* FULLSCREEN_VERTEX_SOURCE =
+		"#version 330 core\n"
+		"out vec2 texCoord;\n"
+		"void main()\n"
+		"{\n"
+		"	vec2 corner = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));\n"
+		"	texCoord = corner;\n"
+		"	gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);\n"
+		"}\n";
+
+	// bindings the passes change, put back afterwards since the
+	// scene keeps its textures bound between frames
+	struct PASS_STATE
+	{
+		GLint program;
+		GLint activeUnit;
+		GLint textures[MAX_STEP_INPUTS];
+		GLint samplers[MAX_STEP_INPUTS];
+		GLboolean bDepthTest;
+	};
+
+	/***********************************************************
+	 *  SavePassState()
+	 *
+	 *  Reads the bindings the passes are about to change.
+	 ***********************************************************/
+	void SavePassState(PASS_STATE& state)
+	{
+		glGetIntegerv(GL_CURRENT_PROGRAM, &state.program);
+		glGetIntegerv(GL_ACTIVE_TEXTURE, &state.activeUnit);
+		for (int i = 0; i < MAX_STEP_INPUTS; i++)
+		{
+			glActiveTexture(GL_TEXTURE0 + i);
+			glGetIntegerv(GL_TEXTURE_BINDING_2D, &state.textures[i]);
+			glGetIntegerv(GL_SAMPLER_BINDING, &state.samplers[i]);
+		}
+		state.bDepthTest = glIsEnabled(GL_DEPTH_TEST);
+	}
+
+	/***********************************************************
+	 *  RestorePassState()
+	 *
+	 *  Puts back the bindings read by SavePassState().
+	 ***********************************************************/
+	void RestorePassState(const PASS_STATE& state)
+	{
+		for (int i = 0; i < MAX_STEP_INPUTS; i++)
+		{
+			glActiveTexture(GL_TEXTURE0 + i);
+			glBindTexture(GL_TEXTURE_2D, (GLuint)state.textures[i]);
+			glBindSampler(i, (GLuint)state.samplers[i]);
+		}
+		glActiveTexture((GLenum)state.activeUnit);
+		glUseProgram((GLuint)state.program);
+		if (state.bDepthTest == GL_TRUE)
+		{
+			glEnable(GL_DEPTH_TEST);
+		}
+	}
+
+	/***********************************************************
+	 *  GetImageFormat()
+	 *
+	 *  Returns the GLSL image format of a sized texture format,
+	 *  or null when a compute shader cannot store to it.
+	 ***********************************************************/
+	const char* GetImageFormat(GLenum format)
+	{
+		switch (format)
+		{
+		case GL_RGBA8:
+			return("rgba8");
+		case GL_RGBA16F:
+			return("rgba16f");
+		case GL_RGBA32F:
+			return("rgba32f");
+		case GL_R11F_G11F_B10F:
+			return("r11f_g11f_b10f");
+		default:
+			return(NULL);
+		}
+	}
+
+	/***********************************************************
+	 *  AddUnique()
+	 *
+	 *  Appends a value to a list that does not hold it yet.
+	 ***********************************************************/
+	void AddUnique(std::vector<int>& values, int value)
+	{
+		if (std::find(values.begin(), values.end(), value) == values.end())
+		{
+			values.push_back(value);
+		}
+	}
+}
+
+/***********************************************************
+ *  PostProcessGraph()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+PostProcessGraph::PostProcessGraph()
+{
+	m_output = -1;
+	m_pOutputTarget = NULL;
+	m_vertexArray = 0;
+	m_sampler = 0;
+	m_culledCount = 0;
+	m_fusedCount = 0;
+}
+
+/***********************************************************
+ *  ~PostProcessGraph()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+PostProcessGraph::~PostProcessGraph()
+{
+	Shutdown();
+}
+
+/***********************************************************
+ *  FindResource()
+ *
+ *  Returns the index of the texture with the passed in name,
+ *  or -1 when there is none.
+ ***********************************************************/
+int PostProcessGraph::FindResource(const std::string& name) const
+{
+	for (int i = 0; i < (int)m_resources.size(); i++)
+	{
+		if (m_resources[i].name == name)
+		{
+			return(i);
+		}
+	}
+	return(-1);
+}
+
+/***********************************************************
+ *  ImportTexture()
+ *
+ *  This method is used for declaring the texture the passes
+ *  start from.  Its target is handed to Execute().
+ ***********************************************************/
+void PostProcessGraph::ImportTexture(const std::string& name)
+{
+	RESOURCE resource;
+	resource.name = name;
+	resource.bImported = true;
+	resource.divisor = 1;
+	resource.format = 0;
+	resource.lastStep = -1;
+	resource.pTarget = NULL;
+	m_resources.push_back(resource);
+}
+
+/***********************************************************
+ *  CreateTexture()
+ *
+ *  This method is used for declaring a texture that only
+ *  lives while the passes of a frame need it.
+ ***********************************************************/
+void PostProcessGraph::CreateTexture(const std::string& name, int divisor, GLenum format)
+{
+	RESOURCE resource;
+	resource.name = name;
+	resource.bImported = false;
+	resource.divisor = std::max(divisor, 1);
+	resource.format = format;
+	resource.lastStep = -1;
+	resource.pTarget = NULL;
+	m_resources.push_back(resource);
+}
+
+/***********************************************************
+ *  AddPass()
+ *
+ *  This method is used for declaring a pass.  Its textures
+ *  are looked up when the graph is compiled.
+ ***********************************************************/
+void PostProcessGraph::AddPass(const PASS_DESC& pass)
+{
+	PASS_ENTRY entry;
+	entry.desc = pass;
+	entry.output = -1;
+	m_passes.push_back(entry);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every declared texture
+ *  and pass, along with the programs built for them.
+ ***********************************************************/
+void PostProcessGraph::Clear()
+{
+	Shutdown();
+	m_resources.clear();
+	m_passes.clear();
+	m_output = -1;
+}
+
+/***********************************************************
+ *  Compile()
+ *
+ *  This method is used for choosing the programs that run
+ *  each frame and building them.  The passes are checked in
+ *  the order declared, so every texture a pass reads must be
+ *  imported or written by an earlier enabled pass.  Per-pixel
+ *  chains run as compute dispatches when compute shaders are
+ *  available, and as full screen draws otherwise.
+ ***********************************************************/
+bool PostProcessGraph::Compile(const std::string& outputName)
+{
+	Shutdown();
+	m_culledCount = 0;
+	m_fusedCount = 0;
+
+	int output = FindResource(outputName);
+	if (output < 0)
+	{
+		std::cout << "Could not compile the post-processing graph, it has no texture " << outputName << std::endl;
+		return(false);
+	}
+
+	// the texture read in place of each texture, which differs
+	// for the outputs of disabled per-pixel passes, and the pass
+	// writing each texture
+	std::vector<int> alias(m_resources.size());
+	std::vector<int> producer(m_resources.size(), -1);
+	for (size_t i = 0; i < m_resources.size(); i++)
+	{
+		alias[i] = (int)i;
+	}
+
+	for (size_t p = 0; p < m_passes.size(); p++)
+	{
+		PASS_ENTRY& pass = m_passes[p];
+		pass.inputs.clear();
+		pass.output = FindResource(pass.desc.output);
+		if ((pass.output < 0) || (m_resources[pass.output].bImported == true))
+		{
+			std::cout << "Could not compile the post-processing graph, pass " << pass.desc.name
+				<< " writes no texture it may write" << std::endl;
+			return(false);
+		}
+		if ((pass.desc.kind == pass_pixel) && (pass.desc.inputs.size() == 0))
+		{
+			std::cout << "Could not compile the post-processing graph, pass " << pass.desc.name
+				<< " has no color to change" << std::endl;
+			return(false);
+		}
+
+		for (size_t i = 0; i < pass.desc.inputs.size(); i++)
+		{
+			int input = FindResource(pass.desc.inputs[i]);
+			if (input < 0)
+			{
+				std::cout << "Could not compile the post-processing graph, pass " << pass.desc.name
+					<< " reads the unknown texture " << pass.desc.inputs[i] << std::endl;
+				return(false);
+			}
+			input = alias[input];
+			if ((pass.desc.bEnabled == true) && (m_resources[input].bImported == false) && (producer[input] < 0))
+			{
+				std::cout << "Could not compile the post-processing graph, pass " << pass.desc.name
+					<< " reads " << m_resources[input].name << " before any pass writes it" << std::endl;
+				return(false);
+			}
+			pass.inputs.push_back(input);
+		}
+
+		if (pass.desc.bEnabled == false)
+		{
+			// a disabled per-pixel pass hands its color on as it is
+			if (pass.desc.kind == pass_pixel)
+			{
+				alias[pass.output] = pass.inputs[0];
+			}
+			continue;
+		}
+		if (producer[pass.output] >= 0)
+		{
+			std::cout << "Could not compile the post-processing graph, " << pass.desc.output
+				<< " is written by more than one pass" << std::endl;
+			return(false);
+		}
+		producer[pass.output] = (int)p;
+	}
+
+	m_output = alias[output];
+	if ((m_resources[m_output].bImported == false) && (producer[m_output] < 0))
+	{
+		std::cout << "Could not compile the post-processing graph, no pass writes " << outputName << std::endl;
+		return(false);
+	}
+
+	// walk back from the output, keeping the passes whose
+	// textures are read on the way
+	std::vector<bool> bNeeded(m_resources.size(), false);
+	std::vector<bool> bLive(m_passes.size(), false);
+	bNeeded[m_output] = true;
+	for (int p = (int)m_passes.size() - 1; p >= 0; p--)
+	{
+		const PASS_ENTRY& pass = m_passes[p];
+		if (pass.desc.bEnabled == false)
+		{
+			continue;
+		}
+		if (bNeeded[pass.output] == false)
+		{
+			m_culledCount++;
+			continue;
+		}
+		bLive[p] = true;
+		for (size_t i = 0; i < pass.inputs.size(); i++)
+		{
+			bNeeded[pass.inputs[i]] = true;
+		}
+	}
+
+	// a texture between two per-pixel passes is left out when
+	// the second pass is its only reader
+	std::vector<int> readers(m_resources.size(), 0);
+	readers[m_output]++;
+	for (size_t p = 0; p < m_passes.size(); p++)
+	{
+		for (size_t i = 0; (bLive[p] == true) && (i < m_passes[p].inputs.size()); i++)
+		{
+			readers[m_passes[p].inputs[i]]++;
+		}
+	}
+
+	for (size_t p = 0; p < m_passes.size(); p++)
+	{
+		if (bLive[p] == false)
+		{
+			continue;
+		}
+		const PASS_ENTRY& pass = m_passes[p];
+
+		bool bFuse = false;
+		if ((pass.desc.kind == pass_pixel) && (m_steps.size() > 0))
+		{
+			const STEP& last = m_steps.back();
+			const PASS_ENTRY& previous = m_passes[last.passes.back()];
+			bFuse = (previous.desc.kind == pass_pixel) &&
+				(pass.inputs[0] == last.output) &&
+				(readers[last.output] == 1) &&
+				(m_resources[last.output].divisor == m_resources[pass.output].divisor);
+		}
+
+		if (bFuse == true)
+		{
+			STEP& step = m_steps.back();
+			step.passes.push_back((int)p);
+			step.output = pass.output;
+			for (size_t i = 1; i < pass.inputs.size(); i++)
+			{
+				AddUnique(step.inputs, pass.inputs[i]);
+			}
+			step.name += " + " + pass.desc.name;
+			m_fusedCount++;
+			continue;
+		}
+
+		STEP step;
+		step.name = pass.desc.name;
+		step.passes.push_back((int)p);
+		for (size_t i = 0; i < pass.inputs.size(); i++)
+		{
+			AddUnique(step.inputs, pass.inputs[i]);
+		}
+		step.output = pass.output;
+		step.bCompute = false;
+		step.program = 0;
+		step.outputSizeLocation = -1;
+		m_steps.push_back(step);
+	}
+
+	// each texture goes back to the pool after its last reader
+	bool bComputeShaders = (GLEW_VERSION_4_3) || (GLEW_ARB_compute_shader);
+	for (size_t i = 0; i < m_resources.size(); i++)
+	{
+		m_resources[i].lastStep = -1;
+	}
+	for (size_t s = 0; s < m_steps.size(); s++)
+	{
+		STEP& step = m_steps[s];
+		if ((int)step.inputs.size() > MAX_STEP_INPUTS)
+		{
+			std::cout << "Could not compile the post-processing graph, " << step.name
+				<< " reads more than " << MAX_STEP_INPUTS << " textures" << std::endl;
+			Shutdown();
+			return(false);
+		}
+		for (size_t i = 0; i < step.inputs.size(); i++)
+		{
+			m_resources[step.inputs[i]].lastStep = (int)s;
+		}
+		step.bCompute = (bComputeShaders == true) &&
+			(m_passes[step.passes[0]].desc.kind == pass_pixel) &&
+			(NULL != GetImageFormat(m_resources[step.output].format));
+	}
+
+	glGenVertexArrays(1, &m_vertexArray);
+	glGenSamplers(1, &m_sampler);
+	glSamplerParameteri(m_sampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glSamplerParameteri(m_sampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glSamplerParameteri(m_sampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glSamplerParameteri(m_sampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	for (size_t s = 0; s < m_steps.size(); s++)
+	{
+		std::string log;
+		if (BuildStep(m_steps[s], log) == false)
+		{
+			std::cout << "Could not build the post-processing program " << m_steps[s].name << ":" << log << std::endl;
+			Shutdown();
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  BuildStep()
+ *
+ *  This method is used for wrapping the functions of the
+ *  passes of a step into a program.  Each texture read gets
+ *  a function that reads it at a position of 0 to 1 over its
+ *  drawn corner, clamped to the texels inside the corner.
+ ***********************************************************/
+bool PostProcessGraph::BuildStep(STEP& step, std::string& log)
+{
+	std::string declarations = "uniform vec2 outputSize;\n";
+	for (size_t i = 0; i < step.inputs.size(); i++)
+	{
+		const std::string& name = m_resources[step.inputs[i]].name;
+		declarations +=
+			"uniform sampler2D " + name + ";\n"
+			"uniform vec2 " + name + "Scale;\n"
+			"uniform vec2 " + name + "Texel;\n"
+			"uniform vec2 " + name + "Step;\n"
+			"vec4 " + name + "At(vec2 uv)\n"
+			"{\n"
+			"	return(texture(" + name + ", clamp(uv * " + name + "Scale, 0.5 * " + name + "Texel, " +
+				name + "Scale - 0.5 * " + name + "Texel)));\n"
+			"}\n";
+	}
+	for (size_t i = 0; i < step.passes.size(); i++)
+	{
+		declarations += m_passes[step.passes[i]].desc.source + "\n";
+	}
+
+	const PASS_ENTRY& first = m_passes[step.passes[0]];
+	std::string body;
+	if (first.desc.kind == pass_gather)
+	{
+		body = "	vec4 result = " + first.desc.function + "(uv);\n";
+	}
+	else
+	{
+		// the color stays in a register from pass to pass
+		body = "	vec3 color = " + m_resources[first.inputs[0]].name + "At(uv).rgb;\n";
+		for (size_t i = 0; i < step.passes.size(); i++)
+		{
+			body += "	color = " + m_passes[step.passes[i]].desc.function + "(color, uv);\n";
+		}
+		body += "	vec4 result = vec4(color, 1.0);\n";
+	}
+
+	if (step.bCompute == true)
+	{
+		std::string source =
+			"#version 430 core\n"
+			"layout(local_size_x = " + std::to_string(GROUP_SIZE) + ", local_size_y = " + std::to_string(GROUP_SIZE) + ") in;\n"
+			"layout(" + std::string(GetImageFormat(m_resources[step.output].format)) + ", binding = 0) uniform writeonly image2D outputImage;\n" +
+			declarations +
+			"void main()\n"
+			"{\n"
+			"	ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);\n"
+			"	if (any(greaterThanEqual(pixel, ivec2(outputSize))))\n"
+			"	{\n"
+			"		return;\n"
+			"	}\n"
+			"	vec2 uv = (vec2(pixel) + 0.5) / outputSize;\n" +
+			body +
+			"	imageStore(outputImage, pixel, result);\n"
+			"}\n";
+		step.program = ShaderCompiler::BuildComputeProgram(source, log);
+	}
+	else
+	{
+		std::string source =
+			"#version 330 core\n"
+			"in vec2 texCoord;\n"
+			"out vec4 fragmentColor;\n" +
+			declarations +
+			"void main()\n"
+			"{\n"
+			"	vec2 uv = texCoord;\n" +
+			body +
+			"	fragmentColor = result;\n"
+			"}\n";
+		step.program = ShaderCompiler::BuildProgram(FULLSCREEN_VERTEX_SOURCE, source, log);
+	}
+	if (step.program == 0)
+	{
+		return(false);
+	}
+
+	step.outputSizeLocation = glGetUniformLocation(step.program, "outputSize");
+	step.inputLocations.clear();
+	for (size_t i = 0; i < step.inputs.size(); i++)
+	{
+		const std::string& name = m_resources[step.inputs[i]].name;
+		INPUT_LOCATIONS locations;
+		locations.sampler = glGetUniformLocation(step.program, name.c_str());
+		locations.scale = glGetUniformLocation(step.program, (name + "Scale").c_str());
+		locations.texel = glGetUniformLocation(step.program, (name + "Texel").c_str());
+		locations.step = glGetUniformLocation(step.program, (name + "Step").c_str());
+		step.inputLocations.push_back(locations);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Shutdown()
+ *
+ *  This method is used for freeing the programs and the
+ *  sampler.  The declared textures and passes are kept, so
+ *  the graph can be compiled again.
+ ***********************************************************/
+void PostProcessGraph::Shutdown()
+{
+	for (size_t i = 0; i < m_steps.size(); i++)
+	{
+		if (m_steps[i].program != 0)
+		{
+			glDeleteProgram(m_steps[i].program);
+		}
+	}
+	m_steps.clear();
+	if (m_vertexArray != 0)
+	{
+		glDeleteVertexArrays(1, &m_vertexArray);
+		m_vertexArray = 0;
+	}
+	if (m_sampler != 0)
+	{
+		glDeleteSamplers(1, &m_sampler);
+		m_sampler = 0;
+	}
+	m_pOutputTarget = NULL;
+}
+
+/***********************************************************
+ *  GetRegionSize()
+ *
+ *  This method is used for getting the size of the corner
+ *  drawn in a texture, rounded up so no pixel is lost.
+ ***********************************************************/
+void PostProcessGraph::GetRegionSize(const RESOURCE& resource, int renderWidth, int renderHeight, int& width, int& height) const
+{
+	width = std::max((renderWidth + resource.divisor - 1) / resource.divisor, 1);
+	height = std::max((renderHeight + resource.divisor - 1) / resource.divisor, 1);
+}
+
+/***********************************************************
+ *  Execute()
+ *
+ *  This method is used for running the compiled steps.  The
+ *  textures are taken from the pool at the size of the
+ *  source target, so they only change with the window.  If a
+ *  target cannot be taken the frame is shown without the
+ *  effects.
+ ***********************************************************/
+RenderTarget* PostProcessGraph::Execute(RenderTargetPool& pool, RenderTarget& source, int renderWidth, int renderHeight)
+{
+	m_pOutputTarget = NULL;
+	if ((m_steps.size() == 0) || (m_resources[m_output].bImported == true))
+	{
+		return(&source);
+	}
+
+	for (size_t i = 0; i < m_resources.size(); i++)
+	{
+		m_resources[i].pTarget = (m_resources[i].bImported == true) ? &source : NULL;
+	}
+
+	GPUProfiler& profiler = GPUProfiler::Get();
+	profiler.BeginScope("Post Process");
+	PASS_STATE state;
+	SavePassState(state);
+	glDisable(GL_DEPTH_TEST);
+
+	bool bResult = true;
+	for (size_t s = 0; s < m_steps.size(); s++)
+	{
+		const STEP& step = m_steps[s];
+		RESOURCE& output = m_resources[step.output];
+
+		RenderTargetPool::TARGET_DESC desc;
+		desc.width = (source.GetWidth() + output.divisor - 1) / output.divisor;
+		desc.height = (source.GetHeight() + output.divisor - 1) / output.divisor;
+		desc.colorFormat = output.format;
+		desc.depthFormat = 0;
+		desc.samples = 1;
+		output.pTarget = pool.Acquire(desc);
+		if (NULL == output.pTarget)
+		{
+			bResult = false;
+			break;
+		}
+
+		RunStep(step, renderWidth, renderHeight);
+
+		for (size_t i = 0; i < step.inputs.size(); i++)
+		{
+			RESOURCE& input = m_resources[step.inputs[i]];
+			if ((input.bImported == false) && (input.lastStep == (int)s) && (step.inputs[i] != m_output))
+			{
+				pool.Release(input.pTarget);
+				input.pTarget = NULL;
+			}
+		}
+	}
+
+	RestorePassState(state);
+	profiler.EndScope();
+
+	if (bResult == false)
+	{
+		for (size_t i = 0; i < m_resources.size(); i++)
+		{
+			if ((m_resources[i].bImported == false) && (NULL != m_resources[i].pTarget))
+			{
+				pool.Release(m_resources[i].pTarget);
+			}
+			m_resources[i].pTarget = NULL;
+		}
+		return(&source);
+	}
+
+	m_pOutputTarget = m_resources[m_output].pTarget;
+	return(m_pOutputTarget);
+}
+
+/***********************************************************
+ *  RunStep()
+ *
+ *  This method is used for running the program of a step
+ *  into its output.  A compute step stores every pixel of
+ *  the output corner itself, so the output is never bound
+ *  as a framebuffer.
+ ***********************************************************/
+void PostProcessGraph::RunStep(const STEP& step, int renderWidth, int renderHeight)
+{
+	const RESOURCE& output = m_resources[step.output];
+	int outputWidth = 0;
+	int outputHeight = 0;
+	GetRegionSize(output, renderWidth, renderHeight, outputWidth, outputHeight);
+
+	GPUProfiler& profiler = GPUProfiler::Get();
+	profiler.BeginScope(step.name.c_str());
+
+	glUseProgram(step.program);
+	glUniform2f(step.outputSizeLocation, (float)outputWidth, (float)outputHeight);
+	for (size_t i = 0; i < step.inputs.size(); i++)
+	{
+		const RESOURCE& input = m_resources[step.inputs[i]];
+		const RenderTarget& target = *input.pTarget;
+		const INPUT_LOCATIONS& locations = step.inputLocations[i];
+		int inputWidth = 0;
+		int inputHeight = 0;
+		GetRegionSize(input, renderWidth, renderHeight, inputWidth, inputHeight);
+
+		glActiveTexture(GL_TEXTURE0 + (GLenum)i);
+		glBindTexture(GL_TEXTURE_2D, target.GetColorTexture());
+		glBindSampler((GLuint)i, m_sampler);
+		glUniform1i(locations.sampler, (GLint)i);
+		glUniform2f(locations.scale,
+			(float)inputWidth / (float)target.GetWidth(),
+			(float)inputHeight / (float)target.GetHeight());
+		glUniform2f(locations.texel, 1.0f / (float)target.GetWidth(), 1.0f / (float)target.GetHeight());
+		glUniform2f(locations.step, 1.0f / (float)inputWidth, 1.0f / (float)inputHeight);
+	}
+	for (size_t i = 0; i < step.passes.size(); i++)
+	{
+		const PASS_DESC& desc = m_passes[step.passes[i]].desc;
+		if (desc.setUniforms)
+		{
+			desc.setUniforms(step.program);
+		}
+	}
+
+	if (step.bCompute == true)
+	{
+		glBindImageTexture(0, output.pTarget->GetColorTexture(), 0, GL_FALSE, 0, GL_WRITE_ONLY, output.format);
+		glDispatchCompute(
+			(GLuint)((outputWidth + GROUP_SIZE - 1) / GROUP_SIZE),
+			(GLuint)((outputHeight + GROUP_SIZE - 1) / GROUP_SIZE), 1);
+		// the stores must land before the next pass samples them
+		// or the output is copied to the window
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+		glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, output.format);
+	}
+	else
+	{
+		output.pTarget->Bind(outputWidth, outputHeight);
+		glBindVertexArray(m_vertexArray);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		glBindVertexArray(0);
+	}
+
+	profiler.EndScope();
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for giving the output target back to
+ *  the pool once it has been copied to the window.
+ ***********************************************************/
+void PostProcessGraph::EndFrame(RenderTargetPool& pool)
+{
+	if (NULL != m_pOutputTarget)
+	{
+		pool.Release(m_pOutputTarget);
+		m_pOutputTarget = NULL;
+		m_resources[m_output].pTarget = NULL;
+	}
+}
+
+/***********************************************************
+ *  PrintSummary()
+ *
+ *  This method is used for printing the programs run each
+ *  frame and how many passes were culled and fused.
+ ***********************************************************/
+void PostProcessGraph::PrintSummary() const
+{
+	std::cout << "INFO: Post-processing runs " << m_steps.size() << " programs, "
+		<< m_culledCount << " passes culled, " << m_fusedCount << " passes fused" << std::endl;
+	for (size_t s = 0; s < m_steps.size(); s++)
+	{
+		std::cout << "INFO:   " << m_steps[s].name
+			<< ((m_steps[s].bCompute == true) ? " (compute)" : " (full screen draw)") << std::endl;
+	}
+}
@@ -0,0 +1,181 @@
+///////////////////////////////////////////////////////////////////////////////
+// postprocessgraph.h
+// ============
+// full screen post-processing passes, culled, fused and run over pooled targets
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderTarget.h"
+#include "RenderTargetPool.h"
+
+#include <GL/glew.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  PostProcessGraph
+ *
+ *  This class runs a chain of full screen passes over the
+ *  finished scene.  Each pass names the textures it reads and
+ *  the one it writes, and brings its GLSL as a function that
+ *  the graph wraps into a program.  Compiling the graph for
+ *  the texture wanted at the end:
+ *
+ *  - passes through a disabled per-pixel pass, reading its
+ *    input wherever its output was read,
+ *  - culls the passes whose output nothing wanted reads, so
+ *    turning off a pass that feeds others also drops those,
+ *  - fuses per-pixel passes that follow each other into one
+ *    program when only the next pass reads the texture in
+ *    between.  That texture is then never written, and with
+ *    compute shaders the chain runs as one dispatch.
+ *
+ *  The textures between the passes come from the render
+ *  target pool when their pass runs and go back right after
+ *  the last pass reading them, so later passes of the frame
+ *  reuse them.  Like the scene, every texture is drawn in
+ *  its lower left corner at the size the scene is drawn
+ *  with, divided by the texture's divisor.
+ *
+ *  In the GLSL, a read texture called name is read with
+ *  nameAt(uv), where uv is 0 to 1 over the drawn corner, and
+ *  nameStep is the size of one of its texels in uv.  The
+ *  uniform outputSize holds the pixel size of the output.
+ ***********************************************************/
+class PostProcessGraph
+{
+public:
+	enum PASS_KIND
+	{
+		// reads its inputs at any position - a function
+		// vec4 function(vec2 uv) giving the output color
+		pass_gather = 0,
+		// reads only its own pixel of its first input - a
+		// function vec3 function(vec3 color, vec2 uv) changing
+		// that color, which can be fused with its neighbors
+		pass_pixel
+	};
+
+	struct PASS_DESC
+	{
+		// name shown in the GPU profiler
+		std::string name;
+		int kind;
+		// textures read, and the texture written
+		std::vector<std::string> inputs;
+		std::string output;
+		// GLSL uniforms and the function of the pass, and the
+		// name of that function
+		std::string source;
+		std::string function;
+		// sets the uniforms of the pass on the program it runs in
+		std::function<void(GLuint program)> setUniforms;
+		bool bEnabled;
+	};
+
+	// constructor
+	PostProcessGraph();
+	// destructor
+	~PostProcessGraph();
+
+	// declare the texture the passes start from, handed to
+	// Execute() every frame
+	void ImportTexture(const std::string& name);
+	// declare a texture the passes draw into, with the size
+	// the scene is drawn with divided by the divisor
+	void CreateTexture(const std::string& name, int divisor, GLenum format);
+	// declare a pass - a pass must come after the passes that
+	// write its inputs
+	void AddPass(const PASS_DESC& pass);
+	// forget the declared textures and passes
+	void Clear();
+
+	// cull and fuse the passes for producing the output
+	// texture and build their programs - false when the graph
+	// is not valid or a program cannot be built
+	bool Compile(const std::string& outputName);
+	// free the programs and sampler
+	void Shutdown();
+
+	// run the passes over the lower left corner of the source
+	// and return the target holding the output in the same
+	// corner, which is the source itself when no pass runs
+	RenderTarget* Execute(RenderTargetPool& pool, RenderTarget& source, int renderWidth, int renderHeight);
+	// give the output target back to the pool
+	void EndFrame(RenderTargetPool& pool);
+
+	// print the programs that run and the passes culled and fused
+	void PrintSummary() const;
+
+private:
+	struct RESOURCE
+	{
+		std::string name;
+		bool bImported;
+		int divisor;
+		GLenum format;
+		// last step reading the texture, -1 for none
+		int lastStep;
+		// target holding the texture while the frame runs
+		RenderTarget* pTarget;
+	};
+
+	struct PASS_ENTRY
+	{
+		PASS_DESC desc;
+		// resources read and written, after passing through
+		// disabled passes
+		std::vector<int> inputs;
+		int output;
+	};
+
+	// uniform locations of a texture read by a step
+	struct INPUT_LOCATIONS
+	{
+		GLint sampler;
+		GLint scale;
+		GLint texel;
+		GLint step;
+	};
+
+	// one program run - a gather pass, or a chain of fused
+	// per-pixel passes
+	struct STEP
+	{
+		std::string name;
+		std::vector<int> passes;
+		std::vector<int> inputs;
+		int output;
+		bool bCompute;
+		GLuint program;
+		GLint outputSizeLocation;
+		std::vector<INPUT_LOCATIONS> inputLocations;
+	};
+
+	std::vector<RESOURCE> m_resources;
+	std::vector<PASS_ENTRY> m_passes;
+	std::vector<STEP> m_steps;
+	int m_output;
+	// target of the output given to the caller this frame
+	RenderTarget* m_pOutputTarget;
+
+	GLuint m_vertexArray;
+	GLuint m_sampler;
+
+	// statistics of the compile
+	int m_culledCount;
+	int m_fusedCount;
+
+	// index of a resource by name, or -1
+	int FindResource(const std::string& name) const;
+	// build the program of a step
+	bool BuildStep(STEP& step, std::string& log);
+	// run a step, its output target already taken
+	void RunStep(const STEP& step, int renderWidth, int renderHeight);
+	// size of the corner drawn in a resource
+	void GetRegionSize(const RESOURCE& resource, int renderWidth, int renderHeight, int& width, int& height) const;
+};
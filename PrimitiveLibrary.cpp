@@ -0,0 +1,499 @@
+///////////////////////////////////////////////////////////////////////////////
+// primitivelibrary.cpp
+// ============
+// generated basic shape meshes, cached on disk and shared between users
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PrimitiveLibrary.h"
+#include "MeshImporter.h"
+#include "SceneManager.h"
+#include "JobSystem.h"
+#include "CPUProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+std::mutex PrimitiveLibrary::s_mutex;
+std::vector<PrimitiveLibrary::SHARED_LIBRARY> PrimitiveLibrary::s_libraries;
+
+// declaration of global variables
+namespace
+{
+	// names of the shapes in the pack, in mesh type order
+	const char* g_PrimitiveNames[SceneManager::mesh_type_count] = {
+		"plane", "box", "sphere", "cylinder", "torus", "tapered_cylinder" };
+
+	// raise when the generated shapes change, so cached packs
+	// of older generators are no longer used
+	const uint32_t GENERATOR_VERSION = 1;
+
+	const float PI = 3.14159265358979f;
+
+	typedef MeshImporter::IMPORT_VERTEX IMPORT_VERTEX;
+
+	/***********************************************************
+	 *  AddVertex()
+	 *
+	 *  Appends a vertex and returns its index.
+	 ***********************************************************/
+	uint32_t AddVertex(
+		std::vector<IMPORT_VERTEX>& vertices,
+		const glm::vec3& position,
+		const glm::vec3& normal,
+		const glm::vec2& texCoord)
+	{
+		IMPORT_VERTEX vertex;
+		vertex.position = position;
+		vertex.normal = normal;
+		vertex.texCoord = texCoord;
+		vertices.push_back(vertex);
+		return((uint32_t)(vertices.size() - 1));
+	}
+
+	/***********************************************************
+	 *  AddTriangle()
+	 *
+	 *  Appends a triangle, wound counterclockwise when seen
+	 *  from the side its vertex normals point to.
+	 ***********************************************************/
+	void AddTriangle(
+		const std::vector<IMPORT_VERTEX>& vertices,
+		std::vector<uint32_t>& indices,
+		uint32_t a,
+		uint32_t b,
+		uint32_t c)
+	{
+		glm::vec3 faceNormal = glm::cross(
+			vertices[b].position - vertices[a].position,
+			vertices[c].position - vertices[a].position);
+		glm::vec3 vertexNormal = vertices[a].normal + vertices[b].normal + vertices[c].normal;
+		indices.push_back(a);
+		if (glm::dot(faceNormal, vertexNormal) < 0.0f)
+		{
+			indices.push_back(c);
+			indices.push_back(b);
+		}
+		else
+		{
+			indices.push_back(b);
+			indices.push_back(c);
+		}
+	}
+
+	/***********************************************************
+	 *  GeneratePlane()
+	 *
+	 *  A 2 x 2 square in the XZ plane, facing up.
+	 ***********************************************************/
+	void GeneratePlane(std::vector<IMPORT_VERTEX>& vertices, std::vector<uint32_t>& indices)
+	{
+		glm::vec3 up(0.0f, 1.0f, 0.0f);
+		uint32_t a = AddVertex(vertices, glm::vec3(-1.0f, 0.0f, -1.0f), up, glm::vec2(0.0f, 1.0f));
+		uint32_t b = AddVertex(vertices, glm::vec3(-1.0f, 0.0f, 1.0f), up, glm::vec2(0.0f, 0.0f));
+		uint32_t c = AddVertex(vertices, glm::vec3(1.0f, 0.0f, 1.0f), up, glm::vec2(1.0f, 0.0f));
+		uint32_t d = AddVertex(vertices, glm::vec3(1.0f, 0.0f, -1.0f), up, glm::vec2(1.0f, 1.0f));
+		AddTriangle(vertices, indices, a, b, c);
+		AddTriangle(vertices, indices, a, c, d);
+	}
+
+	/***********************************************************
+	 *  GenerateBox()
+	 *
+	 *  A unit cube around the origin, with the whole texture
+	 *  on every side.
+	 ***********************************************************/
+	void GenerateBox(std::vector<IMPORT_VERTEX>& vertices, std::vector<uint32_t>& indices)
+	{
+		const glm::vec3 normals[6] = {
+			glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f),
+			glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f),
+			glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f) };
+		const glm::vec3 across[6] = {
+			glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f),
+			glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f),
+			glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) };
+
+		for (int side = 0; side < 6; side++)
+		{
+			glm::vec3 center = normals[side] * 0.5f;
+			glm::vec3 u = across[side] * 0.5f;
+			glm::vec3 v = glm::cross(normals[side], across[side]) * 0.5f;
+			uint32_t a = AddVertex(vertices, center - u - v, normals[side], glm::vec2(0.0f, 0.0f));
+			uint32_t b = AddVertex(vertices, center + u - v, normals[side], glm::vec2(1.0f, 0.0f));
+			uint32_t c = AddVertex(vertices, center + u + v, normals[side], glm::vec2(1.0f, 1.0f));
+			uint32_t d = AddVertex(vertices, center - u + v, normals[side], glm::vec2(0.0f, 1.0f));
+			AddTriangle(vertices, indices, a, b, c);
+			AddTriangle(vertices, indices, a, c, d);
+		}
+	}
+
+	/***********************************************************
+	 *  GenerateSphere()
+	 *
+	 *  A sphere of radius 1 around the origin, with the
+	 *  texture wrapped around it once.
+	 ***********************************************************/
+	void GenerateSphere(
+		int segments,
+		int rings,
+		std::vector<IMPORT_VERTEX>& vertices,
+		std::vector<uint32_t>& indices)
+	{
+		for (int ring = 0; ring <= rings; ring++)
+		{
+			float phi = PI * ring / rings;
+			for (int segment = 0; segment <= segments; segment++)
+			{
+				float theta = 2.0f * PI * segment / segments;
+				glm::vec3 normal(sinf(phi) * cosf(theta), cosf(phi), sinf(phi) * sinf(theta));
+				AddVertex(vertices, normal, normal,
+					glm::vec2((float)segment / segments, 1.0f - (float)ring / rings));
+			}
+		}
+
+		// the rows at the poles are single triangles
+		uint32_t row = (uint32_t)segments + 1;
+		for (int ring = 0; ring < rings; ring++)
+		{
+			for (int segment = 0; segment < segments; segment++)
+			{
+				uint32_t a = ring * row + segment;
+				uint32_t b = a + row;
+				uint32_t c = b + 1;
+				uint32_t d = a + 1;
+				if (ring < rings - 1)
+				{
+					AddTriangle(vertices, indices, a, b, c);
+				}
+				if (ring > 0)
+				{
+					AddTriangle(vertices, indices, a, c, d);
+				}
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  GenerateCylinder()
+	 *
+	 *  A cylinder standing on the XZ plane, 1 high, with a
+	 *  bottom radius of 1 and the passed in top radius, closed
+	 *  by a cap at either end.
+	 ***********************************************************/
+	void GenerateCylinder(
+		int segments,
+		float topRadius,
+		std::vector<IMPORT_VERTEX>& vertices,
+		std::vector<uint32_t>& indices)
+	{
+		// the side leans in by the change of radius over the height
+		for (int segment = 0; segment <= segments; segment++)
+		{
+			float theta = 2.0f * PI * segment / segments;
+			glm::vec3 around(cosf(theta), 0.0f, sinf(theta));
+			glm::vec3 normal = glm::normalize(around + glm::vec3(0.0f, 1.0f - topRadius, 0.0f));
+			float u = (float)segment / segments;
+			AddVertex(vertices, around, normal, glm::vec2(u, 0.0f));
+			AddVertex(vertices, around * topRadius + glm::vec3(0.0f, 1.0f, 0.0f), normal, glm::vec2(u, 1.0f));
+		}
+		for (int segment = 0; segment < segments; segment++)
+		{
+			uint32_t a = segment * 2;
+			AddTriangle(vertices, indices, a, a + 1, a + 3);
+			AddTriangle(vertices, indices, a, a + 3, a + 2);
+		}
+
+		// caps, with the texture laid flat across them
+		for (int cap = 0; cap < 2; cap++)
+		{
+			float height = (float)cap;
+			float radius = (cap == 0) ? 1.0f : topRadius;
+			glm::vec3 normal(0.0f, (cap == 0) ? -1.0f : 1.0f, 0.0f);
+			uint32_t center = AddVertex(vertices, glm::vec3(0.0f, height, 0.0f), normal, glm::vec2(0.5f, 0.5f));
+			for (int segment = 0; segment <= segments; segment++)
+			{
+				float theta = 2.0f * PI * segment / segments;
+				AddVertex(vertices,
+					glm::vec3(cosf(theta) * radius, height, sinf(theta) * radius),
+					normal,
+					glm::vec2(0.5f + 0.5f * cosf(theta), 0.5f + 0.5f * sinf(theta)));
+			}
+			if (radius > 0.0f)
+			{
+				for (int segment = 0; segment < segments; segment++)
+				{
+					AddTriangle(vertices, indices, center, center + 1 + segment, center + 2 + segment);
+				}
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  GenerateTorus()
+	 *
+	 *  A ring of radius 1 around the Z axis, with a tube of the
+	 *  passed in radius.
+	 ***********************************************************/
+	void GenerateTorus(
+		int segments,
+		int rings,
+		float thickness,
+		std::vector<IMPORT_VERTEX>& vertices,
+		std::vector<uint32_t>& indices)
+	{
+		for (int segment = 0; segment <= segments; segment++)
+		{
+			float theta = 2.0f * PI * segment / segments;
+			glm::vec3 center(cosf(theta), sinf(theta), 0.0f);
+			for (int ring = 0; ring <= rings; ring++)
+			{
+				float phi = 2.0f * PI * ring / rings;
+				glm::vec3 normal = center * cosf(phi) + glm::vec3(0.0f, 0.0f, sinf(phi));
+				AddVertex(vertices, center + normal * thickness, normal,
+					glm::vec2((float)segment / segments, (float)ring / rings));
+			}
+		}
+
+		uint32_t row = (uint32_t)rings + 1;
+		for (int segment = 0; segment < segments; segment++)
+		{
+			for (int ring = 0; ring < rings; ring++)
+			{
+				uint32_t a = segment * row + ring;
+				uint32_t b = a + row;
+				AddTriangle(vertices, indices, a, b, b + 1);
+				AddTriangle(vertices, indices, a, b + 1, a + 1);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  GetDefaultSettings()
+ *
+ *  Returns the parameters of the basic shapes drawn until
+ *  now.
+ ***********************************************************/
+PrimitiveLibrary::PRIMITIVE_SETTINGS PrimitiveLibrary::GetDefaultSettings()
+{
+	PRIMITIVE_SETTINGS settings;
+	settings.segments = 36;
+	settings.rings = 18;
+	settings.taperRatio = 0.5f;
+	settings.torusThickness = 0.2f;
+	return(settings);
+}
+
+/***********************************************************
+ *  Acquire()
+ *
+ *  This method is used for getting the library of a set of
+ *  parameters: the one already in use, the pack saved by an
+ *  earlier run, or a newly generated pack.
+ ***********************************************************/
+const MeshLibrary* PrimitiveLibrary::Acquire(
+	const PRIMITIVE_SETTINGS& settings,
+	const std::string& directory,
+	JobSystem* pJobSystem)
+{
+	CPU_PROFILE_ZONE("PrimitiveLibrary::Acquire");
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	uint64_t key = HashSettings(settings);
+	for (size_t i = 0; i < s_libraries.size(); i++)
+	{
+		if (s_libraries[i].key == key)
+		{
+			s_libraries[i].references++;
+			return(s_libraries[i].pLibrary);
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	if (error)
+	{
+		std::cout << "Could not create mesh cache directory:" << directory << std::endl;
+		return(NULL);
+	}
+	char name[64];
+	snprintf(name, sizeof(name), "primitives_%016llx.pack", (unsigned long long)key);
+	std::string filename = (std::filesystem::path(directory) / name).string();
+
+	// a pack from an earlier run is used when it holds the
+	// shapes in mesh type order
+	MeshLibrary* pLibrary = new MeshLibrary();
+	bool bLoaded = false;
+	if (std::filesystem::exists(filename, error) == true)
+	{
+		bLoaded = pLibrary->Load(filename.c_str()) && (pLibrary->GetMeshCount() == SceneManager::mesh_type_count);
+		for (int i = 0; (bLoaded == true) && (i < SceneManager::mesh_type_count); i++)
+		{
+			bLoaded = (pLibrary->FindMesh(g_PrimitiveNames[i]) == i);
+		}
+	}
+	if (bLoaded == false)
+	{
+		bLoaded = (GeneratePack(settings, filename, pJobSystem) == true) &&
+			(pLibrary->Load(filename.c_str()) == true);
+	}
+	if ((bLoaded == false) || (pLibrary->Upload() == false))
+	{
+		delete pLibrary;
+		return(NULL);
+	}
+
+	SHARED_LIBRARY shared;
+	shared.key = key;
+	shared.pLibrary = pLibrary;
+	shared.references = 1;
+	s_libraries.push_back(shared);
+	return(pLibrary);
+}
+
+/***********************************************************
+ *  Release()
+ *
+ *  This method is used for giving up a library, deleting it
+ *  once nothing holds it any more.
+ ***********************************************************/
+void PrimitiveLibrary::Release(const MeshLibrary* pLibrary)
+{
+	if (NULL == pLibrary)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+	for (size_t i = 0; i < s_libraries.size(); i++)
+	{
+		if (s_libraries[i].pLibrary == pLibrary)
+		{
+			s_libraries[i].references--;
+			if (s_libraries[i].references == 0)
+			{
+				delete s_libraries[i].pLibrary;
+				s_libraries.erase(s_libraries.begin() + i);
+			}
+			return;
+		}
+	}
+}
+
+/***********************************************************
+ *  HashSettings()
+ *
+ *  This method is used for getting the FNV-1a hash of the
+ *  parameters and the generator version, which names the
+ *  cached pack.
+ ***********************************************************/
+uint64_t PrimitiveLibrary::HashSettings(const PRIMITIVE_SETTINGS& settings)
+{
+	unsigned char bytes[20];
+	memcpy(bytes, &GENERATOR_VERSION, 4);
+	memcpy(bytes + 4, &settings.segments, 4);
+	memcpy(bytes + 8, &settings.rings, 4);
+	memcpy(bytes + 12, &settings.taperRatio, 4);
+	memcpy(bytes + 16, &settings.torusThickness, 4);
+
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < sizeof(bytes); i++)
+	{
+		hash = (hash ^ bytes[i]) * 1099511628211ULL;
+	}
+	return(hash);
+}
+
+/***********************************************************
+ *  GeneratePack()
+ *
+ *  This method is used for generating every shape, each on
+ *  a worker of its own, and saving them as a mesh pack.
+ ***********************************************************/
+bool PrimitiveLibrary::GeneratePack(
+	const PRIMITIVE_SETTINGS& settings,
+	const std::string& filename,
+	JobSystem* pJobSystem)
+{
+	CPU_PROFILE_ZONE("PrimitiveLibrary::GeneratePack");
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	int segments = std::max(3, settings.segments);
+	int rings = std::max(2, settings.rings);
+	float taperRatio = std::max(0.0f, settings.taperRatio);
+
+	// one importer per shape, so the shapes are welded and
+	// reordered in parallel too
+	std::vector<MeshImporter> importers(SceneManager::mesh_type_count);
+	std::vector<char> results(SceneManager::mesh_type_count, 0);
+	JobSystem::RANGE_FUNCTION generate = [&](int begin, int end, int)
+	{
+		for (int meshType = begin; meshType < end; meshType++)
+		{
+			CPU_PROFILE_ZONE("GeneratePrimitive");
+
+			std::vector<IMPORT_VERTEX> vertices;
+			std::vector<uint32_t> indices;
+			switch (meshType)
+			{
+			case SceneManager::mesh_plane:
+				GeneratePlane(vertices, indices);
+				break;
+			case SceneManager::mesh_box:
+				GenerateBox(vertices, indices);
+				break;
+			case SceneManager::mesh_sphere:
+				GenerateSphere(segments, rings, vertices, indices);
+				break;
+			case SceneManager::mesh_cylinder:
+				GenerateCylinder(segments, 1.0f, vertices, indices);
+				break;
+			case SceneManager::mesh_torus:
+				GenerateTorus(segments, rings, settings.torusThickness, vertices, indices);
+				break;
+			case SceneManager::mesh_tapered_cylinder:
+				GenerateCylinder(segments, taperRatio, vertices, indices);
+				break;
+			}
+			results[meshType] = (importers[meshType].AddMesh(g_PrimitiveNames[meshType], vertices, indices) == true) ? 1 : 0;
+		}
+	};
+
+	if (NULL != pJobSystem)
+	{
+		pJobSystem->ParallelFor(SceneManager::mesh_type_count, 1, generate);
+	}
+	else
+	{
+		generate(0, SceneManager::mesh_type_count, 0);
+	}
+
+	MeshImporter pack;
+	for (int meshType = 0; meshType < SceneManager::mesh_type_count; meshType++)
+	{
+		if ((results[meshType] == 0) || (importers[meshType].GetMeshCount() != 1))
+		{
+			std::cout << "Could not generate basic shape:" << g_PrimitiveNames[meshType] << std::endl;
+			return(false);
+		}
+		pack.AppendMeshes(importers[meshType]);
+	}
+	if (pack.SavePack(filename.c_str()) == false)
+	{
+		return(false);
+	}
+
+	double milliseconds = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start).count();
+	std::cout << "INFO: Generated the basic shapes with " << segments << " segments in "
+		<< milliseconds << " ms" << std::endl;
+	return(true);
+}
@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+// primitivelibrary.h
+// ============
+// generated basic shape meshes, cached on disk and shared between users
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshLibrary.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+/***********************************************************
+ *  PrimitiveLibrary
+ *
+ *  This class provides the basic shapes - plane, box, sphere,
+ *  cylinder, torus and tapered cylinder - as a mesh library
+ *  whose mesh indices are the mesh types of the scene.  The
+ *  shapes are generated once for every set of parameters:
+ *  each shape on its own worker, then welded, reordered and
+ *  quantized like imported meshes and saved as a mesh pack
+ *  named after a hash of the parameters.  Later runs map that
+ *  pack instead of generating anything.
+ *
+ *  A library is shared by every user that acquires the same
+ *  parameters and deleted when the last of them releases it,
+ *  so several scene managers draw from a single set of
+ *  buffers.  The windows of those scene managers must share
+ *  their OpenGL objects.  Acquire and release on the thread
+ *  that owns the context.
+ ***********************************************************/
+class PrimitiveLibrary
+{
+public:
+	// parameters the shapes are generated with - shapes with
+	// other segment counts make other levels of detail
+	struct PRIMITIVE_SETTINGS
+	{
+		// divisions around the round shapes, and along the
+		// sphere and the tube of the torus
+		int segments;
+		int rings;
+		// top radius of the tapered cylinder, the bottom is 1
+		float taperRatio;
+		// radius of the tube of the torus, the ring is 1
+		float torusThickness;
+	};
+
+	// the parameters of the basic shapes drawn until now
+	static PRIMITIVE_SETTINGS GetDefaultSettings();
+
+	// the library of the parameters, loaded from the cache
+	// directory or generated into it - null when it cannot be
+	// written, and the caller draws its own shapes instead
+	static const MeshLibrary* Acquire(
+		const PRIMITIVE_SETTINGS& settings,
+		const std::string& directory,
+		JobSystem* pJobSystem);
+	// give up a library returned by Acquire()
+	static void Release(const MeshLibrary* pLibrary);
+
+private:
+	// a library and the number of users holding it
+	struct SHARED_LIBRARY
+	{
+		uint64_t key;
+		MeshLibrary* pLibrary;
+		int references;
+	};
+
+	static std::mutex s_mutex;
+	static std::vector<SHARED_LIBRARY> s_libraries;
+
+	// hash of the parameters and the generator version
+	static uint64_t HashSettings(const PRIMITIVE_SETTINGS& settings);
+	// generate every shape and save them as a pack
+	static bool GeneratePack(
+		const PRIMITIVE_SETTINGS& settings,
+		const std::string& filename,
+		JobSystem* pJobSystem);
+};
@@ -0,0 +1,214 @@
+///////////////////////////////////////////////////////////////////////////////
+// rendertarget.cpp
+// ============
+// offscreen framebuffer with color and depth textures of chosen formats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderTarget.h"
+
+#include <iostream>
+
+/***********************************************************
+ *  RenderTarget()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderTarget::RenderTarget()
+{
+	m_width = 0;
+	m_height = 0;
+	m_colorFormat = 0;
+	m_depthFormat = 0;
+	m_samples = 1;
+	m_framebuffer = 0;
+	m_colorTexture = 0;
+	m_depthTexture = 0;
+}
+
+/***********************************************************
+ *  ~RenderTarget()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RenderTarget::~RenderTarget()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  CreateTexture()
+ *
+ *  This method is used for creating an immutable texture of
+ *  the size of the target, sampled without filtering.  A
+ *  multisampled texture has no sampling state to set.  Targets
+ *  are created in the middle of a frame, while the scene keeps
+ *  its textures bound, so the binding of the active texture
+ *  unit is put back afterwards.
+ ***********************************************************/
+GLuint RenderTarget::CreateTexture(GLenum format) const
+{
+	GLuint texture = 0;
+	GLint previousTexture = 0;
+	glGenTextures(1, &texture);
+	if (m_samples > 1)
+	{
+		glGetIntegerv(GL_TEXTURE_BINDING_2D_MULTISAMPLE, &previousTexture);
+		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, texture);
+		glTexStorage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, m_samples, format, m_width, m_height, GL_TRUE);
+		glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, (GLuint)previousTexture);
+		return(texture);
+	}
+
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexStorage2D(GL_TEXTURE_2D, 1, format, m_width, m_height);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)previousTexture);
+	return(texture);
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the framebuffer and its
+ *  attachments.  Any previous contents are deleted first, and
+ *  the framebuffers that were bound stay bound.
+ ***********************************************************/
+bool RenderTarget::Create(int width, int height, GLenum colorFormat, GLenum depthFormat, int samples)
+{
+	Destroy();
+
+	if ((width <= 0) || (height <= 0))
+	{
+		return(false);
+	}
+
+	m_width = width;
+	m_height = height;
+	m_colorFormat = colorFormat;
+	m_depthFormat = depthFormat;
+	m_samples = (samples > 1) ? samples : 1;
+	GLenum textureTarget = (m_samples > 1) ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+
+	GLint previousDrawFramebuffer = 0;
+	GLint previousReadFramebuffer = 0;
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDrawFramebuffer);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFramebuffer);
+
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+
+	if (colorFormat != 0)
+	{
+		m_colorTexture = CreateTexture(colorFormat);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, textureTarget, m_colorTexture, 0);
+	}
+	else
+	{
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+	}
+	if (depthFormat != 0)
+	{
+		m_depthTexture = CreateTexture(depthFormat);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, textureTarget, m_depthTexture, 0);
+	}
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)previousDrawFramebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)previousReadFramebuffer);
+	if (status != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Could not create render target, the framebuffer is incomplete:" << std::hex << status << std::dec << std::endl;
+		Destroy();
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for deleting the framebuffer and its
+ *  textures.
+ ***********************************************************/
+void RenderTarget::Destroy()
+{
+	if (m_framebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &m_framebuffer);
+		m_framebuffer = 0;
+	}
+	if (m_colorTexture != 0)
+	{
+		glDeleteTextures(1, &m_colorTexture);
+		m_colorTexture = 0;
+	}
+	if (m_depthTexture != 0)
+	{
+		glDeleteTextures(1, &m_depthTexture);
+		m_depthTexture = 0;
+	}
+	m_width = 0;
+	m_height = 0;
+	m_samples = 1;
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for drawing into the target, with the
+ *  viewport covering all of it.
+ ***********************************************************/
+void RenderTarget::Bind() const
+{
+	Bind(m_width, m_height);
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for drawing into the lower left
+ *  corner of the target, so a smaller image can be drawn
+ *  without creating the textures again.
+ ***********************************************************/
+void RenderTarget::Bind(int width, int height) const
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glViewport(0, 0, width, height);
+}
+
+/***********************************************************
+ *  BlitColor()
+ *
+ *  This method is used for copying the color of the target
+ *  into another framebuffer, which stays bound afterwards.
+ ***********************************************************/
+void RenderTarget::BlitColor(GLuint framebuffer, int width, int height) const
+{
+	BlitColor(m_width, m_height, framebuffer, width, height);
+}
+
+/***********************************************************
+ *  BlitColor()
+ *
+ *  This method is used for copying the color of the lower
+ *  left corner of the target into another framebuffer, which
+ *  stays bound afterwards.  The copy is filtered when its
+ *  size changes.  A multisampled target is resolved by the
+ *  copy, which then must keep its size.
+ ***********************************************************/
+void RenderTarget::BlitColor(int sourceWidth, int sourceHeight, GLuint framebuffer, int width, int height) const
+{
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+	GLenum filter = ((width == sourceWidth) && (height == sourceHeight)) ? GL_NEAREST : GL_LINEAR;
+	glBlitFramebuffer(0, 0, sourceWidth, sourceHeight, 0, 0, width, height, GL_COLOR_BUFFER_BIT, filter);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glViewport(0, 0, width, height);
+}
@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// rendertarget.h
+// ============
+// offscreen framebuffer with color and depth textures of chosen formats
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  RenderTarget
+ *
+ *  This class owns a framebuffer object with a color and a
+ *  depth texture.  The window's own framebuffer only offers
+ *  the depth formats the platform chose when the window was
+ *  created, so anything needing another format - such as a
+ *  floating point depth buffer - is drawn here and copied to
+ *  the window afterwards.  The textures can also be sampled
+ *  by later passes.
+ *
+ *  A multisampled target keeps several samples per pixel
+ *  for anti-aliasing.  Its textures cannot be filtered, so it
+ *  is copied into a single sampled target before anything
+ *  else reads it.
+ ***********************************************************/
+class RenderTarget
+{
+public:
+	// constructor
+	RenderTarget();
+	// destructor
+	~RenderTarget();
+
+	// create the framebuffer and its textures - a zero format
+	// leaves out that attachment, and more than one sample makes
+	// the textures multisampled
+	bool Create(int width, int height, GLenum colorFormat, GLenum depthFormat, int samples);
+	// delete the framebuffer and its textures
+	void Destroy();
+
+	// draw into the target from here on, over all of it
+	void Bind() const;
+	// draw into the lower left corner of the passed in size
+	void Bind(int width, int height) const;
+	// copy the color to another framebuffer, scaled to the
+	// passed in size - zero is the window
+	void BlitColor(GLuint framebuffer, int width, int height) const;
+	// copy the color of the lower left corner of the first
+	// size to another framebuffer, scaled to the second size
+	void BlitColor(int sourceWidth, int sourceHeight, GLuint framebuffer, int width, int height) const;
+
+	bool IsValid() const { return(m_framebuffer != 0); }
+	int GetWidth() const { return(m_width); }
+	int GetHeight() const { return(m_height); }
+	GLenum GetColorFormat() const { return(m_colorFormat); }
+	GLenum GetDepthFormat() const { return(m_depthFormat); }
+	int GetSamples() const { return(m_samples); }
+	GLuint GetFramebuffer() const { return(m_framebuffer); }
+	GLuint GetColorTexture() const { return(m_colorTexture); }
+	GLuint GetDepthTexture() const { return(m_depthTexture); }
+
+private:
+	int m_width;
+	int m_height;
+	GLenum m_colorFormat;
+	GLenum m_depthFormat;
+	int m_samples;
+	GLuint m_framebuffer;
+	GLuint m_colorTexture;
+	GLuint m_depthTexture;
+
+	// create a texture of the size of the target
+	GLuint CreateTexture(GLenum format) const;
+};
@@ -0,0 +1,209 @@
+///////////////////////////////////////////////////////////////////////////////
+// rendertargetpool.cpp
+// ============
+// reuse of offscreen render targets across passes and frames
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderTargetPool.h"
+
+#include <algorithm>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// frames a free target is kept without being asked for -
+	// long enough to ride out a pass that skips a frame
+	const int EVICT_FRAMES = 3;
+
+	/***********************************************************
+	 *  GetFormatBytes()
+	 *
+	 *  Returns the bytes per pixel of a sized format used for
+	 *  render targets, or 4 for formats it does not know.
+	 ***********************************************************/
+	size_t GetFormatBytes(GLenum format)
+	{
+		switch (format)
+		{
+		case 0:
+			return(0);
+		case GL_R8:
+			return(1);
+		case GL_RG8:
+		case GL_R16F:
+		case GL_DEPTH_COMPONENT16:
+			return(2);
+		case GL_RGBA16F:
+		case GL_RG32F:
+			return(8);
+		case GL_RGBA32F:
+			return(16);
+		case GL_DEPTH32F_STENCIL8:
+			return(8);
+		default:
+			return(4);
+		}
+	}
+}
+
+/***********************************************************
+ *  RenderTargetPool()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderTargetPool::RenderTargetPool()
+{
+	m_frameIndex = 0;
+	m_createdCount = 0;
+	m_reusedCount = 0;
+	m_heldBytes = 0;
+	m_peakBytes = 0;
+}
+
+/***********************************************************
+ *  ~RenderTargetPool()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RenderTargetPool::~RenderTargetPool()
+{
+	Clear();
+}
+
+/***********************************************************
+ *  GetTargetBytes()
+ *
+ *  This method is used for estimating the video memory that
+ *  the textures of a target take.
+ ***********************************************************/
+size_t RenderTargetPool::GetTargetBytes(const RenderTarget& target)
+{
+	size_t pixels = (size_t)target.GetWidth() * (size_t)target.GetHeight() * (size_t)target.GetSamples();
+	return(pixels * (GetFormatBytes(target.GetColorFormat()) + GetFormatBytes(target.GetDepthFormat())));
+}
+
+/***********************************************************
+ *  Acquire()
+ *
+ *  This method is used for taking a target of the passed in
+ *  size and formats.  The free target used most recently is
+ *  preferred, so the same textures keep being used.
+ ***********************************************************/
+RenderTarget* RenderTargetPool::Acquire(const TARGET_DESC& desc)
+{
+	int found = -1;
+	for (int i = 0; i < (int)m_entries.size(); i++)
+	{
+		const POOL_ENTRY& entry = m_entries[i];
+		if ((entry.bInUse == false) &&
+			(entry.pTarget->GetWidth() == desc.width) &&
+			(entry.pTarget->GetHeight() == desc.height) &&
+			(entry.pTarget->GetColorFormat() == desc.colorFormat) &&
+			(entry.pTarget->GetDepthFormat() == desc.depthFormat) &&
+			(entry.pTarget->GetSamples() == std::max(desc.samples, 1)) &&
+			((found < 0) || (entry.lastUsedFrame > m_entries[found].lastUsedFrame)))
+		{
+			found = i;
+		}
+	}
+
+	if (found >= 0)
+	{
+		m_entries[found].bInUse = true;
+		m_entries[found].lastUsedFrame = m_frameIndex;
+		m_reusedCount++;
+		return(m_entries[found].pTarget);
+	}
+
+	RenderTarget* pTarget = new RenderTarget();
+	if (pTarget->Create(desc.width, desc.height, desc.colorFormat, desc.depthFormat, desc.samples) == false)
+	{
+		delete pTarget;
+		return(NULL);
+	}
+
+	POOL_ENTRY entry;
+	entry.pTarget = pTarget;
+	entry.bInUse = true;
+	entry.lastUsedFrame = m_frameIndex;
+	m_entries.push_back(entry);
+
+	m_createdCount++;
+	m_heldBytes += GetTargetBytes(*pTarget);
+	m_peakBytes = std::max(m_peakBytes, m_heldBytes);
+	return(pTarget);
+}
+
+/***********************************************************
+ *  Release()
+ *
+ *  This method is used for giving back a target.  Its
+ *  contents stay as they are until the next user draws.
+ ***********************************************************/
+void RenderTargetPool::Release(RenderTarget* pTarget)
+{
+	for (size_t i = 0; i < m_entries.size(); i++)
+	{
+		if (m_entries[i].pTarget == pTarget)
+		{
+			m_entries[i].bInUse = false;
+			return;
+		}
+	}
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for deleting the free targets that
+ *  were not asked for in the last few frames.
+ ***********************************************************/
+void RenderTargetPool::EndFrame()
+{
+	for (size_t i = 0; i < m_entries.size(); )
+	{
+		POOL_ENTRY& entry = m_entries[i];
+		if ((entry.bInUse == false) && (m_frameIndex - entry.lastUsedFrame >= EVICT_FRAMES))
+		{
+			m_heldBytes -= GetTargetBytes(*entry.pTarget);
+			delete entry.pTarget;
+			m_entries.erase(m_entries.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	m_frameIndex++;
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for deleting every target of the
+ *  pool.  It must be called while the context is current.
+ ***********************************************************/
+void RenderTargetPool::Clear()
+{
+	for (size_t i = 0; i < m_entries.size(); i++)
+	{
+		delete m_entries[i].pTarget;
+	}
+	m_entries.clear();
+	m_heldBytes = 0;
+}
+
+/***********************************************************
+ *  PrintStats()
+ *
+ *  This method is used for printing how many targets were
+ *  created and reused, and the most memory held at once.
+ ***********************************************************/
+void RenderTargetPool::PrintStats() const
+{
+	std::cout << "INFO: Render targets: " << m_createdCount << " created, " << m_reusedCount
+		<< " reused, at most " << (double)m_peakBytes / (1024.0 * 1024.0) << " MB held" << std::endl;
+}
@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+// rendertargetpool.h
+// ============
+// reuse of offscreen render targets across passes and frames
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderTarget.h"
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <vector>
+
+/***********************************************************
+ *  RenderTargetPool
+ *
+ *  This class hands out render targets by size and format.
+ *  A released target goes back to the pool and is handed to
+ *  the next request with the same description, whether that
+ *  comes later in the same frame or in a later frame.  Passes
+ *  that take their targets for only as long as they need
+ *  them therefore share textures with the passes that run
+ *  after them: OpenGL cannot place two textures in the same
+ *  memory, so the aliasing happens one whole target at a
+ *  time.
+ *
+ *  Targets are only created when a request finds no free
+ *  match, so a window resize creates its targets lazily on
+ *  the first frame of the new size.  A free target that has
+ *  not been asked for in a few frames is deleted, which
+ *  frees the targets of the old size.
+ ***********************************************************/
+class RenderTargetPool
+{
+public:
+	struct TARGET_DESC
+	{
+		int width;
+		int height;
+		// sized internal formats, or zero for no attachment
+		GLenum colorFormat;
+		GLenum depthFormat;
+		// samples per pixel, more than one for multisampling
+		int samples;
+	};
+
+	// constructor
+	RenderTargetPool();
+	// destructor
+	~RenderTargetPool();
+
+	// take a free target of the description, creating one when
+	// there is none - null when it cannot be created
+	RenderTarget* Acquire(const TARGET_DESC& desc);
+	// give a target back for the passes and frames after this
+	void Release(RenderTarget* pTarget);
+	// finish a frame, deleting targets left unused too long
+	void EndFrame();
+	// delete every target - none may be in use
+	void Clear();
+
+	// print how often targets were created and reused, and the
+	// most memory the pool held
+	void PrintStats() const;
+
+private:
+	struct POOL_ENTRY
+	{
+		RenderTarget* pTarget;
+		bool bInUse;
+		// frame the target was last handed out in
+		int lastUsedFrame;
+	};
+
+	std::vector<POOL_ENTRY> m_entries;
+	int m_frameIndex;
+
+	// statistics
+	int m_createdCount;
+	int m_reusedCount;
+	size_t m_heldBytes;
+	size_t m_peakBytes;
+
+	// estimated video memory of a target
+	static size_t GetTargetBytes(const RenderTarget& target);
+};
@@ -0,0 +1,272 @@
+///////////////////////////////////////////////////////////////////////////////
+// samplercache.cpp
+// ============
+// shared sampler objects for the texture filtering and wrapping presets
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SamplerCache.h"
+
+#include <algorithm>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// names of the presets, indexed by the enum values
+	const char* g_FilterNames[SceneManager::filter_count] = {
+		"default", "bilinear", "trilinear", "anisotropic" };
+	const char* g_WrapNames[SceneManager::wrap_count] = {
+		"repeat", "clamp" };
+}
+
+/***********************************************************
+ *  SamplerCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SamplerCache::SamplerCache()
+{
+	for (int filter = 0; filter < SceneManager::filter_count; filter++)
+	{
+		for (int wrap = 0; wrap < SceneManager::wrap_count; wrap++)
+		{
+			m_samplers[filter][wrap] = 0;
+		}
+	}
+	m_defaultFilter = SceneManager::filter_anisotropic;
+	m_overrideFilter = SceneManager::filter_default;
+	m_maxAnisotropy = 8.0f;
+	m_driverMaxAnisotropy = 0.0f;
+}
+
+/***********************************************************
+ *  ~SamplerCache()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SamplerCache::~SamplerCache()
+{
+	Clear();
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for reading the highest anisotropy
+ *  the driver supports.  Anisotropic filtering is core in
+ *  OpenGL 4.6 and an extension before; without it the
+ *  anisotropic preset is the same as trilinear.
+ ***********************************************************/
+void SamplerCache::Initialize()
+{
+	m_driverMaxAnisotropy = 0.0f;
+	if ((GLEW_VERSION_4_6) || (GLEW_ARB_texture_filter_anisotropic) || (GLEW_EXT_texture_filter_anisotropic))
+	{
+		glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &m_driverMaxAnisotropy);
+	}
+	else
+	{
+		std::cout << "INFO: Anisotropic filtering is not supported, using trilinear filtering" << std::endl;
+	}
+	SetMaxAnisotropy(m_maxAnisotropy);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for deleting the sampler objects and
+ *  forgetting the bindings.
+ ***********************************************************/
+void SamplerCache::Clear()
+{
+	for (int filter = 0; filter < SceneManager::filter_count; filter++)
+	{
+		for (int wrap = 0; wrap < SceneManager::wrap_count; wrap++)
+		{
+			if (m_samplers[filter][wrap] != 0)
+			{
+				glDeleteSamplers(1, &m_samplers[filter][wrap]);
+				m_samplers[filter][wrap] = 0;
+			}
+		}
+	}
+	m_boundSamplers.clear();
+}
+
+/***********************************************************
+ *  SetMaxAnisotropy()
+ *
+ *  This method is used for setting the samples of the
+ *  anisotropic preset, clamped to what the driver supports.
+ *  Existing anisotropic samplers are updated.
+ ***********************************************************/
+void SamplerCache::SetMaxAnisotropy(float anisotropy)
+{
+	m_maxAnisotropy = std::max(1.0f, anisotropy);
+	if (m_driverMaxAnisotropy > 0.0f)
+	{
+		m_maxAnisotropy = std::min(m_maxAnisotropy, m_driverMaxAnisotropy);
+	}
+
+	for (int wrap = 0; wrap < SceneManager::wrap_count; wrap++)
+	{
+		GLuint sampler = m_samplers[SceneManager::filter_anisotropic][wrap];
+		if ((sampler != 0) && (m_driverMaxAnisotropy > 0.0f))
+		{
+			glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY_EXT, m_maxAnisotropy);
+		}
+	}
+}
+
+/***********************************************************
+ *  ResolveFilter()
+ *
+ *  This method is used for getting the filter a material
+ *  is drawn with - the forced filter, the material's own,
+ *  or the default.
+ ***********************************************************/
+int SamplerCache::ResolveFilter(int filter) const
+{
+	if (m_overrideFilter != SceneManager::filter_default)
+	{
+		return(m_overrideFilter);
+	}
+	if ((filter <= SceneManager::filter_default) || (filter >= SceneManager::filter_count))
+	{
+		return(m_defaultFilter);
+	}
+	return(filter);
+}
+
+/***********************************************************
+ *  GetSampler()
+ *
+ *  This method is used for getting the sampler object of a
+ *  preset, creating it the first time it is needed.
+ ***********************************************************/
+GLuint SamplerCache::GetSampler(int filter, int wrap)
+{
+	filter = ResolveFilter(filter);
+	if ((wrap < 0) || (wrap >= SceneManager::wrap_count))
+	{
+		wrap = SceneManager::wrap_repeat;
+	}
+
+	GLuint& sampler = m_samplers[filter][wrap];
+	if (sampler != 0)
+	{
+		return(sampler);
+	}
+
+	glGenSamplers(1, &sampler);
+
+	GLint wrapMode = (wrap == SceneManager::wrap_clamp) ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, wrapMode);
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, wrapMode);
+	glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	if (filter == SceneManager::filter_bilinear)
+	{
+		glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	}
+	else
+	{
+		glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	}
+	if ((filter == SceneManager::filter_anisotropic) && (m_driverMaxAnisotropy > 0.0f))
+	{
+		glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY_EXT, m_maxAnisotropy);
+	}
+
+	return(sampler);
+}
+
+/***********************************************************
+ *  BindSampler()
+ *
+ *  This method is used for binding the sampler of a preset
+ *  to a texture unit, unless it is bound there already.
+ ***********************************************************/
+bool SamplerCache::BindSampler(int unit, int filter, int wrap)
+{
+	if (unit < 0)
+	{
+		return(false);
+	}
+
+	GLuint sampler = GetSampler(filter, wrap);
+	if (unit >= (int)m_boundSamplers.size())
+	{
+		m_boundSamplers.resize(unit + 1, 0);
+	}
+	if (m_boundSamplers[unit] == sampler)
+	{
+		return(false);
+	}
+
+	glBindSampler(unit, sampler);
+	m_boundSamplers[unit] = sampler;
+	return(true);
+}
+
+/***********************************************************
+ *  GetFilterName()
+ *
+ *  Returns the name of a filter preset.
+ ***********************************************************/
+const char* SamplerCache::GetFilterName(int filter)
+{
+	if ((filter < 0) || (filter >= SceneManager::filter_count))
+	{
+		return(g_FilterNames[SceneManager::filter_default]);
+	}
+	return(g_FilterNames[filter]);
+}
+
+/***********************************************************
+ *  FindFilter()
+ *
+ *  Returns the filter preset with the passed in name.
+ ***********************************************************/
+int SamplerCache::FindFilter(const std::string& name)
+{
+	for (int filter = 0; filter < SceneManager::filter_count; filter++)
+	{
+		if (name == g_FilterNames[filter])
+		{
+			return(filter);
+		}
+	}
+	return(-1);
+}
+
+/***********************************************************
+ *  GetWrapName()
+ *
+ *  Returns the name of a wrap preset.
+ ***********************************************************/
+const char* SamplerCache::GetWrapName(int wrap)
+{
+	if ((wrap < 0) || (wrap >= SceneManager::wrap_count))
+	{
+		return(g_WrapNames[SceneManager::wrap_repeat]);
+	}
+	return(g_WrapNames[wrap]);
+}
+
+/***********************************************************
+ *  FindWrap()
+ *
+ *  Returns the wrap preset with the passed in name.
+ ***********************************************************/
+int SamplerCache::FindWrap(const std::string& name)
+{
+	for (int wrap = 0; wrap < SceneManager::wrap_count; wrap++)
+	{
+		if (name == g_WrapNames[wrap])
+		{
+			return(wrap);
+		}
+	}
+	return(-1);
+}
@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+// samplercache.h
+// ============
+// shared sampler objects for the texture filtering and wrapping presets
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SamplerCache
+ *
+ *  This class keeps one sampler object for each filtering
+ *  and wrapping preset, so the way a texture is sampled is
+ *  chosen per draw from the material instead of being fixed
+ *  in the texture object.  Samplers are created on first
+ *  use and bound to texture units only when the binding of
+ *  the unit changes.
+ *
+ *  The bilinear preset samples the finest level only, as the
+ *  textures used to; trilinear blends between the mip levels
+ *  and anisotropic adds up to the chosen number of samples
+ *  along the direction a surface is seen at a slant.
+ ***********************************************************/
+class SamplerCache
+{
+public:
+	// constructor
+	SamplerCache();
+	// destructor
+	~SamplerCache();
+
+	// read the anisotropy limit of the driver - call once the
+	// OpenGL context is current
+	void Initialize();
+	// delete every sampler object
+	void Clear();
+
+	// filter of the materials that do not choose one
+	void SetDefaultFilter(int filter) { m_defaultFilter = filter; }
+	int GetDefaultFilter() const { return(m_defaultFilter); }
+	// filter forced on every material, or filter_default to let
+	// the materials choose
+	void SetOverrideFilter(int filter) { m_overrideFilter = filter; }
+	// samples of the anisotropic preset, up to the driver limit
+	void SetMaxAnisotropy(float anisotropy);
+	float GetMaxAnisotropy() const { return(m_maxAnisotropy); }
+	// the filter a material filter is drawn with
+	int ResolveFilter(int filter) const;
+
+	// the sampler object of a preset, created on first use
+	GLuint GetSampler(int filter, int wrap);
+	// bind the sampler of a preset to a texture unit - true when
+	// the binding changed
+	bool BindSampler(int unit, int filter, int wrap);
+
+	// names of the presets in scene files and on the command
+	// line - the find functions return -1 for unknown names
+	static const char* GetFilterName(int filter);
+	static int FindFilter(const std::string& name);
+	static const char* GetWrapName(int wrap);
+	static int FindWrap(const std::string& name);
+
+private:
+	GLuint m_samplers[SceneManager::filter_count][SceneManager::wrap_count];
+	// sampler bound to each texture unit, zero for none
+	std::vector<GLuint> m_boundSamplers;
+	int m_defaultFilter;
+	int m_overrideFilter;
+	float m_maxAnisotropy;
+	// zero when anisotropic filtering is not supported
+	float m_driverMaxAnisotropy;
+};
@@ -0,0 +1,928 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.cpp
+// ============
+// text and compiled scene description files for data driven scenes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneFile.h"
+#include "JsonParser.h"
+#include "MeshLibrary.h"
+#include "SamplerCache.h"
+#include "CPUProfiler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+const MeshLibrary* SceneFile::s_pMeshLibrary = NULL;
+
+// declaration of global variables
+namespace
+{
+	// names of the mesh types in text files
+	const char* g_MeshNames[SceneManager::mesh_type_count] = {
+		"plane", "box", "sphere", "cylinder", "torus", "tapered_cylinder" };
+
+	// newest text and compiled format versions
+	const int TEXT_VERSION = 1;
+	const uint32_t BINARY_VERSION = 2;
+
+	// first bytes of every compiled scene file
+	const char SCENE_FILE_MAGIC[8] = { 'S', 'C', 'E', 'N', 'E', 'B', 'I', 'N' };
+	// written in native byte order to detect a foreign one
+	const uint32_t BYTE_ORDER_MARK = 0x01020304;
+	// every section starts at a multiple of this offset
+	const uint64_t SECTION_ALIGNMENT = 16;
+
+	// an array of the compiled file - the offset is from the
+	// start of the file, the count is in elements
+	struct FILE_SECTION
+	{
+		uint64_t offset;
+		uint64_t count;
+	};
+
+	// header at the start of a compiled file
+	struct FILE_HEADER
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t byteOrder;
+		// element sizes of the in-place arrays - a build with a
+		// different layout must not read them
+		uint32_t objectSize;
+		uint32_t lightSize;
+		// null terminated strings, counted in bytes
+		FILE_SECTION strings;
+		FILE_SECTION textures;
+		FILE_SECTION materials;
+		FILE_SECTION lights;
+		FILE_SECTION objects;
+	};
+
+	// a texture of the compiled file, as string offsets
+	struct FILE_TEXTURE
+	{
+		uint32_t tag;
+		uint32_t filename;
+	};
+
+	// a material of the compiled file
+	struct FILE_MATERIAL
+	{
+		float diffuseColor[3];
+		float specularColor[3];
+		float shininess;
+		uint32_t samplerFilter;
+		uint32_t samplerWrap;
+		uint32_t tag;
+	};
+
+	/***********************************************************
+	 *  SchemaError()
+	 *
+	 *  Records an error about a value that parsed but does not
+	 *  describe a valid scene, and returns false.
+	 ***********************************************************/
+	bool SchemaError(std::string& error, const JSON_VALUE& value, const std::string& message)
+	{
+		error = "line " + std::to_string(value.line) + ": " + message;
+		return(false);
+	}
+
+	/***********************************************************
+	 *  ReadFloats()
+	 *
+	 *  Reads an array of exactly count numbers, or a plain
+	 *  number when count is one.  A missing member leaves the
+	 *  defaults in place.
+	 ***********************************************************/
+	bool ReadFloats(const JSON_VALUE& object, const char* name, float* pValues, int count, std::string& error)
+	{
+		const JSON_VALUE* pArray = JsonParser::FindMember(object, name);
+		if (NULL == pArray)
+		{
+			return(true);
+		}
+		if ((count == 1) && (pArray->type == json_number))
+		{
+			pValues[0] = (float)pArray->number;
+			return(true);
+		}
+		if ((pArray->type != json_array) || ((int)pArray->items.size() != count))
+		{
+			return(SchemaError(error, *pArray,
+				std::string("\"") + name + "\" must be an array of " + std::to_string(count) + " numbers"));
+		}
+		for (int i = 0; i < count; i++)
+		{
+			if (pArray->items[i].type != json_number)
+			{
+				return(SchemaError(error, pArray->items[i], std::string("\"") + name + "\" must hold numbers"));
+			}
+			pValues[i] = (float)pArray->items[i].number;
+		}
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ReadText()
+	 *
+	 *  Reads a string member.  A missing member gives an empty
+	 *  string.
+	 ***********************************************************/
+	bool ReadText(const JSON_VALUE& object, const char* name, std::string& text, std::string& error)
+	{
+		text.clear();
+		const JSON_VALUE* pValue = JsonParser::FindMember(object, name);
+		if (NULL == pValue)
+		{
+			return(true);
+		}
+		if (pValue->type != json_string)
+		{
+			return(SchemaError(error, *pValue, std::string("\"") + name + "\" must be a string"));
+		}
+		text = pValue->text;
+		return(true);
+	}
+
+	/***********************************************************
+	 *  GetArray()
+	 *
+	 *  Returns a top level array of the scene, or null when it
+	 *  is missing or is not an array.
+	 ***********************************************************/
+	const JSON_VALUE* GetArray(const JSON_VALUE& root, const char* name, std::string& error)
+	{
+		const JSON_VALUE* pArray = JsonParser::FindMember(root, name);
+		if ((NULL != pArray) && (pArray->type != json_array))
+		{
+			SchemaError(error, *pArray, std::string("\"") + name + "\" must be an array");
+			return(NULL);
+		}
+		return(pArray);
+	}
+
+	/***********************************************************
+	 *  WriteString()
+	 *
+	 *  Writes a quoted string with JSON escapes.
+	 ***********************************************************/
+	void WriteString(std::ostream& out, const std::string& text)
+	{
+		out << '"';
+		for (size_t i = 0; i < text.size(); i++)
+		{
+			char c = text[i];
+			if ((c == '"') || (c == '\\'))
+			{
+				out << '\\' << c;
+			}
+			else if ((unsigned char)c < 0x20)
+			{
+				char escape[8];
+				snprintf(escape, sizeof(escape), "\\u%04x", (unsigned int)c);
+				out << escape;
+			}
+			else
+			{
+				out << c;
+			}
+		}
+		out << '"';
+	}
+
+	/***********************************************************
+	 *  WriteFloats()
+	 *
+	 *  Writes an array of numbers.
+	 ***********************************************************/
+	void WriteFloats(std::ostream& out, const float* pValues, int count)
+	{
+		out << '[';
+		for (int i = 0; i < count; i++)
+		{
+			out << ((i > 0) ? ", " : "") << pValues[i];
+		}
+		out << ']';
+	}
+
+	/***********************************************************
+	 *  AlignOffset()
+	 *
+	 *  Rounds an offset up to the section alignment.
+	 ***********************************************************/
+	uint64_t AlignOffset(uint64_t offset)
+	{
+		return((offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1));
+	}
+
+	/***********************************************************
+	 *  GetSection()
+	 *
+	 *  Returns the start of a section of the mapped file, or
+	 *  null when the section does not fit inside the file.
+	 ***********************************************************/
+	const unsigned char* GetSection(const MappedFile& file, const FILE_SECTION& section, size_t elementSize)
+	{
+		if ((section.offset % SECTION_ALIGNMENT != 0) || (section.offset > file.GetSize()) ||
+			(section.count > (file.GetSize() - section.offset) / elementSize))
+		{
+			return(NULL);
+		}
+		return(file.GetData() + section.offset);
+	}
+
+	/***********************************************************
+	 *  GetFileString()
+	 *
+	 *  Returns a string of the compiled file's string section,
+	 *  checking that it is terminated inside the section.
+	 ***********************************************************/
+	bool GetFileString(const char* pStrings, uint64_t size, uint32_t offset, std::string& text)
+	{
+		if ((offset >= size) || (memchr(pStrings + offset, '\0', (size_t)(size - offset)) == NULL))
+		{
+			return(false);
+		}
+		text = pStrings + offset;
+		return(true);
+	}
+}
+
+/***********************************************************
+ *  SceneFile()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneFile::SceneFile()
+{
+	m_pObjects = NULL;
+	m_objectCount = 0;
+}
+
+/***********************************************************
+ *  ~SceneFile()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneFile::~SceneFile()
+{
+	Clear();
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for forgetting the current contents
+ *  and unmapping the file.
+ ***********************************************************/
+void SceneFile::Clear()
+{
+	m_textures.clear();
+	m_materials.clear();
+	m_lights.clear();
+	m_objects.clear();
+	m_pObjects = NULL;
+	m_objectCount = 0;
+	m_mappedFile.Close();
+}
+
+/***********************************************************
+ *  SetContents()
+ *
+ *  This method is used for setting the scene that the next
+ *  save writes.
+ ***********************************************************/
+void SceneFile::SetContents(
+	const std::vector<SceneManager::TEXTURE_FILE>& textures,
+	const std::vector<SceneManager::OBJECT_MATERIAL>& materials,
+	const std::vector<SceneManager::SCENE_LIGHT>& lights,
+	const SceneManager::SCENE_OBJECT* pObjects,
+	int objectCount)
+{
+	Clear();
+	m_textures = textures;
+	m_materials = materials;
+	m_lights = lights;
+	m_pObjects = pObjects;
+	m_objectCount = objectCount;
+}
+
+/***********************************************************
+ *  Load()
+ *
+ *  This method is used for reading a scene file.  The file
+ *  is mapped either way; a compiled scene keeps the mapping
+ *  and uses it in place, a text scene is parsed from it.
+ ***********************************************************/
+bool SceneFile::Load(const char* filename)
+{
+	CPU_PROFILE_ZONE("SceneFile::Load");
+
+	Clear();
+	if (m_mappedFile.Open(filename) == false)
+	{
+		return(false);
+	}
+
+	bool bResult = false;
+	if ((m_mappedFile.GetSize() >= sizeof(SCENE_FILE_MAGIC)) &&
+		(memcmp(m_mappedFile.GetData(), SCENE_FILE_MAGIC, sizeof(SCENE_FILE_MAGIC)) == 0))
+	{
+		bResult = LoadBinary(filename);
+	}
+	else
+	{
+		bResult = LoadText(filename);
+		// the parsed scene no longer needs the file
+		m_mappedFile.Close();
+	}
+
+	if (bResult == false)
+	{
+		Clear();
+	}
+
+	return(bResult);
+}
+
+/***********************************************************
+ *  LoadBinary()
+ *
+ *  This method is used for checking the header of a mapped
+ *  compiled scene and pointing at its objects.  The few
+ *  textures, materials and lights are copied out; the
+ *  objects are never touched here, so their pages are only
+ *  read from disk when the first frame culls them.
+ ***********************************************************/
+bool SceneFile::LoadBinary(const char* filename)
+{
+	if (m_mappedFile.GetSize() < sizeof(FILE_HEADER))
+	{
+		std::cout << "Could not load scene file, header is truncated:" << filename << std::endl;
+		return(false);
+	}
+
+	FILE_HEADER header;
+	memcpy(&header, m_mappedFile.GetData(), sizeof(header));
+	if ((header.version != BINARY_VERSION) || (header.byteOrder != BYTE_ORDER_MARK) ||
+		(header.objectSize != sizeof(SceneManager::SCENE_OBJECT)) ||
+		(header.lightSize != sizeof(SceneManager::SCENE_LIGHT)))
+	{
+		std::cout << "Could not load scene file, it was compiled by a different build - "
+			<< "compile it again from the text form:" << filename << std::endl;
+		return(false);
+	}
+
+	const char* pStrings = (const char*)GetSection(m_mappedFile, header.strings, 1);
+	const FILE_TEXTURE* pTextures = (const FILE_TEXTURE*)GetSection(m_mappedFile, header.textures, sizeof(FILE_TEXTURE));
+	const FILE_MATERIAL* pMaterials = (const FILE_MATERIAL*)GetSection(m_mappedFile, header.materials, sizeof(FILE_MATERIAL));
+	const SceneManager::SCENE_LIGHT* pLights =
+		(const SceneManager::SCENE_LIGHT*)GetSection(m_mappedFile, header.lights, sizeof(SceneManager::SCENE_LIGHT));
+	const SceneManager::SCENE_OBJECT* pObjects =
+		(const SceneManager::SCENE_OBJECT*)GetSection(m_mappedFile, header.objects, sizeof(SceneManager::SCENE_OBJECT));
+	if ((NULL == pStrings) || (NULL == pTextures) || (NULL == pMaterials) || (NULL == pLights) || (NULL == pObjects) ||
+		(header.objects.count > (uint64_t)std::numeric_limits<int>::max()))
+	{
+		std::cout << "Could not load scene file, a section is out of range:" << filename << std::endl;
+		return(false);
+	}
+	if (header.textures.count > 16)
+	{
+		std::cout << "Could not load scene file, no more than 16 textures can be loaded:" << filename << std::endl;
+		return(false);
+	}
+
+	m_textures.resize((size_t)header.textures.count);
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		if ((GetFileString(pStrings, header.strings.count, pTextures[i].tag, m_textures[i].tag) == false) ||
+			(GetFileString(pStrings, header.strings.count, pTextures[i].filename, m_textures[i].filename) == false))
+		{
+			std::cout << "Could not load scene file, a texture name is out of range:" << filename << std::endl;
+			return(false);
+		}
+	}
+
+	m_materials.resize((size_t)header.materials.count);
+	for (size_t i = 0; i < m_materials.size(); i++)
+	{
+		const FILE_MATERIAL& fileMaterial = pMaterials[i];
+		SceneManager::OBJECT_MATERIAL& material = m_materials[i];
+		material.diffuseColor = glm::vec3(fileMaterial.diffuseColor[0], fileMaterial.diffuseColor[1], fileMaterial.diffuseColor[2]);
+		material.specularColor = glm::vec3(fileMaterial.specularColor[0], fileMaterial.specularColor[1], fileMaterial.specularColor[2]);
+		material.shininess = fileMaterial.shininess;
+		material.samplerFilter = (int)fileMaterial.samplerFilter;
+		material.samplerWrap = (int)fileMaterial.samplerWrap;
+		if ((material.samplerFilter >= SceneManager::filter_count) || (material.samplerWrap >= SceneManager::wrap_count))
+		{
+			std::cout << "Could not load scene file, a material sampler is out of range:" << filename << std::endl;
+			return(false);
+		}
+		if (GetFileString(pStrings, header.strings.count, fileMaterial.tag, material.tag) == false)
+		{
+			std::cout << "Could not load scene file, a material name is out of range:" << filename << std::endl;
+			return(false);
+		}
+	}
+
+	m_lights.assign(pLights, pLights + header.lights.count);
+
+	m_pObjects = pObjects;
+	m_objectCount = (int)header.objects.count;
+
+	return(true);
+}
+
+/***********************************************************
+ *  LoadText()
+ *
+ *  This method is used for parsing a JSON scene.  Textures
+ *  and materials are referred to by tag in the text and are
+ *  resolved to slots and indices here.
+ ***********************************************************/
+bool SceneFile::LoadText(const char* filename)
+{
+	JSON_VALUE root;
+	std::string error;
+	if (JsonParser::Parse((const char*)m_mappedFile.GetData(), m_mappedFile.GetSize(), root, error) == false)
+	{
+		std::cout << "Could not parse scene file " << filename << ", " << error << std::endl;
+		return(false);
+	}
+
+	if (root.type != json_object)
+	{
+		SchemaError(error, root, "the scene must be an object");
+	}
+
+	const JSON_VALUE* pVersion = JsonParser::FindMember(root, "version");
+	if ((error.size() == 0) && (NULL != pVersion) &&
+		((pVersion->type != json_number) || (pVersion->number > TEXT_VERSION)))
+	{
+		SchemaError(error, *pVersion, "unsupported version");
+	}
+
+	// textures
+	std::unordered_map<std::string, int> textureSlots;
+	const JSON_VALUE* pTextures = GetArray(root, "textures", error);
+	for (size_t i = 0; (error.size() == 0) && (NULL != pTextures) && (i < pTextures->items.size()); i++)
+	{
+		const JSON_VALUE& item = pTextures->items[i];
+		SceneManager::TEXTURE_FILE texture;
+		if ((ReadText(item, "tag", texture.tag, error) == false) ||
+			(ReadText(item, "file", texture.filename, error) == false))
+		{
+			break;
+		}
+		if ((texture.tag.size() == 0) || (texture.filename.size() == 0))
+		{
+			SchemaError(error, item, "a texture needs a \"tag\" and a \"file\"");
+		}
+		else if (m_textures.size() >= 16)
+		{
+			SchemaError(error, item, "no more than 16 textures can be loaded");
+		}
+		else if (textureSlots.insert(std::make_pair(texture.tag, (int)m_textures.size())).second == false)
+		{
+			SchemaError(error, item, "texture \"" + texture.tag + "\" is defined twice");
+		}
+		m_textures.push_back(texture);
+	}
+
+	// materials
+	std::unordered_map<std::string, int> materialIndices;
+	const JSON_VALUE* pMaterials = GetArray(root, "materials", error);
+	for (size_t i = 0; (error.size() == 0) && (NULL != pMaterials) && (i < pMaterials->items.size()); i++)
+	{
+		const JSON_VALUE& item = pMaterials->items[i];
+		SceneManager::OBJECT_MATERIAL material;
+		material.diffuseColor = glm::vec3(1.0f, 1.0f, 1.0f);
+		material.specularColor = glm::vec3(0.0f, 0.0f, 0.0f);
+		material.shininess = 1.0f;
+		material.samplerFilter = SceneManager::filter_default;
+		material.samplerWrap = SceneManager::wrap_repeat;
+		std::string filterName;
+		std::string wrapName;
+		if ((ReadText(item, "tag", material.tag, error) == false) ||
+			(ReadFloats(item, "diffuse", &material.diffuseColor[0], 3, error) == false) ||
+			(ReadFloats(item, "specular", &material.specularColor[0], 3, error) == false) ||
+			(ReadFloats(item, "shininess", &material.shininess, 1, error) == false) ||
+			(ReadText(item, "filter", filterName, error) == false) ||
+			(ReadText(item, "wrap", wrapName, error) == false))
+		{
+			break;
+		}
+		if (filterName.size() > 0)
+		{
+			material.samplerFilter = SamplerCache::FindFilter(filterName);
+		}
+		if (wrapName.size() > 0)
+		{
+			material.samplerWrap = SamplerCache::FindWrap(wrapName);
+		}
+		if (material.tag.size() == 0)
+		{
+			SchemaError(error, item, "a material needs a \"tag\"");
+		}
+		else if (material.samplerFilter < 0)
+		{
+			SchemaError(error, item, "unknown filter \"" + filterName + "\"");
+		}
+		else if (material.samplerWrap < 0)
+		{
+			SchemaError(error, item, "unknown wrap \"" + wrapName + "\"");
+		}
+		else if (materialIndices.insert(std::make_pair(material.tag, (int)m_materials.size())).second == false)
+		{
+			SchemaError(error, item, "material \"" + material.tag + "\" is defined twice");
+		}
+		m_materials.push_back(material);
+	}
+
+	// lights
+	const JSON_VALUE* pLights = GetArray(root, "lights", error);
+	for (size_t i = 0; (error.size() == 0) && (NULL != pLights) && (i < pLights->items.size()); i++)
+	{
+		const JSON_VALUE& item = pLights->items[i];
+		SceneManager::SCENE_LIGHT light;
+		light.position = glm::vec3(0.0f, 0.0f, 0.0f);
+		light.ambient = glm::vec3(0.0f, 0.0f, 0.0f);
+		light.diffuse = glm::vec3(1.0f, 1.0f, 1.0f);
+		light.specular = glm::vec3(1.0f, 1.0f, 1.0f);
+		if ((ReadFloats(item, "position", &light.position[0], 3, error) == false) ||
+			(ReadFloats(item, "ambient", &light.ambient[0], 3, error) == false) ||
+			(ReadFloats(item, "diffuse", &light.diffuse[0], 3, error) == false) ||
+			(ReadFloats(item, "specular", &light.specular[0], 3, error) == false))
+		{
+			break;
+		}
+		m_lights.push_back(light);
+	}
+
+	// objects
+	const JSON_VALUE* pObjects = GetArray(root, "objects", error);
+	if ((error.size() == 0) && (NULL != pObjects))
+	{
+		m_objects.reserve(pObjects->items.size());
+	}
+	for (size_t i = 0; (error.size() == 0) && (NULL != pObjects) && (i < pObjects->items.size()); i++)
+	{
+		const JSON_VALUE& item = pObjects->items[i];
+		SceneManager::SCENE_OBJECT object;
+		object.meshType = -1;
+		object.scaleXYZ = glm::vec3(1.0f, 1.0f, 1.0f);
+		object.rotationDegrees = glm::vec3(0.0f, 0.0f, 0.0f);
+		object.positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
+		object.textureSlot = -1;
+		object.color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+		object.uvScale = glm::vec2(1.0f, 1.0f);
+		object.materialIndex = -1;
+
+		std::string meshName;
+		std::string textureTag;
+		std::string materialTag;
+		const JSON_VALUE* pColor = JsonParser::FindMember(item, "color");
+		int colorCount = ((NULL != pColor) && (pColor->items.size() == 3)) ? 3 : 4;
+		if ((ReadText(item, "mesh", meshName, error) == false) ||
+			(ReadText(item, "texture", textureTag, error) == false) ||
+			(ReadText(item, "material", materialTag, error) == false) ||
+			(ReadFloats(item, "scale", &object.scaleXYZ[0], 3, error) == false) ||
+			(ReadFloats(item, "rotation", &object.rotationDegrees[0], 3, error) == false) ||
+			(ReadFloats(item, "position", &object.positionXYZ[0], 3, error) == false) ||
+			(ReadFloats(item, "color", &object.color[0], colorCount, error) == false) ||
+			(ReadFloats(item, "uv_scale", &object.uvScale[0], 2, error) == false))
+		{
+			break;
+		}
+
+		for (int mesh = 0; mesh < SceneManager::mesh_type_count; mesh++)
+		{
+			if (meshName == g_MeshNames[mesh])
+			{
+				object.meshType = mesh;
+			}
+		}
+		if ((object.meshType < 0) && (NULL != s_pMeshLibrary) && (s_pMeshLibrary->FindMesh(meshName) >= 0))
+		{
+			object.meshType = SceneManager::mesh_type_count + s_pMeshLibrary->FindMesh(meshName);
+		}
+		if (object.meshType < 0)
+		{
+			SchemaError(error, item, "unknown mesh \"" + meshName + "\"");
+			break;
+		}
+
+		if (textureTag.size() > 0)
+		{
+			std::unordered_map<std::string, int>::const_iterator texture = textureSlots.find(textureTag);
+			if (texture == textureSlots.end())
+			{
+				SchemaError(error, item, "unknown texture \"" + textureTag + "\"");
+				break;
+			}
+			object.textureSlot = texture->second;
+		}
+		if (materialTag.size() > 0)
+		{
+			std::unordered_map<std::string, int>::const_iterator material = materialIndices.find(materialTag);
+			if (material == materialIndices.end())
+			{
+				SchemaError(error, item, "unknown material \"" + materialTag + "\"");
+				break;
+			}
+			object.materialIndex = material->second;
+		}
+
+		// the same bounding sphere the scene generator uses, or
+		// one around the bounds of a library mesh, which need not
+		// be centered on its origin
+		float maxScale = std::max(object.scaleXYZ.x, std::max(object.scaleXYZ.y, object.scaleXYZ.z));
+		object.center = object.positionXYZ;
+		object.radius = 1.415f * maxScale;
+		if (object.meshType >= SceneManager::mesh_type_count)
+		{
+			glm::vec3 boundsCenter;
+			float boundsRadius;
+			s_pMeshLibrary->GetBounds(object.meshType - SceneManager::mesh_type_count, boundsCenter, boundsRadius);
+			object.radius = maxScale * (glm::length(boundsCenter) + boundsRadius);
+		}
+
+		m_objects.push_back(object);
+	}
+
+	if (error.size() > 0)
+	{
+		std::cout << "Could not load scene file " << filename << ", " << error << std::endl;
+		return(false);
+	}
+
+	m_pObjects = m_objects.data();
+	m_objectCount = (int)m_objects.size();
+
+	return(true);
+}
+
+/***********************************************************
+ *  Save()
+ *
+ *  This method is used for writing the scene in the form
+ *  given by the file name.
+ ***********************************************************/
+bool SceneFile::Save(const char* filename) const
+{
+	std::string name = filename;
+	if ((name.size() >= 5) && (name.compare(name.size() - 5, 5, ".json") == 0))
+	{
+		return(SaveText(filename));
+	}
+	return(SaveBinary(filename));
+}
+
+/***********************************************************
+ *  SaveText()
+ *
+ *  This method is used for writing the scene as JSON, with
+ *  one object per line.  Texture slots and material indices
+ *  are written as the tags they refer to.
+ ***********************************************************/
+bool SceneFile::SaveText(const char* filename) const
+{
+	CPU_PROFILE_ZONE("SceneFile::SaveText");
+
+	std::ofstream file(filename);
+	if (!file.is_open())
+	{
+		std::cout << "Could not write scene file:" << filename << std::endl;
+		return(false);
+	}
+
+	// enough digits for every float to read back unchanged
+	file.precision(std::numeric_limits<float>::max_digits10);
+
+	file << "{\n  \"version\": " << TEXT_VERSION << ",\n";
+
+	file << "  \"textures\": [";
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		file << ((i > 0) ? ",\n" : "\n") << "    { \"tag\": ";
+		WriteString(file, m_textures[i].tag);
+		file << ", \"file\": ";
+		WriteString(file, m_textures[i].filename);
+		file << " }";
+	}
+	file << "\n  ],\n";
+
+	file << "  \"materials\": [";
+	for (size_t i = 0; i < m_materials.size(); i++)
+	{
+		const SceneManager::OBJECT_MATERIAL& material = m_materials[i];
+		file << ((i > 0) ? ",\n" : "\n") << "    { \"tag\": ";
+		WriteString(file, material.tag);
+		file << ", \"diffuse\": ";
+		WriteFloats(file, &material.diffuseColor[0], 3);
+		file << ", \"specular\": ";
+		WriteFloats(file, &material.specularColor[0], 3);
+		file << ", \"shininess\": " << material.shininess;
+		if (material.samplerFilter != SceneManager::filter_default)
+		{
+			file << ", \"filter\": \"" << SamplerCache::GetFilterName(material.samplerFilter) << "\"";
+		}
+		if (material.samplerWrap != SceneManager::wrap_repeat)
+		{
+			file << ", \"wrap\": \"" << SamplerCache::GetWrapName(material.samplerWrap) << "\"";
+		}
+		file << " }";
+	}
+	file << "\n  ],\n";
+
+	file << "  \"lights\": [";
+	for (size_t i = 0; i < m_lights.size(); i++)
+	{
+		const SceneManager::SCENE_LIGHT& light = m_lights[i];
+		file << ((i > 0) ? ",\n" : "\n") << "    { \"position\": ";
+		WriteFloats(file, &light.position[0], 3);
+		file << ", \"ambient\": ";
+		WriteFloats(file, &light.ambient[0], 3);
+		file << ", \"diffuse\": ";
+		WriteFloats(file, &light.diffuse[0], 3);
+		file << ", \"specular\": ";
+		WriteFloats(file, &light.specular[0], 3);
+		file << " }";
+	}
+	file << "\n  ],\n";
+
+	file << "  \"objects\": [";
+	for (int i = 0; i < m_objectCount; i++)
+	{
+		const SceneManager::SCENE_OBJECT& object = m_pObjects[i];
+		file << ((i > 0) ? ",\n" : "\n") << "    { \"mesh\": \"";
+		if ((object.meshType >= 0) && (object.meshType < SceneManager::mesh_type_count))
+		{
+			file << g_MeshNames[object.meshType];
+		}
+		else if ((NULL != s_pMeshLibrary) && (object.meshType >= SceneManager::mesh_type_count) &&
+			(object.meshType - SceneManager::mesh_type_count < s_pMeshLibrary->GetMeshCount()))
+		{
+			file << s_pMeshLibrary->GetMeshName(object.meshType - SceneManager::mesh_type_count);
+		}
+		file << "\", \"scale\": ";
+		WriteFloats(file, &object.scaleXYZ[0], 3);
+		file << ", \"rotation\": ";
+		WriteFloats(file, &object.rotationDegrees[0], 3);
+		file << ", \"position\": ";
+		WriteFloats(file, &object.positionXYZ[0], 3);
+		if ((object.textureSlot >= 0) && (object.textureSlot < (int)m_textures.size()))
+		{
+			file << ", \"texture\": ";
+			WriteString(file, m_textures[object.textureSlot].tag);
+		}
+		else
+		{
+			file << ", \"color\": ";
+			WriteFloats(file, &object.color[0], 4);
+		}
+		file << ", \"uv_scale\": ";
+		WriteFloats(file, &object.uvScale[0], 2);
+		if ((object.materialIndex >= 0) && (object.materialIndex < (int)m_materials.size()))
+		{
+			file << ", \"material\": ";
+			WriteString(file, m_materials[object.materialIndex].tag);
+		}
+		file << " }";
+	}
+	file << "\n  ]\n}\n";
+
+	if (file.fail())
+	{
+		std::cout << "Could not write scene file:" << filename << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  SaveBinary()
+ *
+ *  This method is used for writing the compiled form: the
+ *  header, then the textures, materials, lights, objects and
+ *  strings, each starting on an aligned offset so the arrays
+ *  can be used in place once the file is mapped.
+ *
+ *  The file is written under a temporary name and renamed
+ *  over the old one, so a program that has the old file
+ *  mapped keeps reading the old contents instead of a file
+ *  cut short under it.  MappedFile shares its files for
+ *  deletion on Windows so the rename is allowed there too.
+ ***********************************************************/
+bool SceneFile::SaveBinary(const char* filename) const
+{
+	CPU_PROFILE_ZONE("SceneFile::SaveBinary");
+
+	std::string temporaryName = std::string(filename) + ".tmp";
+	std::ofstream file(temporaryName.c_str(), std::ios::binary);
+	if (!file.is_open())
+	{
+		std::cout << "Could not write scene file:" << filename << std::endl;
+		return(false);
+	}
+
+	// gather the names into the string section
+	std::string strings;
+	std::vector<FILE_TEXTURE> textures(m_textures.size());
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		textures[i].tag = (uint32_t)strings.size();
+		strings.append(m_textures[i].tag.c_str(), m_textures[i].tag.size() + 1);
+		textures[i].filename = (uint32_t)strings.size();
+		strings.append(m_textures[i].filename.c_str(), m_textures[i].filename.size() + 1);
+	}
+
+	std::vector<FILE_MATERIAL> materials(m_materials.size());
+	for (size_t i = 0; i < m_materials.size(); i++)
+	{
+		const SceneManager::OBJECT_MATERIAL& material = m_materials[i];
+		for (int j = 0; j < 3; j++)
+		{
+			materials[i].diffuseColor[j] = material.diffuseColor[j];
+			materials[i].specularColor[j] = material.specularColor[j];
+		}
+		materials[i].shininess = material.shininess;
+		materials[i].samplerFilter = (uint32_t)material.samplerFilter;
+		materials[i].samplerWrap = (uint32_t)material.samplerWrap;
+		materials[i].tag = (uint32_t)strings.size();
+		strings.append(material.tag.c_str(), material.tag.size() + 1);
+	}
+
+	FILE_HEADER header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SCENE_FILE_MAGIC, sizeof(header.magic));
+	header.version = BINARY_VERSION;
+	header.byteOrder = BYTE_ORDER_MARK;
+	header.objectSize = sizeof(SceneManager::SCENE_OBJECT);
+	header.lightSize = sizeof(SceneManager::SCENE_LIGHT);
+
+	header.textures.offset = AlignOffset(sizeof(FILE_HEADER));
+	header.textures.count = textures.size();
+	header.materials.offset = AlignOffset(header.textures.offset + textures.size() * sizeof(FILE_TEXTURE));
+	header.materials.count = materials.size();
+	header.lights.offset = AlignOffset(header.materials.offset + materials.size() * sizeof(FILE_MATERIAL));
+	header.lights.count = m_lights.size();
+	header.objects.offset = AlignOffset(header.lights.offset + m_lights.size() * sizeof(SceneManager::SCENE_LIGHT));
+	header.objects.count = (uint64_t)m_objectCount;
+	header.strings.offset = AlignOffset(header.objects.offset + (uint64_t)m_objectCount * sizeof(SceneManager::SCENE_OBJECT));
+	header.strings.count = strings.size();
+
+	// write each section after the padding up to its offset
+	const char padding[SECTION_ALIGNMENT] = { 0 };
+	uint64_t position = 0;
+	const FILE_SECTION* sections[] = {
+		&header.textures, &header.materials, &header.lights, &header.objects, &header.strings };
+	const void* sectionData[] = {
+		textures.data(), materials.data(), m_lights.data(), m_pObjects, strings.data() };
+	size_t sectionBytes[] = {
+		textures.size() * sizeof(FILE_TEXTURE),
+		materials.size() * sizeof(FILE_MATERIAL),
+		m_lights.size() * sizeof(SceneManager::SCENE_LIGHT),
+		(size_t)m_objectCount * sizeof(SceneManager::SCENE_OBJECT),
+		strings.size() };
+
+	file.write((const char*)&header, sizeof(header));
+	position += sizeof(header);
+	for (int i = 0; i < 5; i++)
+	{
+		file.write(padding, (std::streamsize)(sections[i]->offset - position));
+		if (sectionBytes[i] > 0)
+		{
+			file.write((const char*)sectionData[i], (std::streamsize)sectionBytes[i]);
+		}
+		position = sections[i]->offset + sectionBytes[i];
+	}
+	file.close();
+
+	std::error_code error;
+	if (file.fail() == false)
+	{
+		std::filesystem::rename(temporaryName, filename, error);
+	}
+	if ((file.fail() == true) || (error))
+	{
+		std::cout << "Could not write scene file:" << filename << std::endl;
+		std::filesystem::remove(temporaryName, error);
+		return(false);
+	}
+
+	return(true);
+}
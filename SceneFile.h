@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.h
+// ============
+// text and compiled scene description files for data driven scenes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "MappedFile.h"
+
+#include <vector>
+
+class MeshLibrary;
+
+/***********************************************************
+ *  SceneFile
+ *
+ *  This class reads and writes the textures, materials,
+ *  lights and objects of a data driven scene.  The text form
+ *  is JSON, meant for editing by hand.  The compiled form is
+ *  a header followed by flat arrays at offsets from the start
+ *  of the file; it is mapped into memory and the objects are
+ *  drawn straight from the mapping, so loading does no
+ *  parsing and no copying no matter how large the scene is.
+ *
+ *  Compiled files hold the objects exactly as laid out in
+ *  memory, so they are only read by builds with the same
+ *  SCENE_OBJECT layout and byte order.  Keep the text form
+ *  as the source and compile it again when the layout
+ *  changes.
+ *
+ *  Objects may also name a mesh of the mesh library.  The
+ *  compiled form stores its index in the library, so compile
+ *  against the same mesh pack the scene is drawn with.
+ ***********************************************************/
+class SceneFile
+{
+public:
+	// constructor
+	SceneFile();
+	// destructor
+	~SceneFile();
+
+	// read a scene file - compiled files are recognized by
+	// their header, anything else is parsed as text
+	bool Load(const char* filename);
+	// write the scene as text when the name ends in .json,
+	// compiled otherwise
+	bool Save(const char* filename) const;
+	// write the scene as JSON text
+	bool SaveText(const char* filename) const;
+	// write the scene in the compiled form
+	bool SaveBinary(const char* filename) const;
+
+	// replace the contents with a scene to save - the objects
+	// are not copied and must stay valid while saving
+	void SetContents(
+		const std::vector<SceneManager::TEXTURE_FILE>& textures,
+		const std::vector<SceneManager::OBJECT_MATERIAL>& materials,
+		const std::vector<SceneManager::SCENE_LIGHT>& lights,
+		const SceneManager::SCENE_OBJECT* pObjects,
+		int objectCount);
+
+	// texture files, loaded into slots in the listed order
+	const std::vector<SceneManager::TEXTURE_FILE>& GetTextures() const { return(m_textures); }
+	// materials, indexed by the objects
+	const std::vector<SceneManager::OBJECT_MATERIAL>& GetMaterials() const { return(m_materials); }
+	// point lights
+	const std::vector<SceneManager::SCENE_LIGHT>& GetLights() const { return(m_lights); }
+	// objects - they stay valid as long as this object lives
+	const SceneManager::SCENE_OBJECT* GetObjects() const { return(m_pObjects); }
+	int GetObjectCount() const { return(m_objectCount); }
+	// true when the objects are read from a mapped compiled file
+	bool IsMapped() const { return(NULL != m_mappedFile.GetData()); }
+
+	// library whose mesh names text files may use besides the
+	// basic shapes - null allows the basic shapes only
+	static void SetMeshLibrary(const MeshLibrary* pMeshLibrary) { s_pMeshLibrary = pMeshLibrary; }
+
+private:
+	static const MeshLibrary* s_pMeshLibrary;
+
+	MappedFile m_mappedFile;
+	std::vector<SceneManager::TEXTURE_FILE> m_textures;
+	std::vector<SceneManager::OBJECT_MATERIAL> m_materials;
+	std::vector<SceneManager::SCENE_LIGHT> m_lights;
+	// objects parsed from a text file
+	std::vector<SceneManager::SCENE_OBJECT> m_objects;
+	// objects in use - parsed, mapped or set for saving
+	const SceneManager::SCENE_OBJECT* m_pObjects;
+	int m_objectCount;
+
+	// use the mapped file as a compiled scene
+	bool LoadBinary(const char* filename);
+	// parse the mapped file as a text scene
+	bool LoadText(const char* filename);
+	// forget the current contents
+	void Clear();
+};
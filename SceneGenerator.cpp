@@ -0,0 +1,243 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenegenerator.cpp
+// ============
+// seedable procedural scenes of basic shapes for scalability benchmarks
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneGenerator.h"
+
+#include <cmath>
+#include <cstdio>
+
+/***********************************************************
+ *  SceneGenerator()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneGenerator::SceneGenerator(uint32_t seed)
+{
+	// xorshift must never be seeded with zero
+	m_state = (seed != 0) ? seed : 0x9E3779B9u;
+}
+
+/***********************************************************
+ *  NextFloat()
+ *
+ *  This method is used for getting the next random value in
+ *  the range [0, 1).  A hand written generator is used since
+ *  the standard distributions differ between libraries.
+ ***********************************************************/
+float SceneGenerator::NextFloat()
+{
+	m_state ^= m_state << 13;
+	m_state ^= m_state >> 17;
+	m_state ^= m_state << 5;
+
+	// keep 24 bits so the value is exact in a float
+	return((float)(m_state >> 8) * (1.0f / 16777216.0f));
+}
+
+/***********************************************************
+ *  NextRange()
+ *
+ *  This method is used for getting the next random value in
+ *  the range [low, high).
+ ***********************************************************/
+float SceneGenerator::NextRange(float low, float high)
+{
+	return(low + (high - low) * NextFloat());
+}
+
+/***********************************************************
+ *  NextIndex()
+ *
+ *  This method is used for getting the next random integer
+ *  in the range [0, count).
+ ***********************************************************/
+int SceneGenerator::NextIndex(int count)
+{
+	if (count <= 0)
+	{
+		return(0);
+	}
+
+	int index = (int)(NextFloat() * count);
+	return((index < count) ? index : count - 1);
+}
+
+/***********************************************************
+ *  Generate()
+ *
+ *  This method is used for generating a complete scene.  The
+ *  objects are spread through a cube whose size grows with
+ *  the object count, keeping the density constant.
+ ***********************************************************/
+void SceneGenerator::Generate(
+	const GENERATOR_SETTINGS& settings,
+	std::vector<SceneManager::OBJECT_MATERIAL>& materials,
+	std::vector<SceneManager::SCENE_LIGHT>& lights,
+	std::vector<SceneManager::SCENE_OBJECT>& objects)
+{
+	// random materials
+	materials.clear();
+	for (int i = 0; i < settings.materialCount; i++)
+	{
+		SceneManager::OBJECT_MATERIAL material;
+		material.diffuseColor = glm::vec3(NextRange(0.1f, 0.8f), NextRange(0.1f, 0.8f), NextRange(0.1f, 0.8f));
+		float specular = NextRange(0.0f, 1.0f);
+		material.specularColor = glm::vec3(specular, specular, specular);
+		material.shininess = NextRange(2.0f, 96.0f);
+		material.samplerFilter = SceneManager::filter_default;
+		material.samplerWrap = SceneManager::wrap_repeat;
+
+		char tag[32];
+		snprintf(tag, sizeof(tag), "generated%d", i);
+		material.tag = tag;
+
+		materials.push_back(material);
+	}
+
+	float halfExtent = 0.5f * settings.spacing * std::cbrt((float)settings.objectCount);
+
+	// random point lights hovering above the objects
+	lights.clear();
+	for (int i = 0; i < settings.lightCount; i++)
+	{
+		SceneManager::SCENE_LIGHT light;
+		light.position = glm::vec3(
+			NextRange(-halfExtent, halfExtent),
+			NextRange(2.0f, 2.0f + halfExtent),
+			NextRange(-halfExtent, halfExtent));
+		light.ambient = glm::vec3(0.05f, 0.05f, 0.05f);
+		light.diffuse = glm::vec3(NextRange(0.3f, 0.6f), NextRange(0.3f, 0.6f), NextRange(0.3f, 0.6f));
+		light.specular = glm::vec3(0.2f, 0.2f, 0.2f);
+
+		lights.push_back(light);
+	}
+
+	// random objects
+	objects.clear();
+	objects.resize(settings.objectCount);
+	for (int i = 0; i < settings.objectCount; i++)
+	{
+		SceneManager::SCENE_OBJECT& object = objects[i];
+
+		object.meshType = NextIndex(SceneManager::mesh_type_count);
+
+		glm::vec3 scaleXYZ = glm::vec3(NextRange(0.2f, 1.0f), NextRange(0.2f, 1.0f), NextRange(0.2f, 1.0f));
+		float XrotationDegrees = NextRange(0.0f, 360.0f);
+		float YrotationDegrees = NextRange(0.0f, 360.0f);
+		float ZrotationDegrees = NextRange(0.0f, 360.0f);
+		glm::vec3 positionXYZ = glm::vec3(
+			NextRange(-halfExtent, halfExtent),
+			NextRange(0.0f, 2.0f * halfExtent),
+			NextRange(-halfExtent, halfExtent));
+
+		object.scaleXYZ = scaleXYZ;
+		object.rotationDegrees = glm::vec3(XrotationDegrees, YrotationDegrees, ZrotationDegrees);
+		object.positionXYZ = positionXYZ;
+
+		// no basic mesh extends further than sqrt(2) from its
+		// origin, which bounds the object under any rotation
+		object.center = positionXYZ;
+		object.radius = 1.415f * std::fmax(scaleXYZ.x, std::fmax(scaleXYZ.y, scaleXYZ.z));
+
+		// roughly one object in four is drawn with a flat color
+		if ((settings.textureCount > 0) && (NextFloat() < 0.75f))
+		{
+			object.textureSlot = NextIndex(settings.textureCount);
+		}
+		else
+		{
+			object.textureSlot = -1;
+		}
+		object.color = glm::vec4(NextFloat(), NextFloat(), NextFloat(), 1.0f);
+		object.uvScale = glm::vec2(1.0f, 1.0f);
+		object.materialIndex = NextIndex(settings.materialCount);
+	}
+}
+
+/***********************************************************
+ *  GenerateDepthTest()
+ *
+ *  This method is used for generating the depth precision
+ *  scene.  Each row is twice as far from the starting camera
+ *  as the one above it and grows with the distance, so every
+ *  row covers the same part of the screen.  Each column puts
+ *  a green panel a smaller fraction of the distance behind a
+ *  red one, half covered by it.  Wherever the depth buffer
+ *  cannot tell the two apart, green shows through the red
+ *  half as stripes or noise.
+ ***********************************************************/
+void SceneGenerator::GenerateDepthTest(
+	std::vector<SceneManager::OBJECT_MATERIAL>& materials,
+	std::vector<SceneManager::SCENE_LIGHT>& lights,
+	std::vector<SceneManager::SCENE_OBJECT>& objects)
+{
+	// rows one unit to 8192 units away
+	const int ROW_COUNT = 14;
+	// gap between the panels of each column, as a fraction of
+	// their distance
+	const float RELATIVE_GAPS[] = { 1e-2f, 1e-3f, 1e-4f, 1e-5f, 1e-6f };
+	const int COLUMN_COUNT = sizeof(RELATIVE_GAPS) / sizeof(RELATIVE_GAPS[0]);
+	// where the camera starts, and the downward slope it looks at
+	const glm::vec3 EYE = glm::vec3(0.0f, 5.0f, 12.0f);
+	const float VIEW_SLOPE = -0.25f;
+
+	materials.clear();
+	SceneManager::OBJECT_MATERIAL material;
+	material.diffuseColor = glm::vec3(0.8f, 0.8f, 0.8f);
+	material.specularColor = glm::vec3(0.0f, 0.0f, 0.0f);
+	material.shininess = 2.0f;
+	material.samplerFilter = SceneManager::filter_default;
+	material.samplerWrap = SceneManager::wrap_repeat;
+	material.tag = "generated0";
+	materials.push_back(material);
+
+	// a bright light at the camera, so far rows are not black
+	lights.clear();
+	SceneManager::SCENE_LIGHT light;
+	light.position = EYE;
+	light.ambient = glm::vec3(0.6f, 0.6f, 0.6f);
+	light.diffuse = glm::vec3(0.4f, 0.4f, 0.4f);
+	light.specular = glm::vec3(0.0f, 0.0f, 0.0f);
+	lights.push_back(light);
+
+	objects.clear();
+	for (int row = 0; row < ROW_COUNT; row++)
+	{
+		float distance = std::ldexp(1.0f, row);
+		float rowY = distance * (VIEW_SLOPE + 0.11f * (6.5f - (float)row));
+
+		for (int column = 0; column < COLUMN_COUNT; column++)
+		{
+			float columnX = distance * 0.35f * (float)(column - COLUMN_COUNT / 2);
+
+			for (int panel = 0; panel < 2; panel++)
+			{
+				SceneManager::SCENE_OBJECT object;
+				object.meshType = SceneManager::mesh_plane;
+				// the plane lies in XZ - turned up, it faces the camera
+				object.scaleXYZ = glm::vec3(0.1f * distance, 1.0f, 0.045f * distance);
+				object.rotationDegrees = glm::vec3(90.0f, 0.0f, 0.0f);
+				object.positionXYZ = EYE + glm::vec3(columnX, rowY, -distance);
+				if (panel == 1)
+				{
+					// behind and half a panel to the right
+					object.positionXYZ += glm::vec3(
+						0.1f * distance, 0.0f, -distance * RELATIVE_GAPS[column]);
+				}
+				object.center = object.positionXYZ;
+				object.radius = 1.415f * object.scaleXYZ.x;
+				object.textureSlot = -1;
+				object.color = (panel == 0) ?
+					glm::vec4(1.0f, 0.0f, 0.0f, 1.0f) :
+					glm::vec4(0.0f, 1.0f, 0.0f, 1.0f);
+				object.uvScale = glm::vec2(1.0f, 1.0f);
+				object.materialIndex = 0;
+				objects.push_back(object);
+			}
+		}
+	}
+}
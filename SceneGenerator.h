@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenegenerator.h
+// ============
+// seedable procedural scenes of basic shapes for scalability benchmarks
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  SceneGenerator
+ *
+ *  This class fills a data driven scene with randomly placed
+ *  basic shapes, random materials and random point lights.
+ *  The same seed always produces the same scene on every
+ *  platform, so benchmark runs can be compared directly.
+ ***********************************************************/
+class SceneGenerator
+{
+public:
+	struct GENERATOR_SETTINGS
+	{
+		int objectCount;
+		// number of loaded textures that objects can use
+		int textureCount;
+		// number of random materials to create
+		int materialCount;
+		// number of point lights to create
+		int lightCount;
+		// average distance between neighboring objects - the
+		// scene grows with the object count at constant density
+		float spacing;
+	};
+
+	// constructor
+	SceneGenerator(uint32_t seed);
+
+	// generate the materials, lights and objects of a scene
+	void Generate(
+		const GENERATOR_SETTINGS& settings,
+		std::vector<SceneManager::OBJECT_MATERIAL>& materials,
+		std::vector<SceneManager::SCENE_LIGHT>& lights,
+		std::vector<SceneManager::SCENE_OBJECT>& objects);
+	// generate a scene for checking depth precision - pairs of
+	// overlapping panels, one a small part of its distance
+	// behind the other, from one unit to thousands away
+	void GenerateDepthTest(
+		std::vector<SceneManager::OBJECT_MATERIAL>& materials,
+		std::vector<SceneManager::SCENE_LIGHT>& lights,
+		std::vector<SceneManager::SCENE_OBJECT>& objects);
+
+private:
+	// state of the xorshift random number generator
+	uint32_t m_state;
+
+	// next random value in the range [0, 1)
+	float NextFloat();
+	// next random value in the range [low, high)
+	float NextRange(float low, float high);
+	// next random integer in the range [0, count)
+	int NextIndex(int count);
+};
@@ -1,1142 +1,2776 @@
-///////////////////////////////////////////////////////////////////////////////
-// scenemanager.cpp
-// ============
-// manage the preparing and rendering of 3D scenes - textures, materials, lighting
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-//  STUDENT MODIFICATIONS: LaTisha Burns - SNHU Student / Computer Science
-//  Updated for CS-330-Computational Graphics and Visualization, Dec. 12th, 2025
-/********************************************************************************/
-
-#include "SceneManager.h"
-
-#ifndef STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#endif
-
-#include <glm/gtx/transform.hpp>
-
-// declaration of global variables
-namespace
-{
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_TextureOverlayValueName = "overlayTexture"; //added
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
-	const char* g_UseTextureOverlayName = "bUseTextureOverlay"; //added
-}
-
-/***********************************************************
- *  SceneManager()
- *
- *  The constructor for the class
- ***********************************************************/
-SceneManager::SceneManager(ShaderManager *pShaderManager)
-{
-	m_pShaderManager = pShaderManager;
-	m_basicMeshes = new ShapeMeshes();
-
-	//*** Added from OpenGLSample
-		// initialize the texture collection
-	for (int i = 0; i < 16; i++)
-	{
-		m_textureIDs[i].tag = "/0";
-		m_textureIDs[i].ID = -1;
-	}
-	m_loadedTextures = 0;
-}
-
-/***********************************************************
- *  ~SceneManager()
- *
- *  The destructor for the class
- ***********************************************************/
-SceneManager::~SceneManager()
-{
-	m_pShaderManager = NULL;
-	delete m_basicMeshes;
-	m_basicMeshes = NULL;
-}
-
-/***********************************************************
- *  CreateGLTexture()
- *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
- ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
-{
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
-
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
-
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename,
-		&width,
-		&height,
-		&colorChannels,
-		0);
-
-	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
-
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
-
-		return true;
-	}
-
-	std::cout << "Could not load image:" << filename << std::endl;
-
-	// Error loading the image
-	return false;
-}
-
-/***********************************************************
- *  BindGLTextures()
- *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
- ***********************************************************/
-void SceneManager::BindGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  DestroyGLTextures()
- *
- *  This method is used for freeing the memory in all the
- *  used texture memory slots.
- ***********************************************************/
-void SceneManager::DestroyGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glGenTextures(1, &m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  FindTextureID()
- *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
-{
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureID);
-}
-
-/***********************************************************
- *  FindTextureSlot()
- *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
-{
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureSlot = index;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureSlot);
-}
-
-/***********************************************************
- *  FindMaterial()
- *
- *  This method is used for getting a material from the previously
- *  defined materials list that is associated with the passed in tag.
- ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
-{
-	if (m_objectMaterials.size() == 0)
-	{
-		return(false);
-	}
-
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
-	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
-	}
-
-	return(true);
-}
-
-/***********************************************************
- *  SetTransformations()
- *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
- ***********************************************************/
-void SceneManager::SetTransformations(
-	glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
-{
-	// variables for this method
-	glm::mat4 modelView;
-	glm::mat4 scale;
-	glm::mat4 rotationX;
-	glm::mat4 rotationY;
-	glm::mat4 rotationZ;
-	glm::mat4 translation;
-
-	// set the scale value in the transform buffer
-	scale = glm::scale(scaleXYZ);
-	// set the rotation values in the transform buffer
-	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
-	// set the translation value in the transform buffer
-	translation = glm::translate(positionXYZ);
-
-	modelView = translation * rotationZ * rotationY * rotationX * scale;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
-	}
-}
-
-/***********************************************************
- *  SetShaderColor()
- *
- *  This method is used for setting the passed in color
- *  into the shader for the next draw command
- ***********************************************************/
-void SceneManager::SetShaderColor(
-	float redColorValue,
-	float greenColorValue,
-	float blueColorValue,
-	float alphaValue)
-{
-	// variables for this method
-	glm::vec4 currentColor;
-
-	currentColor.r = redColorValue;
-	currentColor.g = greenColorValue;
-	currentColor.b = blueColorValue;
-	currentColor.a = alphaValue;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-	}
-}
-
-/***********************************************************
- *  SetShaderTexture()
- *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
- ***********************************************************/
-void SceneManager::SetShaderTexture(
-	std::string textureTag)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
-
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
-	}
-}
-
-//***Added
-
-/***********************************************************
- *  SetShaderTextureOverlay()
- *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
- ***********************************************************/
-void SceneManager::SetShaderTextureOverlay(
-	std::string textureTag)
-{
-	if (NULL != m_pShaderManager)
-	{
-		if (textureTag.size() > 0)
-		{
-			m_pShaderManager->setIntValue(g_UseTextureOverlayName, true);
-
-			int textureID = -1;
-			textureID = FindTextureSlot(textureTag);
-			m_pShaderManager->setSampler2DValue(g_TextureOverlayValueName, textureID);
-		}
-		else
-		{
-			m_pShaderManager->setIntValue(g_UseTextureOverlayName, false);
-		}
-	}
-}
-
-
-
-/***********************************************************
- *  SetTextureUVScale()
- *
- *  This method is used for setting the texture UV scale
- *  values into the shader.
- ***********************************************************/
-void SceneManager::SetTextureUVScale(float u, float v)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
-	}
-}
-
-
-
-/***********************************************************
- *  SetShaderMaterial()
- *
- *  This method is used for passing the material values
- *  into the shader.
- ***********************************************************/
-void SceneManager::SetShaderMaterial(
-	std::string materialTag)
-{
-	if (m_objectMaterials.size() > 0)
-	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
-	}
-}
-
-/**************************************************************/
-/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
-/*** preparing and rendering their own 3D replicated scenes.***/
-/*** Please refer to the code in the OpenGL sample project  ***/
-/*** for assistance.                                        ***/
-/**************************************************************/
-
-//***Added from OpenGLSample
-/***********************************************************
- *  LoadSceneTextures()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene
- *  rendering
- ***********************************************************/
-
-void SceneManager::LoadSceneTextures()
-{
-	bool bReturn = false;
-
-	// Added Wood texture to make plane look like a table
-	bReturn = CreateGLTexture(
-		"textures/wood_cherry_seamless.jpg",
-		"Wood Table");
-
-	bReturn = CreateGLTexture(
-		"textures/ERainbowOverlay2.png",
-		"Cylinder Overlay");
-
-	bReturn = CreateGLTexture(
-		"textures/VaseStripes2.png",
-		"Stripes2");
-
-	bReturn = CreateGLTexture(
-		"textures/wood_black_seamless.jpg",
-		"Black Wood");
-
-	bReturn = CreateGLTexture(
-		"textures/transparent.png",
-		"transparent");
-
-	bReturn = CreateGLTexture(
-		"textures/GoldLeaves.png",
-		"Gold Leaves");
-
-	bReturn = CreateGLTexture(
-		"textures/GoldLeavesSides.png",
-		"Gold Leaves2");
-
-	bReturn = CreateGLTexture(
-		"textures/CandleHolder.png",
-		"Candle Holder");
-
-	bReturn = CreateGLTexture(
-		"textures/WetGlass.jpg",
-		"Wet Glass");
-
-	bReturn = CreateGLTexture(
-		"textures/pumpkin_texture3.jpg",
-		"Pumpkin3");
-
-	bReturn = CreateGLTexture(
-		"textures/Pumpkinbark.jpg",
-		"Stem");
-
-	bReturn = CreateGLTexture(
-		"textures/bricks_weathered_seamless2.jpg",
-		"backdrop2");
-
-
-}
-
-//***Added
-/***********************************************************
- *  DefineObjectMaterials()
- *
- *  This method is used for configuring the various material
- *  settings for all of the objects within the 3D scene.
- ***********************************************************/
-void SceneManager::DefineObjectMaterials()
-{
-	// Metal
-	OBJECT_MATERIAL metalMaterial;
-	metalMaterial.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	metalMaterial.specularColor = glm::vec3(0.7f, 0.7f, 0.7f);
-	metalMaterial.shininess = 42.0;
-	metalMaterial.tag = "metal";
-
-	m_objectMaterials.push_back(metalMaterial);
-
-	// Wood
-	OBJECT_MATERIAL woodMaterial;
-	woodMaterial.diffuseColor = glm::vec3(0.6f, 0.35f, 0.2f);
-	woodMaterial.specularColor = glm::vec3(0.2f, 0.2f, 0.2f);
-	woodMaterial.shininess = 8.0f;
-	woodMaterial.tag = "wood";
-
-	m_objectMaterials.push_back(woodMaterial);
-
-	//Glass
-	OBJECT_MATERIAL glassMaterial;
-	glassMaterial.diffuseColor = glm::vec3(0.4f, 0.4f, 0.5f);
-	glassMaterial.specularColor = glm::vec3(1.0f, 1.0f, 1.0f);
-	glassMaterial.shininess = 95.0;
-	glassMaterial.tag = "glass";
-
-	m_objectMaterials.push_back(glassMaterial);
-
-	//Gold
-	OBJECT_MATERIAL goldMaterial;
-	goldMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.2f);
-	goldMaterial.specularColor = glm::vec3(0.6f, 0.5f, 0.4f);
-	goldMaterial.shininess = 22.0;
-	goldMaterial.tag = "gold";
-
-	m_objectMaterials.push_back(goldMaterial);
-
-	//Tile
-	OBJECT_MATERIAL tileMaterial;
-	tileMaterial.diffuseColor = glm::vec3(0.3f, 0.2f, 0.1f);
-	tileMaterial.specularColor = glm::vec3(0.4f, 0.5f, 0.6f);
-	tileMaterial.shininess = 25.0;
-	tileMaterial.tag = "tile";
-
-	m_objectMaterials.push_back(tileMaterial);
-
-	OBJECT_MATERIAL backdropMaterial;
-	backdropMaterial.diffuseColor = glm::vec3(0.4f, 0.4f, 0.4f);
-	backdropMaterial.specularColor = glm::vec3(0.0f, 0.0f, 0.0f);
-	backdropMaterial.shininess = .02;
-	backdropMaterial.tag = "backdrop";
-
-	m_objectMaterials.push_back(backdropMaterial);
-
-
-}
-
-/***********************************************************
- *  SetupSceneLights()
- *
- *  This method is called to add and configure the light
- *  sources for the 3D scene.  There are up to 4 light sources.
- ***********************************************************/
-void SceneManager::SetupSceneLights()
-{
-	// this line of code is NEEDED for telling the shaders to render 
-	// the 3D scene with custom lighting - to use the default rendered 
-	// lighting then comment out the following line
-	m_pShaderManager->setBoolValue(g_UseLightingName, true);
-
-	// directional light to emulate sunlight coming into scene
-	m_pShaderManager->setVec3Value("directionalLight.direction", -0.1f, -0.3f, -0.2f);
-	m_pShaderManager->setVec3Value("directionalLight.ambient", 0.5f, 0.5f, 0.5f);
-	m_pShaderManager->setVec3Value("directionalLight.diffuse", 0.25f, 0.25f, 0.30f);
-	m_pShaderManager->setVec3Value("directionalLight.specular", 0.05f, 0.05f, 0.05f);
-	m_pShaderManager->setBoolValue("directionalLight.bActive", true);
-
-
-	///****************************************************************/
-	//light 0 - above the scene
-	m_pShaderManager->setVec3Value("pointLights[0].position", 0.0f, 5.0f, 0.0f);
-	m_pShaderManager->setVec3Value("pointLights[0].ambient", 0.15f, 0.15f, 0.15f);
-	m_pShaderManager->setVec3Value("pointLights[0].diffuse", 0.5f, 0.5f, 0.5f);
-	m_pShaderManager->setVec3Value("pointLights[0].specular", 0.5f, 0.5f, 0.5f);
-	m_pShaderManager->setBoolValue("pointLights[0].bActive", true);
-	
-	//point light 1
-	m_pShaderManager->setVec3Value("pointLights[1].position", -3.0f, 7.0f, -3.0f);
-	m_pShaderManager->setVec3Value("pointLights[1].ambient", 0.05f, 0.05f, 0.05f);
-	m_pShaderManager->setVec3Value("pointLights[1].diffuse", 0.4f, 0.3f, 0.4f);
-	m_pShaderManager->setVec3Value("pointLights[1].specular", 0.2f, 0.2f, 0.2f);
-	m_pShaderManager->setBoolValue("pointLights[1].bActive", true); 
-
-	//point light 2
-	m_pShaderManager->setVec3Value("pointLights[2].position", -3.0f, 7.0f, 3.0f);
-	m_pShaderManager->setVec3Value("pointLights[2].ambient", 0.05f, 0.05f, 0.05f);
-	m_pShaderManager->setVec3Value("pointLights[2].diffuse", 0.4f, 0.3f, 0.4f);
-	m_pShaderManager->setVec3Value("pointLights[2].specular", 0.2f, 0.3f, 0.2f);
-	m_pShaderManager->setBoolValue("pointLights[2].bActive", true); 
-	
-	//point light 3
-	m_pShaderManager->setVec3Value("pointLights[3].position", 0.0f, 2.0f, -7.0f);
-	m_pShaderManager->setVec3Value("pointLights[3].ambient", 0.05f, 0.05f, 0.05f);
-	m_pShaderManager->setVec3Value("pointLights[3].diffuse", 0.5f, 0.5f, .5f);
-	m_pShaderManager->setVec3Value("pointLights[3].specular", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setBoolValue("pointLights[3].bActive", true);
-
-	//point light 4
-	m_pShaderManager->setVec3Value("pointLights[4].position", 3.2f, 6.0f, 4.0f);
-	m_pShaderManager->setVec3Value("pointLights[4].ambient", 0.05f, 0.05f, 0.05f);
-	m_pShaderManager->setVec3Value("pointLights[4].diffuse", 0.5f, 0.5f, 0.5f);
-	m_pShaderManager->setVec3Value("pointLights[4].specular", 0.1f, 0.1f, 0.1f);
-	m_pShaderManager->setBoolValue("pointLights[4].bActive", true);
-	
-	
-	m_pShaderManager->setVec3Value("spotLight.ambient", 0.3f, 0.3f, 0.3f);
-	m_pShaderManager->setVec3Value("spotLight.diffuse", 0.8f, 0.8f, 0.8f);
-	m_pShaderManager->setVec3Value("spotLight.specular", 0.4f, 0.4f, 0.4f);
-	m_pShaderManager->setFloatValue("spotLight.constant", 1.0f);
-	m_pShaderManager->setFloatValue("spotLight.linear", 0.09f);
-	m_pShaderManager->setFloatValue("spotLight.quadratic", 0.032f);
-	m_pShaderManager->setFloatValue("spotLight.cutOff", glm::cos(glm::radians(42.5f)));
-	m_pShaderManager->setFloatValue("spotLight.outerCutOff", glm::cos(glm::radians(48.0f)));
-	m_pShaderManager->setBoolValue("spotLight.bActive", true);
-
-}
-/***********************************************************
- *  PrepareScene()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void SceneManager::PrepareScene()
-{
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-
-	m_basicMeshes->LoadPlaneMesh();
-	//Shapes Added
-	m_basicMeshes->LoadBoxMesh(); 
-	m_basicMeshes->LoadSphereMesh();
-	m_basicMeshes->LoadCylinderMesh();
-	m_basicMeshes->LoadTorusMesh();
-	m_basicMeshes->LoadTaperedCylinderMesh();
-
-	// load the texture image files for the textures applied
-	// to objects in the 3D scene
-	LoadSceneTextures();
-	BindGLTextures();
-
-	// define the materials that will be used for the objects
-	// in the 3D scene
-	DefineObjectMaterials();
-
-	// add and defile the light sources for the 3D scene
-	SetupSceneLights();
-}
-
-/***********************************************************
- *  RenderScene()
- *
- *  This method is used for rendering the 3D scene by 
- *  transforming and drawing the basic 3D shapes
- ***********************************************************/
-void SceneManager::RenderScene()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(30.0f, 1.0f, 10.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, -0.5f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// Bottom plane for the scene  represents the coffee table surface
-	//*** Added texture to plane
-	SetShaderTexture("Wood Table");
-	SetTextureUVScale(1.0, 1.0);
-
-	//material
-	SetShaderMaterial("wood");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawBoxMesh();
-
-	/****************************************************************/
-
-	//***Backdrop - added 12/12
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(20.0f, 1.0f, 10.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 10.0f, -5.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//texture
-	SetShaderTexture("backdrop2");
-	SetTextureUVScale(1.0, 1.0);
-
-	//material
-	SetShaderMaterial("backdrop");
-
-	// draw the mesh with transformation values - this plane is used for the backdrop
-	m_basicMeshes->DrawPlaneMesh();
-
-
-	/****************************************************************/
-	//***Objects Start Here
-	
-	// ***Glass Candle Holder
-	//Base of Candle
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.3f, 1.35f, 0.7f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(6.0f, 0.2f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//texture
-	SetShaderTexture("Wet Glass");
-	SetTextureUVScale(0.2f, 0.2f);
-	//material
-	SetShaderMaterial("glass");
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawTorusMesh();
-
-
-	// Body of Candle
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.4f, 1.6f, 1.4f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = -10.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(6.0f, 0.3f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//***Complex Texturing Technique - Overlay option
-	//base texture for the cylinder 
-	SetShaderTexture("Candle Holder");
-
-	//overlay texture for cylinder
-	SetShaderTextureOverlay("Cylinder Overlay");
-
-	//uv scale for both textures 
-	SetTextureUVScale(2.0f, 1.0f);
-
-	//material
-	SetShaderMaterial("glass");
-
-	//apply the texture and overlay to the sides only
-	m_basicMeshes->DrawCylinderMesh(false, false, true);
-
-	//disable the texture overlay
-	SetShaderTextureOverlay("");
-
-
-	// Rounded Top/Dome of candle holder
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.37f, 1.37f, 1.37f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 15.0f;
-	YrotationDegrees = 20.0f;
-	ZrotationDegrees = 90.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(6.0f, 2.0f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//SetShaderColor(0.467, 0.533, 0.600, 1);
-	SetShaderTexture("Candle Holder");
-	SetTextureUVScale(0.8f, 0.8);
-	//material
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawSphereMesh();
-
-
-	// Candle Holder knob
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(0.3f, 0.5f, 0.3f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(6.0f, 3.5f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//texture
-	SetShaderTexture("Candle Holder");
-	SetTextureUVScale(0.8f, 0.8f);
-
-	//material
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawSphereMesh();
-
-
-
-	/****************************************************************/
-	//*** Vase
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.2f, 7.0f, 1.2f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(2.0f, 0.2f, -0.8f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//sides, stripes
-	SetShaderTexture("Stripes2");
-	SetTextureUVScale(1.0f, 1.0f);
-
-	//material
-	SetShaderMaterial("glass");
-	m_basicMeshes->DrawCylinderMesh(false, false, true); //sides only
-
-	//top, transparent
-	SetShaderTexture("transparent"); //created transparent texture for glass
-	SetTextureUVScale(1.0f, 1.0f);
-	m_basicMeshes->DrawCylinderMesh(true, false, false); //top only
-
-	//bottom, dark base
-	SetShaderTexture("Black Wood");
-	SetTextureUVScale(1.0f, 1.0f);
-
-	//material
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawCylinderMesh(false, true, false); //bottom only
-
-
-	/****************************************************************/
-	//*** Picture Frame
-	
-	//picture inside Frame
-	// ***Complex Texturing Technique - Applying different colors to each side of the box
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(4.0f, 5.0f, 0.1f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = -20.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.0f, 2.5f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//front of picture = light tan to represent blank picture
-	SetShaderColor(0.95f, 0.90f, 0.80f, 1.0f);
-	m_basicMeshes->DrawBoxMeshSide(ShapeMeshes::box_front);
-
-	//other sides of picture = gold like the frame so they are not visble from side/top views
-	SetShaderColor(0.65f, 0.45f, 0.20f, 1.0f);
-	m_basicMeshes->DrawBoxMeshSide(ShapeMeshes::box_back);
-	m_basicMeshes->DrawBoxMeshSide(ShapeMeshes::box_left);
-	m_basicMeshes->DrawBoxMeshSide(ShapeMeshes::box_right);
-	m_basicMeshes->DrawBoxMeshSide(ShapeMeshes::box_top);
-	m_basicMeshes->DrawBoxMeshSide(ShapeMeshes::box_bottom);
-
-	//material
-	SetShaderMaterial("wood");
-
-
-	//Back of Picture frame
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(4.0f, 5.0f, 0.1f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = -20.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-2.0f, 2.5f, -0.1f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-
-	//gold color for back of frame
-	SetShaderColor(0.65f, 0.45f, 0.20f, 1.0f);
-	SetShaderMaterial("wood");
-	m_basicMeshes->DrawBoxMesh();
-
-	//top frame piece
-	scaleXYZ = glm::vec3(4.1f, 0.7f, 0.15f);
-	XrotationDegrees = -20.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	positionXYZ = glm::vec3(-2.0f, 4.6f, -0.7f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//texture
-	SetShaderTexture("Gold Leaves");
-	SetTextureUVScale(0.9f, 0.3f);
-	SetShaderMaterial("gold");
-	m_basicMeshes->DrawBoxMesh();
-
-	//bottom frame piece
-	scaleXYZ = glm::vec3(4.1f, 0.7f, 0.15f);
-	XrotationDegrees = 20.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 180.0f;
-	positionXYZ = glm::vec3(-2.0f, 0.5f, 0.8f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//texture
-	SetShaderTexture("Gold Leaves");
-	SetTextureUVScale(0.9f, 0.3f);
-	SetShaderMaterial("gold");
-	m_basicMeshes->DrawBoxMesh();
-
-	//left frame piece
-	scaleXYZ = glm::vec3(0.7f, 3.8f, 0.10f);   
-	XrotationDegrees = 20.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 180.0f;
-	positionXYZ = glm::vec3(-3.7f, 2.6f, 0.05f);   
-	
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//texture
-	SetShaderTexture("Gold Leaves2");
-	SetTextureUVScale(0.3f, 0.9f);
-	SetShaderMaterial("gold");
-	m_basicMeshes->DrawBoxMesh();
-
-
-	//right frame piece
-	scaleXYZ = glm::vec3(0.7f, 3.8f, 0.10f);
-	XrotationDegrees = -20.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-	positionXYZ = glm::vec3(-0.3f, 2.6f, 0.05f);  
-	
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//texture
-	SetShaderTexture("Gold Leaves2");
-	SetTextureUVScale(0.3f, 0.9f);
-	SetShaderMaterial("gold");
-	m_basicMeshes->DrawBoxMesh();
-
-	//back stand piece
-	scaleXYZ = glm::vec3(0.7f, 3.0f, 0.1f);
-	XrotationDegrees = 30.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 00.0f;
-	positionXYZ = glm::vec3(-1.5f, 1.5f, -1.0f);
-	
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//texture
-	SetShaderColor(0.65f, 0.45f, 0.20f, 1.0f);
-
-	//material
-	SetShaderMaterial("wood");
-
-	m_basicMeshes->DrawBoxMesh();
-
-	/****************************************************************/
-	//***Pumpkin
-	//Base of Pumpkin
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(2.1f, 1.8f, 1.5f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = -35.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(-7.0f, 1.4f, -0.3f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//texture
-	SetShaderTexture("Pumpkin3");  //closest I could get to getting a pumpkin texture to wrap :(
-	SetTextureUVScale(1.0f, 1.0f);
-	
-	//material
-	SetShaderMaterial("glass");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawSphereMesh();
-
-
-	//Pumpkin stem  
-	scaleXYZ = glm::vec3(0.5f, 0.7f, 0.5f);
-	XrotationDegrees = 0.0f;    
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = -10.0f;
-
-	//sit on top of the pumpkin body
-	positionXYZ = glm::vec3(-7.1f, 3.1f, -0.3f);
-
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	//texture
-	SetShaderTexture("Stem");
-	SetTextureUVScale(1.0f, 1.0f);
-
-	//material
-	SetShaderMaterial("wood");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawTaperedCylinderMesh();
-
-}
+///////////////////////////////////////////////////////////////////////////////
+// scenemanager.cpp
+// ============
+// manage the preparing and rendering of 3D scenes - textures, materials, lighting
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+//  STUDENT MODIFICATIONS: LaTisha Burns - SNHU Student / Computer Science
+//  Updated for CS-330-Computational Graphics and Visualization, Dec. 12th, 2025
+/********************************************************************************/
+
+#include "SceneManager.h"
+#include "SceneGenerator.h"
+#include "SceneFile.h"
+#include "ShaderVariants.h"
+#include "TextureStreamer.h"
+#include "TextureAtlas.h"
+#include "SamplerCache.h"
+#include "MeshLibrary.h"
+#include "FileWatcher.h"
+#include "GPUProfiler.h"
+#include "CPUProfiler.h"
+
+#ifndef STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+// declaration of global variables
+namespace
+{
+	const char* g_ModelName = "model";
+	const char* g_ColorValueName = "objectColor";
+	const char* g_TextureValueName = "objectTexture";
+	const char* g_TextureOverlayValueName = "overlayTexture"; //added
+	const char* g_UseTextureName = "bUseTexture";
+	const char* g_UseLightingName = "bUseLighting";
+	const char* g_UseTextureOverlayName = "bUseTextureOverlay"; //added
+	const char* g_UVOffsetName = "UVoffset";
+	const char* g_ViewName = "view";
+	const char* g_ProjectionName = "projection";
+	const char* g_ViewPositionName = "viewPosition";
+
+	// GPU profiler scope of each scene view
+	const char* VIEW_SCOPE_NAMES[SceneManager::MAX_SCENE_VIEWS] =
+	{
+		"View 0", "View 1", "View 2", "View 3", "View 4", "View 5", "View 6", "View 7"
+	};
+
+	/***********************************************************
+	 *  ExtractFrustumPlanes()
+	 *
+	 *  Writes the six frustum planes of a combined view and
+	 *  projection matrix, normalized so the plane distances are
+	 *  in world units.  With reverse depth the clip range is
+	 *  zero to one and the near plane maps to one, and a far
+	 *  plane at infinity becomes a plane that culls nothing.
+	 ***********************************************************/
+	void ExtractFrustumPlanes(const glm::mat4& viewProjection, bool bReverseDepth, glm::vec4* pPlanes)
+	{
+		// rows of the matrix - glm stores the matrix by columns
+		glm::vec4 rows[4];
+		for (int i = 0; i < 4; i++)
+		{
+			rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+		}
+
+		pPlanes[0] = rows[3] + rows[0];	// left
+		pPlanes[1] = rows[3] - rows[0];	// right
+		pPlanes[2] = rows[3] + rows[1];	// bottom
+		pPlanes[3] = rows[3] - rows[1];	// top
+		if (bReverseDepth == true)
+		{
+			pPlanes[4] = rows[3] - rows[2];	// near
+			pPlanes[5] = rows[2];	// far
+		}
+		else
+		{
+			pPlanes[4] = rows[3] + rows[2];	// near
+			pPlanes[5] = rows[3] - rows[2];	// far
+		}
+
+		for (int i = 0; i < 6; i++)
+		{
+			float length = glm::length(glm::vec3(pPlanes[i].x, pPlanes[i].y, pPlanes[i].z));
+			if (length < 1.0e-6f)
+			{
+				// an infinite far plane
+				pPlanes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+				continue;
+			}
+			pPlanes[i] = pPlanes[i] / length;
+		}
+	}
+
+	/***********************************************************
+	 *  IsSphereInsidePlanes()
+	 *
+	 *  True when a bounding sphere is at least partially inside
+	 *  six frustum planes.
+	 ***********************************************************/
+	bool IsSphereInsidePlanes(const glm::vec4* pPlanes, const glm::vec3& center, float radius)
+	{
+		for (int i = 0; i < 6; i++)
+		{
+			const glm::vec4& plane = pPlanes[i];
+			if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+			{
+				return(false);
+			}
+		}
+		return(true);
+	}
+}
+
+/***********************************************************
+ *  SceneManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneManager::SceneManager(ShaderManager *pShaderManager)
+{
+	m_pShaderManager = pShaderManager;
+	m_basicMeshes = new ShapeMeshes();
+
+	//*** Added from OpenGLSample
+		// initialize the texture collection
+	for (int i = 0; i < 16; i++)
+	{
+		m_textureIDs[i].tag = "/0";
+		m_textureIDs[i].ID = -1;
+	}
+	m_loadedTextures = 0;
+	m_bFrustumValid = false;
+	m_bReverseDepth = false;
+	m_pJobSystem = NULL;
+	m_changeCount = 0;
+	m_pSceneObjects = NULL;
+	m_sceneObjectCount = 0;
+	m_pSceneFile = NULL;
+	m_pShaderVariants = NULL;
+	m_variantFlags = 0;
+	m_pointLightCount = 0;
+	m_baseProgram = 0;
+	m_activeProgram = 0;
+	m_pTextureStreamer = NULL;
+	m_drawRadius = 0.0f;
+	m_drawTextureSlot = -1;
+	m_drawOverlaySlot = -1;
+	m_pTextureAtlas = NULL;
+	m_bAtlasActive = false;
+	m_boundTextureUnit = -1;
+	m_textureUVScale = glm::vec2(1.0f, 1.0f);
+	m_bTextureFromAtlas = false;
+	m_pSamplerCache = NULL;
+	m_materialFilter = filter_default;
+	m_materialWrap = wrap_repeat;
+	m_pMeshLibrary = NULL;
+	m_pPrimitiveLibrary = NULL;
+
+	ResetRenderStats();
+}
+
+/***********************************************************
+ *  ~SceneManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneManager::~SceneManager()
+{
+	m_pShaderManager = NULL;
+	delete m_basicMeshes;
+	m_basicMeshes = NULL;
+	ReleaseSceneFile();
+	PrimitiveLibrary::Release(m_pPrimitiveLibrary);
+	m_pPrimitiveLibrary = NULL;
+}
+
+/***********************************************************
+ *  CreateGLTexture()
+ *
+ *  This method is used for loading textures from image files,
+ *  configuring the texture mapping parameters in OpenGL,
+ *  generating the mipmaps, and loading the read texture into
+ *  the next available texture slot in memory.
+ ***********************************************************/
+bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
+{
+	CPU_PROFILE_ZONE("SceneManager::CreateGLTexture");
+
+	// indicate to always flip images vertically when loaded
+	stbi_set_flip_vertically_on_load(true);
+
+	TEXTURE_IMAGE image;
+	DecodeTextureImage(filename, image);
+
+	return(UploadGLTexture(image, tag));
+}
+
+/***********************************************************
+ *  DecodeTextureImage()
+ *
+ *  This method is used for reading an image file into memory.
+ *  It does not touch OpenGL, so it can run on any thread.
+ ***********************************************************/
+bool SceneManager::DecodeTextureImage(const char* filename, TEXTURE_IMAGE& image)
+{
+	CPU_PROFILE_ZONE("SceneManager::DecodeTextureImage");
+
+	image.filename = filename;
+	image.width = 0;
+	image.height = 0;
+	image.colorChannels = 0;
+
+	// try to parse the image data from the specified image file
+	image.pixels = stbi_load(
+		filename,
+		&image.width,
+		&image.height,
+		&image.colorChannels,
+		0);
+
+	return(NULL != image.pixels);
+}
+
+/***********************************************************
+ *  FreeTextureImage()
+ *
+ *  This method is used for freeing the pixels of a decoded
+ *  image that will not be uploaded.
+ ***********************************************************/
+void SceneManager::FreeTextureImage(TEXTURE_IMAGE& image)
+{
+	if (NULL != image.pixels)
+	{
+		stbi_image_free(image.pixels);
+		image.pixels = NULL;
+	}
+}
+
+/***********************************************************
+ *  CreateTextureObject()
+ *
+ *  This method is used for creating an OpenGL texture, with
+ *  mipmaps, from a decoded image.  The image data is kept.
+ *  It must run on the OpenGL thread.
+ ***********************************************************/
+GLuint SceneManager::CreateTextureObject(const TEXTURE_IMAGE& image)
+{
+	CPU_PROFILE_ZONE("SceneManager::CreateTextureObject");
+
+	GLuint textureID = 0;
+
+	// if the image was successfully read from the image file
+	if (image.pixels)
+	{
+		std::cout << "Successfully loaded image:" << image.filename << ", width:" << image.width << ", height:" << image.height << ", channels:" << image.colorChannels << std::endl;
+
+		glGenTextures(1, &textureID);
+		glBindTexture(GL_TEXTURE_2D, textureID);
+
+		// set the texture wrapping parameters
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		// set texture filtering parameters - blend the mipmaps
+		// when minified, unless a sampler object says otherwise
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		// if the loaded image is in RGB format
+		if (image.colorChannels == 3)
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, image.width, image.height, 0, GL_RGB, GL_UNSIGNED_BYTE, image.pixels);
+		// if the loaded image is in RGBA format - it supports transparency
+		else if (image.colorChannels == 4)
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels);
+		else
+		{
+			std::cout << "Not implemented to handle image with " << image.colorChannels << " channels" << std::endl;
+			glBindTexture(GL_TEXTURE_2D, 0);
+			glDeleteTextures(1, &textureID);
+			return 0;
+		}
+
+		// generate the texture mipmaps for mapping textures to lower resolutions
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
+
+		return textureID;
+	}
+
+	std::cout << "Could not load image:" << image.filename << std::endl;
+
+	// Error loading the image
+	return 0;
+}
+
+/***********************************************************
+ *  UploadGLTexture()
+ *
+ *  This method is used for creating an OpenGL texture from a
+ *  decoded image and registering it in the next free slot.
+ *  The image data is freed, and false is returned when every
+ *  slot is taken.  It must run on the OpenGL
+ *  thread.
+ ***********************************************************/
+bool SceneManager::UploadGLTexture(TEXTURE_IMAGE& image, std::string tag)
+{
+	// every texture slot is already taken
+	if (m_loadedTextures >= 16)
+	{
+		std::cout << "Could not load texture, no more than 16 textures can be loaded:" << image.filename << std::endl;
+		FreeTextureImage(image);
+		return false;
+	}
+
+	GLuint textureID = 0;
+	if (NULL != m_pTextureStreamer)
+	{
+		textureID = m_pTextureStreamer->AddTexture(m_loadedTextures, image);
+	}
+	else
+	{
+		textureID = CreateTextureObject(image);
+	}
+
+	// free the image data from local memory
+	FreeTextureImage(image);
+	if (textureID == 0)
+	{
+		return false;
+	}
+
+	// register the loaded texture and associate it with the special tag string
+	m_textureIDs[m_loadedTextures].ID = textureID;
+	m_textureIDs[m_loadedTextures].tag = tag;
+	m_textureIDs[m_loadedTextures].filename = image.filename;
+	m_loadedTextures++;
+
+	return true;
+}
+
+/***********************************************************
+ *  UsesTextureFile()
+ *
+ *  This method is used for checking whether an image file
+ *  is loaded into any texture slot.
+ ***********************************************************/
+bool SceneManager::UsesTextureFile(const std::string& filename) const
+{
+	std::string path = FileWatcher::NormalizePath(filename);
+	for (int i = 0; i < m_loadedTextures; i++)
+	{
+		if (FileWatcher::NormalizePath(m_textureIDs[i].filename) == path)
+		{
+			return(true);
+		}
+	}
+	return(false);
+}
+
+/***********************************************************
+ *  ReplaceTexture()
+ *
+ *  This method is used for swapping a newly decoded version
+ *  of a loaded image file into every slot that uses it.  The
+ *  old texture is only deleted once the new one exists, so
+ *  a file that fails to load leaves the old one in place.
+ *  The image data is freed.
+ ***********************************************************/
+bool SceneManager::ReplaceTexture(TEXTURE_IMAGE& image)
+{
+	CPU_PROFILE_ZONE("SceneManager::ReplaceTexture");
+
+	std::string path = FileWatcher::NormalizePath(image.filename);
+	bool bReplaced = false;
+	for (int i = 0; i < m_loadedTextures; i++)
+	{
+		if (FileWatcher::NormalizePath(m_textureIDs[i].filename) != path)
+		{
+			continue;
+		}
+
+		// the atlas keeps its own copy of a small texture
+		if (NULL != m_pTextureAtlas)
+		{
+			m_pTextureAtlas->ReplaceImage(i, image);
+		}
+
+		// the streamer replaces the texture of the slot itself
+		if (NULL != m_pTextureStreamer)
+		{
+			GLuint textureID = m_pTextureStreamer->ReplaceTexture(i, image);
+			if (textureID == 0)
+			{
+				break;
+			}
+			m_textureIDs[i].ID = textureID;
+			bReplaced = true;
+			continue;
+		}
+
+		GLuint textureID = CreateTextureObject(image);
+		if (textureID == 0)
+		{
+			break;
+		}
+		glDeleteTextures(1, &m_textureIDs[i].ID);
+		m_textureIDs[i].ID = textureID;
+		glActiveTexture(GL_TEXTURE0 + i);
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		bReplaced = true;
+	}
+
+	FreeTextureImage(image);
+	if (bReplaced == true)
+	{
+		MarkSceneChanged();
+	}
+
+	return(bReplaced);
+}
+
+/***********************************************************
+ *  BindGLTextures()
+ *
+ *  This method is used for binding the loaded textures to
+ *  OpenGL texture memory slots.  There are up to 16 slots.
+ ***********************************************************/
+void SceneManager::BindGLTextures()
+{
+	CPU_PROFILE_ZONE("SceneManager::BindGLTextures");
+
+	for (int i = 0; i < m_loadedTextures; i++)
+	{
+		// bind textures on corresponding texture units
+		glActiveTexture(GL_TEXTURE0 + i);
+		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
+	}
+
+	if (NULL != m_pTextureAtlas)
+	{
+		m_pTextureAtlas->Bind();
+	}
+}
+
+/***********************************************************
+ *  DestroyGLTextures()
+ *
+ *  This method is used for freeing the memory in all the
+ *  used texture memory slots.
+ ***********************************************************/
+void SceneManager::DestroyGLTextures()
+{
+	if (NULL != m_pTextureStreamer)
+	{
+		m_pTextureStreamer->RemoveAll();
+	}
+	if (NULL != m_pTextureAtlas)
+	{
+		m_pTextureAtlas->Clear();
+	}
+	for (int i = 0; i < m_loadedTextures; i++)
+	{
+		if (NULL == m_pTextureStreamer)
+		{
+			glDeleteTextures(1, &m_textureIDs[i].ID);
+		}
+		m_textureIDs[i].tag = "/0";
+		m_textureIDs[i].ID = -1;
+		m_textureIDs[i].filename.clear();
+	}
+	m_loadedTextures = 0;
+}
+
+/***********************************************************
+ *  LoadTextureFiles()
+ *
+ *  This method is used for loading a list of image files
+ *  into the next free texture slots.  With a job system the
+ *  images are decoded on every worker, then uploaded on the
+ *  OpenGL thread in the listed order so the slots never
+ *  change.  With an atlas the small images are packed into
+ *  its pages between decoding and uploading.
+ ***********************************************************/
+void SceneManager::LoadTextureFiles(const std::vector<TEXTURE_FILE>& textureFiles)
+{
+	CPU_PROFILE_ZONE("SceneManager::LoadTextureFiles");
+
+	const int textureCount = (int)textureFiles.size();
+
+	// indicate to always flip images vertically when loaded - the
+	// flag is shared by every thread, so set it before decoding
+	stbi_set_flip_vertically_on_load(true);
+
+	std::vector<TEXTURE_IMAGE> images(textureCount);
+	// slot each image was uploaded to, or -1
+	std::vector<int> slots(textureCount, -1);
+
+	if (NULL == m_pJobSystem)
+	{
+		for (int i = 0; i < textureCount; i++)
+		{
+			DecodeTextureImage(textureFiles[i].filename.c_str(), images[i]);
+		}
+		if (NULL != m_pTextureAtlas)
+		{
+			m_pTextureAtlas->Build(images);
+		}
+		for (int i = 0; i < textureCount; i++)
+		{
+			int slot = m_loadedTextures;
+			if (UploadGLTexture(images[i], textureFiles[i].tag) == true)
+			{
+				slots[i] = slot;
+			}
+		}
+		if (NULL != m_pTextureAtlas)
+		{
+			m_pTextureAtlas->Upload(slots);
+		}
+		return;
+	}
+
+	JobCounter decoded;
+	JobCounter packed;
+	JobCounter uploaded;
+	for (int i = 0; i < textureCount; i++)
+	{
+		m_pJobSystem->Run([&images, &textureFiles, i](int) {
+			DecodeTextureImage(textureFiles[i].filename.c_str(), images[i]);
+		}, &decoded);
+	}
+	m_pJobSystem->RunAfter(&decoded, [this, &images](int) {
+		if (NULL != m_pTextureAtlas)
+		{
+			m_pTextureAtlas->Build(images);
+		}
+	}, &packed);
+	m_pJobSystem->RunAfter(&packed, [this, &images, &slots, &textureFiles, textureCount](int) {
+		for (int i = 0; i < textureCount; i++)
+		{
+			int slot = m_loadedTextures;
+			if (UploadGLTexture(images[i], textureFiles[i].tag) == true)
+			{
+				slots[i] = slot;
+			}
+		}
+		if (NULL != m_pTextureAtlas)
+		{
+			m_pTextureAtlas->Upload(slots);
+		}
+	}, &uploaded, JobSystem::affinity_main_thread);
+
+	m_pJobSystem->Wait(&uploaded);
+}
+
+/***********************************************************
+ *  FindTextureID()
+ *
+ *  This method is used for getting an ID for the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureID(std::string tag)
+{
+	int textureID = -1;
+	int index = 0;
+	bool bFound = false;
+
+	while ((index < m_loadedTextures) && (bFound == false))
+	{
+		if (m_textureIDs[index].tag.compare(tag) == 0)
+		{
+			textureID = m_textureIDs[index].ID;
+			bFound = true;
+		}
+		else
+			index++;
+	}
+
+	return(textureID);
+}
+
+/***********************************************************
+ *  FindTextureSlot()
+ *
+ *  This method is used for getting a slot index for the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureSlot(std::string tag)
+{
+	CPU_PROFILE_ZONE("SceneManager::FindTextureSlot");
+
+	int textureSlot = -1;
+	int index = 0;
+	bool bFound = false;
+
+	while ((index < m_loadedTextures) && (bFound == false))
+	{
+		if (m_textureIDs[index].tag.compare(tag) == 0)
+		{
+			textureSlot = index;
+			bFound = true;
+		}
+		else
+			index++;
+	}
+
+	return(textureSlot);
+}
+
+/***********************************************************
+ *  FindMaterial()
+ *
+ *  This method is used for getting a material from the previously
+ *  defined materials list that is associated with the passed in tag.
+ ***********************************************************/
+bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
+{
+	CPU_PROFILE_ZONE("SceneManager::FindMaterial");
+
+	if (m_objectMaterials.size() == 0)
+	{
+		return(false);
+	}
+
+	int index = 0;
+	bool bFound = false;
+	while ((index < m_objectMaterials.size()) && (bFound == false))
+	{
+		if (m_objectMaterials[index].tag.compare(tag) == 0)
+		{
+			bFound = true;
+			material.diffuseColor = m_objectMaterials[index].diffuseColor;
+			material.specularColor = m_objectMaterials[index].specularColor;
+			material.shininess = m_objectMaterials[index].shininess;
+			material.samplerFilter = m_objectMaterials[index].samplerFilter;
+			material.samplerWrap = m_objectMaterials[index].samplerWrap;
+		}
+		else
+		{
+			index++;
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  ComputeModelMatrix()
+ *
+ *  This method is used for composing the model matrix from
+ *  the passed in transformation values.
+ ***********************************************************/
+glm::mat4 SceneManager::ComputeModelMatrix(
+	const glm::vec3& scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	const glm::vec3& positionXYZ)
+{
+	// variables for this method
+	glm::mat4 scale;
+	glm::mat4 rotationX;
+	glm::mat4 rotationY;
+	glm::mat4 rotationZ;
+	glm::mat4 translation;
+
+	// set the scale value in the transform buffer
+	scale = glm::scale(scaleXYZ);
+	// set the rotation values in the transform buffer
+	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
+	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
+	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
+	// set the translation value in the transform buffer
+	translation = glm::translate(positionXYZ);
+
+	return(translation * rotationZ * rotationY * rotationX * scale);
+}
+
+/***********************************************************
+ *  SetTransformations()
+ *
+ *  This method is used for setting the transform buffer
+ *  using the passed in transformation values.
+ ***********************************************************/
+void SceneManager::SetTransformations(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	CPU_PROFILE_ZONE("SceneManager::SetTransformations");
+
+	glm::mat4 modelView = ComputeModelMatrix(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	if (NULL != m_pShaderManager)
+	{
+		m_pShaderManager->setMat4Value(g_ModelName, modelView);
+	}
+	m_renderStats.transformChanges++;
+
+	// the same bounds as the objects of scene files
+	m_drawCenter = positionXYZ;
+	m_drawRadius = 1.415f * std::max(scaleXYZ.x, std::max(scaleXYZ.y, scaleXYZ.z));
+}
+
+/***********************************************************
+ *  SetShaderColor()
+ *
+ *  This method is used for setting the passed in color
+ *  into the shader for the next draw command
+ ***********************************************************/
+void SceneManager::SetShaderColor(
+	float redColorValue,
+	float greenColorValue,
+	float blueColorValue,
+	float alphaValue)
+{
+	CPU_PROFILE_ZONE("SceneManager::SetShaderColor");
+
+	// variables for this method
+	glm::vec4 currentColor;
+
+	currentColor.r = redColorValue;
+	currentColor.g = greenColorValue;
+	currentColor.b = blueColorValue;
+	currentColor.a = alphaValue;
+
+	if (NULL != m_pShaderManager)
+	{
+		SetVariantFlag(ShaderVariants::variant_texture, false);
+		m_drawTextureSlot = -1;
+		m_pShaderManager->setIntValue(g_UseTextureName, false);
+		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
+	}
+	m_renderStats.colorChanges++;
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture data
+ *  associated with the passed in ID into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	std::string textureTag)
+{
+	CPU_PROFILE_ZONE("SceneManager::SetShaderTexture");
+
+	if (NULL != m_pShaderManager)
+	{
+		SetVariantFlag(ShaderVariants::variant_texture, true);
+		m_pShaderManager->setIntValue(g_UseTextureName, true);
+
+		// the UV scale of the object usually follows, and may
+		// move the sampler off the atlas again
+		int textureID = -1;
+		textureID = FindTextureSlot(textureTag);
+		BindTextureSlot(textureID, m_textureUVScale);
+		m_drawTextureSlot = textureID;
+	}
+}
+
+//***Added
+
+/***********************************************************
+ *  SetShaderTextureOverlay()
+ *
+ *  This method is used for setting the texture data
+ *  associated with the passed in ID into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderTextureOverlay(
+	std::string textureTag)
+{
+	CPU_PROFILE_ZONE("SceneManager::SetShaderTextureOverlay");
+
+	if (NULL != m_pShaderManager)
+	{
+		SetVariantFlag(ShaderVariants::variant_texture_overlay, textureTag.size() > 0);
+		if (textureTag.size() > 0)
+		{
+			m_pShaderManager->setIntValue(g_UseTextureOverlayName, true);
+
+			int textureID = -1;
+			textureID = FindTextureSlot(textureTag);
+			m_pShaderManager->setSampler2DValue(g_TextureOverlayValueName, textureID);
+			m_drawOverlaySlot = textureID;
+			BindTextureSamplers();
+		}
+		else
+		{
+			m_pShaderManager->setIntValue(g_UseTextureOverlayName, false);
+			m_drawOverlaySlot = -1;
+		}
+	}
+	m_renderStats.textureChanges++;
+}
+
+
+
+/***********************************************************
+ *  SetTextureUVScale()
+ *
+ *  This method is used for setting the texture UV scale
+ *  values into the shader.  The built-in scene sets it for
+ *  every textured object, after the textures, so this is
+ *  where its texture sizes on screen are noted, and where it
+ *  is decided whether the texture is drawn from the atlas.
+ ***********************************************************/
+void SceneManager::SetTextureUVScale(float u, float v)
+{
+	CPU_PROFILE_ZONE("SceneManager::SetTextureUVScale");
+
+	m_textureUVScale = glm::vec2(u, v);
+	bool bFromAtlas = false;
+	if (NULL != m_pShaderManager)
+	{
+		if (m_drawTextureSlot >= 0)
+		{
+			bFromAtlas = BindTextureSlot(m_drawTextureSlot, m_textureUVScale);
+		}
+		else
+		{
+			m_pShaderManager->setVec2Value("UVscale", m_textureUVScale);
+		}
+	}
+
+	if ((NULL != m_pTextureStreamer) && (m_sceneObjectCount == 0))
+	{
+		float texturePixels = m_pTextureStreamer->ComputeTexturePixels(
+			m_drawCenter, m_drawRadius, m_textureUVScale);
+		if (bFromAtlas == false)
+		{
+			m_pTextureStreamer->NoteUse(m_drawTextureSlot, texturePixels);
+		}
+		m_pTextureStreamer->NoteUse(m_drawOverlaySlot, texturePixels);
+	}
+}
+
+/***********************************************************
+ *  FindAtlasRegion()
+ *
+ *  This method is used for getting the atlas region of a
+ *  texture slot.  A region does not repeat, so only objects
+ *  whose texture coordinates stay within one repeat and that
+ *  have no overlay, which shares their coordinates, are
+ *  drawn from the atlas.
+ ***********************************************************/
+bool SceneManager::FindAtlasRegion(int slot, const glm::vec2& uvScale, glm::vec2& offset, glm::vec2& scale, int& unit) const
+{
+	if ((m_bAtlasActive == false) || (m_drawOverlaySlot >= 0) ||
+		(uvScale.x > 1.0f) || (uvScale.y > 1.0f))
+	{
+		return(false);
+	}
+
+	TextureAtlas::ATLAS_REGION region;
+	if (m_pTextureAtlas->FindRegion(slot, region) == false)
+	{
+		return(false);
+	}
+
+	offset = region.offset;
+	scale = region.scale;
+	unit = region.unit;
+	return(true);
+}
+
+/***********************************************************
+ *  BindTextureSlot()
+ *
+ *  This method is used for pointing the object texture at a
+ *  slot, or at its atlas region when it has one, and setting
+ *  the UV scale and offset that map the object into it.  The
+ *  sampler is only set when the unit changes, so objects
+ *  drawn from the same atlas page share one binding.
+ ***********************************************************/
+bool SceneManager::BindTextureSlot(int slot, const glm::vec2& uvScale)
+{
+	int unit = slot;
+	glm::vec2 offset(0.0f, 0.0f);
+	glm::vec2 scale(1.0f, 1.0f);
+	bool bFromAtlas = FindAtlasRegion(slot, uvScale, offset, scale, unit);
+
+	if (unit != m_boundTextureUnit)
+	{
+		m_pShaderManager->setSampler2DValue(g_TextureValueName, unit);
+		m_boundTextureUnit = unit;
+		m_bTextureFromAtlas = bFromAtlas;
+		m_renderStats.textureChanges++;
+		BindTextureSamplers();
+	}
+
+	m_pShaderManager->setVec2Value("UVscale", uvScale * scale);
+	if (m_bAtlasActive == true)
+	{
+		m_pShaderManager->setVec2Value(g_UVOffsetName, offset);
+	}
+
+	return(bFromAtlas);
+}
+
+/***********************************************************
+ *  SetMaterialSampler()
+ *
+ *  This method is used for taking the filter and wrap
+ *  presets of a material for the textures drawn next.
+ ***********************************************************/
+void SceneManager::SetMaterialSampler(const OBJECT_MATERIAL& material)
+{
+	if ((material.samplerFilter == m_materialFilter) && (material.samplerWrap == m_materialWrap))
+	{
+		return;
+	}
+
+	m_materialFilter = material.samplerFilter;
+	m_materialWrap = material.samplerWrap;
+	BindTextureSamplers();
+}
+
+/***********************************************************
+ *  BindTextureSamplers()
+ *
+ *  This method is used for binding the samplers of the
+ *  material in use to the units of the object and overlay
+ *  textures.  An atlas region must not wrap into its
+ *  neighbors and its gutter is too narrow for anisotropic
+ *  footprints, so it is always clamped and at most
+ *  trilinear.
+ ***********************************************************/
+void SceneManager::BindTextureSamplers()
+{
+	if (NULL == m_pSamplerCache)
+	{
+		return;
+	}
+
+	int filter = m_pSamplerCache->ResolveFilter(m_materialFilter);
+	if (m_bTextureFromAtlas == true)
+	{
+		if (m_pSamplerCache->BindSampler(m_boundTextureUnit,
+			std::min(filter, (int)filter_trilinear), wrap_clamp) == true)
+		{
+			m_renderStats.samplerChanges++;
+		}
+	}
+	else if (m_pSamplerCache->BindSampler(m_boundTextureUnit, filter, m_materialWrap) == true)
+	{
+		m_renderStats.samplerChanges++;
+	}
+
+	if (m_pSamplerCache->BindSampler(m_drawOverlaySlot, filter, m_materialWrap) == true)
+	{
+		m_renderStats.samplerChanges++;
+	}
+}
+
+
+
+/***********************************************************
+ *  ResetRenderStats()
+ *
+ *  This method is used for clearing the counts of draws and
+ *  shader state changes, usually at the start of a frame.
+ ***********************************************************/
+void SceneManager::ResetRenderStats()
+{
+	m_renderStats.drawCalls = 0;
+	m_renderStats.transformChanges = 0;
+	m_renderStats.textureChanges = 0;
+	m_renderStats.materialChanges = 0;
+	m_renderStats.colorChanges = 0;
+	m_renderStats.programChanges = 0;
+	m_renderStats.samplerChanges = 0;
+	m_renderStats.culledObjects = 0;
+	m_renderStats.buildMs = 0.0;
+	m_renderStats.submitMs = 0.0;
+}
+
+/***********************************************************
+ *  SetCullingFrustum()
+ *
+ *  This method is used for extracting the six view frustum
+ *  planes from the combined view and projection matrix.  The
+ *  scene objects are culled against these planes.
+ ***********************************************************/
+void SceneManager::SetCullingFrustum(const glm::mat4& viewProjection)
+{
+	ExtractFrustumPlanes(viewProjection, m_bReverseDepth, m_frustumPlanes);
+	m_bFrustumValid = true;
+}
+
+/***********************************************************
+ *  SetSceneViews()
+ *
+ *  This method is used for setting the views the next frames
+ *  are drawn into.  The scene objects are culled against the
+ *  frustum of every view and sorted once; the sorted packets
+ *  are then drawn again for each view with its own viewport
+ *  and camera, skipping the packets it cannot see.
+ ***********************************************************/
+void SceneManager::SetSceneViews(const std::vector<SCENE_VIEW>& views)
+{
+	size_t count = std::min(views.size(), (size_t)MAX_SCENE_VIEWS);
+	m_sceneViews.assign(views.begin(), views.begin() + count);
+	m_viewFrustumPlanes.resize(count * 6);
+	for (size_t i = 0; i < count; i++)
+	{
+		ExtractFrustumPlanes(m_sceneViews[i].projection * m_sceneViews[i].view, m_bReverseDepth, &m_viewFrustumPlanes[i * 6]);
+	}
+}
+
+/***********************************************************
+ *  IsSphereVisible()
+ *
+ *  This method is used for testing whether a bounding sphere
+ *  is at least partially inside the view frustum.
+ ***********************************************************/
+bool SceneManager::IsSphereVisible(const glm::vec3& center, float radius) const
+{
+	if (m_bFrustumValid == false)
+	{
+		return(true);
+	}
+
+	return(IsSphereInsidePlanes(m_frustumPlanes, center, radius));
+}
+
+/***********************************************************
+ *  GetVisibleViews()
+ *
+ *  This method is used for testing a bounding sphere against
+ *  the frustum of every scene view.  Without views the
+ *  culling frustum decides bit 0.
+ ***********************************************************/
+unsigned int SceneManager::GetVisibleViews(const glm::vec3& center, float radius) const
+{
+	if (m_sceneViews.empty() == true)
+	{
+		return(IsSphereVisible(center, radius) ? 1u : 0u);
+	}
+
+	unsigned int viewMask = 0;
+	for (size_t i = 0; i < m_sceneViews.size(); i++)
+	{
+		if (IsSphereInsidePlanes(&m_viewFrustumPlanes[i * 6], center, radius) == true)
+		{
+			viewMask |= 1u << i;
+		}
+	}
+	return(viewMask);
+}
+
+/***********************************************************
+ *  ApplySceneView()
+ *
+ *  This method is used for drawing into a scene view from
+ *  here on.  The camera goes to the program in use, which
+ *  hands it on when the shader variant changes.
+ ***********************************************************/
+void SceneManager::ApplySceneView(int index)
+{
+	const SCENE_VIEW& sceneView = m_sceneViews[index];
+	glViewport(sceneView.x, sceneView.y, sceneView.width, sceneView.height);
+	m_pShaderManager->setMat4Value(g_ViewName, sceneView.view);
+	m_pShaderManager->setMat4Value(g_ProjectionName, sceneView.projection);
+	m_pShaderManager->setVec3Value(g_ViewPositionName, sceneView.position);
+}
+
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing one of the basic shape
+ *  meshes, or a mesh of the library, by its mesh type.
+ ***********************************************************/
+void SceneManager::DrawMesh(int meshType)
+{
+	const MeshLibrary* pLibrary = NULL;
+	int libraryIndex = 0;
+	if (FindLibraryMesh(meshType, pLibrary, libraryIndex) == true)
+	{
+		if (pLibrary->DrawMesh(libraryIndex) == true)
+		{
+			m_renderStats.drawCalls++;
+		}
+		return;
+	}
+
+	switch (meshType)
+	{
+	case mesh_plane:
+		m_basicMeshes->DrawPlaneMesh();
+		break;
+	case mesh_box:
+		m_basicMeshes->DrawBoxMesh();
+		break;
+	case mesh_sphere:
+		m_basicMeshes->DrawSphereMesh();
+		break;
+	case mesh_cylinder:
+		m_basicMeshes->DrawCylinderMesh();
+		break;
+	case mesh_torus:
+		m_basicMeshes->DrawTorusMesh();
+		break;
+	case mesh_tapered_cylinder:
+		m_basicMeshes->DrawTaperedCylinderMesh();
+		break;
+	default:
+		return;
+	}
+	m_renderStats.drawCalls++;
+}
+
+/***********************************************************
+ *  FindLibraryMesh()
+ *
+ *  This method is used for finding the mesh library a mesh
+ *  type is drawn from: the imported meshes past the basic
+ *  shapes, or the generated basic shapes when acquired.
+ ***********************************************************/
+bool SceneManager::FindLibraryMesh(int meshType, const MeshLibrary*& pLibrary, int& index) const
+{
+	if (meshType >= mesh_type_count)
+	{
+		pLibrary = m_pMeshLibrary;
+		index = meshType - mesh_type_count;
+	}
+	else
+	{
+		pLibrary = m_pPrimitiveLibrary;
+		index = meshType;
+	}
+	return((NULL != pLibrary) && (index >= 0) && (index < pLibrary->GetMeshCount()));
+}
+
+/***********************************************************
+ *  UsePrimitiveLibrary()
+ *
+ *  This method is used for acquiring the generated basic
+ *  shapes of a set of parameters, in place of the ones held
+ *  until now.
+ ***********************************************************/
+bool SceneManager::UsePrimitiveLibrary(const PrimitiveLibrary::PRIMITIVE_SETTINGS& settings, const std::string& directory)
+{
+	const MeshLibrary* pLibrary = PrimitiveLibrary::Acquire(settings, directory, m_pJobSystem);
+	PrimitiveLibrary::Release(m_pPrimitiveLibrary);
+	m_pPrimitiveLibrary = pLibrary;
+	MarkSceneChanged();
+	return(NULL != pLibrary);
+}
+
+/***********************************************************
+ *  RenderSceneObjects()
+ *
+ *  This method is used for drawing the objects of the data
+ *  driven scene.  The frame is split into a build phase that
+ *  can run on every core and a submit phase that issues the
+ *  OpenGL calls on the calling thread.  With several scene
+ *  views the packets are built and sorted once and only the
+ *  submit phase runs for each view.
+ ***********************************************************/
+void SceneManager::RenderSceneObjects()
+{
+	CPU_PROFILE_ZONE("SceneManager::RenderSceneObjects");
+
+	std::chrono::steady_clock::time_point buildStart = std::chrono::steady_clock::now();
+	BuildDrawPackets();
+	std::chrono::steady_clock::time_point submitStart = std::chrono::steady_clock::now();
+	SortDrawPackets();
+	if (m_sceneViews.empty() == true)
+	{
+		SubmitDrawPackets(1);
+	}
+	else
+	{
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		for (int i = 0; i < (int)m_sceneViews.size(); i++)
+		{
+			GPU_PROFILE_SCOPE(VIEW_SCOPE_NAMES[i]);
+			ApplySceneView(i);
+			SubmitDrawPackets(1u << i);
+		}
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	}
+	std::chrono::steady_clock::time_point submitEnd = std::chrono::steady_clock::now();
+
+	m_renderStats.buildMs += std::chrono::duration<double, std::milli>(submitStart - buildStart).count();
+	m_renderStats.submitMs += std::chrono::duration<double, std::milli>(submitEnd - submitStart).count();
+}
+
+/***********************************************************
+ *  BuildDrawPackets()
+ *
+ *  This method is used for culling the scene objects against
+ *  the view frustum and writing a draw packet, with its model
+ *  matrix and sort key, for every visible object.  Each
+ *  builder writes only to its own lists, so no locking is
+ *  needed.  No OpenGL calls may be made here.
+ ***********************************************************/
+void SceneManager::BuildDrawPackets()
+{
+	CPU_PROFILE_ZONE("SceneManager::BuildDrawPackets");
+
+	// objects per job - large enough to hide the scheduling cost
+	const int BUILD_GRAIN_SIZE = 4096;
+
+	int builderCount = 1;
+	if (NULL != m_pJobSystem)
+	{
+		builderCount = m_pJobSystem->GetWorkerCount();
+	}
+
+	m_threadDrawLists.resize(builderCount);
+	m_threadSortLists.resize(builderCount);
+	m_threadCulledCounts.assign(builderCount, 0);
+	for (int i = 0; i < builderCount; i++)
+	{
+		m_threadDrawLists[i].clear();
+		m_threadSortLists[i].clear();
+	}
+
+	JobSystem::RANGE_FUNCTION build = [this](int begin, int end, int workerIndex) {
+		CPU_PROFILE_ZONE("BuildDrawPackets slice");
+
+		std::vector<DRAW_PACKET>& packets = m_threadDrawLists[workerIndex];
+		std::vector<DRAW_SORT_ENTRY>& sortEntries = m_threadSortLists[workerIndex];
+		int culled = 0;
+
+		for (int i = begin; i < end; i++)
+		{
+			const SCENE_OBJECT& object = m_pSceneObjects[i];
+			unsigned int viewMask = GetVisibleViews(object.center, object.radius);
+			if (viewMask == 0)
+			{
+				culled++;
+				continue;
+			}
+
+			DRAW_PACKET packet;
+			packet.viewMask = viewMask;
+			packet.model = ComputeModelMatrix(
+				object.scaleXYZ,
+				object.rotationDegrees.x,
+				object.rotationDegrees.y,
+				object.rotationDegrees.z,
+				object.positionXYZ);
+			// library meshes hold quantized positions, mapped back to
+			// model units by their own matrix
+			const MeshLibrary* pLibrary = NULL;
+			int libraryIndex = 0;
+			if (FindLibraryMesh(object.meshType, pLibrary, libraryIndex) == true)
+			{
+				packet.model = packet.model * pLibrary->GetDequantization(libraryIndex);
+			}
+			packet.color = object.color;
+			packet.uvScale = object.uvScale;
+			packet.meshType = object.meshType;
+			packet.textureSlot = object.textureSlot;
+			packet.materialIndex = object.materialIndex;
+			packet.texturePixels = 0.0f;
+			if ((NULL != m_pTextureStreamer) && (object.textureSlot >= 0))
+			{
+				packet.texturePixels = m_pTextureStreamer->ComputeTexturePixels(
+					object.center, object.radius, object.uvScale);
+			}
+
+			// objects drawn from the same atlas page sort together
+			int textureUnit = object.textureSlot;
+			glm::vec2 atlasOffset;
+			glm::vec2 atlasScale;
+			FindAtlasRegion(object.textureSlot, object.uvScale, atlasOffset, atlasScale, textureUnit);
+
+			DRAW_SORT_ENTRY entry;
+			unsigned int variant = (object.textureSlot >= 0) ? ShaderVariants::variant_texture : 0;
+			entry.key =
+				((uint64_t)variant << 56) |
+				((uint64_t)((textureUnit + 1) & 0xFF) << 48) |
+				((uint64_t)(object.materialIndex & 0xFFFF) << 32) |
+				((uint64_t)(object.meshType & 0xFFFFFF));
+			entry.reference = ((uint32_t)workerIndex << 24) | (uint32_t)packets.size();
+
+			packets.push_back(packet);
+			sortEntries.push_back(entry);
+		}
+
+		m_threadCulledCounts[workerIndex] += culled;
+	};
+
+	if (NULL != m_pJobSystem)
+	{
+		m_pJobSystem->ParallelFor(m_sceneObjectCount, BUILD_GRAIN_SIZE, build);
+	}
+	else
+	{
+		build(0, m_sceneObjectCount, 0);
+	}
+
+	for (int i = 0; i < builderCount; i++)
+	{
+		m_renderStats.culledObjects += m_threadCulledCounts[i];
+	}
+}
+
+/***********************************************************
+ *  SortDrawPackets()
+ *
+ *  This method is used for merging the sort entries of every
+ *  builder and sorting them so objects sharing a shader
+ *  variant, a texture or atlas page and a material are drawn
+ *  together.
+ ***********************************************************/
+void SceneManager::SortDrawPackets()
+{
+	CPU_PROFILE_ZONE("SceneManager::SortDrawPackets");
+
+	// merge
+	m_sortedDraws.clear();
+	for (size_t i = 0; i < m_threadSortLists.size(); i++)
+	{
+		m_sortedDraws.insert(m_sortedDraws.end(), m_threadSortLists[i].begin(), m_threadSortLists[i].end());
+	}
+
+	// sort - equal keys keep the scene order of each builder
+	std::stable_sort(m_sortedDraws.begin(), m_sortedDraws.end(),
+		[](const DRAW_SORT_ENTRY& a, const DRAW_SORT_ENTRY& b) { return(a.key < b.key); });
+}
+
+/***********************************************************
+ *  SubmitDrawPackets()
+ *
+ *  This method is used for drawing the sorted packets that
+ *  are visible in the views of the mask.  Shader state is
+ *  only sent when it differs from the previous packet.
+ ***********************************************************/
+void SceneManager::SubmitDrawPackets(unsigned int viewMask)
+{
+	CPU_PROFILE_ZONE("SceneManager::SubmitDrawPackets");
+
+	// execute
+	int lastTextureSlot = -2;
+	int lastMaterialIndex = -1;
+	glm::vec2 lastUVScale = glm::vec2(-1.0f, -1.0f);
+	bool bFromAtlas = false;
+	for (size_t i = 0; i < m_sortedDraws.size(); i++)
+	{
+		uint32_t reference = m_sortedDraws[i].reference;
+		const DRAW_PACKET& packet = m_threadDrawLists[reference >> 24][reference & 0xFFFFFF];
+		if ((packet.viewMask & viewMask) == 0)
+		{
+			continue;
+		}
+
+		m_pShaderManager->setMat4Value(g_ModelName, packet.model);
+		m_renderStats.transformChanges++;
+
+		if (packet.textureSlot < 0)
+		{
+			SetShaderColor(packet.color.r, packet.color.g, packet.color.b, packet.color.a);
+			lastTextureSlot = -1;
+		}
+		else if ((packet.textureSlot != lastTextureSlot) ||
+			(packet.uvScale.x != lastUVScale.x) || (packet.uvScale.y != lastUVScale.y))
+		{
+			if (lastTextureSlot < 0)
+			{
+				SetVariantFlag(ShaderVariants::variant_texture, true);
+				m_pShaderManager->setIntValue(g_UseTextureName, true);
+			}
+			bFromAtlas = BindTextureSlot(packet.textureSlot, packet.uvScale);
+			lastTextureSlot = packet.textureSlot;
+			lastUVScale = packet.uvScale;
+		}
+		// a texture drawn from the atlas needs no streamed levels
+		if ((NULL != m_pTextureStreamer) && (packet.textureSlot >= 0) && (bFromAtlas == false))
+		{
+			m_pTextureStreamer->NoteUse(packet.textureSlot, packet.texturePixels);
+		}
+
+		if ((packet.materialIndex != lastMaterialIndex) &&
+			(packet.materialIndex >= 0) && (packet.materialIndex < (int)m_objectMaterials.size()))
+		{
+			const OBJECT_MATERIAL& material = m_objectMaterials[packet.materialIndex];
+			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
+			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
+			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
+			SetMaterialSampler(material);
+			m_renderStats.materialChanges++;
+			lastMaterialIndex = packet.materialIndex;
+		}
+
+		DrawMesh(packet.meshType);
+	}
+}
+
+/***********************************************************
+ *  SetJobSystem()
+ *
+ *  This method is used for setting the job system that the
+ *  build phase of data driven scenes runs on.
+ ***********************************************************/
+void SceneManager::SetJobSystem(JobSystem* pJobSystem)
+{
+	m_pJobSystem = pJobSystem;
+}
+
+/***********************************************************
+ *  SetSceneLights()
+ *
+ *  This method is used for setting the point lights of the
+ *  data driven scene into the shader.  The shader supports
+ *  up to 5 point lights; unused ones are switched off.
+ ***********************************************************/
+void SceneManager::SetSceneLights(const std::vector<SCENE_LIGHT>& lights)
+{
+	const int MAX_POINT_LIGHTS = 5;
+
+	m_sceneLights = lights;
+	m_pointLightCount = std::min((int)lights.size(), MAX_POINT_LIGHTS);
+	for (int i = 0; i < MAX_POINT_LIGHTS; i++)
+	{
+		std::string prefix = "pointLights[" + std::to_string(i) + "].";
+		if (i < (int)lights.size())
+		{
+			m_pShaderManager->setVec3Value(prefix + "position", lights[i].position);
+			m_pShaderManager->setVec3Value(prefix + "ambient", lights[i].ambient);
+			m_pShaderManager->setVec3Value(prefix + "diffuse", lights[i].diffuse);
+			m_pShaderManager->setVec3Value(prefix + "specular", lights[i].specular);
+			m_pShaderManager->setBoolValue(prefix + "bActive", true);
+		}
+		else
+		{
+			m_pShaderManager->setBoolValue(prefix + "bActive", false);
+		}
+	}
+
+	MarkSceneChanged();
+}
+
+/***********************************************************
+ *  SetSceneObject()
+ *
+ *  This method is used for replacing one object of the data
+ *  driven scene, for example to move it.
+ ***********************************************************/
+bool SceneManager::SetSceneObject(int index, const SCENE_OBJECT& object)
+{
+	if ((index < 0) || (index >= m_sceneObjectCount))
+	{
+		return(false);
+	}
+
+	// the objects of a loaded scene file are read-only, so the
+	// first change copies them into the list
+	if (m_pSceneObjects != m_sceneObjects.data())
+	{
+		m_sceneObjects.assign(m_pSceneObjects, m_pSceneObjects + m_sceneObjectCount);
+		UseSceneObjectList();
+		ReleaseSceneFile();
+	}
+
+	m_sceneObjects[index] = object;
+	MarkSceneChanged();
+
+	return(true);
+}
+
+/***********************************************************
+ *  SetMaterial()
+ *
+ *  This method is used for changing the values of a defined
+ *  material, or adding it when no material has its tag.
+ ***********************************************************/
+void SceneManager::SetMaterial(const OBJECT_MATERIAL& material)
+{
+	size_t index = 0;
+	while ((index < m_objectMaterials.size()) &&
+		(m_objectMaterials[index].tag != material.tag))
+	{
+		index++;
+	}
+
+	if (index < m_objectMaterials.size())
+	{
+		m_objectMaterials[index] = material;
+	}
+	else
+	{
+		m_objectMaterials.push_back(material);
+	}
+	MarkSceneChanged();
+}
+
+/***********************************************************
+ *  GenerateScene()
+ *
+ *  This method is used for replacing the built-in scene with
+ *  a procedurally generated one.  The same seed always gives
+ *  the same scene.  Passing zero objects restores the
+ *  built-in scene.
+ ***********************************************************/
+void SceneManager::GenerateScene(int objectCount, unsigned int seed)
+{
+	CPU_PROFILE_ZONE("SceneManager::GenerateScene");
+
+	if (objectCount <= 0)
+	{
+		RemoveGeneratedMaterials();
+		MarkSceneChanged();
+		ReleaseSceneFile();
+		m_sceneObjects.clear();
+		UseSceneObjectList();
+		SetupSceneLights();
+		return;
+	}
+
+	SceneGenerator::GENERATOR_SETTINGS settings;
+	settings.objectCount = objectCount;
+	settings.textureCount = m_loadedTextures;
+	settings.materialCount = 16;
+	settings.lightCount = 5;
+	settings.spacing = 3.0f;
+
+	std::vector<OBJECT_MATERIAL> materials;
+	std::vector<SCENE_LIGHT> lights;
+
+	SceneGenerator generator(seed);
+	generator.Generate(settings, materials, lights, m_sceneObjects);
+	UseGeneratedScene(materials, lights);
+
+	std::cout << "Generated scene: objects:" << m_sceneObjects.size()
+		<< ", materials:" << materials.size() << ", lights:" << lights.size()
+		<< ", seed:" << seed << std::endl;
+}
+
+/***********************************************************
+ *  GenerateDepthTestScene()
+ *
+ *  This method is used for replacing the scene with panels
+ *  that show where the depth buffer runs out of precision,
+ *  seen from the starting camera.
+ ***********************************************************/
+void SceneManager::GenerateDepthTestScene()
+{
+	std::vector<OBJECT_MATERIAL> materials;
+	std::vector<SCENE_LIGHT> lights;
+
+	SceneGenerator generator(0);
+	generator.GenerateDepthTest(materials, lights, m_sceneObjects);
+	UseGeneratedScene(materials, lights);
+
+	std::cout << "Generated depth test scene: objects:" << m_sceneObjects.size() << std::endl;
+}
+
+/***********************************************************
+ *  RemoveGeneratedMaterials()
+ *
+ *  This method is used for removing the materials of any
+ *  previously generated scene.
+ ***********************************************************/
+void SceneManager::RemoveGeneratedMaterials()
+{
+	m_objectMaterials.erase(
+		std::remove_if(m_objectMaterials.begin(), m_objectMaterials.end(),
+			[](const OBJECT_MATERIAL& material) { return(material.tag.compare(0, 9, "generated") == 0); }),
+		m_objectMaterials.end());
+}
+
+/***********************************************************
+ *  UseGeneratedScene()
+ *
+ *  This method is used for drawing the objects generated
+ *  into the list.  The generated materials are appended after
+ *  the built-in ones, replacing the materials of any
+ *  previously generated scene.
+ ***********************************************************/
+void SceneManager::UseGeneratedScene(const std::vector<OBJECT_MATERIAL>& materials, const std::vector<SCENE_LIGHT>& lights)
+{
+	RemoveGeneratedMaterials();
+	MarkSceneChanged();
+	ReleaseSceneFile();
+	UseSceneObjectList();
+
+	int firstMaterial = (int)m_objectMaterials.size();
+	m_objectMaterials.insert(m_objectMaterials.end(), materials.begin(), materials.end());
+	for (size_t i = 0; i < m_sceneObjects.size(); i++)
+	{
+		m_sceneObjects[i].materialIndex += firstMaterial;
+	}
+
+	SetSceneLights(lights);
+}
+
+/***********************************************************
+ *  UseSceneObjectList()
+ *
+ *  This method is used for drawing the objects held in the
+ *  scene object list.
+ ***********************************************************/
+void SceneManager::UseSceneObjectList()
+{
+	m_pSceneObjects = m_sceneObjects.data();
+	m_sceneObjectCount = (int)m_sceneObjects.size();
+}
+
+/***********************************************************
+ *  ReleaseSceneFile()
+ *
+ *  This method is used for closing the loaded scene file.
+ *  Its objects must no longer be drawn afterwards.
+ ***********************************************************/
+void SceneManager::ReleaseSceneFile()
+{
+	if (NULL != m_pSceneFile)
+	{
+		if (m_pSceneObjects != m_sceneObjects.data())
+		{
+			m_pSceneObjects = NULL;
+			m_sceneObjectCount = 0;
+		}
+		delete m_pSceneFile;
+		m_pSceneFile = NULL;
+	}
+}
+
+/***********************************************************
+ *  LoadSceneFile()
+ *
+ *  This method is used for replacing the scene with the
+ *  contents of a scene file.  The textures of the file
+ *  replace the loaded ones when it lists any, and its
+ *  materials and lights replace the current ones.  The
+ *  objects of a compiled file are drawn straight from the
+ *  mapped file, which stays open until the scene changes.
+ ***********************************************************/
+bool SceneManager::LoadSceneFile(const char* filename)
+{
+	CPU_PROFILE_ZONE("SceneManager::LoadSceneFile");
+
+	std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+
+	SceneFile* pSceneFile = new SceneFile();
+	if (pSceneFile->Load(filename) == false)
+	{
+		delete pSceneFile;
+		return(false);
+	}
+
+	double loadMs = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - loadStart).count();
+
+	std::cout << "Loaded scene file:" << filename << ", objects:" << pSceneFile->GetObjectCount()
+		<< ", materials:" << pSceneFile->GetMaterials().size() << ", lights:" << pSceneFile->GetLights().size()
+		<< ", textures:" << pSceneFile->GetTextures().size()
+		<< ", " << ((pSceneFile->IsMapped() == true) ? "mapped" : "parsed")
+		<< " in " << loadMs << " ms" << std::endl;
+
+	UseSceneFile(pSceneFile);
+
+	return(true);
+}
+
+/***********************************************************
+ *  UseSceneFile()
+ *
+ *  This method is used for replacing the scene with a loaded
+ *  scene file.  The textures of the file replace the loaded
+ *  ones when it lists any, but only when the list differs,
+ *  so editing the objects of a scene does not decode every
+ *  image again.  Its materials and lights replace the
+ *  current ones.  The objects of a compiled file are drawn
+ *  straight from the mapped file, which stays open until the
+ *  scene changes.
+ ***********************************************************/
+void SceneManager::UseSceneFile(SceneFile* pSceneFile)
+{
+	CPU_PROFILE_ZONE("SceneManager::UseSceneFile");
+
+	const std::vector<TEXTURE_FILE>& textures = pSceneFile->GetTextures();
+	bool bSameTextures = ((int)textures.size() == m_loadedTextures);
+	for (int i = 0; (bSameTextures == true) && (i < m_loadedTextures); i++)
+	{
+		bSameTextures = (textures[i].tag == m_textureIDs[i].tag) &&
+			(FileWatcher::NormalizePath(textures[i].filename) == FileWatcher::NormalizePath(m_textureIDs[i].filename));
+	}
+	if ((textures.size() > 0) && (bSameTextures == false))
+	{
+		DestroyGLTextures();
+		LoadTextureFiles(textures);
+		BindGLTextures();
+	}
+
+	ReleaseSceneFile();
+	m_sceneObjects.clear();
+	m_pSceneFile = pSceneFile;
+	m_pSceneObjects = pSceneFile->GetObjects();
+	m_sceneObjectCount = pSceneFile->GetObjectCount();
+
+	m_objectMaterials = pSceneFile->GetMaterials();
+	SetSceneLights(pSceneFile->GetLights());
+	MarkSceneChanged();
+}
+
+/***********************************************************
+ *  RestoreShaderState()
+ *
+ *  This method is used for setting the lights into a newly
+ *  linked shader program, which starts with every uniform
+ *  cleared.  Everything else is set while drawing.
+ ***********************************************************/
+void SceneManager::RestoreShaderState()
+{
+	// the built-in lights also switch lighting on, and the
+	// point lights of a data driven scene replace theirs
+	SetupSceneLights();
+	if (m_sceneObjectCount > 0)
+	{
+		SetSceneLights(m_sceneLights);
+	}
+	PrewarmShaderVariants();
+	MarkSceneChanged();
+}
+
+/***********************************************************
+ *  PrewarmShaderVariants()
+ *
+ *  This method is used for building the variants the scene
+ *  can draw with under the current lights - untextured,
+ *  textured, and textured with an overlay - so that the
+ *  first frame does not wait for them one at a time.
+ ***********************************************************/
+void SceneManager::PrewarmShaderVariants()
+{
+	if (NULL == m_pShaderVariants)
+	{
+		return;
+	}
+
+	unsigned int lighting = m_variantFlags & ShaderVariants::variant_lighting;
+	std::vector<uint32_t> keys;
+	keys.push_back(ShaderVariants::MakeKey(lighting, m_pointLightCount));
+	keys.push_back(ShaderVariants::MakeKey(lighting | ShaderVariants::variant_texture, m_pointLightCount));
+	keys.push_back(ShaderVariants::MakeKey(
+		lighting | ShaderVariants::variant_texture | ShaderVariants::variant_texture_overlay, m_pointLightCount));
+	m_pShaderVariants->Prewarm(keys);
+}
+
+/***********************************************************
+ *  SetTextureStreamingView()
+ *
+ *  This method is used for setting the camera that the
+ *  streamed textures are sized for.
+ ***********************************************************/
+void SceneManager::SetTextureStreamingView(const glm::mat4& view, const glm::mat4& projection, int viewportHeight)
+{
+	if (NULL != m_pTextureStreamer)
+	{
+		m_pTextureStreamer->SetView(view, projection, viewportHeight);
+	}
+}
+
+/***********************************************************
+ *  UpdateTextureStreaming()
+ *
+ *  This method is used for letting the streamer change the
+ *  levels of the textures.  A changed texture is a new
+ *  texture object, so the slots are updated and the scene
+ *  drawn again with the new detail.
+ ***********************************************************/
+void SceneManager::UpdateTextureStreaming()
+{
+	if (NULL == m_pTextureStreamer)
+	{
+		return;
+	}
+
+	if (m_pTextureStreamer->Update() == true)
+	{
+		for (int i = 0; i < m_loadedTextures; i++)
+		{
+			m_textureIDs[i].ID = m_pTextureStreamer->GetTextureID(i);
+		}
+		MarkSceneChanged();
+	}
+}
+
+/***********************************************************
+ *  SetVariantFlag()
+ *
+ *  This method is used for turning one switch of the shader
+ *  variant on or off.
+ ***********************************************************/
+void SceneManager::SetVariantFlag(unsigned int flag, bool bOn)
+{
+	if (bOn == true)
+	{
+		m_variantFlags |= flag;
+	}
+	else
+	{
+		m_variantFlags &= ~flag;
+	}
+	SelectShaderVariant();
+}
+
+/***********************************************************
+ *  SelectShaderVariant()
+ *
+ *  This method is used for switching to the program of the
+ *  variant the switches select, while a frame is drawn.  The
+ *  uniform values are carried over, so the draw code goes on
+ *  setting uniforms as if there were only one program.  A
+ *  variant that does not build falls back to the main
+ *  program, which still branches on the switch uniforms.
+ ***********************************************************/
+void SceneManager::SelectShaderVariant()
+{
+	if ((NULL == m_pShaderVariants) || (m_baseProgram == 0))
+	{
+		return;
+	}
+
+	GLuint program = m_pShaderVariants->GetProgram(
+		ShaderVariants::MakeKey(m_variantFlags, m_pointLightCount));
+	if (program == 0)
+	{
+		program = m_baseProgram;
+	}
+	if (program == m_activeProgram)
+	{
+		return;
+	}
+
+	m_pShaderVariants->CopyUniforms(m_activeProgram, program);
+	m_pShaderManager->m_programID = program;
+	m_pShaderManager->use();
+	m_activeProgram = program;
+	m_renderStats.programChanges++;
+}
+
+/***********************************************************
+ *  BeginShaderVariants()
+ *
+ *  This method is used for starting to draw with the shader
+ *  variants.  The main program holds the uniforms set
+ *  between frames, such as the view and the lights, and they
+ *  are copied from it into the first variant used.
+ ***********************************************************/
+void SceneManager::BeginShaderVariants()
+{
+	if (NULL == m_pShaderVariants)
+	{
+		return;
+	}
+
+	m_baseProgram = m_pShaderManager->m_programID;
+	m_activeProgram = m_baseProgram;
+	SelectShaderVariant();
+}
+
+/***********************************************************
+ *  EndShaderVariants()
+ *
+ *  This method is used for making the main program current
+ *  again, so uniforms set between frames go to it.
+ ***********************************************************/
+void SceneManager::EndShaderVariants()
+{
+	if (m_baseProgram == 0)
+	{
+		return;
+	}
+
+	if (m_activeProgram != m_baseProgram)
+	{
+		m_pShaderManager->m_programID = m_baseProgram;
+		m_pShaderManager->use();
+	}
+	m_baseProgram = 0;
+	m_activeProgram = 0;
+}
+
+/***********************************************************
+ *  SaveSceneFile()
+ *
+ *  This method is used for writing the data driven scene,
+ *  with the loaded textures, to a scene file.  The built-in
+ *  scene is drawn by code and cannot be saved.
+ ***********************************************************/
+bool SceneManager::SaveSceneFile(const char* filename) const
+{
+	CPU_PROFILE_ZONE("SceneManager::SaveSceneFile");
+
+	if (m_sceneObjectCount == 0)
+	{
+		std::cout << "Could not save scene file, only generated or loaded scenes can be saved:" << filename << std::endl;
+		return(false);
+	}
+
+	std::vector<TEXTURE_FILE> textures(m_loadedTextures);
+	for (int i = 0; i < m_loadedTextures; i++)
+	{
+		textures[i].filename = m_textureIDs[i].filename;
+		textures[i].tag = m_textureIDs[i].tag;
+	}
+
+	SceneFile sceneFile;
+	sceneFile.SetContents(textures, m_objectMaterials, m_sceneLights, m_pSceneObjects, m_sceneObjectCount);
+
+	bool bResult = sceneFile.Save(filename);
+	if (bResult == true)
+	{
+		std::cout << "INFO: Scene written to " << filename << std::endl;
+	}
+
+	return(bResult);
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for passing the material values
+ *  into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	std::string materialTag)
+{
+	CPU_PROFILE_ZONE("SceneManager::SetShaderMaterial");
+
+	if (m_objectMaterials.size() > 0)
+	{
+		OBJECT_MATERIAL material;
+		material.samplerFilter = filter_default;
+		material.samplerWrap = wrap_repeat;
+		bool bReturn = false;
+
+		bReturn = FindMaterial(materialTag, material);
+		if (bReturn == true)
+		{
+			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
+			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
+			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
+			SetMaterialSampler(material);
+			m_renderStats.materialChanges++;
+		}
+	}
+}
+
+/**************************************************************/
+/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
+/*** preparing and rendering their own 3D replicated scenes.***/
+/*** Please refer to the code in the OpenGL sample project  ***/
+/*** for assistance.                                        ***/
+/**************************************************************/
+
+//***Added from OpenGLSample
+/***********************************************************
+ *  LoadSceneTextures()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene
+ *  rendering
+ ***********************************************************/
+
+void SceneManager::LoadSceneTextures()
+{
+	CPU_PROFILE_ZONE("SceneManager::LoadSceneTextures");
+
+	// image files and the tags they are registered under
+	const std::vector<TEXTURE_FILE> textureFiles = {
+		// Added Wood texture to make plane look like a table
+		{ "textures/wood_cherry_seamless.jpg", "Wood Table" },
+		{ "textures/ERainbowOverlay2.png", "Cylinder Overlay" },
+		{ "textures/VaseStripes2.png", "Stripes2" },
+		{ "textures/wood_black_seamless.jpg", "Black Wood" },
+		{ "textures/transparent.png", "transparent" },
+		{ "textures/GoldLeaves.png", "Gold Leaves" },
+		{ "textures/GoldLeavesSides.png", "Gold Leaves2" },
+		{ "textures/CandleHolder.png", "Candle Holder" },
+		{ "textures/WetGlass.jpg", "Wet Glass" },
+		{ "textures/pumpkin_texture3.jpg", "Pumpkin3" },
+		{ "textures/Pumpkinbark.jpg", "Stem" },
+		{ "textures/bricks_weathered_seamless2.jpg", "backdrop2" }
+	};
+
+	LoadTextureFiles(textureFiles);
+}
+
+//***Added
+/***********************************************************
+ *  DefineObjectMaterials()
+ *
+ *  This method is used for configuring the various material
+ *  settings for all of the objects within the 3D scene.
+ ***********************************************************/
+void SceneManager::DefineObjectMaterials()
+{
+	CPU_PROFILE_ZONE("SceneManager::DefineObjectMaterials");
+
+	// Metal
+	OBJECT_MATERIAL metalMaterial;
+	metalMaterial.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f);
+	metalMaterial.specularColor = glm::vec3(0.7f, 0.7f, 0.7f);
+	metalMaterial.shininess = 42.0;
+	metalMaterial.samplerFilter = filter_default;
+	metalMaterial.samplerWrap = wrap_repeat;
+	metalMaterial.tag = "metal";
+
+	m_objectMaterials.push_back(metalMaterial);
+
+	// Wood
+	OBJECT_MATERIAL woodMaterial;
+	woodMaterial.diffuseColor = glm::vec3(0.6f, 0.35f, 0.2f);
+	woodMaterial.specularColor = glm::vec3(0.2f, 0.2f, 0.2f);
+	woodMaterial.shininess = 8.0f;
+	woodMaterial.samplerFilter = filter_default;
+	woodMaterial.samplerWrap = wrap_repeat;
+	woodMaterial.tag = "wood";
+
+	m_objectMaterials.push_back(woodMaterial);
+
+	//Glass
+	OBJECT_MATERIAL glassMaterial;
+	glassMaterial.diffuseColor = glm::vec3(0.4f, 0.4f, 0.5f);
+	glassMaterial.specularColor = glm::vec3(1.0f, 1.0f, 1.0f);
+	glassMaterial.shininess = 95.0;
+	glassMaterial.samplerFilter = filter_default;
+	glassMaterial.samplerWrap = wrap_repeat;
+	glassMaterial.tag = "glass";
+
+	m_objectMaterials.push_back(glassMaterial);
+
+	//Gold
+	OBJECT_MATERIAL goldMaterial;
+	goldMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.2f);
+	goldMaterial.specularColor = glm::vec3(0.6f, 0.5f, 0.4f);
+	goldMaterial.shininess = 22.0;
+	goldMaterial.samplerFilter = filter_default;
+	goldMaterial.samplerWrap = wrap_repeat;
+	goldMaterial.tag = "gold";
+
+	m_objectMaterials.push_back(goldMaterial);
+
+	//Tile
+	OBJECT_MATERIAL tileMaterial;
+	tileMaterial.diffuseColor = glm::vec3(0.3f, 0.2f, 0.1f);
+	tileMaterial.specularColor = glm::vec3(0.4f, 0.5f, 0.6f);
+	tileMaterial.shininess = 25.0;
+	tileMaterial.samplerFilter = filter_default;
+	tileMaterial.samplerWrap = wrap_repeat;
+	tileMaterial.tag = "tile";
+
+	m_objectMaterials.push_back(tileMaterial);
+
+	OBJECT_MATERIAL backdropMaterial;
+	backdropMaterial.diffuseColor = glm::vec3(0.4f, 0.4f, 0.4f);
+	backdropMaterial.specularColor = glm::vec3(0.0f, 0.0f, 0.0f);
+	backdropMaterial.shininess = .02;
+	backdropMaterial.samplerFilter = filter_default;
+	backdropMaterial.samplerWrap = wrap_repeat;
+	backdropMaterial.tag = "backdrop";
+
+	m_objectMaterials.push_back(backdropMaterial);
+
+	MarkSceneChanged();
+}
+
+/***********************************************************
+ *  SetupSceneLights()
+ *
+ *  This method is called to add and configure the light
+ *  sources for the 3D scene.  There are up to 4 light sources.
+ ***********************************************************/
+void SceneManager::SetupSceneLights()
+{
+	CPU_PROFILE_ZONE("SceneManager::SetupSceneLights");
+
+	// this line of code is NEEDED for telling the shaders to render 
+	// the 3D scene with custom lighting - to use the default rendered 
+	// lighting then comment out the following line
+	m_pShaderManager->setBoolValue(g_UseLightingName, true);
+	m_variantFlags |= ShaderVariants::variant_lighting;
+
+	// directional light to emulate sunlight coming into scene
+	m_pShaderManager->setVec3Value("directionalLight.direction", -0.1f, -0.3f, -0.2f);
+	m_pShaderManager->setVec3Value("directionalLight.ambient", 0.5f, 0.5f, 0.5f);
+	m_pShaderManager->setVec3Value("directionalLight.diffuse", 0.25f, 0.25f, 0.30f);
+	m_pShaderManager->setVec3Value("directionalLight.specular", 0.05f, 0.05f, 0.05f);
+	m_pShaderManager->setBoolValue("directionalLight.bActive", true);
+
+
+	///****************************************************************/
+	//light 0 - above the scene
+	m_pShaderManager->setVec3Value("pointLights[0].position", 0.0f, 5.0f, 0.0f);
+	m_pShaderManager->setVec3Value("pointLights[0].ambient", 0.15f, 0.15f, 0.15f);
+	m_pShaderManager->setVec3Value("pointLights[0].diffuse", 0.5f, 0.5f, 0.5f);
+	m_pShaderManager->setVec3Value("pointLights[0].specular", 0.5f, 0.5f, 0.5f);
+	m_pShaderManager->setBoolValue("pointLights[0].bActive", true);
+	
+	//point light 1
+	m_pShaderManager->setVec3Value("pointLights[1].position", -3.0f, 7.0f, -3.0f);
+	m_pShaderManager->setVec3Value("pointLights[1].ambient", 0.05f, 0.05f, 0.05f);
+	m_pShaderManager->setVec3Value("pointLights[1].diffuse", 0.4f, 0.3f, 0.4f);
+	m_pShaderManager->setVec3Value("pointLights[1].specular", 0.2f, 0.2f, 0.2f);
+	m_pShaderManager->setBoolValue("pointLights[1].bActive", true); 
+
+	//point light 2
+	m_pShaderManager->setVec3Value("pointLights[2].position", -3.0f, 7.0f, 3.0f);
+	m_pShaderManager->setVec3Value("pointLights[2].ambient", 0.05f, 0.05f, 0.05f);
+	m_pShaderManager->setVec3Value("pointLights[2].diffuse", 0.4f, 0.3f, 0.4f);
+	m_pShaderManager->setVec3Value("pointLights[2].specular", 0.2f, 0.3f, 0.2f);
+	m_pShaderManager->setBoolValue("pointLights[2].bActive", true); 
+	
+	//point light 3
+	m_pShaderManager->setVec3Value("pointLights[3].position", 0.0f, 2.0f, -7.0f);
+	m_pShaderManager->setVec3Value("pointLights[3].ambient", 0.05f, 0.05f, 0.05f);
+	m_pShaderManager->setVec3Value("pointLights[3].diffuse", 0.5f, 0.5f, .5f);
+	m_pShaderManager->setVec3Value("pointLights[3].specular", 0.1f, 0.1f, 0.1f);
+	m_pShaderManager->setBoolValue("pointLights[3].bActive", true);
+
+	//point light 4
+	m_pShaderManager->setVec3Value("pointLights[4].position", 3.2f, 6.0f, 4.0f);
+	m_pShaderManager->setVec3Value("pointLights[4].ambient", 0.05f, 0.05f, 0.05f);
+	m_pShaderManager->setVec3Value("pointLights[4].diffuse", 0.5f, 0.5f, 0.5f);
+	m_pShaderManager->setVec3Value("pointLights[4].specular", 0.1f, 0.1f, 0.1f);
+	m_pShaderManager->setBoolValue("pointLights[4].bActive", true);
+	
+	
+	m_pShaderManager->setVec3Value("spotLight.ambient", 0.3f, 0.3f, 0.3f);
+	m_pShaderManager->setVec3Value("spotLight.diffuse", 0.8f, 0.8f, 0.8f);
+	m_pShaderManager->setVec3Value("spotLight.specular", 0.4f, 0.4f, 0.4f);
+	m_pShaderManager->setFloatValue("spotLight.constant", 1.0f);
+	m_pShaderManager->setFloatValue("spotLight.linear", 0.09f);
+	m_pShaderManager->setFloatValue("spotLight.quadratic", 0.032f);
+	m_pShaderManager->setFloatValue("spotLight.cutOff", glm::cos(glm::radians(42.5f)));
+	m_pShaderManager->setFloatValue("spotLight.outerCutOff", glm::cos(glm::radians(48.0f)));
+	m_pShaderManager->setBoolValue("spotLight.bActive", true);
+	m_pointLightCount = 5;
+
+	MarkSceneChanged();
+}
+/***********************************************************
+ *  PrepareScene()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering
+ ***********************************************************/
+void SceneManager::PrepareScene()
+{
+	CPU_PROFILE_ZONE("SceneManager::PrepareScene");
+
+	// only one instance of a particular mesh needs to be
+	// loaded in memory no matter how many times it is drawn
+	// in the rendered 3D scene
+
+	m_basicMeshes->LoadPlaneMesh();
+	//Shapes Added
+	m_basicMeshes->LoadBoxMesh(); 
+	m_basicMeshes->LoadSphereMesh();
+	m_basicMeshes->LoadCylinderMesh();
+	m_basicMeshes->LoadTorusMesh();
+	m_basicMeshes->LoadTaperedCylinderMesh();
+
+	// load the texture image files for the textures applied
+	// to objects in the 3D scene
+	LoadSceneTextures();
+	BindGLTextures();
+
+	// define the materials that will be used for the objects
+	// in the 3D scene
+	DefineObjectMaterials();
+
+	// add and defile the light sources for the 3D scene
+	SetupSceneLights();
+}
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene by 
+ *  transforming and drawing the basic 3D shapes
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+	CPU_PROFILE_ZONE("SceneManager::RenderScene");
+
+	UpdateTextureStreaming();
+
+	// the atlas needs a program that offsets the texture
+	// coordinates; the sampler is set again on the first draw
+	m_bAtlasActive = (NULL != m_pTextureAtlas) &&
+		(m_pTextureAtlas->GetRegionCount() > 0) &&
+		(glGetUniformLocation(m_pShaderManager->m_programID, g_UVOffsetName) >= 0);
+	m_boundTextureUnit = -1;
+	BeginShaderVariants();
+
+	// a generated or loaded scene replaces the built-in one
+	if (m_sceneObjectCount > 0)
+	{
+		GPU_PROFILE_SCOPE("Scene Objects");
+		RenderSceneObjects();
+	}
+	else if (m_sceneViews.empty() == false)
+	{
+		// the built-in scene is drawn by code, so the code runs
+		// again for every view
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		for (int i = 0; i < (int)m_sceneViews.size(); i++)
+		{
+			GPU_PROFILE_SCOPE(VIEW_SCOPE_NAMES[i]);
+			ApplySceneView(i);
+			RenderBuiltInScene();
+		}
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	}
+	else
+	{
+		RenderBuiltInScene();
+	}
+
+	EndShaderVariants();
+}
+
+/***********************************************************
+ *  RenderBuiltInScene()
+ *
+ *  This method is used for drawing the built-in scene by
+ *  transforming and drawing the basic 3D shapes
+ ***********************************************************/
+void SceneManager::RenderBuiltInScene()
+{
+	// each group of objects is timed as its own GPU profiler scope
+	GPUProfiler& profiler = GPUProfiler::Get();
+	profiler.BeginScope("Table");
+
+	// declare the variables for the transformations
+	glm::vec3 scaleXYZ;
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ;
+
+	/*** Set needed transformations before drawing the basic mesh.  ***/
+	/*** This same ordering of code should be used for transforming ***/
+	/*** and drawing all the basic 3D shapes.						***/
+	/******************************************************************/
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(30.0f, 1.0f, 10.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.0f, -0.5f, 0.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	// Bottom plane for the scene � represents the coffee table surface
+	//*** Added texture to plane
+	SetShaderTexture("Wood Table");
+	SetTextureUVScale(1.0, 1.0);
+
+	//material
+	SetShaderMaterial("wood");
+
+	// draw the mesh with transformation values
+	m_basicMeshes->DrawBoxMesh();
+	m_renderStats.drawCalls++;
+
+	/****************************************************************/
+
+	profiler.EndScope();
+	profiler.BeginScope("Backdrop");
+
+	//***Backdrop - added 12/12
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(20.0f, 1.0f, 10.0f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(0.0f, 10.0f, -5.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//texture
+	SetShaderTexture("backdrop2");
+	SetTextureUVScale(1.0, 1.0);
+
+	//material
+	SetShaderMaterial("backdrop");
+
+	// draw the mesh with transformation values - this plane is used for the backdrop
+	m_basicMeshes->DrawPlaneMesh();
+	m_renderStats.drawCalls++;
+
+
+	/****************************************************************/
+	//***Objects Start Here
+	
+	profiler.EndScope();
+	profiler.BeginScope("Candle Holder");
+
+	// ***Glass Candle Holder
+	//Base of Candle
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.3f, 1.35f, 0.7f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 90.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(6.0f, 0.2f, 0.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//texture
+	SetShaderTexture("Wet Glass");
+	SetTextureUVScale(0.2f, 0.2f);
+	//material
+	SetShaderMaterial("glass");
+	// draw the mesh with transformation values
+	m_basicMeshes->DrawTorusMesh();
+	m_renderStats.drawCalls++;
+
+
+	// Body of Candle
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.4f, 1.6f, 1.4f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = -10.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(6.0f, 0.3f, 0.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//***Complex Texturing Technique - Overlay option
+	//base texture for the cylinder 
+	SetShaderTexture("Candle Holder");
+
+	//overlay texture for cylinder
+	SetShaderTextureOverlay("Cylinder Overlay");
+
+	//uv scale for both textures 
+	SetTextureUVScale(2.0f, 1.0f);
+
+	//material
+	SetShaderMaterial("glass");
+
+	//apply the texture and overlay to the sides only
+	m_basicMeshes->DrawCylinderMesh(false, false, true);
+	m_renderStats.drawCalls++;
+
+	//disable the texture overlay
+	SetShaderTextureOverlay("");
+
+
+	// Rounded Top/Dome of candle holder
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.37f, 1.37f, 1.37f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 15.0f;
+	YrotationDegrees = 20.0f;
+	ZrotationDegrees = 90.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(6.0f, 2.0f, 0.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//SetShaderColor(0.467, 0.533, 0.600, 1);
+	SetShaderTexture("Candle Holder");
+	SetTextureUVScale(0.8f, 0.8);
+	//material
+	SetShaderMaterial("glass");
+
+	// draw the mesh with transformation values
+	m_basicMeshes->DrawSphereMesh();
+	m_renderStats.drawCalls++;
+
+
+	// Candle Holder knob
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(0.3f, 0.5f, 0.3f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(6.0f, 3.5f, 0.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//texture
+	SetShaderTexture("Candle Holder");
+	SetTextureUVScale(0.8f, 0.8f);
+
+	//material
+	SetShaderMaterial("glass");
+
+	// draw the mesh with transformation values
+	m_basicMeshes->DrawSphereMesh();
+	m_renderStats.drawCalls++;
+
+
+
+	/****************************************************************/
+	profiler.EndScope();
+	profiler.BeginScope("Vase");
+
+	//*** Vase
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(1.2f, 7.0f, 1.2f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(2.0f, 0.2f, -0.8f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//sides, stripes
+	SetShaderTexture("Stripes2");
+	SetTextureUVScale(1.0f, 1.0f);
+
+	//material
+	SetShaderMaterial("glass");
+	m_basicMeshes->DrawCylinderMesh(false, false, true); //sides only
+	m_renderStats.drawCalls++;
+
+	//top, transparent
+	SetShaderTexture("transparent"); //created transparent texture for glass
+	SetTextureUVScale(1.0f, 1.0f);
+	m_basicMeshes->DrawCylinderMesh(true, false, false); //top only
+	m_renderStats.drawCalls++;
+
+	//bottom, dark base
+	SetShaderTexture("Black Wood");
+	SetTextureUVScale(1.0f, 1.0f);
+
+	//material
+	SetShaderMaterial("wood");
+	m_basicMeshes->DrawCylinderMesh(false, true, false); //bottom only
+	m_renderStats.drawCalls++;
+
+
+	/****************************************************************/
+	profiler.EndScope();
+	profiler.BeginScope("Picture Frame");
+
+	//*** Picture Frame
+	
+	//picture inside Frame
+	// ***Complex Texturing Technique - Applying different colors to each side of the box
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(4.0f, 5.0f, 0.1f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = -20.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-2.0f, 2.5f, 0.0f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//front of picture = light tan to represent blank picture
+	SetShaderColor(0.95f, 0.90f, 0.80f, 1.0f);
+	m_basicMeshes->DrawBoxMeshSide(ShapeMeshes::box_front);
+	m_renderStats.drawCalls++;
+
+	//other sides of picture = gold like the frame so they are not visble from side/top views
+	SetShaderColor(0.65f, 0.45f, 0.20f, 1.0f);
+	m_basicMeshes->DrawBoxMeshSide(ShapeMeshes::box_back);
+	m_renderStats.drawCalls++;
+	m_basicMeshes->DrawBoxMeshSide(ShapeMeshes::box_left);
+	m_renderStats.drawCalls++;
+	m_basicMeshes->DrawBoxMeshSide(ShapeMeshes::box_right);
+	m_renderStats.drawCalls++;
+	m_basicMeshes->DrawBoxMeshSide(ShapeMeshes::box_top);
+	m_renderStats.drawCalls++;
+	m_basicMeshes->DrawBoxMeshSide(ShapeMeshes::box_bottom);
+	m_renderStats.drawCalls++;
+
+	//material
+	SetShaderMaterial("wood");
+
+
+	//Back of Picture frame
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(4.0f, 5.0f, 0.1f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = -20.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-2.0f, 2.5f, -0.1f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+
+	//gold color for back of frame
+	SetShaderColor(0.65f, 0.45f, 0.20f, 1.0f);
+	SetShaderMaterial("wood");
+	m_basicMeshes->DrawBoxMesh();
+	m_renderStats.drawCalls++;
+
+	//top frame piece
+	scaleXYZ = glm::vec3(4.1f, 0.7f, 0.15f);
+	XrotationDegrees = -20.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	positionXYZ = glm::vec3(-2.0f, 4.6f, -0.7f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//texture
+	SetShaderTexture("Gold Leaves");
+	SetTextureUVScale(0.9f, 0.3f);
+	SetShaderMaterial("gold");
+	m_basicMeshes->DrawBoxMesh();
+	m_renderStats.drawCalls++;
+
+	//bottom frame piece
+	scaleXYZ = glm::vec3(4.1f, 0.7f, 0.15f);
+	XrotationDegrees = 20.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 180.0f;
+	positionXYZ = glm::vec3(-2.0f, 0.5f, 0.8f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//texture
+	SetShaderTexture("Gold Leaves");
+	SetTextureUVScale(0.9f, 0.3f);
+	SetShaderMaterial("gold");
+	m_basicMeshes->DrawBoxMesh();
+	m_renderStats.drawCalls++;
+
+	//left frame piece
+	scaleXYZ = glm::vec3(0.7f, 3.8f, 0.10f);   
+	XrotationDegrees = 20.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 180.0f;
+	positionXYZ = glm::vec3(-3.7f, 2.6f, 0.05f);   
+	
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//texture
+	SetShaderTexture("Gold Leaves2");
+	SetTextureUVScale(0.3f, 0.9f);
+	SetShaderMaterial("gold");
+	m_basicMeshes->DrawBoxMesh();
+	m_renderStats.drawCalls++;
+
+
+	//right frame piece
+	scaleXYZ = glm::vec3(0.7f, 3.8f, 0.10f);
+	XrotationDegrees = -20.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 0.0f;
+	positionXYZ = glm::vec3(-0.3f, 2.6f, 0.05f);  
+	
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//texture
+	SetShaderTexture("Gold Leaves2");
+	SetTextureUVScale(0.3f, 0.9f);
+	SetShaderMaterial("gold");
+	m_basicMeshes->DrawBoxMesh();
+	m_renderStats.drawCalls++;
+
+	//back stand piece
+	scaleXYZ = glm::vec3(0.7f, 3.0f, 0.1f);
+	XrotationDegrees = 30.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = 00.0f;
+	positionXYZ = glm::vec3(-1.5f, 1.5f, -1.0f);
+	
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//texture
+	SetShaderColor(0.65f, 0.45f, 0.20f, 1.0f);
+
+	//material
+	SetShaderMaterial("wood");
+
+	m_basicMeshes->DrawBoxMesh();
+	m_renderStats.drawCalls++;
+
+	/****************************************************************/
+	profiler.EndScope();
+	profiler.BeginScope("Pumpkin");
+
+	//***Pumpkin
+	//Base of Pumpkin
+	// set the XYZ scale for the mesh
+	scaleXYZ = glm::vec3(2.1f, 1.8f, 1.5f);
+
+	// set the XYZ rotation for the mesh
+	XrotationDegrees = 0.0f;
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = -35.0f;
+
+	// set the XYZ position for the mesh
+	positionXYZ = glm::vec3(-7.0f, 1.4f, -0.3f);
+
+	// set the transformations into memory to be used on the drawn meshes
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//texture
+	SetShaderTexture("Pumpkin3");  //closest I could get to getting a pumpkin texture to wrap :(
+	SetTextureUVScale(1.0f, 1.0f);
+	
+	//material
+	SetShaderMaterial("glass");
+
+	// draw the mesh with transformation values
+	m_basicMeshes->DrawSphereMesh();
+	m_renderStats.drawCalls++;
+
+
+	//Pumpkin stem  
+	scaleXYZ = glm::vec3(0.5f, 0.7f, 0.5f);
+	XrotationDegrees = 0.0f;    
+	YrotationDegrees = 0.0f;
+	ZrotationDegrees = -10.0f;
+
+	//sit on top of the pumpkin body
+	positionXYZ = glm::vec3(-7.1f, 3.1f, -0.3f);
+
+	SetTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	//texture
+	SetShaderTexture("Stem");
+	SetTextureUVScale(1.0f, 1.0f);
+
+	//material
+	SetShaderMaterial("wood");
+
+	// draw the mesh with transformation values
+	m_basicMeshes->DrawTaperedCylinderMesh();
+	m_renderStats.drawCalls++;
+
+	profiler.EndScope();
+}
@@ -1,119 +1,499 @@
-///////////////////////////////////////////////////////////////////////////////
-// scenemanager.h
-// ============
-// manage the preparing and rendering of 3D scenes - textures, materials, lighting
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "ShapeMeshes.h"
-
-#include <string>
-#include <vector>
-
-/***********************************************************
- *  SceneManager
- *
- *  This class contains the code for preparing and rendering
- *  3D scenes, including the shader settings.
- ***********************************************************/
-class SceneManager
-{
-public:
-	// constructor
-	SceneManager(ShaderManager *pShaderManager);
-	// destructor
-	~SceneManager();
-
-	struct TEXTURE_INFO
-	{
-		std::string tag;
-		uint32_t ID;
-	};
-
-	struct OBJECT_MATERIAL
-	{
-		glm::vec3 diffuseColor;
-		glm::vec3 specularColor;
-		float shininess;
-		std::string tag;
-	};
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// pointer to basic shapes object
-	ShapeMeshes* m_basicMeshes;
-	// total number of loaded textures
-	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
-	// defined object materials
-	std::vector<OBJECT_MATERIAL> m_objectMaterials;
-
-	// load texture images and convert to OpenGL texture data
-	bool CreateGLTexture(const char* filename, std::string tag);
-	// bind loaded OpenGL textures to slots in memory
-	void BindGLTextures();
-	// free the loaded OpenGL textures
-	void DestroyGLTextures();
-	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
-	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
-
-	// set the transformation values 
-	// into the transform buffer
-	void SetTransformations(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
-
-	// set the color values into the shader
-	void SetShaderColor(
-		float redColorValue,
-		float greenColorValue,
-		float blueColorValue,
-		float alphaValue);
-
-	// set the texture data into the shader
-	void SetShaderTexture(
-		std::string textureTag);
-
-	//***Added from OpenGLSample
-	// set the overlay texture data into the shader
-	void SetShaderTextureOverlay(
-		std::string textureTag);
-
-	// set the UV scale for the texture mapping
-	void SetTextureUVScale(
-		float u, float v);
-
-	// set the object material into the shader
-	void SetShaderMaterial(
-		std::string materialTag);
-
-public:
-
-	// The following methods are for the students to 
-	// customize for their own 3D scene
-	void PrepareScene();
-	void RenderScene();
-
-	//***Added from OpenGLSample
-	// load all of the needed textures before rendering
-	void LoadSceneTextures();
-
-	//***Added
-	void DefineObjectMaterials();
-	// add and define the light sources before rendering
-	void SetupSceneLights();
-
+///////////////////////////////////////////////////////////////////////////////
+// scenemanager.h
+// ============
+// manage the preparing and rendering of 3D scenes - textures, materials, lighting
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "ShapeMeshes.h"
+#include "JobSystem.h"
+#include "PrimitiveLibrary.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class MeshLibrary;
+class SamplerCache;
+class SceneFile;
+class ShaderVariants;
+class TextureAtlas;
+class TextureStreamer;
+
+/***********************************************************
+ *  SceneManager
+ *
+ *  This class contains the code for preparing and rendering
+ *  3D scenes, including the shader settings.
+ ***********************************************************/
+class SceneManager
+{
+public:
+	// constructor
+	SceneManager(ShaderManager *pShaderManager);
+	// destructor
+	~SceneManager();
+
+	struct TEXTURE_INFO
+	{
+		std::string tag;
+		uint32_t ID;
+		std::string filename;
+	};
+
+	// an image file to load as a texture, and its tag
+	struct TEXTURE_FILE
+	{
+		std::string filename;
+		std::string tag;
+	};
+
+	// texture filtering of a material - the default is the
+	// filter chosen for the whole scene
+	enum SAMPLER_FILTER
+	{
+		filter_default,
+		filter_bilinear,
+		filter_trilinear,
+		filter_anisotropic,
+		filter_count
+	};
+
+	// texture coordinate wrapping of a material
+	enum SAMPLER_WRAP
+	{
+		wrap_repeat,
+		wrap_clamp,
+		wrap_count
+	};
+
+	struct OBJECT_MATERIAL
+	{
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float shininess;
+		// how the textures drawn with the material are sampled
+		int samplerFilter;
+		int samplerWrap;
+		std::string tag;
+	};
+
+	// basic shape meshes that scene objects can be drawn with
+	enum MESH_TYPE
+	{
+		mesh_plane,
+		mesh_box,
+		mesh_sphere,
+		mesh_cylinder,
+		mesh_torus,
+		mesh_tapered_cylinder,
+		// meshes of the mesh library follow, from
+		// mesh_type_count + the library index
+		mesh_type_count
+	};
+
+	// a single drawn object of a data driven scene
+	struct SCENE_OBJECT
+	{
+		int meshType;
+		// transformation values, as passed to SetTransformations()
+		glm::vec3 scaleXYZ;
+		glm::vec3 rotationDegrees;
+		glm::vec3 positionXYZ;
+		// world space bounding sphere used for culling
+		glm::vec3 center;
+		float radius;
+		// loaded texture slot, or -1 to draw with the color
+		int textureSlot;
+		glm::vec4 color;
+		glm::vec2 uvScale;
+		// index into the defined object materials
+		int materialIndex;
+	};
+
+	// an image file read into memory, not yet uploaded
+	struct TEXTURE_IMAGE
+	{
+		std::string filename;
+		unsigned char* pixels;
+		int width;
+		int height;
+		int colorChannels;
+	};
+
+	// a point light of a data driven scene
+	struct SCENE_LIGHT
+	{
+		glm::vec3 position;
+		glm::vec3 ambient;
+		glm::vec3 diffuse;
+		glm::vec3 specular;
+	};
+
+	// everything needed to draw one visible scene object,
+	// prepared during the build phase of a frame
+	struct DRAW_PACKET
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+		glm::vec2 uvScale;
+		int meshType;
+		int textureSlot;
+		int materialIndex;
+		// screen pixels one repeat of the texture covers
+		float texturePixels;
+		// bit per scene view the object is visible in
+		unsigned int viewMask;
+	};
+
+	// sort entry of a draw packet - the key orders packets by
+	// shader variant, then texture or atlas page, then material,
+	// then mesh; the reference holds the builder list in the
+	// top 8 bits and the packet index below
+	struct DRAW_SORT_ENTRY
+	{
+		uint64_t key;
+		uint32_t reference;
+	};
+
+	// per-frame counts of draws and shader state changes, and
+	// the time spent building and submitting scene objects
+	struct RENDER_STATS
+	{
+		int drawCalls;
+		int transformChanges;
+		int textureChanges;
+		int materialChanges;
+		int colorChanges;
+		int programChanges;
+		int samplerChanges;
+		int culledObjects;
+		double buildMs;
+		double submitMs;
+	};
+
+	// a camera and the part of the framebuffer it is drawn
+	// into, for showing the scene from several cameras at once
+	struct SCENE_VIEW
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec3 position;
+		int x;
+		int y;
+		int width;
+		int height;
+	};
+
+	// most views a frame can be drawn into
+	static const int MAX_SCENE_VIEWS = 8;
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// pointer to basic shapes object
+	ShapeMeshes* m_basicMeshes;
+	// total number of loaded textures
+	int m_loadedTextures;
+	// loaded textures info
+	TEXTURE_INFO m_textureIDs[16];
+	// defined object materials
+	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// draw and state change counts since the last reset
+	RENDER_STATS m_renderStats;
+	// raised whenever lights, materials or scene objects change
+	unsigned int m_changeCount;
+	// objects of a generated or edited data driven scene
+	std::vector<SCENE_OBJECT> m_sceneObjects;
+	// objects drawn - the list above, or the objects of a loaded
+	// scene file, used in place; none for the built-in scene
+	const SCENE_OBJECT* m_pSceneObjects;
+	int m_sceneObjectCount;
+	// loaded scene file, kept open while its objects are drawn
+	SceneFile* m_pSceneFile;
+	// point lights of the data driven scene
+	std::vector<SCENE_LIGHT> m_sceneLights;
+	// job system used to build the draw packets in parallel
+	JobSystem* m_pJobSystem;
+	// draw packets, sort entries and culled counts per builder
+	std::vector<std::vector<DRAW_PACKET>> m_threadDrawLists;
+	std::vector<std::vector<DRAW_SORT_ENTRY>> m_threadSortLists;
+	std::vector<int> m_threadCulledCounts;
+	// merged sort entries of all builders
+	std::vector<DRAW_SORT_ENTRY> m_sortedDraws;
+	// view frustum planes used for culling the scene objects
+	glm::vec4 m_frustumPlanes[6];
+	bool m_bFrustumValid;
+	// true when the projections map depth in reverse to the
+	// zero to one clip range
+	bool m_bReverseDepth;
+	// views of the next frame and six frustum planes for each,
+	// none when the frame is drawn into the current viewport
+	std::vector<SCENE_VIEW> m_sceneViews;
+	std::vector<glm::vec4> m_viewFrustumPlanes;
+	// specialized programs drawn with instead of the main one
+	ShaderVariants* m_pShaderVariants;
+	// switches of the variant the next draw needs, and the
+	// number of point lights switched on
+	unsigned int m_variantFlags;
+	int m_pointLightCount;
+	// main program while a frame is drawn, and the program in use
+	GLuint m_baseProgram;
+	GLuint m_activeProgram;
+	// streams the mip levels of the textures, when set
+	TextureStreamer* m_pTextureStreamer;
+	// bounds and textures of the object the built-in scene is
+	// drawing, for the texture streaming
+	glm::vec3 m_drawCenter;
+	float m_drawRadius;
+	int m_drawTextureSlot;
+	int m_drawOverlaySlot;
+	// small textures packed together, when set
+	TextureAtlas* m_pTextureAtlas;
+	// true while the program maps texture coordinates with an
+	// offset, so the atlas can be drawn from
+	bool m_bAtlasActive;
+	// texture unit the object texture sampler is set to, and
+	// the UV scale of the textured object being drawn
+	int m_boundTextureUnit;
+	glm::vec2 m_textureUVScale;
+	bool m_bTextureFromAtlas;
+	// sampler objects bound from the material, when set, and
+	// the presets of the material in use
+	SamplerCache* m_pSamplerCache;
+	int m_materialFilter;
+	int m_materialWrap;
+	// imported meshes drawn after the basic shapes, when set
+	const MeshLibrary* m_pMeshLibrary;
+	// shared generated basic shapes the scene objects are drawn
+	// with, when acquired
+	const MeshLibrary* m_pPrimitiveLibrary;
+
+	// load texture images and convert to OpenGL texture data
+	bool CreateGLTexture(const char* filename, std::string tag);
+	// create an OpenGL texture object from a decoded image
+	GLuint CreateTextureObject(const TEXTURE_IMAGE& image);
+	// create an OpenGL texture from a decoded image and
+	// register it in the next free slot
+	bool UploadGLTexture(TEXTURE_IMAGE& image, std::string tag);
+	// bind loaded OpenGL textures to slots in memory
+	void BindGLTextures();
+	// free the loaded OpenGL textures
+	void DestroyGLTextures();
+	// load a list of image files into the next texture slots,
+	// decoding them in parallel when a job system is set
+	void LoadTextureFiles(const std::vector<TEXTURE_FILE>& textureFiles);
+	// find a loaded texture by tag
+	int FindTextureID(std::string tag);
+	int FindTextureSlot(std::string tag);
+	// find a defined material by tag
+	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
+
+	// compose the model matrix from the transformation values
+	static glm::mat4 ComputeModelMatrix(
+		const glm::vec3& scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		const glm::vec3& positionXYZ);
+
+	// set the transformation values 
+	// into the transform buffer
+	void SetTransformations(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// set the color values into the shader
+	void SetShaderColor(
+		float redColorValue,
+		float greenColorValue,
+		float blueColorValue,
+		float alphaValue);
+
+	// set the texture data into the shader
+	void SetShaderTexture(
+		std::string textureTag);
+
+	//***Added from OpenGLSample
+	// set the overlay texture data into the shader
+	void SetShaderTextureOverlay(
+		std::string textureTag);
+
+	// set the UV scale for the texture mapping
+	void SetTextureUVScale(
+		float u, float v);
+	// get the atlas region a slot drawn with the UV scale can
+	// use - false when it must use its own texture
+	bool FindAtlasRegion(int slot, const glm::vec2& uvScale, glm::vec2& offset, glm::vec2& scale, int& unit) const;
+	// point the texture sampler at a slot, or at its atlas
+	// region, and set the UV transform - true when drawn from
+	// the atlas
+	bool BindTextureSlot(int slot, const glm::vec2& uvScale);
+	// use the presets of a material for the textures drawn next
+	void SetMaterialSampler(const OBJECT_MATERIAL& material);
+	// bind the samplers of the material to the texture units
+	// of the object and overlay textures
+	void BindTextureSamplers();
+
+	// set the object material into the shader
+	void SetShaderMaterial(
+		std::string materialTag);
+
+	// draw one of the basic shape meshes
+	void DrawMesh(int meshType);
+	// the library and library index a mesh type is drawn from -
+	// false for the basic shapes of the shape meshes
+	bool FindLibraryMesh(int meshType, const MeshLibrary*& pLibrary, int& index) const;
+	// test a bounding sphere against the view frustum
+	bool IsSphereVisible(const glm::vec3& center, float radius) const;
+	// bit per scene view whose frustum a bounding sphere is at
+	// least partially inside - bit 0 alone without views
+	unsigned int GetVisibleViews(const glm::vec3& center, float radius) const;
+	// cull and draw the objects of the data driven scene
+	void RenderSceneObjects();
+	// draw the built-in scene
+	void RenderBuiltInScene();
+	// build phase - cull objects and write draw packets, in
+	// parallel when a job system is set
+	void BuildDrawPackets();
+	// merge the sort entries of every builder and sort them
+	void SortDrawPackets();
+	// submit phase - draw the sorted packets visible in the
+	// views of the mask on the OpenGL thread
+	void SubmitDrawPackets(unsigned int viewMask);
+	// set the viewport and camera of a scene view
+	void ApplySceneView(int index);
+	// set the point lights of the data driven scene into the shader
+	void SetSceneLights(const std::vector<SCENE_LIGHT>& lights);
+	// draw the scene objects held in the list
+	void UseSceneObjectList();
+	// remove the materials of a generated scene
+	void RemoveGeneratedMaterials();
+	// draw the generated objects held in the list, with their
+	// materials and lights
+	void UseGeneratedScene(const std::vector<OBJECT_MATERIAL>& materials, const std::vector<SCENE_LIGHT>& lights);
+	// close the loaded scene file, if any
+	void ReleaseSceneFile();
+	// turn a variant switch on or off and use the variant
+	void SetVariantFlag(unsigned int flag, bool bOn);
+	// use the program of the variant the switches select
+	void SelectShaderVariant();
+	// draw with the variants from here on
+	void BeginShaderVariants();
+	// go back to the main program
+	void EndShaderVariants();
+
+public:
+
+	// The following methods are for the students to 
+	// customize for their own 3D scene
+	void PrepareScene();
+	void RenderScene();
+
+	//***Added from OpenGLSample
+	// load all of the needed textures before rendering
+	void LoadSceneTextures();
+
+	//***Added
+	void DefineObjectMaterials();
+	// add and define the light sources before rendering
+	void SetupSceneLights();
+
+	// get the draw and state change counts since the last reset
+	const RENDER_STATS& GetRenderStats() const { return(m_renderStats); }
+	// clear the draw and state change counts
+	void ResetRenderStats();
+
+	// build the draw packets of data driven scenes on this job
+	// system - null builds them on the calling thread
+	void SetJobSystem(JobSystem* pJobSystem);
+
+	// set how the projections map depth, which the frustum
+	// planes are extracted for
+	void SetReverseDepth(bool bReverseDepth) { m_bReverseDepth = bReverseDepth; }
+	// set the view and projection used for culling scene objects
+	void SetCullingFrustum(const glm::mat4& viewProjection);
+	// draw the next frames once into each of the views - the
+	// objects are culled and sorted once for all of them, so
+	// an extra view only costs its draws; an empty list draws
+	// into the current viewport with the current camera
+	void SetSceneViews(const std::vector<SCENE_VIEW>& views);
+	int GetSceneViewCount() const { return((int)m_sceneViews.size()); }
+	// replace the built-in scene with a procedurally generated one
+	void GenerateScene(int objectCount, unsigned int seed);
+	// replace the scene with panels for checking depth precision
+	void GenerateDepthTestScene();
+	// replace the scene with the contents of a text or compiled
+	// scene file
+	bool LoadSceneFile(const char* filename);
+	// replace the scene with a loaded scene file, taking
+	// ownership of it - textures are only loaded again when the
+	// list differs from the loaded one
+	void UseSceneFile(SceneFile* pSceneFile);
+	// write the data driven scene - as text when the name ends
+	// in .json, compiled otherwise
+	bool SaveSceneFile(const char* filename) const;
+	// number of objects in the data driven scene
+	int GetSceneObjectCount() const { return(m_sceneObjectCount); }
+	// replace one object of the data driven scene
+	bool SetSceneObject(int index, const SCENE_OBJECT& object);
+	// replace the material with the same tag, or add it
+	void SetMaterial(const OBJECT_MATERIAL& material);
+
+	// read an image file into memory - safe on any thread
+	static bool DecodeTextureImage(const char* filename, TEXTURE_IMAGE& image);
+	// free the memory of a decoded image
+	static void FreeTextureImage(TEXTURE_IMAGE& image);
+	// true when an image file is loaded into a texture slot
+	bool UsesTextureFile(const std::string& filename) const;
+	// swap a newly decoded image into the slots of its file
+	bool ReplaceTexture(TEXTURE_IMAGE& image);
+	// send the lights to a newly linked shader program - other
+	// uniforms are set every frame
+	void RestoreShaderState();
+
+	// draw with specialized shader variants - null draws with
+	// the main program
+	void SetShaderVariants(ShaderVariants* pShaderVariants) { m_pShaderVariants = pShaderVariants; }
+	ShaderVariants* GetShaderVariants() const { return(m_pShaderVariants); }
+	// build the variants the scene draws with ahead of time
+	void PrewarmShaderVariants();
+
+	// stream the mip levels of the textures loaded from here on
+	// - null uploads every level of every texture
+	void SetTextureStreamer(TextureStreamer* pTextureStreamer) { m_pTextureStreamer = pTextureStreamer; }
+	// set the view the streamed texture sizes are computed for
+	void SetTextureStreamingView(const glm::mat4& view, const glm::mat4& projection, int viewportHeight);
+	// swap in streamed levels and request new ones - call
+	// between frames
+	void UpdateTextureStreaming();
+
+	// draw the small textures loaded from here on from atlas
+	// pages - null draws every texture on its own
+	void SetTextureAtlas(TextureAtlas* pTextureAtlas) { m_pTextureAtlas = pTextureAtlas; }
+	// sample the textures with the presets of the materials -
+	// null leaves the sampling to the texture objects
+	void SetSamplerCache(SamplerCache* pSamplerCache) { m_pSamplerCache = pSamplerCache; }
+	// draw the mesh types past the basic shapes from the meshes
+	// of an uploaded library
+	void SetMeshLibrary(const MeshLibrary* pMeshLibrary) { m_pMeshLibrary = pMeshLibrary; }
+	// draw the basic shapes of the scene objects from generated
+	// meshes shared with other scene managers, cached in the
+	// directory - false keeps drawing the shape meshes
+	bool UsePrimitiveLibrary(const PrimitiveLibrary::PRIMITIVE_SETTINGS& settings, const std::string& directory);
+
+	// note a change that the next frame must show
+	void MarkSceneChanged() { m_changeCount++; }
+	// changes so far - a frame only needs drawing again when
+	// this differs from the count when it was last drawn
+	unsigned int GetChangeCount() const { return(m_changeCount); }
+
 };
\ No newline at end of file
@@ -0,0 +1,380 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadercache.cpp
+// ============
+// keep linked shader program binaries on disk to skip compiling at startup
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderCache.h"
+#include "CPUProfiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	// identifies an entry, followed by the layout version
+	const char CACHE_ENTRY_MAGIC[8] = { 'S', 'H', 'A', 'D', 'E', 'R', 'B', 'N' };
+	const uint32_t CACHE_ENTRY_VERSION = 1;
+	const char* const CACHE_ENTRY_EXTENSION = ".bin";
+	// entries kept before the oldest are deleted - every shader
+	// edit adds one, so without a limit the directory only grows
+	const size_t MAX_CACHE_ENTRIES = 64;
+
+	// start of an entry, followed by the program binary
+	struct ENTRY_HEADER
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t binaryFormat;
+		uint64_t sourceHash;
+		uint64_t driverHash;
+		uint64_t binaryLength;
+	};
+
+	/***********************************************************
+	 *  HashBytes()
+	 *
+	 *  Continues a 64-bit FNV-1a hash over a block of bytes.
+	 ***********************************************************/
+	uint64_t HashBytes(uint64_t hash, const void* pData, size_t size)
+	{
+		const unsigned char* pBytes = (const unsigned char*)pData;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= pBytes[i];
+			hash *= 0x100000001B3ULL;
+		}
+		return(hash);
+	}
+
+	/***********************************************************
+	 *  HashString()
+	 *
+	 *  Continues the hash over a string and its terminator, so
+	 *  that moving text from one string to the next changes it.
+	 ***********************************************************/
+	uint64_t HashString(uint64_t hash, const char* text)
+	{
+		if (NULL == text)
+		{
+			text = "";
+		}
+		return(HashBytes(hash, text, strlen(text) + 1));
+	}
+
+	const uint64_t HASH_SEED = 0xCBF29CE484222325ULL;
+}
+
+/***********************************************************
+ *  ShaderCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShaderCache::ShaderCache()
+{
+	m_driverHash = 0;
+	m_bEnabled = false;
+	m_hitCount = 0;
+	m_missCount = 0;
+	m_rejectCount = 0;
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for reading the identity of the
+ *  driver and creating the cache directory.
+ ***********************************************************/
+bool ShaderCache::Initialize(const std::string& directory)
+{
+	m_bEnabled = false;
+
+	GLint formatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	if (formatCount <= 0)
+	{
+		std::cout << "INFO: The driver cannot save program binaries, shaders are always compiled" << std::endl;
+		return(false);
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	if (error)
+	{
+		std::cout << "Could not create shader cache directory:" << directory << std::endl;
+		return(false);
+	}
+
+	m_directory = directory;
+	m_driverHash = HASH_SEED;
+	m_driverHash = HashString(m_driverHash, (const char*)glGetString(GL_VENDOR));
+	m_driverHash = HashString(m_driverHash, (const char*)glGetString(GL_RENDERER));
+	m_driverHash = HashString(m_driverHash, (const char*)glGetString(GL_VERSION));
+	m_bEnabled = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  BeginProgram()
+ *
+ *  This method is used for creating the program from its
+ *  cache entry, or issuing its build from source when there
+ *  is no usable entry.
+ ***********************************************************/
+void ShaderCache::BeginProgram(
+	const std::string& vertexSource,
+	const std::string& fragmentSource,
+	CACHED_BUILD& cached)
+{
+	CPU_PROFILE_ZONE("ShaderCache::BeginProgram");
+
+	cached.sourceHash = HashString(HashString(HASH_SEED, vertexSource.c_str()), fragmentSource.c_str());
+	cached.program = 0;
+	cached.bFromCache = false;
+	memset(&cached.build, 0, sizeof(cached.build));
+
+	if (m_bEnabled == true)
+	{
+		cached.program = LoadEntry(cached.sourceHash);
+		if (cached.program != 0)
+		{
+			cached.bFromCache = true;
+			m_hitCount++;
+			return;
+		}
+	}
+
+	ShaderCompiler::BeginBuild(vertexSource, fragmentSource, m_bEnabled, cached.build);
+}
+
+/***********************************************************
+ *  FinishProgram()
+ *
+ *  This method is used for waiting for a program and saving
+ *  it to the cache when it was compiled.
+ ***********************************************************/
+GLuint ShaderCache::FinishProgram(CACHED_BUILD& cached, std::string& log)
+{
+	log.clear();
+	if (cached.bFromCache == true)
+	{
+		GLuint program = cached.program;
+		cached.program = 0;
+		return(program);
+	}
+
+	GLuint program = ShaderCompiler::FinishBuild(cached.build, log);
+	if ((program != 0) && (m_bEnabled == true))
+	{
+		SaveEntry(cached.sourceHash, program);
+	}
+
+	return(program);
+}
+
+/***********************************************************
+ *  BuildProgram()
+ *
+ *  This method is used for loading or building one program
+ *  and waiting for it.
+ ***********************************************************/
+GLuint ShaderCache::BuildProgram(
+	const std::string& vertexSource,
+	const std::string& fragmentSource,
+	std::string& log)
+{
+	CACHED_BUILD cached;
+	BeginProgram(vertexSource, fragmentSource, cached);
+	return(FinishProgram(cached, log));
+}
+
+/***********************************************************
+ *  GetEntryName()
+ *
+ *  This method is used for naming the entry of a pair of
+ *  sources on the current driver.
+ ***********************************************************/
+std::string ShaderCache::GetEntryName(uint64_t sourceHash) const
+{
+	uint64_t key = HashBytes(sourceHash, &m_driverHash, sizeof(m_driverHash));
+
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+	return(m_directory + "/" + name + CACHE_ENTRY_EXTENSION);
+}
+
+/***********************************************************
+ *  LoadEntry()
+ *
+ *  This method is used for creating a program from a cache
+ *  entry.  A missing entry is a plain miss; an entry that is
+ *  damaged, was written for other sources or another driver,
+ *  or that the driver does not link is deleted.
+ ***********************************************************/
+GLuint ShaderCache::LoadEntry(uint64_t sourceHash)
+{
+	CPU_PROFILE_ZONE("ShaderCache::LoadEntry");
+
+	std::string filename = GetEntryName(sourceHash);
+	std::ifstream file(filename.c_str(), std::ios::binary);
+	if (!file.is_open())
+	{
+		m_missCount++;
+		return(0);
+	}
+
+	ENTRY_HEADER header;
+	std::vector<char> binary;
+	file.read((char*)&header, sizeof(header));
+	bool bValid = (file.gcount() == (std::streamsize)sizeof(header)) &&
+		(memcmp(header.magic, CACHE_ENTRY_MAGIC, sizeof(header.magic)) == 0) &&
+		(header.version == CACHE_ENTRY_VERSION) &&
+		(header.sourceHash == sourceHash) &&
+		(header.driverHash == m_driverHash) &&
+		(header.binaryLength > 0) && (header.binaryLength < 0x40000000ULL);
+	if (bValid == true)
+	{
+		binary.resize((size_t)header.binaryLength);
+		file.read(binary.data(), (std::streamsize)binary.size());
+		bValid = (file.gcount() == (std::streamsize)binary.size());
+	}
+	file.close();
+
+	GLuint program = 0;
+	if (bValid == true)
+	{
+		program = glCreateProgram();
+		glProgramBinary(program, (GLenum)header.binaryFormat, binary.data(), (GLsizei)binary.size());
+
+		GLint status = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if (status == GL_FALSE)
+		{
+			glDeleteProgram(program);
+			program = 0;
+		}
+	}
+
+	if (program != 0)
+	{
+		// entries in use are the last to be pruned
+		std::error_code error;
+		std::filesystem::last_write_time(filename, std::filesystem::file_time_type::clock::now(), error);
+		return(program);
+	}
+
+	std::cout << "INFO: Shader cache entry " << filename << " was rejected, compiling from source" << std::endl;
+	std::error_code error;
+	std::filesystem::remove(filename, error);
+	m_rejectCount++;
+
+	return(0);
+}
+
+/***********************************************************
+ *  SaveEntry()
+ *
+ *  This method is used for writing the binary of a linked
+ *  program.  It is written under a temporary name and
+ *  renamed, so a crash never leaves half an entry behind.
+ *  Failing to save is not an error; the program is simply
+ *  compiled again next time.
+ ***********************************************************/
+void ShaderCache::SaveEntry(uint64_t sourceHash, GLuint program)
+{
+	CPU_PROFILE_ZONE("ShaderCache::SaveEntry");
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+	{
+		return;
+	}
+
+	std::vector<char> binary((size_t)length);
+	GLenum binaryFormat = 0;
+	GLsizei written = 0;
+	glGetProgramBinary(program, length, &written, &binaryFormat, binary.data());
+	if (written <= 0)
+	{
+		return;
+	}
+
+	ENTRY_HEADER header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CACHE_ENTRY_MAGIC, sizeof(header.magic));
+	header.version = CACHE_ENTRY_VERSION;
+	header.binaryFormat = binaryFormat;
+	header.sourceHash = sourceHash;
+	header.driverHash = m_driverHash;
+	header.binaryLength = (uint64_t)written;
+
+	std::string filename = GetEntryName(sourceHash);
+	std::string temporaryName = filename + ".tmp";
+	std::ofstream file(temporaryName.c_str(), std::ios::binary);
+	if (!file.is_open())
+	{
+		return;
+	}
+	file.write((const char*)&header, sizeof(header));
+	file.write(binary.data(), written);
+	file.close();
+
+	std::error_code error;
+	if (file.fail() == false)
+	{
+		std::filesystem::rename(temporaryName, filename, error);
+	}
+	if ((file.fail() == true) || (error))
+	{
+		std::cout << "Could not write shader cache entry:" << filename << std::endl;
+		std::filesystem::remove(temporaryName, error);
+		return;
+	}
+
+	PruneEntries();
+}
+
+/***********************************************************
+ *  PruneEntries()
+ *
+ *  This method is used for deleting the entries written or
+ *  used longest ago once there are more than the limit.
+ ***********************************************************/
+void ShaderCache::PruneEntries()
+{
+	std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path> > entries;
+
+	std::error_code error;
+	std::filesystem::directory_iterator files(m_directory, error);
+	for (; (!error) && (files != std::filesystem::directory_iterator()); files.increment(error))
+	{
+		if (files->path().extension() == CACHE_ENTRY_EXTENSION)
+		{
+			std::error_code timeError;
+			std::filesystem::file_time_type writeTime = files->last_write_time(timeError);
+			if (!timeError)
+			{
+				entries.push_back(std::make_pair(writeTime, files->path()));
+			}
+		}
+	}
+	if (entries.size() <= MAX_CACHE_ENTRIES)
+	{
+		return;
+	}
+
+	std::sort(entries.begin(), entries.end());
+	for (size_t i = 0; i + MAX_CACHE_ENTRIES < entries.size(); i++)
+	{
+		std::filesystem::remove(entries[i].second, error);
+	}
+}
@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadercache.h
+// ============
+// keep linked shader program binaries on disk to skip compiling at startup
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderCompiler.h"
+
+#include <cstdint>
+#include <string>
+
+/***********************************************************
+ *  ShaderCache
+ *
+ *  This class saves the binary of every program it builds
+ *  from source, and loads that binary instead of compiling
+ *  the next time the same sources are built.  An entry is
+ *  named after a hash of both sources and of the vendor,
+ *  renderer and version strings of the driver, so editing a
+ *  shader or updating the driver simply misses the cache.
+ *
+ *  A driver is free to reject a binary it wrote itself, for
+ *  example after an update that kept the version string.  A
+ *  rejected entry is deleted and the program is compiled from
+ *  source as if there had been no entry, so the cache can
+ *  only ever make building faster, never make it fail.
+ ***********************************************************/
+class ShaderCache
+{
+public:
+	// a program being built - from the cache, or from source
+	// when the cache missed
+	struct CACHED_BUILD
+	{
+		uint64_t sourceHash;
+		GLuint program;
+		bool bFromCache;
+		ShaderCompiler::PROGRAM_BUILD build;
+	};
+
+	// constructor
+	ShaderCache();
+
+	// use the directory for the entries - call with a current
+	// OpenGL context; returns false when the driver cannot save
+	// program binaries, and the cache then stays disabled
+	bool Initialize(const std::string& directory);
+	// true when entries are loaded and saved
+	bool IsEnabled() const { return(m_bEnabled); }
+
+	// load the program from the cache, or issue its build from
+	// source - begin every program before finishing any, so
+	// their sources compile in parallel
+	void BeginProgram(
+		const std::string& vertexSource,
+		const std::string& fragmentSource,
+		CACHED_BUILD& cached);
+	// wait for the program, saving it when it was built from
+	// source - returns zero and the error log on failure
+	GLuint FinishProgram(CACHED_BUILD& cached, std::string& log);
+
+	// load or build a program, waiting for the result
+	GLuint BuildProgram(
+		const std::string& vertexSource,
+		const std::string& fragmentSource,
+		std::string& log);
+
+	// counts of programs loaded, compiled because there was no
+	// entry, and compiled because the driver rejected the entry
+	int GetHitCount() const { return(m_hitCount); }
+	int GetMissCount() const { return(m_missCount); }
+	int GetRejectCount() const { return(m_rejectCount); }
+
+private:
+	std::string m_directory;
+	uint64_t m_driverHash;
+	bool m_bEnabled;
+	int m_hitCount;
+	int m_missCount;
+	int m_rejectCount;
+
+	// file name of the entry for the sources
+	std::string GetEntryName(uint64_t sourceHash) const;
+	// create a program from the entry - zero when there is no
+	// usable entry
+	GLuint LoadEntry(uint64_t sourceHash);
+	// save the binary of a linked program
+	void SaveEntry(uint64_t sourceHash, GLuint program);
+	// delete the oldest entries beyond the limit
+	void PruneEntries();
+};
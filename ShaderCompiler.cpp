@@ -0,0 +1,252 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadercompiler.cpp
+// ============
+// build shader programs from GLSL source, reporting errors instead of failing
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderCompiler.h"
+#include "CPUProfiler.h"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+bool ShaderCompiler::s_bParallelCompile = false;
+
+/***********************************************************
+ *  EnableParallelCompile()
+ *
+ *  This method is used for letting the driver compile
+ *  shaders on its own threads.
+ ***********************************************************/
+bool ShaderCompiler::EnableParallelCompile()
+{
+	if (GLEW_KHR_parallel_shader_compile)
+	{
+		// the largest count lets the driver choose
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+		s_bParallelCompile = true;
+	}
+	return(s_bParallelCompile);
+}
+
+/***********************************************************
+ *  ReadSourceFile()
+ *
+ *  This method is used for reading a whole source file into
+ *  a string.
+ ***********************************************************/
+bool ShaderCompiler::ReadSourceFile(const std::string& filename, std::string& source)
+{
+	std::ifstream file(filename.c_str(), std::ios::binary);
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	std::ostringstream text;
+	text << file.rdbuf();
+	source = text.str();
+
+	return(source.size() > 0);
+}
+
+/***********************************************************
+ *  BeginBuild()
+ *
+ *  This method is used for issuing the compile of both
+ *  stages and the link of the program.  No status is asked
+ *  for here, since that would wait for the driver.
+ ***********************************************************/
+void ShaderCompiler::BeginBuild(
+	const std::string& vertexSource,
+	const std::string& fragmentSource,
+	bool bRetrievable,
+	PROGRAM_BUILD& build)
+{
+	CPU_PROFILE_ZONE("ShaderCompiler::BeginBuild");
+
+	const char* pVertexSource = vertexSource.c_str();
+	build.vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(build.vertexShader, 1, &pVertexSource, NULL);
+	glCompileShader(build.vertexShader);
+
+	const char* pFragmentSource = fragmentSource.c_str();
+	build.fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(build.fragmentShader, 1, &pFragmentSource, NULL);
+	glCompileShader(build.fragmentShader);
+
+	build.program = glCreateProgram();
+	if (bRetrievable == true)
+	{
+		glProgramParameteri(build.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+	glAttachShader(build.program, build.vertexShader);
+	glAttachShader(build.program, build.fragmentShader);
+	glLinkProgram(build.program);
+}
+
+/***********************************************************
+ *  IsBuildReady()
+ *
+ *  This method is used for checking, without waiting,
+ *  whether the driver has finished a build.  Without
+ *  parallel compiling there is no way to tell, so builds
+ *  always count as ready.
+ ***********************************************************/
+bool ShaderCompiler::IsBuildReady(const PROGRAM_BUILD& build)
+{
+	if (s_bParallelCompile == false)
+	{
+		return(true);
+	}
+
+	GLint bCompleted = GL_FALSE;
+	glGetProgramiv(build.program, GL_COMPLETION_STATUS_KHR, &bCompleted);
+	return(bCompleted == GL_TRUE);
+}
+
+/***********************************************************
+ *  FinishBuild()
+ *
+ *  This method is used for getting the result of a build.
+ *  The stages are freed either way; the program is freed
+ *  when it did not link.
+ ***********************************************************/
+GLuint ShaderCompiler::FinishBuild(PROGRAM_BUILD& build, std::string& log)
+{
+	CPU_PROFILE_ZONE("ShaderCompiler::FinishBuild");
+
+	log.clear();
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(build.program, GL_LINK_STATUS, &status);
+	if (status == GL_FALSE)
+	{
+		// a stage that failed to compile explains the link error
+		AppendLog(build.vertexShader, false, "vertex shader", log);
+		AppendLog(build.fragmentShader, false, "fragment shader", log);
+		if (log.size() == 0)
+		{
+			AppendLog(build.program, true, "link", log);
+		}
+	}
+
+	// the program keeps what it needs of the stages
+	glDetachShader(build.program, build.vertexShader);
+	glDetachShader(build.program, build.fragmentShader);
+	glDeleteShader(build.vertexShader);
+	glDeleteShader(build.fragmentShader);
+	build.vertexShader = 0;
+	build.fragmentShader = 0;
+
+	GLuint program = build.program;
+	build.program = 0;
+	if (status == GL_FALSE)
+	{
+		glDeleteProgram(program);
+		return(0);
+	}
+
+	return(program);
+}
+
+/***********************************************************
+ *  AppendLog()
+ *
+ *  This method is used for adding the info log of a shader
+ *  that failed to compile, or a program that failed to
+ *  link, to the error log.
+ ***********************************************************/
+void ShaderCompiler::AppendLog(GLuint object, bool bProgram, const char* stage, std::string& log)
+{
+	GLint status = GL_FALSE;
+	GLint length = 0;
+	if (bProgram == true)
+	{
+		glGetProgramiv(object, GL_LINK_STATUS, &status);
+		glGetProgramiv(object, GL_INFO_LOG_LENGTH, &length);
+	}
+	else
+	{
+		glGetShaderiv(object, GL_COMPILE_STATUS, &status);
+		glGetShaderiv(object, GL_INFO_LOG_LENGTH, &length);
+	}
+	if (status == GL_TRUE)
+	{
+		return;
+	}
+
+	std::vector<char> message(length + 1, '\0');
+	if (bProgram == true)
+	{
+		glGetProgramInfoLog(object, length, NULL, message.data());
+	}
+	else
+	{
+		glGetShaderInfoLog(object, length, NULL, message.data());
+	}
+
+	log += stage;
+	log += ":\n";
+	log += message.data();
+}
+
+/***********************************************************
+ *  BuildProgram()
+ *
+ *  This method is used for compiling both stages and linking
+ *  them into a program, waiting for the result.
+ ***********************************************************/
+GLuint ShaderCompiler::BuildProgram(
+	const std::string& vertexSource,
+	const std::string& fragmentSource,
+	std::string& log)
+{
+	PROGRAM_BUILD build;
+	BeginBuild(vertexSource, fragmentSource, false, build);
+	return(FinishBuild(build, log));
+}
+
+/***********************************************************
+ *  BuildComputeProgram()
+ *
+ *  This method is used for compiling a compute shader and
+ *  linking it into a program of its own, waiting for the
+ *  result.  Compute shaders need OpenGL 4.3.
+ ***********************************************************/
+GLuint ShaderCompiler::BuildComputeProgram(const std::string& computeSource, std::string& log)
+{
+	log.clear();
+
+	const char* pSource = computeSource.c_str();
+	GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(shader, 1, &pSource, NULL);
+	glCompileShader(shader);
+
+	GLuint program = glCreateProgram();
+	glAttachShader(program, shader);
+	glLinkProgram(program);
+
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (status == GL_FALSE)
+	{
+		AppendLog(shader, false, "compute shader", log);
+		if (log.size() == 0)
+		{
+			AppendLog(program, true, "link", log);
+		}
+	}
+
+	glDetachShader(program, shader);
+	glDeleteShader(shader);
+	if (status == GL_FALSE)
+	{
+		glDeleteProgram(program);
+		return(0);
+	}
+
+	return(program);
+}
@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadercompiler.h
+// ============
+// build shader programs from GLSL source, reporting errors instead of failing
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <string>
+
+/***********************************************************
+ *  ShaderCompiler
+ *
+ *  This class builds shader programs outside of the shader
+ *  manager, so a new program can be tried before it replaces
+ *  the one in use.  A program that fails to compile or link
+ *  is deleted and its log returned; nothing else changes.
+ *
+ *  A build is split in two.  BeginBuild() only issues the
+ *  compile and link calls, and FinishBuild() asks for the
+ *  result.  With KHR_parallel_shader_compile the driver
+ *  compiles on its own threads in between, so beginning
+ *  every build before finishing any of them compiles all the
+ *  programs at once.  Without it, the driver compiles while
+ *  the status is first asked for, so nothing is lost.
+ ***********************************************************/
+class ShaderCompiler
+{
+public:
+	// a program whose compile and link have been issued
+	struct PROGRAM_BUILD
+	{
+		GLuint program;
+		GLuint vertexShader;
+		GLuint fragmentShader;
+	};
+
+	// let the driver compile on as many threads as it likes,
+	// when it supports that - call once after creating the
+	// context, returns true when it does
+	static bool EnableParallelCompile();
+
+	// read a whole source file - safe on any thread
+	static bool ReadSourceFile(const std::string& filename, std::string& source);
+
+	// issue the compile and link of a program - set
+	// bRetrievable to read the program binary afterwards
+	static void BeginBuild(
+		const std::string& vertexSource,
+		const std::string& fragmentSource,
+		bool bRetrievable,
+		PROGRAM_BUILD& build);
+	// true once FinishBuild() would not wait for the driver
+	static bool IsBuildReady(const PROGRAM_BUILD& build);
+	// wait for the build - returns the program, or zero and the
+	// error log on failure
+	static GLuint FinishBuild(PROGRAM_BUILD& build, std::string& log);
+
+	// compile and link a program on the OpenGL thread - returns
+	// zero and the error log on failure
+	static GLuint BuildProgram(
+		const std::string& vertexSource,
+		const std::string& fragmentSource,
+		std::string& log);
+	// compile and link a compute program on the OpenGL thread -
+	// returns zero and the error log on failure
+	static GLuint BuildComputeProgram(const std::string& computeSource, std::string& log);
+
+private:
+	// true when KHR_parallel_shader_compile was enabled
+	static bool s_bParallelCompile;
+
+	// append the info log of a failed shader or program
+	static void AppendLog(GLuint object, bool bProgram, const char* stage, std::string& log);
+};
@@ -0,0 +1,422 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadervariants.cpp
+// ============
+// specialized shader programs for each combination of draw state
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderVariants.h"
+#include "CPUProfiler.h"
+
+#include <algorithm>
+#include <iostream>
+#include <regex>
+
+// declaration of global variables
+namespace
+{
+	// the switches, by flag, as uniform names and as macros
+	struct VARIANT_SWITCH
+	{
+		unsigned int flag;
+		const char* uniformName;
+		const char* macroName;
+	};
+	const VARIANT_SWITCH g_VariantSwitches[] = {
+		{ ShaderVariants::variant_texture, "bUseTexture", "VARIANT_TEXTURE" },
+		{ ShaderVariants::variant_texture_overlay, "bUseTextureOverlay", "VARIANT_TEXTURE_OVERLAY" },
+		{ ShaderVariants::variant_lighting, "bUseLighting", "VARIANT_LIGHTING" }
+	};
+	const int VARIANT_SWITCH_COUNT = sizeof(g_VariantSwitches) / sizeof(g_VariantSwitches[0]);
+
+	// the light count is kept above the switch flags
+	const int LIGHT_COUNT_SHIFT = 8;
+
+	/***********************************************************
+	 *  GetComponentCount()
+	 *
+	 *  Returns the number of values in a uniform of a type, or
+	 *  zero for types that are not copied.
+	 ***********************************************************/
+	int GetComponentCount(GLenum type)
+	{
+		switch (type)
+		{
+		case GL_FLOAT:
+		case GL_INT:
+		case GL_BOOL:
+		case GL_SAMPLER_2D:
+		case GL_SAMPLER_2D_ARRAY:
+		case GL_SAMPLER_2D_SHADOW:
+		case GL_SAMPLER_CUBE:
+			return(1);
+		case GL_FLOAT_VEC2:
+			return(2);
+		case GL_FLOAT_VEC3:
+			return(3);
+		case GL_FLOAT_VEC4:
+			return(4);
+		case GL_FLOAT_MAT3:
+			return(9);
+		case GL_FLOAT_MAT4:
+			return(16);
+		default:
+			return(0);
+		}
+	}
+
+	/***********************************************************
+	 *  IsFloatType()
+	 *
+	 *  Returns true for uniform types that hold floats.
+	 ***********************************************************/
+	bool IsFloatType(GLenum type)
+	{
+		return((type == GL_FLOAT) || (type == GL_FLOAT_VEC2) || (type == GL_FLOAT_VEC3) ||
+			(type == GL_FLOAT_VEC4) || (type == GL_FLOAT_MAT3) || (type == GL_FLOAT_MAT4));
+	}
+}
+
+/***********************************************************
+ *  ShaderVariants()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShaderVariants::ShaderVariants()
+{
+	m_pShaderCache = NULL;
+	m_bUsesLightCount = false;
+}
+
+/***********************************************************
+ *  ~ShaderVariants()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ShaderVariants::~ShaderVariants()
+{
+	FreePrograms();
+}
+
+/***********************************************************
+ *  SetSources()
+ *
+ *  This method is used for setting the sources the variants
+ *  are built from.  Variants of the old sources are freed
+ *  and built again on demand.
+ ***********************************************************/
+void ShaderVariants::SetSources(const std::string& vertexSource, const std::string& fragmentSource)
+{
+	FreePrograms();
+	m_vertexSource = vertexSource;
+	m_fragmentSource = fragmentSource;
+	m_bUsesLightCount =
+		(vertexSource.find("POINT_LIGHT_COUNT") != std::string::npos) ||
+		(fragmentSource.find("POINT_LIGHT_COUNT") != std::string::npos);
+}
+
+/***********************************************************
+ *  MakeKey()
+ *
+ *  This method is used for combining the switch flags and
+ *  the number of point lights into a variant key.
+ ***********************************************************/
+uint32_t ShaderVariants::MakeKey(unsigned int flags, int pointLightCount)
+{
+	return((uint32_t)flags | ((uint32_t)pointLightCount << LIGHT_COUNT_SHIFT));
+}
+
+/***********************************************************
+ *  Prewarm()
+ *
+ *  This method is used for building a set of variants before
+ *  they are first drawn with.  Every build is issued before
+ *  any is waited for, so with parallel compiling they all
+ *  compile at the same time.
+ ***********************************************************/
+void ShaderVariants::Prewarm(const std::vector<uint32_t>& keys)
+{
+	CPU_PROFILE_ZONE("ShaderVariants::Prewarm");
+
+	if (m_vertexSource.size() == 0)
+	{
+		return;
+	}
+
+	std::vector<uint32_t> buildKeys;
+	std::vector<ShaderCache::CACHED_BUILD> builds(keys.size());
+	// a cache that was never initialized only compiles
+	ShaderCache noCache;
+	ShaderCache* pCache = (NULL != m_pShaderCache) ? m_pShaderCache : &noCache;
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		uint32_t key = NormalizeKey(keys[i]);
+		if ((m_programs.find(key) != m_programs.end()) ||
+			(std::find(buildKeys.begin(), buildKeys.end(), key) != buildKeys.end()))
+		{
+			continue;
+		}
+		pCache->BeginProgram(
+			MakeVariantSource(m_vertexSource, key),
+			MakeVariantSource(m_fragmentSource, key),
+			builds[buildKeys.size()]);
+		buildKeys.push_back(key);
+	}
+
+	for (size_t i = 0; i < buildKeys.size(); i++)
+	{
+		std::string log;
+		GLuint program = pCache->FinishProgram(builds[i], log);
+		if (program == 0)
+		{
+			std::cout << "Could not build shader variant " << buildKeys[i] << ":\n" << log << std::endl;
+		}
+		m_programs[buildKeys[i]] = program;
+	}
+}
+
+/***********************************************************
+ *  GetProgram()
+ *
+ *  This method is used for getting the program of a variant,
+ *  building it when it is first asked for.
+ ***********************************************************/
+GLuint ShaderVariants::GetProgram(uint32_t key)
+{
+	key = NormalizeKey(key);
+
+	std::map<uint32_t, GLuint>::const_iterator found = m_programs.find(key);
+	if (found == m_programs.end())
+	{
+		std::vector<uint32_t> keys(1, key);
+		Prewarm(keys);
+		found = m_programs.find(key);
+	}
+
+	return((found != m_programs.end()) ? found->second : 0);
+}
+
+/***********************************************************
+ *  NormalizeKey()
+ *
+ *  This method is used for getting the key a variant is kept
+ *  under.  The light count makes no difference to sources
+ *  that do not use it, so it is dropped from their keys and
+ *  prewarmed and drawn variants share one program.
+ ***********************************************************/
+uint32_t ShaderVariants::NormalizeKey(uint32_t key) const
+{
+	if (m_bUsesLightCount == false)
+	{
+		key &= ((1u << LIGHT_COUNT_SHIFT) - 1);
+	}
+	return(key);
+}
+
+/***********************************************************
+ *  MakeVariantSource()
+ *
+ *  This method is used for specializing the source of one
+ *  stage.  The #define lines go right after the #version
+ *  line, followed by a #line directive so that compile
+ *  errors still point at the lines of the file.
+ ***********************************************************/
+std::string ShaderVariants::MakeVariantSource(const std::string& source, uint32_t key) const
+{
+	std::string defines;
+	std::string variantSource = source;
+	for (int i = 0; i < VARIANT_SWITCH_COUNT; i++)
+	{
+		bool bOn = ((key & g_VariantSwitches[i].flag) != 0);
+		defines += std::string("#define ") + g_VariantSwitches[i].macroName + (bOn ? " 1\n" : " 0\n");
+
+		std::regex declaration(std::string("uniform\\s+bool\\s+") + g_VariantSwitches[i].uniformName + "\\s*;");
+		variantSource = std::regex_replace(variantSource, declaration,
+			std::string("const bool ") + g_VariantSwitches[i].uniformName + (bOn ? " = true;" : " = false;"));
+	}
+	defines += "#define POINT_LIGHT_COUNT " + std::to_string(key >> LIGHT_COUNT_SHIFT) + "\n";
+
+	// insert after the #version line, which must come first
+	size_t insertAt = 0;
+	int nextLine = 1;
+	size_t versionAt = variantSource.find("#version");
+	if (versionAt != std::string::npos)
+	{
+		size_t lineEnd = variantSource.find('\n', versionAt);
+		insertAt = (lineEnd == std::string::npos) ? variantSource.size() : lineEnd + 1;
+		nextLine = 1;
+		for (size_t i = 0; i < insertAt; i++)
+		{
+			if (variantSource[i] == '\n')
+			{
+				nextLine++;
+			}
+		}
+		if (lineEnd == std::string::npos)
+		{
+			defines = "\n" + defines;
+		}
+	}
+	defines += "#line " + std::to_string(nextLine) + "\n";
+
+	variantSource.insert(insertAt, defines);
+	return(variantSource);
+}
+
+/***********************************************************
+ *  GetUniformTable()
+ *
+ *  This method is used for listing the active uniforms of a
+ *  program, with arrays split into their elements.
+ ***********************************************************/
+const std::vector<ShaderVariants::UNIFORM_INFO>& ShaderVariants::GetUniformTable(GLuint program)
+{
+	std::map<GLuint, std::vector<UNIFORM_INFO> >::iterator found = m_uniformTables.find(program);
+	if (found != m_uniformTables.end())
+	{
+		return(found->second);
+	}
+
+	std::vector<UNIFORM_INFO>& table = m_uniformTables[program];
+
+	GLint uniformCount = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+	std::vector<char> name(maxNameLength + 1, '\0');
+	for (GLint i = 0; i < uniformCount; i++)
+	{
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(program, (GLuint)i, (GLsizei)name.size(), NULL, &size, &type, name.data());
+		if (GetComponentCount(type) == 0)
+		{
+			continue;
+		}
+
+		// arrays are reported by their first element
+		std::string baseName = name.data();
+		if ((size > 1) && (baseName.size() > 3) && (baseName.compare(baseName.size() - 3, 3, "[0]") == 0))
+		{
+			baseName.erase(baseName.size() - 3);
+		}
+		for (GLint element = 0; element < size; element++)
+		{
+			UNIFORM_INFO info;
+			info.name = (size > 1) ? baseName + "[" + std::to_string(element) + "]" : baseName;
+			info.location = glGetUniformLocation(program, info.name.c_str());
+			info.type = type;
+			if (info.location >= 0)
+			{
+				table.push_back(info);
+			}
+		}
+	}
+
+	return(table);
+}
+
+/***********************************************************
+ *  CopyUniforms()
+ *
+ *  This method is used for carrying the uniform state over
+ *  to the program that is about to be used.  Uniforms with
+ *  the same name and type in both programs are copied.
+ ***********************************************************/
+void ShaderVariants::CopyUniforms(GLuint sourceProgram, GLuint targetProgram)
+{
+	CPU_PROFILE_ZONE("ShaderVariants::CopyUniforms");
+
+	if ((sourceProgram == 0) || (targetProgram == 0) || (sourceProgram == targetProgram))
+	{
+		return;
+	}
+
+	std::pair<GLuint, GLuint> pair(sourceProgram, targetProgram);
+	std::map<std::pair<GLuint, GLuint>, std::vector<UNIFORM_COPY> >::iterator found = m_copyTables.find(pair);
+	if (found == m_copyTables.end())
+	{
+		const std::vector<UNIFORM_INFO>& sourceTable = GetUniformTable(sourceProgram);
+		const std::vector<UNIFORM_INFO>& targetTable = GetUniformTable(targetProgram);
+
+		std::map<std::string, const UNIFORM_INFO*> sourceByName;
+		for (size_t i = 0; i < sourceTable.size(); i++)
+		{
+			sourceByName[sourceTable[i].name] = &sourceTable[i];
+		}
+
+		std::vector<UNIFORM_COPY>& copies = m_copyTables[pair];
+		for (size_t i = 0; i < targetTable.size(); i++)
+		{
+			std::map<std::string, const UNIFORM_INFO*>::const_iterator source = sourceByName.find(targetTable[i].name);
+			if ((source != sourceByName.end()) && (source->second->type == targetTable[i].type))
+			{
+				UNIFORM_COPY copy;
+				copy.sourceLocation = source->second->location;
+				copy.targetLocation = targetTable[i].location;
+				copy.type = targetTable[i].type;
+				copies.push_back(copy);
+			}
+		}
+		found = m_copyTables.find(pair);
+	}
+
+	const std::vector<UNIFORM_COPY>& copies = found->second;
+	for (size_t i = 0; i < copies.size(); i++)
+	{
+		const UNIFORM_COPY& copy = copies[i];
+		if (IsFloatType(copy.type) == true)
+		{
+			GLfloat values[16];
+			glGetUniformfv(sourceProgram, copy.sourceLocation, values);
+			switch (copy.type)
+			{
+			case GL_FLOAT:
+				glProgramUniform1fv(targetProgram, copy.targetLocation, 1, values);
+				break;
+			case GL_FLOAT_VEC2:
+				glProgramUniform2fv(targetProgram, copy.targetLocation, 1, values);
+				break;
+			case GL_FLOAT_VEC3:
+				glProgramUniform3fv(targetProgram, copy.targetLocation, 1, values);
+				break;
+			case GL_FLOAT_VEC4:
+				glProgramUniform4fv(targetProgram, copy.targetLocation, 1, values);
+				break;
+			case GL_FLOAT_MAT3:
+				glProgramUniformMatrix3fv(targetProgram, copy.targetLocation, 1, GL_FALSE, values);
+				break;
+			case GL_FLOAT_MAT4:
+				glProgramUniformMatrix4fv(targetProgram, copy.targetLocation, 1, GL_FALSE, values);
+				break;
+			}
+		}
+		else
+		{
+			GLint value = 0;
+			glGetUniformiv(sourceProgram, copy.sourceLocation, &value);
+			glProgramUniform1i(targetProgram, copy.targetLocation, value);
+		}
+	}
+}
+
+/***********************************************************
+ *  FreePrograms()
+ *
+ *  This method is used for deleting every built variant and
+ *  forgetting the uniform tables, which also list programs
+ *  that are not variants.
+ ***********************************************************/
+void ShaderVariants::FreePrograms()
+{
+	for (std::map<uint32_t, GLuint>::const_iterator program = m_programs.begin(); program != m_programs.end(); ++program)
+	{
+		if (program->second != 0)
+		{
+			glDeleteProgram(program->second);
+		}
+	}
+	m_programs.clear();
+	m_uniformTables.clear();
+	m_copyTables.clear();
+}
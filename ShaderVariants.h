@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadervariants.h
+// ============
+// specialized shader programs for each combination of draw state
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderCache.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/***********************************************************
+ *  ShaderVariants
+ *
+ *  This class builds one program per combination of the
+ *  switches the scene sets per draw - texture, overlay
+ *  texture and lighting - from the same sources as the main
+ *  program.  In each variant the switches are constants
+ *  rather than uniforms: every "uniform bool" declaration of
+ *  a switch is rewritten into a constant of the variant's
+ *  value, so the compiler removes the branches on it
+ *  instead of the shader taking them for every fragment.
+ *
+ *  Each variant also gets #define lines for its switches and
+ *  for the number of point lights, after the #version line.
+ *  POINT_LIGHT_COUNT is only part of the variant when the
+ *  sources use it, for example to bound the light loop.
+ *
+ *  A program switch keeps the uniform state: the values of
+ *  every uniform the new program shares with the old one are
+ *  copied over, so code that sets uniforms does not need to
+ *  know which variant is in use.
+ ***********************************************************/
+class ShaderVariants
+{
+public:
+	// switches that select a variant
+	enum VARIANT_FLAG
+	{
+		variant_texture = 1,
+		variant_texture_overlay = 2,
+		variant_lighting = 4
+	};
+
+	// constructor
+	ShaderVariants();
+	// destructor
+	~ShaderVariants();
+
+	// load and save the variants through the cache - null
+	// compiles them every time
+	void SetShaderCache(ShaderCache* pShaderCache) { m_pShaderCache = pShaderCache; }
+	// use new sources, freeing the variants built from the old
+	void SetSources(const std::string& vertexSource, const std::string& fragmentSource);
+
+	// the key of a variant
+	static uint32_t MakeKey(unsigned int flags, int pointLightCount);
+	// build the variants that are not built yet, all at once
+	// so their compiles overlap
+	void Prewarm(const std::vector<uint32_t>& keys);
+	// the program of a variant, built on first use - zero when
+	// it does not build
+	GLuint GetProgram(uint32_t key);
+
+	// copy the values of the uniforms two programs share
+	void CopyUniforms(GLuint sourceProgram, GLuint targetProgram);
+
+	// true when the sources use the number of point lights
+	bool UsesLightCount() const { return(m_bUsesLightCount); }
+	// number of variants built so far
+	int GetProgramCount() const { return((int)m_programs.size()); }
+
+private:
+	// an active uniform - one entry per array element
+	struct UNIFORM_INFO
+	{
+		std::string name;
+		GLint location;
+		GLenum type;
+	};
+	// one uniform to copy between two programs
+	struct UNIFORM_COPY
+	{
+		GLint sourceLocation;
+		GLint targetLocation;
+		GLenum type;
+	};
+
+	ShaderCache* m_pShaderCache;
+	std::string m_vertexSource;
+	std::string m_fragmentSource;
+	bool m_bUsesLightCount;
+	// built programs by key - zero for variants that failed
+	std::map<uint32_t, GLuint> m_programs;
+	// active uniforms of each program seen, and the uniforms
+	// shared by each pair of programs
+	std::map<GLuint, std::vector<UNIFORM_INFO> > m_uniformTables;
+	std::map<std::pair<GLuint, GLuint>, std::vector<UNIFORM_COPY> > m_copyTables;
+
+	// the key a variant is built and looked up under - without
+	// the light count when the sources do not use it
+	uint32_t NormalizeKey(uint32_t key) const;
+	// the source of one stage of a variant
+	std::string MakeVariantSource(const std::string& source, uint32_t key) const;
+	// the active uniforms of a program
+	const std::vector<UNIFORM_INFO>& GetUniformTable(GLuint program);
+	// free every built variant and the uniform tables
+	void FreePrograms();
+};
@@ -0,0 +1,445 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureatlas.cpp
+// ============
+// pack the small textures of the scene into shared atlas pages
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureAtlas.h"
+#include "CPUProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// largest width and height of a page
+	const int ATLAS_PAGE_SIZE = 2048;
+	// largest width and height of a packed image
+	const int ATLAS_MAX_IMAGE_SIZE = 512;
+	// edge texels repeated around every image
+	const int ATLAS_GUTTER = 8;
+	// cells start and end on this grid, so the first levels
+	// are box filtered from texels of one cell only
+	const int ATLAS_ALIGNMENT = 2 * ATLAS_GUTTER;
+	// levels kept - the gutter halves with every level, and is
+	// one texel wide in the last one
+	const int ATLAS_MIP_LEVELS = 4;
+	// the pages are bound after the 16 texture slots
+	const int ATLAS_FIRST_UNIT = 16;
+
+	/***********************************************************
+	 *  AlignCell()
+	 *
+	 *  Returns the size of a cell holding an image of the
+	 *  given size and its gutters.
+	 ***********************************************************/
+	int AlignCell(int size)
+	{
+		return((size + 2 * ATLAS_GUTTER + ATLAS_ALIGNMENT - 1) / ATLAS_ALIGNMENT * ATLAS_ALIGNMENT);
+	}
+
+	/***********************************************************
+	 *  PixelFormat()
+	 *
+	 *  Returns the OpenGL format of the texels of a page.
+	 ***********************************************************/
+	GLenum PixelFormat(int channels)
+	{
+		return((channels == 3) ? GL_RGB : GL_RGBA);
+	}
+}
+
+/***********************************************************
+ *  TextureAtlas()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureAtlas::TextureAtlas()
+{
+}
+
+/***********************************************************
+ *  ~TextureAtlas()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureAtlas::~TextureAtlas()
+{
+	Clear();
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for packing the decoded images of the
+ *  slots into pages, one group of images per color format.
+ *  The texels are only written to memory here; Upload()
+ *  turns the pages into textures.
+ ***********************************************************/
+void TextureAtlas::Build(const std::vector<SceneManager::TEXTURE_IMAGE>& images)
+{
+	CPU_PROFILE_ZONE("TextureAtlas::Build");
+
+	m_images.clear();
+	m_pages.clear();
+	m_slotImages.clear();
+
+	const int formats[] = { 3, 4 };
+	for (int channels : formats)
+	{
+		std::vector<int> group;
+		for (int i = 0; i < (int)images.size(); i++)
+		{
+			const SceneManager::TEXTURE_IMAGE& image = images[i];
+			if ((NULL != image.pixels) &&
+				(image.colorChannels == channels) &&
+				(image.width <= ATLAS_MAX_IMAGE_SIZE) &&
+				(image.height <= ATLAS_MAX_IMAGE_SIZE))
+			{
+				group.push_back(i);
+			}
+		}
+
+		// a texture alone in its page would save no binding
+		if (group.size() >= 2)
+		{
+			PackGroup(images, group);
+		}
+	}
+}
+
+/***********************************************************
+ *  PackGroup()
+ *
+ *  This method is used for placing a group of images of one
+ *  format on shelves, tallest first, starting a new page
+ *  whenever the current one is full, and then writing the
+ *  cells of the new pages.
+ ***********************************************************/
+void TextureAtlas::PackGroup(
+	const std::vector<SceneManager::TEXTURE_IMAGE>& images,
+	const std::vector<int>& group)
+{
+	std::vector<int> order = group;
+	std::stable_sort(order.begin(), order.end(), [&images](int a, int b) {
+		return(images[a].height > images[b].height);
+	});
+
+	const int firstPage = (int)m_pages.size();
+	const int channels = images[order[0]].colorChannels;
+	int page = -1;
+	int shelfX = 0;
+	int shelfY = 0;
+	int shelfHeight = 0;
+
+	for (int index : order)
+	{
+		const SceneManager::TEXTURE_IMAGE& image = images[index];
+		int cellWidth = AlignCell(image.width);
+		int cellHeight = AlignCell(image.height);
+
+		// start a new shelf, and a new page when no shelf fits
+		if ((page < 0) || (shelfX + cellWidth > ATLAS_PAGE_SIZE))
+		{
+			shelfY += shelfHeight;
+			shelfX = 0;
+			shelfHeight = 0;
+			if ((page < 0) || (shelfY + cellHeight > ATLAS_PAGE_SIZE))
+			{
+				ATLAS_PAGE newPage;
+				newPage.width = 0;
+				newPage.height = 0;
+				newPage.channels = channels;
+				newPage.unit = -1;
+				newPage.textureID = 0;
+				m_pages.push_back(newPage);
+				page = (int)m_pages.size() - 1;
+				shelfY = 0;
+			}
+		}
+
+		PACKED_IMAGE packed;
+		packed.image = index;
+		packed.slot = -1;
+		packed.page = page;
+		packed.cellX = shelfX;
+		packed.cellY = shelfY;
+		packed.cellWidth = cellWidth;
+		packed.cellHeight = cellHeight;
+		packed.width = image.width;
+		packed.height = image.height;
+		packed.channels = channels;
+
+		shelfX += cellWidth;
+		shelfHeight = std::max(shelfHeight, cellHeight);
+		m_pages[page].width = std::max(m_pages[page].width, shelfX);
+		m_pages[page].height = std::max(m_pages[page].height, shelfY + cellHeight);
+
+		m_images.push_back(packed);
+	}
+
+	for (int i = firstPage; i < (int)m_pages.size(); i++)
+	{
+		m_pages[i].pixels.assign((size_t)m_pages[i].width * m_pages[i].height * channels, 0);
+	}
+	for (const PACKED_IMAGE& packed : m_images)
+	{
+		if (packed.page < firstPage)
+		{
+			continue;
+		}
+		ATLAS_PAGE& target = m_pages[packed.page];
+		int stride = target.width * channels;
+		WriteCell(
+			packed,
+			images[packed.image].pixels,
+			&target.pixels[(size_t)packed.cellY * stride + (size_t)packed.cellX * channels],
+			stride);
+	}
+}
+
+/***********************************************************
+ *  WriteCell()
+ *
+ *  This method is used for copying an image into its cell.
+ *  The texels around the image repeat its nearest edge texel
+ *  out to the border of the cell, so filtering at the edge
+ *  of the image never reaches into a neighbor.
+ ***********************************************************/
+void TextureAtlas::WriteCell(
+	const PACKED_IMAGE& packed,
+	const unsigned char* pSource,
+	unsigned char* pTarget,
+	int targetStride)
+{
+	const int channels = packed.channels;
+	for (int y = 0; y < packed.cellHeight; y++)
+	{
+		int sourceY = std::min(std::max(y - ATLAS_GUTTER, 0), packed.height - 1);
+		const unsigned char* pSourceRow = pSource + (size_t)sourceY * packed.width * channels;
+		unsigned char* pTargetRow = pTarget + (size_t)y * targetStride;
+
+		for (int x = 0; x < ATLAS_GUTTER; x++)
+		{
+			memcpy(pTargetRow + x * channels, pSourceRow, channels);
+		}
+		memcpy(pTargetRow + ATLAS_GUTTER * channels, pSourceRow, (size_t)packed.width * channels);
+		for (int x = ATLAS_GUTTER + packed.width; x < packed.cellWidth; x++)
+		{
+			memcpy(pTargetRow + x * channels, pSourceRow + (packed.width - 1) * channels, channels);
+		}
+	}
+}
+
+/***********************************************************
+ *  Upload()
+ *
+ *  This method is used for creating the textures of the
+ *  packed pages and binding them to the units after the
+ *  texture slots.  Images that did not make it into a slot
+ *  are left out, and pages beyond the texture units of the
+ *  driver are dropped, their slots drawn on their own.
+ ***********************************************************/
+bool TextureAtlas::Upload(const std::vector<int>& imageSlots)
+{
+	CPU_PROFILE_ZONE("TextureAtlas::Upload");
+
+	for (int i = 0; i < (int)m_images.size(); i++)
+	{
+		PACKED_IMAGE& packed = m_images[i];
+		if ((packed.image >= (int)imageSlots.size()) || (imageSlots[packed.image] < 0))
+		{
+			continue;
+		}
+		packed.slot = imageSlots[packed.image];
+		if (packed.slot >= (int)m_slotImages.size())
+		{
+			m_slotImages.resize(packed.slot + 1, -1);
+		}
+		m_slotImages[packed.slot] = i;
+	}
+
+	GLint maxUnits = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits);
+
+	for (int i = 0; i < (int)m_pages.size(); i++)
+	{
+		ATLAS_PAGE& page = m_pages[i];
+		if (ATLAS_FIRST_UNIT + i >= maxUnits)
+		{
+			for (const PACKED_IMAGE& packed : m_images)
+			{
+				if ((packed.page == i) && (packed.slot >= 0))
+				{
+					m_slotImages[packed.slot] = -1;
+				}
+			}
+			std::vector<unsigned char>().swap(page.pixels);
+			continue;
+		}
+
+		page.unit = ATLAS_FIRST_UNIT + i;
+		glGenTextures(1, &page.textureID);
+		glActiveTexture(GL_TEXTURE0 + page.unit);
+		glBindTexture(GL_TEXTURE_2D, page.textureID);
+
+		// regions never repeat, and the gutter only covers the
+		// first levels
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, ATLAS_MIP_LEVELS - 1);
+
+		GLenum format = PixelFormat(page.channels);
+		glTexImage2D(GL_TEXTURE_2D, 0, (page.channels == 3) ? GL_RGB8 : GL_RGBA8,
+			page.width, page.height, 0, format, GL_UNSIGNED_BYTE, page.pixels.data());
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		std::vector<unsigned char>().swap(page.pixels);
+	}
+	glActiveTexture(GL_TEXTURE0);
+
+	int regionCount = GetRegionCount();
+	if (regionCount > 0)
+	{
+		std::cout << "INFO: Packed " << regionCount << " textures into " << m_pages.size() << " atlas pages" << std::endl;
+	}
+
+	return(regionCount > 0);
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the page textures to
+ *  their units.
+ ***********************************************************/
+void TextureAtlas::Bind() const
+{
+	for (const ATLAS_PAGE& page : m_pages)
+	{
+		if (page.textureID != 0)
+		{
+			glActiveTexture(GL_TEXTURE0 + page.unit);
+			glBindTexture(GL_TEXTURE_2D, page.textureID);
+		}
+	}
+	glActiveTexture(GL_TEXTURE0);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for deleting the page textures and
+ *  forgetting every packed slot.
+ ***********************************************************/
+void TextureAtlas::Clear()
+{
+	for (ATLAS_PAGE& page : m_pages)
+	{
+		if (page.textureID != 0)
+		{
+			glDeleteTextures(1, &page.textureID);
+		}
+	}
+	m_pages.clear();
+	m_images.clear();
+	m_slotImages.clear();
+}
+
+/***********************************************************
+ *  FindRegion()
+ *
+ *  This method is used for getting the page, unit and
+ *  texture coordinates of a packed slot.
+ ***********************************************************/
+bool TextureAtlas::FindRegion(int slot, ATLAS_REGION& region) const
+{
+	if ((slot < 0) || (slot >= (int)m_slotImages.size()) || (m_slotImages[slot] < 0))
+	{
+		return(false);
+	}
+
+	const PACKED_IMAGE& packed = m_images[m_slotImages[slot]];
+	const ATLAS_PAGE& page = m_pages[packed.page];
+	if (page.textureID == 0)
+	{
+		return(false);
+	}
+
+	region.page = packed.page;
+	region.unit = page.unit;
+	region.offset = glm::vec2(
+		(float)(packed.cellX + ATLAS_GUTTER) / page.width,
+		(float)(packed.cellY + ATLAS_GUTTER) / page.height);
+	region.scale = glm::vec2(
+		(float)packed.width / page.width,
+		(float)packed.height / page.height);
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReplaceImage()
+ *
+ *  This method is used for writing an edited image of a
+ *  packed slot into its cell and filtering the levels of the
+ *  page again.  An image that no longer fits its cell takes
+ *  the slot out of the atlas, so it is drawn on its own.
+ ***********************************************************/
+bool TextureAtlas::ReplaceImage(int slot, const SceneManager::TEXTURE_IMAGE& image)
+{
+	CPU_PROFILE_ZONE("TextureAtlas::ReplaceImage");
+
+	ATLAS_REGION region;
+	if (FindRegion(slot, region) == false)
+	{
+		return(false);
+	}
+
+	const PACKED_IMAGE& packed = m_images[m_slotImages[slot]];
+	if ((NULL == image.pixels) ||
+		(image.width != packed.width) ||
+		(image.height != packed.height) ||
+		(image.colorChannels != packed.channels))
+	{
+		std::cout << "INFO: " << image.filename << " changed format, drawn outside the texture atlas" << std::endl;
+		m_slotImages[slot] = -1;
+		return(false);
+	}
+
+	std::vector<unsigned char> cell((size_t)packed.cellWidth * packed.cellHeight * packed.channels);
+	WriteCell(packed, image.pixels, cell.data(), packed.cellWidth * packed.channels);
+
+	glActiveTexture(GL_TEXTURE0 + region.unit);
+	glBindTexture(GL_TEXTURE_2D, m_pages[packed.page].textureID);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, packed.cellX, packed.cellY, packed.cellWidth, packed.cellHeight,
+		PixelFormat(packed.channels), GL_UNSIGNED_BYTE, cell.data());
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glActiveTexture(GL_TEXTURE0);
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetRegionCount()
+ *
+ *  This method is used for counting the slots that are
+ *  drawn from the atlas.
+ ***********************************************************/
+int TextureAtlas::GetRegionCount() const
+{
+	int count = 0;
+	for (int index : m_slotImages)
+	{
+		if (index >= 0)
+		{
+			count++;
+		}
+	}
+	return(count);
+}
@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureatlas.h
+// ============
+// pack the small textures of the scene into shared atlas pages
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+
+#include <vector>
+
+/***********************************************************
+ *  TextureAtlas
+ *
+ *  This class packs the small textures of the scene slots
+ *  into a few large atlas pages, so objects drawn with
+ *  different small textures can share one texture binding.
+ *  Images with the same number of color channels are packed
+ *  together; a texture larger than ATLAS_MAX_IMAGE_SIZE, or
+ *  the only one of its format, is left on its own.
+ *
+ *  Every image sits in a cell padded with a gutter of its
+ *  own edge texels, and cells start on a grid of
+ *  ATLAS_ALIGNMENT texels.  Box filtered mip levels then
+ *  never mix texels of two cells, and the pages only keep
+ *  the levels whose gutter is still at least one texel wide.
+ *
+ *  A region does not repeat, so a slot is only drawn from
+ *  its page when the texture coordinates stay within one
+ *  repeat - the shader maps them with
+ *  texCoord * UVscale + UVoffset.  The standalone texture of
+ *  the slot is kept for every other use.
+ ***********************************************************/
+class TextureAtlas
+{
+public:
+	// where a packed slot is in its page, in page texture
+	// coordinates
+	struct ATLAS_REGION
+	{
+		int page;
+		// texture unit the page is bound to
+		int unit;
+		glm::vec2 offset;
+		glm::vec2 scale;
+	};
+
+	// constructor
+	TextureAtlas();
+	// destructor
+	~TextureAtlas();
+
+	// pack decoded images into pages, replacing the packing
+	// left by Clear() - this only fills memory, so it is safe
+	// on any thread
+	void Build(const std::vector<SceneManager::TEXTURE_IMAGE>& images);
+	// create the page textures of the last build and bind them
+	// to their units, given the slot each built image was
+	// loaded into, or -1 - call on the OpenGL thread
+	bool Upload(const std::vector<int>& imageSlots);
+	// bind the page textures to their units again
+	void Bind() const;
+	// delete the pages and forget every region
+	void Clear();
+
+	// the region of a slot - false when the slot is not packed
+	bool FindRegion(int slot, ATLAS_REGION& region) const;
+	// write a newly decoded image of a packed slot into its
+	// cell - a slot whose image changed size is dropped from
+	// the atlas and false is returned
+	bool ReplaceImage(int slot, const SceneManager::TEXTURE_IMAGE& image);
+
+	// number of packed slots and of pages
+	int GetRegionCount() const;
+	int GetPageCount() const { return((int)m_pages.size()); }
+
+private:
+	// a slot image placed in a page
+	struct PACKED_IMAGE
+	{
+		// index of the built image, and the slot it is in
+		int image;
+		int slot;
+		int page;
+		// corner of the cell, and size of the image inside it
+		int cellX;
+		int cellY;
+		int cellWidth;
+		int cellHeight;
+		int width;
+		int height;
+		int channels;
+	};
+
+	struct ATLAS_PAGE
+	{
+		int width;
+		int height;
+		int channels;
+		int unit;
+		GLuint textureID;
+		// texels of the build, freed once uploaded
+		std::vector<unsigned char> pixels;
+	};
+
+	std::vector<PACKED_IMAGE> m_images;
+	std::vector<ATLAS_PAGE> m_pages;
+	// packed image of each slot, or -1
+	std::vector<int> m_slotImages;
+
+	// pack one group of images of the same format into new pages
+	void PackGroup(
+		const std::vector<SceneManager::TEXTURE_IMAGE>& images,
+		const std::vector<int>& group);
+	// fill a cell with the image and its gutter of edge texels
+	static void WriteCell(
+		const PACKED_IMAGE& packed,
+		const unsigned char* pSource,
+		unsigned char* pTarget,
+		int targetStride);
+};
@@ -0,0 +1,732 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturestreamer.cpp
+// ============
+// keep only the mip levels the view needs in video memory, within a budget
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureStreamer.h"
+#include "CPUProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// levels no larger than this are always resident
+	const int MIP_TAIL_SIZE = 64;
+	// textures decoded in the background at the same time
+	const int MAX_PENDING_REQUESTS = 2;
+	// video memory per texel - drivers pad RGB8 to four bytes
+	const size_t BYTES_PER_TEXEL = 4;
+
+	/***********************************************************
+	 *  LevelSize()
+	 *
+	 *  Returns the width or height of a mip level.
+	 ***********************************************************/
+	int LevelSize(int size, int level)
+	{
+		return(std::max(1, size >> level));
+	}
+}
+
+/***********************************************************
+ *  TextureStreamer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureStreamer::TextureStreamer(size_t budgetBytes, JobSystem* pJobSystem)
+{
+	m_budgetBytes = budgetBytes;
+	m_pJobSystem = pJobSystem;
+	m_residentBytes = 0;
+	m_frame = 0;
+	m_bUsesNoted = false;
+	m_cameraPosition = glm::vec3(0.0f, 0.0f, 0.0f);
+	m_pixelScale = 1.0f;
+	m_bOrthographic = false;
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+/***********************************************************
+ *  ~TextureStreamer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureStreamer::~TextureStreamer()
+{
+	RemoveAll();
+}
+
+/***********************************************************
+ *  AddTexture()
+ *
+ *  This method is used for creating the texture of a slot
+ *  from a decoded image.  Only the mip tail is made and
+ *  uploaded; finer levels are streamed in once they are
+ *  drawn large enough to need them.
+ ***********************************************************/
+GLuint TextureStreamer::AddTexture(int slot, const SceneManager::TEXTURE_IMAGE& image)
+{
+	CPU_PROFILE_ZONE("TextureStreamer::AddTexture");
+
+	if (NULL == image.pixels)
+	{
+		std::cout << "Could not load image:" << image.filename << std::endl;
+		return(0);
+	}
+	if ((image.colorChannels != 3) && (image.colorChannels != 4))
+	{
+		std::cout << "Not implemented to handle image with " << image.colorChannels << " channels" << std::endl;
+		return(0);
+	}
+
+	if ((int)m_textures.size() <= slot)
+	{
+		STREAMED_TEXTURE empty;
+		empty.textureID = 0;
+		empty.width = 0;
+		empty.height = 0;
+		empty.channels = 0;
+		empty.levelCount = 0;
+		empty.tailLevel = 0;
+		empty.residentLevel = 0;
+		empty.wantedLevel = 0;
+		empty.frameWantedLevel = 0;
+		empty.lastUsedFrame = 0;
+		empty.pRequest = NULL;
+		m_textures.resize(slot + 1, empty);
+	}
+
+	STREAMED_TEXTURE& texture = m_textures[slot];
+	FreeRequest(texture);
+	int residentLevel = -1;
+	if (texture.textureID != 0)
+	{
+		residentLevel = texture.residentLevel;
+		SwapTexture(slot, 0, 0);
+	}
+
+	texture.filename = image.filename;
+	texture.width = image.width;
+	texture.height = image.height;
+	texture.channels = image.colorChannels;
+	texture.levelCount = 1;
+	while ((LevelSize(image.width, texture.levelCount - 1) > 1) || (LevelSize(image.height, texture.levelCount - 1) > 1))
+	{
+		texture.levelCount++;
+	}
+	texture.tailLevel = 0;
+	while (std::max(LevelSize(image.width, texture.tailLevel), LevelSize(image.height, texture.tailLevel)) > MIP_TAIL_SIZE)
+	{
+		texture.tailLevel++;
+	}
+	// a replaced texture keeps the detail it had
+	int firstLevel = ((residentLevel >= 0) && (residentLevel < texture.tailLevel)) ? residentLevel : texture.tailLevel;
+	texture.wantedLevel = firstLevel;
+	texture.frameWantedLevel = texture.levelCount;
+	texture.lastUsedFrame = 0;
+	texture.pRequest = NULL;
+
+	// the first level straight from the image, each following
+	// one from the level before it
+	std::vector<std::vector<unsigned char> > levels(texture.levelCount - firstLevel);
+	DownsampleImage(image.pixels, image.width, image.height, image.colorChannels, 1 << firstLevel, levels[0]);
+	for (size_t i = 1; i < levels.size(); i++)
+	{
+		int level = firstLevel + (int)i - 1;
+		DownsampleImage(levels[i - 1].data(),
+			LevelSize(image.width, level), LevelSize(image.height, level),
+			image.colorChannels, 2, levels[i]);
+	}
+
+	GLuint textureID = BuildTexture(texture, firstLevel, levels);
+	SwapTexture(slot, textureID, firstLevel);
+
+	std::cout << "Successfully loaded image:" << image.filename << ", width:" << image.width
+		<< ", height:" << image.height << ", channels:" << image.colorChannels
+		<< ", streaming from level " << firstLevel << " of " << texture.levelCount << std::endl;
+
+	return(textureID);
+}
+
+/***********************************************************
+ *  ReplaceTexture()
+ *
+ *  This method is used for replacing the image of a slot,
+ *  for example when the file was edited.
+ ***********************************************************/
+GLuint TextureStreamer::ReplaceTexture(int slot, const SceneManager::TEXTURE_IMAGE& image)
+{
+	return(AddTexture(slot, image));
+}
+
+/***********************************************************
+ *  RemoveAll()
+ *
+ *  This method is used for deleting every texture, waiting
+ *  for the requests still being decoded.
+ ***********************************************************/
+void TextureStreamer::RemoveAll()
+{
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		FreeRequest(m_textures[i]);
+		if (m_textures[i].textureID != 0)
+		{
+			glDeleteTextures(1, &m_textures[i].textureID);
+		}
+	}
+	m_textures.clear();
+	m_residentBytes = 0;
+}
+
+/***********************************************************
+ *  GetTextureID()
+ *
+ *  This method is used for getting the current texture of a
+ *  slot, which changes whenever its levels do.
+ ***********************************************************/
+GLuint TextureStreamer::GetTextureID(int slot) const
+{
+	if ((slot < 0) || (slot >= (int)m_textures.size()))
+	{
+		return(0);
+	}
+	return(m_textures[slot].textureID);
+}
+
+/***********************************************************
+ *  SetView()
+ *
+ *  This method is used for setting the camera the texture
+ *  sizes on screen are computed for.
+ ***********************************************************/
+void TextureStreamer::SetView(const glm::mat4& view, const glm::mat4& projection, int viewportHeight)
+{
+	glm::mat4 cameraToWorld = glm::inverse(view);
+	m_cameraPosition = glm::vec3(cameraToWorld[3][0], cameraToWorld[3][1], cameraToWorld[3][2]);
+	m_pixelScale = projection[1][1] * 0.5f * (float)viewportHeight;
+	m_bOrthographic = (projection[2][3] == 0.0f);
+}
+
+/***********************************************************
+ *  ComputeTexturePixels()
+ *
+ *  This method is used for estimating how many pixels one
+ *  repeat of a texture covers across an object, from its
+ *  bounding sphere and UV scale.  The near side of the
+ *  sphere is used, so close objects rather get too much
+ *  detail than too little.
+ ***********************************************************/
+float TextureStreamer::ComputeTexturePixels(const glm::vec3& center, float radius, const glm::vec2& uvScale) const
+{
+	float screenDiameter = 2.0f * radius * m_pixelScale;
+	if (m_bOrthographic == false)
+	{
+		float distance = glm::length(center - m_cameraPosition) - radius;
+		screenDiameter /= std::max(distance, 0.05f);
+	}
+
+	float repeats = std::max(std::max(std::fabs(uvScale.x), std::fabs(uvScale.y)), 0.001f);
+	return(screenDiameter / repeats);
+}
+
+/***********************************************************
+ *  NoteUse()
+ *
+ *  This method is used for noting that a slot is drawn, and
+ *  the finest level that drawing it needs.
+ ***********************************************************/
+void TextureStreamer::NoteUse(int slot, float texturePixels)
+{
+	if ((slot < 0) || (slot >= (int)m_textures.size()) || (m_textures[slot].textureID == 0))
+	{
+		return;
+	}
+
+	STREAMED_TEXTURE& texture = m_textures[slot];
+	float texels = (float)std::max(texture.width, texture.height);
+	int level = (int)std::floor(std::log2(texels / std::max(texturePixels, 1.0f)));
+	level = std::max(0, std::min(level, texture.tailLevel));
+
+	texture.frameWantedLevel = std::min(texture.frameWantedLevel, level);
+	m_bUsesNoted = true;
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for moving the levels in video memory
+ *  toward what the last frame needed.  At most one texture
+ *  receives new levels per call, to keep the upload cost of
+ *  a frame small.
+ ***********************************************************/
+bool TextureStreamer::Update()
+{
+	CPU_PROFILE_ZONE("TextureStreamer::Update");
+
+	bool bChanged = false;
+
+	// an idle loop draws no frames, so nothing is learned then
+	if (m_bUsesNoted == true)
+	{
+		m_frame++;
+		for (size_t i = 0; i < m_textures.size(); i++)
+		{
+			STREAMED_TEXTURE& texture = m_textures[i];
+			if ((texture.textureID != 0) && (texture.frameWantedLevel < texture.levelCount))
+			{
+				texture.wantedLevel = texture.frameWantedLevel;
+				texture.lastUsedFrame = m_frame;
+			}
+			texture.frameWantedLevel = texture.levelCount;
+		}
+		m_bUsesNoted = false;
+	}
+
+	// swap in one finished request - requests for textures that
+	// lost levels since they were made are dropped
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		STREAMED_TEXTURE& texture = m_textures[i];
+		STREAM_REQUEST* pRequest = texture.pRequest;
+		if ((NULL == pRequest) || (pRequest->bFinished.load(std::memory_order_acquire) == false))
+		{
+			continue;
+		}
+		if ((pRequest->bLoaded == false) || (pRequest->residentLevel != texture.residentLevel))
+		{
+			FreeRequest(texture);
+			continue;
+		}
+
+		// make room, and when there is still not enough, keep
+		// only the coarser of the new levels
+		int firstLevel = pRequest->firstLevel;
+		while ((m_residentBytes + LevelBytes(texture, firstLevel, texture.residentLevel - 1) > m_budgetBytes) &&
+			(EvictOneLevel(false, (int)i) == true))
+		{
+		}
+		while ((firstLevel < texture.residentLevel) &&
+			(m_residentBytes + LevelBytes(texture, firstLevel, texture.residentLevel - 1) > m_budgetBytes))
+		{
+			firstLevel++;
+		}
+		if (firstLevel < texture.residentLevel)
+		{
+			pRequest->levels.erase(pRequest->levels.begin(),
+				pRequest->levels.begin() + (firstLevel - pRequest->firstLevel));
+			size_t uploadedBytes = LevelBytes(texture, firstLevel, texture.residentLevel - 1);
+			GLuint textureID = BuildTexture(texture, firstLevel, pRequest->levels);
+			SwapTexture((int)i, textureID, firstLevel);
+			m_stats.uploads++;
+			m_stats.uploadedBytes += uploadedBytes;
+			bChanged = true;
+		}
+		FreeRequest(texture);
+		break;
+	}
+
+	// a lowered budget or a replaced texture can leave too much
+	// resident - unused textures give up levels before used ones
+	while ((m_residentBytes > m_budgetBytes) && (EvictOneLevel(false, -1) == true))
+	{
+		bChanged = true;
+	}
+	while ((m_residentBytes > m_budgetBytes) && (EvictOneLevel(true, -1) == true))
+	{
+		bChanged = true;
+	}
+
+	// request the textures of the last frame that lack the most
+	// detail first
+	int pendingRequests = 0;
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		if (NULL != m_textures[i].pRequest)
+		{
+			pendingRequests++;
+		}
+	}
+	while (pendingRequests < MAX_PENDING_REQUESTS)
+	{
+		int bestSlot = -1;
+		int bestMissing = 0;
+		for (size_t i = 0; i < m_textures.size(); i++)
+		{
+			const STREAMED_TEXTURE& texture = m_textures[i];
+			int missing = texture.residentLevel - texture.wantedLevel;
+			if ((texture.textureID != 0) && (NULL == texture.pRequest) &&
+				(texture.lastUsedFrame == m_frame) && (missing > bestMissing))
+			{
+				bestSlot = (int)i;
+				bestMissing = missing;
+			}
+		}
+		if (bestSlot < 0)
+		{
+			break;
+		}
+		StartRequest(bestSlot);
+		if (NULL == m_textures[bestSlot].pRequest)
+		{
+			// nothing fits in the budget - try again next frame
+			break;
+		}
+		pendingRequests++;
+	}
+
+	m_stats.peakResidentBytes = std::max(m_stats.peakResidentBytes, m_residentBytes);
+
+	return(bChanged);
+}
+
+/***********************************************************
+ *  PrintStats()
+ *
+ *  This method is used for printing the video memory used
+ *  and the resident levels of every texture.
+ ***********************************************************/
+void TextureStreamer::PrintStats() const
+{
+	std::cout << "INFO: Texture streaming " << m_residentBytes / 1024 << " KB resident of a "
+		<< m_budgetBytes / 1024 << " KB budget, peak " << m_stats.peakResidentBytes / 1024
+		<< " KB, " << m_stats.requests << " requests, " << m_stats.uploads << " uploads of "
+		<< m_stats.uploadedBytes / 1024 << " KB, " << m_stats.evictions << " evictions" << std::endl;
+
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		const STREAMED_TEXTURE& texture = m_textures[i];
+		if (texture.textureID == 0)
+		{
+			continue;
+		}
+		std::cout << "INFO:   slot " << i << " " << texture.filename << " level " << texture.residentLevel
+			<< " (" << LevelSize(texture.width, texture.residentLevel) << "x"
+			<< LevelSize(texture.height, texture.residentLevel) << "), wants " << texture.wantedLevel
+			<< ", " << LevelBytes(texture, texture.residentLevel, texture.levelCount - 1) / 1024 << " KB" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  LevelBytes()
+ *
+ *  This method is used for adding up the video memory of a
+ *  range of levels.
+ ***********************************************************/
+size_t TextureStreamer::LevelBytes(const STREAMED_TEXTURE& texture, int firstLevel, int lastLevel)
+{
+	size_t bytes = 0;
+	for (int level = firstLevel; level <= lastLevel; level++)
+	{
+		bytes += (size_t)LevelSize(texture.width, level) * (size_t)LevelSize(texture.height, level) * BYTES_PER_TEXEL;
+	}
+	return(bytes);
+}
+
+/***********************************************************
+ *  DownsampleImage()
+ *
+ *  This method is used for shrinking an image by a power of
+ *  two, averaging each block of texels.  Sizes follow the
+ *  mip level rule, halved and rounded down but at least one.
+ ***********************************************************/
+void TextureStreamer::DownsampleImage(
+	const unsigned char* pSource, int width, int height, int channels, int factor,
+	std::vector<unsigned char>& result)
+{
+	int resultWidth = std::max(1, width / factor);
+	int resultHeight = std::max(1, height / factor);
+	result.resize((size_t)resultWidth * resultHeight * channels);
+
+	if (factor == 1)
+	{
+		memcpy(result.data(), pSource, result.size());
+		return;
+	}
+
+	for (int y = 0; y < resultHeight; y++)
+	{
+		int y0 = y * factor;
+		int y1 = std::min(y0 + factor, height);
+		for (int x = 0; x < resultWidth; x++)
+		{
+			int x0 = x * factor;
+			int x1 = std::min(x0 + factor, width);
+
+			unsigned int sums[4] = { 0, 0, 0, 0 };
+			for (int sy = y0; sy < y1; sy++)
+			{
+				const unsigned char* pTexel = pSource + ((size_t)sy * width + x0) * channels;
+				for (int sx = x0; sx < x1; sx++)
+				{
+					for (int c = 0; c < channels; c++)
+					{
+						sums[c] += pTexel[c];
+					}
+					pTexel += channels;
+				}
+			}
+
+			unsigned int count = (unsigned int)((y1 - y0) * (x1 - x0));
+			unsigned char* pResult = result.data() + ((size_t)y * resultWidth + x) * channels;
+			for (int c = 0; c < channels; c++)
+			{
+				pResult[c] = (unsigned char)((sums[c] + count / 2) / count);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  LoadRequest()
+ *
+ *  This method is used for decoding the image file of a
+ *  request and making its levels.  It runs on a worker
+ *  thread and does not touch OpenGL.  A file that changed
+ *  size since it was added fails; the hot reload replaces
+ *  the whole texture then.
+ ***********************************************************/
+void TextureStreamer::LoadRequest(STREAM_REQUEST* pRequest, int width, int height, int channels)
+{
+	CPU_PROFILE_ZONE("TextureStreamer::LoadRequest");
+
+	SceneManager::TEXTURE_IMAGE image;
+	pRequest->bLoaded = false;
+	if ((SceneManager::DecodeTextureImage(pRequest->filename.c_str(), image) == false) ||
+		(image.width != width) || (image.height != height) || (image.colorChannels != channels))
+	{
+		SceneManager::FreeTextureImage(image);
+		return;
+	}
+
+	pRequest->levels.resize(pRequest->residentLevel - pRequest->firstLevel);
+	DownsampleImage(image.pixels, width, height, channels, 1 << pRequest->firstLevel, pRequest->levels[0]);
+	SceneManager::FreeTextureImage(image);
+	for (size_t i = 1; i < pRequest->levels.size(); i++)
+	{
+		int level = pRequest->firstLevel + (int)i - 1;
+		DownsampleImage(pRequest->levels[i - 1].data(),
+			LevelSize(width, level), LevelSize(height, level), channels, 2, pRequest->levels[i]);
+	}
+	pRequest->bLoaded = true;
+}
+
+/***********************************************************
+ *  BuildTexture()
+ *
+ *  This method is used for creating a texture object with
+ *  storage for the levels from the first to the last.  The
+ *  given levels are uploaded and the coarser ones copied on
+ *  the GPU from the current texture object.  No texture unit
+ *  binding is changed.
+ ***********************************************************/
+GLuint TextureStreamer::BuildTexture(
+	STREAMED_TEXTURE& texture,
+	int firstLevel,
+	const std::vector<std::vector<unsigned char> >& newLevels)
+{
+	CPU_PROFILE_ZONE("TextureStreamer::BuildTexture");
+
+	GLenum internalFormat = (texture.channels == 4) ? GL_RGBA8 : GL_RGB8;
+	GLenum format = (texture.channels == 4) ? GL_RGBA : GL_RGB;
+
+	GLuint textureID = 0;
+	glCreateTextures(GL_TEXTURE_2D, 1, &textureID);
+	glTextureStorage2D(textureID, texture.levelCount - firstLevel, internalFormat,
+		LevelSize(texture.width, firstLevel), LevelSize(texture.height, firstLevel));
+
+	// set the texture wrapping and filtering parameters
+	glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// rows of RGB levels are not padded to four bytes
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (size_t i = 0; i < newLevels.size(); i++)
+	{
+		int level = firstLevel + (int)i;
+		glTextureSubImage2D(textureID, (GLint)i, 0, 0,
+			LevelSize(texture.width, level), LevelSize(texture.height, level),
+			format, GL_UNSIGNED_BYTE, newLevels[i].data());
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	for (int level = firstLevel + (int)newLevels.size(); level < texture.levelCount; level++)
+	{
+		glCopyImageSubData(
+			texture.textureID, GL_TEXTURE_2D, level - texture.residentLevel, 0, 0, 0,
+			textureID, GL_TEXTURE_2D, level - firstLevel, 0, 0, 0,
+			LevelSize(texture.width, level), LevelSize(texture.height, level), 1);
+	}
+
+	return(textureID);
+}
+
+/***********************************************************
+ *  SwapTexture()
+ *
+ *  This method is used for deleting the old texture object
+ *  of a slot and binding the new one to the slot's unit.
+ ***********************************************************/
+void TextureStreamer::SwapTexture(int slot, GLuint textureID, int residentLevel)
+{
+	STREAMED_TEXTURE& texture = m_textures[slot];
+	if (texture.textureID != 0)
+	{
+		m_residentBytes -= LevelBytes(texture, texture.residentLevel, texture.levelCount - 1);
+		glDeleteTextures(1, &texture.textureID);
+	}
+
+	texture.textureID = textureID;
+	texture.residentLevel = residentLevel;
+	if (textureID != 0)
+	{
+		m_residentBytes += LevelBytes(texture, residentLevel, texture.levelCount - 1);
+		glBindTextureUnit((GLuint)slot, textureID);
+	}
+}
+
+/***********************************************************
+ *  EvictOneLevel()
+ *
+ *  This method is used for dropping the finest level of the
+ *  texture used longest ago.  Textures used in the last
+ *  frame are only considered when asked for; among them,
+ *  ones holding more detail than they need go first.
+ ***********************************************************/
+bool TextureStreamer::EvictOneLevel(bool bIncludeUsed, int skipSlot)
+{
+	int bestSlot = -1;
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		const STREAMED_TEXTURE& texture = m_textures[i];
+		if ((texture.textureID == 0) || ((int)i == skipSlot) || (texture.residentLevel >= texture.tailLevel) ||
+			((bIncludeUsed == false) && (texture.lastUsedFrame == m_frame) && (m_frame > 0)))
+		{
+			continue;
+		}
+
+		if (bestSlot < 0)
+		{
+			bestSlot = (int)i;
+			continue;
+		}
+		const STREAMED_TEXTURE& best = m_textures[bestSlot];
+		bool bSpare = (texture.residentLevel < texture.wantedLevel);
+		bool bBestSpare = (best.residentLevel < best.wantedLevel);
+		if ((bSpare != bBestSpare) ? (bSpare == true) :
+			((texture.lastUsedFrame < best.lastUsedFrame) ||
+			((texture.lastUsedFrame == best.lastUsedFrame) && (texture.residentLevel < best.residentLevel))))
+		{
+			bestSlot = (int)i;
+		}
+	}
+	if (bestSlot < 0)
+	{
+		return(false);
+	}
+
+	STREAMED_TEXTURE& texture = m_textures[bestSlot];
+	std::vector<std::vector<unsigned char> > noLevels;
+	GLuint textureID = BuildTexture(texture, texture.residentLevel + 1, noLevels);
+	SwapTexture(bestSlot, textureID, texture.residentLevel + 1);
+	m_stats.evictions++;
+
+	return(true);
+}
+
+/***********************************************************
+ *  StartRequest()
+ *
+ *  This method is used for queueing the decoding of the
+ *  finer levels a texture needs.  It asks for no more than
+ *  fits in the budget once the textures not in use have
+ *  given up their levels.
+ ***********************************************************/
+void TextureStreamer::StartRequest(int slot)
+{
+	STREAMED_TEXTURE& texture = m_textures[slot];
+
+	size_t evictableBytes = 0;
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		const STREAMED_TEXTURE& other = m_textures[i];
+		if ((other.textureID != 0) && ((int)i != slot) && (other.lastUsedFrame != m_frame) &&
+			(other.residentLevel < other.tailLevel))
+		{
+			evictableBytes += LevelBytes(other, other.residentLevel, other.tailLevel - 1);
+		}
+	}
+	size_t keptBytes = m_residentBytes - evictableBytes;
+	size_t availableBytes = (keptBytes < m_budgetBytes) ? m_budgetBytes - keptBytes : 0;
+
+	int firstLevel = texture.wantedLevel;
+	while ((firstLevel < texture.residentLevel) &&
+		(LevelBytes(texture, firstLevel, texture.residentLevel - 1) > availableBytes))
+	{
+		firstLevel++;
+	}
+	if (firstLevel >= texture.residentLevel)
+	{
+		return;
+	}
+
+	STREAM_REQUEST* pRequest = new STREAM_REQUEST();
+	pRequest->filename = texture.filename;
+	pRequest->firstLevel = firstLevel;
+	pRequest->residentLevel = texture.residentLevel;
+	pRequest->bFinished = false;
+	pRequest->bLoaded = false;
+	texture.pRequest = pRequest;
+	m_stats.requests++;
+
+	int width = texture.width;
+	int height = texture.height;
+	int channels = texture.channels;
+	if ((NULL != m_pJobSystem) && (m_pJobSystem->GetWorkerCount() > 1))
+	{
+		WAKE_FUNCTION wake = m_wake;
+		m_pJobSystem->Run([pRequest, width, height, channels, wake](int) {
+			LoadRequest(pRequest, width, height, channels);
+			pRequest->bFinished.store(true, std::memory_order_release);
+			// let an idle main loop swap the levels in
+			if (wake)
+			{
+				wake();
+			}
+		}, &pRequest->counter, JobSystem::affinity_worker_thread);
+	}
+	else
+	{
+		LoadRequest(pRequest, width, height, channels);
+		pRequest->bFinished = true;
+	}
+}
+
+/***********************************************************
+ *  FreeRequest()
+ *
+ *  This method is used for freeing the request of a texture,
+ *  waiting for its job when it is still running.
+ ***********************************************************/
+void TextureStreamer::FreeRequest(STREAMED_TEXTURE& texture)
+{
+	if (NULL == texture.pRequest)
+	{
+		return;
+	}
+
+	if (NULL != m_pJobSystem)
+	{
+		m_pJobSystem->Wait(&texture.pRequest->counter);
+	}
+	delete texture.pRequest;
+	texture.pRequest = NULL;
+}
@@ -0,0 +1,172 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturestreamer.h
+// ============
+// keep only the mip levels the view needs in video memory, within a budget
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "JobSystem.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  TextureStreamer
+ *
+ *  This class manages the textures of the scene slots so
+ *  that only the mip levels the view needs are in video
+ *  memory.  A texture starts with just its small levels,
+ *  the mip tail, which are always kept.  While drawing, each
+ *  use of a texture notes how many pixels one repeat of it
+ *  covers on screen, from the distance of the object to the
+ *  camera and the UV scale; that decides the finest level
+ *  worth having.
+ *
+ *  Finer levels are decoded from the image file on a worker
+ *  thread and swapped in between frames, one texture at a
+ *  time, so a frame never waits for a texture.  When the
+ *  levels in video memory would exceed the budget, the least
+ *  recently used textures give up their finest levels first.
+ *  Textures drawn in the current frame are only reduced when
+ *  nothing else is left, and never below the mip tail.
+ *
+ *  A texture object holds exactly its resident levels, so
+ *  changing them creates a new object: levels already in
+ *  video memory are copied on the GPU, and only new levels
+ *  are uploaded.
+ ***********************************************************/
+class TextureStreamer
+{
+public:
+	typedef std::function<void()> WAKE_FUNCTION;
+
+	// counts since the streamer was created
+	struct STREAM_STATS
+	{
+		int requests;
+		int uploads;
+		int evictions;
+		size_t uploadedBytes;
+		size_t peakResidentBytes;
+	};
+
+	// constructor - the budget is in bytes
+	TextureStreamer(size_t budgetBytes, JobSystem* pJobSystem);
+	// destructor
+	~TextureStreamer();
+
+	// call from other threads when a decoded level is ready
+	void SetWakeFunction(const WAKE_FUNCTION& wake) { m_wake = wake; }
+
+	// create the texture of a slot from a decoded image, with
+	// only the mip tail resident - returns the texture, or zero
+	GLuint AddTexture(int slot, const SceneManager::TEXTURE_IMAGE& image);
+	// replace the texture of a slot with a newly decoded image,
+	// keeping the same levels resident - returns the texture
+	GLuint ReplaceTexture(int slot, const SceneManager::TEXTURE_IMAGE& image);
+	// delete every texture
+	void RemoveAll();
+	// the texture of a slot, or zero
+	GLuint GetTextureID(int slot) const;
+
+	// set the view the next frame is drawn with
+	void SetView(const glm::mat4& view, const glm::mat4& projection, int viewportHeight);
+	// screen pixels covered by one repeat of a texture on an
+	// object - safe on any thread while drawing
+	float ComputeTexturePixels(const glm::vec3& center, float radius, const glm::vec2& uvScale) const;
+	// note that a slot is drawn covering that many pixels
+	void NoteUse(int slot, float texturePixels);
+
+	// swap in decoded levels, give up levels over the budget and
+	// request the levels the last frame needed - call between
+	// frames on the OpenGL thread, returns true when a texture
+	// changed
+	bool Update();
+
+	// bytes of the levels in video memory
+	size_t GetResidentBytes() const { return(m_residentBytes); }
+	const STREAM_STATS& GetStats() const { return(m_stats); }
+	// print the residency of every texture
+	void PrintStats() const;
+
+private:
+	// finer levels being decoded in the background
+	struct STREAM_REQUEST
+	{
+		std::string filename;
+		// levels decoded, from the first up to but not including
+		// the level that was resident when requested
+		int firstLevel;
+		int residentLevel;
+		JobCounter counter;
+		std::atomic<bool> bFinished;
+		bool bLoaded;
+		std::vector<std::vector<unsigned char> > levels;
+	};
+
+	struct STREAMED_TEXTURE
+	{
+		std::string filename;
+		GLuint textureID;
+		int width;
+		int height;
+		int channels;
+		int levelCount;
+		// first level of the mip tail, which is never dropped
+		int tailLevel;
+		// finest level in video memory, and finest level needed
+		int residentLevel;
+		int wantedLevel;
+		// finest level noted in the frame being drawn
+		int frameWantedLevel;
+		uint64_t lastUsedFrame;
+		STREAM_REQUEST* pRequest;
+	};
+
+	size_t m_budgetBytes;
+	JobSystem* m_pJobSystem;
+	WAKE_FUNCTION m_wake;
+	std::vector<STREAMED_TEXTURE> m_textures;
+	size_t m_residentBytes;
+	uint64_t m_frame;
+	bool m_bUsesNoted;
+	// the view - camera position, and screen pixels per unit at
+	// unit distance
+	glm::vec3 m_cameraPosition;
+	float m_pixelScale;
+	bool m_bOrthographic;
+	STREAM_STATS m_stats;
+
+	// bytes of levels first to last of a texture
+	static size_t LevelBytes(const STREAMED_TEXTURE& texture, int firstLevel, int lastLevel);
+	// box filter an image down by a power of two
+	static void DownsampleImage(
+		const unsigned char* pSource, int width, int height, int channels, int factor,
+		std::vector<unsigned char>& result);
+	// decode the image file and make the requested levels
+	static void LoadRequest(STREAM_REQUEST* pRequest, int width, int height, int channels);
+
+	// create a texture object holding the levels from first to
+	// the last, uploading the given ones and copying the rest
+	// from the current texture
+	GLuint BuildTexture(
+		STREAMED_TEXTURE& texture,
+		int firstLevel,
+		const std::vector<std::vector<unsigned char> >& newLevels);
+	// put a new texture object in place of the old one
+	void SwapTexture(int slot, GLuint textureID, int residentLevel);
+	// give up the finest level of the least recently used
+	// texture other than the skipped slot - false when nothing
+	// can be given up
+	bool EvictOneLevel(bool bIncludeUsed, int skipSlot);
+	// start decoding the finer levels a texture needs
+	void StartRequest(int slot);
+	// free a request once its job has finished
+	void FreeRequest(STREAMED_TEXTURE& texture);
+};
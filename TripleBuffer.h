@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////////////
+// triplebuffer.h
+// ============
+// lock-free single producer / single consumer hand-off of the latest value
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+
+/***********************************************************
+ *  TripleBuffer
+ *
+ *  This class hands the most recent value from one producer
+ *  thread to one consumer thread without locking.  The
+ *  producer writes into its own slot and publishes it by
+ *  swapping it with the shared middle slot; the consumer
+ *  swaps the middle slot with its own slot when a new value
+ *  is waiting.  Neither side ever waits for the other, and
+ *  values the consumer did not get to are simply skipped.
+ ***********************************************************/
+template <typename T>
+class TripleBuffer
+{
+public:
+	// constructor
+	TripleBuffer()
+	{
+		m_writeIndex = 0;
+		m_middle.store(1, std::memory_order_relaxed);
+		m_readIndex = 2;
+	}
+
+	// set every slot to the same starting value
+	void Reset(const T& value)
+	{
+		m_slots[0] = value;
+		m_slots[1] = value;
+		m_slots[2] = value;
+		m_middle.store(m_middle.load(std::memory_order_relaxed) & INDEX_MASK,
+			std::memory_order_release);
+	}
+
+	// producer - the slot to fill in before Publish()
+	T& GetWriteBuffer() { return(m_slots[m_writeIndex]); }
+	// producer - make the filled in slot the latest value
+	void Publish()
+	{
+		int previous = m_middle.exchange(m_writeIndex | NEW_VALUE_BIT, std::memory_order_acq_rel);
+		m_writeIndex = previous & INDEX_MASK;
+	}
+
+	// consumer - take the latest value if a new one was
+	// published, returns false when nothing changed
+	bool Update()
+	{
+		if ((m_middle.load(std::memory_order_relaxed) & NEW_VALUE_BIT) == 0)
+		{
+			return(false);
+		}
+		int previous = m_middle.exchange(m_readIndex, std::memory_order_acq_rel);
+		m_readIndex = previous & INDEX_MASK;
+		return(true);
+	}
+	// consumer - the value taken by the last Update()
+	const T& GetReadBuffer() const { return(m_slots[m_readIndex]); }
+
+private:
+	static const int INDEX_MASK = 3;
+	static const int NEW_VALUE_BIT = 4;
+
+	T m_slots[3];
+	// slot owned by the producer
+	alignas(64) int m_writeIndex;
+	// shared slot, with a bit set while it holds a new value
+	alignas(64) std::atomic<int> m_middle;
+	// slot owned by the consumer
+	alignas(64) int m_readIndex;
+};
@@ -1,294 +1,1005 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.cpp
-// ============
-// manage the viewing of 3D objects within the viewport - camera, projection
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "ViewManager.h"
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>    
-
-// declaration of the global variables and defines
-namespace
-{
-	// Variables for window width and height
-	const int WINDOW_WIDTH = 1000;
-	const int WINDOW_HEIGHT = 800;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
-
-	// camera object used for viewing and interacting with
-	// the 3D scene
-	Camera* g_pCamera = nullptr;
-
-	// these variables are used for mouse movement processing
-	float gLastX = WINDOW_WIDTH / 2.0f;
-	float gLastY = WINDOW_HEIGHT / 2.0f;
-	bool gFirstMouse = true;
-
-	// time between current frame and last frame
-	float gDeltaTime = 0.0f; 
-	float gLastFrame = 0.0f;
-
-	// the following variable is false when orthographic projection
-	// is off and true when it is on
-	bool bOrthographicProjection = false;
-}
-
-/***********************************************************
- *  ViewManager()
- *
- *  The constructor for the class
- ***********************************************************/
-ViewManager::ViewManager(
-	ShaderManager *pShaderManager)
-{
-	// initialize the member variables
-	m_pShaderManager = pShaderManager;
-	m_pWindow = NULL;
-	g_pCamera = new Camera();
-	// default camera view parameters
-	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
-	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	g_pCamera->Zoom = 80;
-	g_pCamera->MovementSpeed = 20;
-}
-
-/***********************************************************
- *  ~ViewManager()
- *
- *  The destructor for the class
- ***********************************************************/
-ViewManager::~ViewManager()
-{
-	// free up allocated memory
-	m_pShaderManager = NULL;
-	m_pWindow = NULL;
-	if (NULL != g_pCamera)
-	{
-		delete g_pCamera;
-		g_pCamera = NULL;
-	}
-}
-
-/***********************************************************
- *  CreateDisplayWindow()
- *
- *  This method is used to create the main display window.
- ***********************************************************/
-GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
-{
-	GLFWwindow* window = nullptr;
-
-	// try to create the displayed OpenGL window
-	window = glfwCreateWindow(
-		WINDOW_WIDTH,
-		WINDOW_HEIGHT,
-		windowTitle,
-		NULL, NULL);
-	if (window == NULL)
-	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
-		return NULL;
-	}
-	glfwMakeContextCurrent(window);
-
-	// this callback is used to receive mouse moving events
-	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
-
-	// this callback is used to receive mouse scroll wheel events
-	glfwSetScrollCallback(window, &ViewManager::Mouse_Scroll_Wheel_Callback);
-
-	// tell GLFW to capture all mouse events
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-	// enable blending for supporting tranparent rendering
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	m_pWindow = window;
-
-	return(window);
-}
-
-/***********************************************************
- *  Mouse_Position_Callback()
- *
- *  This method is automatically called from GLFW whenever
- *  the mouse is moved within the active GLFW display window.
- ***********************************************************/
-void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
-{
-	// when the first mouse move event is received, this needs to be recorded so that
-	// all subsequent mouse moves can correctly calculate the X position offset and Y
-	// position offset for proper operation
-	if (gFirstMouse)
-	{
-		gLastX = xMousePos;
-		gLastY = yMousePos;
-		gFirstMouse = false;
-	}
-
-	// calculate the X offset and Y offset values for moving the 3D camera accordingly
-	float xOffset = xMousePos - gLastX;
-	float yOffset = gLastY - yMousePos; // reversed since y-coordinates go from bottom to top
-
-	// set the current positions into the last position variables
-	gLastX = xMousePos;
-	gLastY = yMousePos;
-
-	// move the 3D camera according to the calculated offsets
-	g_pCamera->ProcessMouseMovement(xOffset, yOffset);
-}
-/***********************************************************
- *  Mouse_Scroll_Wheel_Callback()
- *
- *  This method is automatically called from GLFW whenever
- *  the mouse wheel is scrolled within the active GLFW display window.
- ***********************************************************/
-void ViewManager::Mouse_Scroll_Wheel_Callback(GLFWwindow* window, double x, double yScrollDistance)
-{
-	// mouse scroll: speed up or slow down camera movement
-	g_pCamera->ProcessMouseScroll(static_cast<float>(yScrollDistance));
-}
-
-/***********************************************************
- *  ProcessKeyboardEvents()
- *
- *  This method is called to process any keyboard events
- *  that may be waiting in the event queue.
- ***********************************************************/
-void ViewManager::ProcessKeyboardEvents()
-{
-	// close the window if the escape key has been pressed
-	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(m_pWindow, true);
-	}
-
-	// process camera zooming in and out
-	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime);
-	}
-
-	// process camera panning left and right
-	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(LEFT, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime);
-	}
-	// *** I added up and down for Q and E
-	// process camera panning up and down
-	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(UP, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime);
-	}
-
-	//*** Added from Mod 1 openGL Sample
-	// Changed 1 to O, 4 to P.
-	// change between different projection views
-	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
-	{
-		// change to a multi-view orthographic projection
-		bOrthographicProjection = true;
-
-		// change the camera settings to show a front orthographic view
-		g_pCamera->Position = glm::vec3(0.0f, 4.0f, 10.0f);
-		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-		g_pCamera->Front = glm::vec3(0.0f, 0.0f, -1.0f);
-	}
-
-	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
-	{
-		// change to perspective projection
-		bOrthographicProjection = false;
-
-		// change the camera settings to show a perspective view
-		g_pCamera->Position = glm::vec3(0.0f, 5.5f, 8.0f);
-		g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-		g_pCamera->Zoom = 80;
-	}
-}
-
-/***********************************************************
- *  PrepareSceneView()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void ViewManager::PrepareSceneView()
-{
-	glm::mat4 view;
-	glm::mat4 projection;
-
-	// per-frame timing
-	float currentFrame = glfwGetTime();
-	gDeltaTime = currentFrame - gLastFrame;
-	gLastFrame = currentFrame;
-
-	// process any keyboard events that may be waiting in the 
-	// event queue
-	ProcessKeyboardEvents();
-
-	// get the current view matrix from the camera
-	view = g_pCamera->GetViewMatrix();
-
-	// define the current projection matrix
-	if (bOrthographicProjection == false)
-	{
-		//***Added from OpenGL Sample
-		// perspective projection
-		projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
-	}
-	else
-	{
-		// front-view orthographic projection with correct aspect ratio
-		double scale = 0.0;
-		if (WINDOW_WIDTH > WINDOW_HEIGHT)
-		{
-			scale = (double)WINDOW_HEIGHT / (double)WINDOW_WIDTH;
-			projection = glm::ortho(-12.0f, 12.0f, -12.0f * (float)scale, 12.0f * (float)scale, 0.1f, 200.0f);
-		}
-		else if (WINDOW_WIDTH < WINDOW_HEIGHT)
-		{
-			scale = (double)WINDOW_WIDTH / (double)WINDOW_HEIGHT;
-			projection = glm::ortho(-12.0f * (float)scale, 12.0f * (float)scale, -12.0f, 12.0f, 0.1f, 200.0f);
-		}
-		else
-		{
-			projection = glm::ortho(-12.0f, 12.0f, -12.0f, 12.0f, 0.1f, 200.0f);
-		}
-	}
-	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
-	{
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
-	}
-}
\ No newline at end of file
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.cpp
+// ============
+// manage the viewing of 3D objects within the viewport - camera, projection
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ViewManager.h"
+#include "CPUProfiler.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>    
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+// declaration of the global variables and defines
+namespace
+{
+	// Variables for window width and height
+	const int WINDOW_WIDTH = 1000;
+	const int WINDOW_HEIGHT = 800;
+	const char* g_ViewName = "view";
+	const char* g_ProjectionName = "projection";
+
+	// camera object used for viewing and interacting with
+	// the 3D scene
+	Camera* g_pCamera = nullptr;
+
+	// size of the window's framebuffer in pixels - differs
+	// from the window size on high density displays, and is
+	// zero while the window is minimized
+	int g_FramebufferWidth = WINDOW_WIDTH;
+	int g_FramebufferHeight = WINDOW_HEIGHT;
+	// aspect ratio of the last framebuffer that had a size
+	float g_FramebufferAspect = (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT;
+
+	// these variables are used for mouse movement processing
+	float gLastX = WINDOW_WIDTH / 2.0f;
+	float gLastY = WINDOW_HEIGHT / 2.0f;
+	bool gFirstMouse = true;
+
+	// time between current frame and last frame
+	float gDeltaTime = 0.0f; 
+	float gLastFrame = 0.0f;
+
+	// the following variable is false when orthographic projection
+	// is off and true when it is on
+	bool bOrthographicProjection = false;
+
+	// keys forwarded to the simulation thread, one bit per key
+	enum INPUT_KEY
+	{
+		key_forward = 1 << 0,
+		key_backward = 1 << 1,
+		key_left = 1 << 2,
+		key_right = 1 << 3,
+		key_up = 1 << 4,
+		key_down = 1 << 5,
+		key_orthographic = 1 << 6,
+		key_perspective = 1 << 7
+	};
+
+	// input gathered by the callbacks on the main thread and
+	// consumed by the simulation thread
+	std::atomic<bool> g_bSimulationInput(false);
+	std::atomic<uint32_t> g_KeysDown(0);
+	std::atomic<uint32_t> g_KeysPressed(0);
+	std::atomic<float> g_MouseDeltaX(0.0f);
+	std::atomic<float> g_MouseDeltaY(0.0f);
+	std::atomic<float> g_ScrollDelta(0.0f);
+
+	// time of the oldest input not yet shown in a frame, or
+	// zero - used for measuring input-to-photon latency
+	std::atomic<double> g_PendingInputTime(0.0);
+
+	// set when the window contents were damaged and must be
+	// drawn again even though nothing changed
+	std::atomic<bool> g_bWindowDamaged(true);
+
+	/***********************************************************
+	 *  AddAtomic()
+	 *
+	 *  Adds to an atomic float without locking.
+	 ***********************************************************/
+	void AddAtomic(std::atomic<float>& value, float amount)
+	{
+		float current = value.load(std::memory_order_relaxed);
+		while (!value.compare_exchange_weak(current, current + amount, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	/***********************************************************
+	 *  NowSeconds()
+	 *
+	 *  Seconds on the steady clock, comparable across threads.
+	 ***********************************************************/
+	double NowSeconds()
+	{
+		return(std::chrono::duration<double>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	/***********************************************************
+	 *  NoteInputTime()
+	 *
+	 *  Timestamps an input event unless an older one is still
+	 *  waiting to be shown.
+	 ***********************************************************/
+	void NoteInputTime()
+	{
+		double expected = 0.0;
+		g_PendingInputTime.compare_exchange_strong(expected, NowSeconds(), std::memory_order_relaxed);
+	}
+}
+
+/***********************************************************
+ *  ViewManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ViewManager::ViewManager(
+	ShaderManager *pShaderManager)
+{
+	// initialize the member variables
+	m_pShaderManager = pShaderManager;
+	m_pWindow = NULL;
+	m_pPlaybackPath = NULL;
+	m_pRecordPath = NULL;
+	m_fixedTimestep = 0.0f;
+	m_pathTime = 0.0f;
+	m_viewMatrix = glm::mat4(1.0f);
+	m_projectionMatrix = glm::mat4(1.0f);
+	m_unjitteredProjection = glm::mat4(1.0f);
+	m_projectionJitter = glm::vec2(0.0f);
+	m_bStopSimulation = false;
+	m_bSimulationRunning = false;
+	m_simulationStep = 0.0;
+	m_frameInputTime = 0.0;
+	m_bHasLastCamera = false;
+	m_bReverseDepth = false;
+	m_bInfiniteFar = false;
+	m_farPlane = 100.0f;
+	g_pCamera = new Camera();
+	// default camera view parameters
+	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
+	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Zoom = 80;
+	g_pCamera->MovementSpeed = 20;
+}
+
+/***********************************************************
+ *  ~ViewManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ViewManager::~ViewManager()
+{
+	// the simulation thread uses the camera until it stops
+	StopSimulation();
+
+	// free up allocated memory
+	m_pShaderManager = NULL;
+	m_pWindow = NULL;
+	if (NULL != g_pCamera)
+	{
+		delete g_pCamera;
+		g_pCamera = NULL;
+	}
+}
+
+/***********************************************************
+ *  CreateDisplayWindow()
+ *
+ *  This method is used to create the main display window.
+ ***********************************************************/
+GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
+{
+	GLFWwindow* window = nullptr;
+
+	// try to create the displayed OpenGL window
+	window = glfwCreateWindow(
+		WINDOW_WIDTH,
+		WINDOW_HEIGHT,
+		windowTitle,
+		NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+	glfwMakeContextCurrent(window);
+
+	// this callback is used to receive mouse moving events
+	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
+
+	// this callback is used to receive mouse scroll wheel events
+	glfwSetScrollCallback(window, &ViewManager::Mouse_Scroll_Wheel_Callback);
+
+	// this callback is used to receive key events for the simulation thread
+	glfwSetKeyCallback(window, &ViewManager::Key_Callback);
+
+	// this callback is used to redraw the window when it was uncovered
+	glfwSetWindowRefreshCallback(window, &ViewManager::Window_Refresh_Callback);
+
+	// this callback is used to follow the framebuffer when the
+	// window is resized or moved to a display of another density
+	glfwSetFramebufferSizeCallback(window, &ViewManager::Framebuffer_Size_Callback);
+	int framebufferWidth = 0;
+	int framebufferHeight = 0;
+	glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+	Framebuffer_Size_Callback(window, framebufferWidth, framebufferHeight);
+
+	// tell GLFW to capture all mouse events
+	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+	// enable blending for supporting tranparent rendering
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	m_pWindow = window;
+
+	return(window);
+}
+
+/***********************************************************
+ *  Mouse_Position_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the mouse is moved within the active GLFW display window.
+ ***********************************************************/
+void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
+{
+	NoteInputTime();
+
+	// when the first mouse move event is received, this needs to be recorded so that
+	// all subsequent mouse moves can correctly calculate the X position offset and Y
+	// position offset for proper operation
+	if (gFirstMouse)
+	{
+		gLastX = xMousePos;
+		gLastY = yMousePos;
+		gFirstMouse = false;
+	}
+
+	// calculate the X offset and Y offset values for moving the 3D camera accordingly
+	float xOffset = xMousePos - gLastX;
+	float yOffset = gLastY - yMousePos; // reversed since y-coordinates go from bottom to top
+
+	// set the current positions into the last position variables
+	gLastX = xMousePos;
+	gLastY = yMousePos;
+
+	// while the simulation thread owns the camera, the offsets
+	// are accumulated for its next step
+	if (g_bSimulationInput.load(std::memory_order_relaxed) == true)
+	{
+		AddAtomic(g_MouseDeltaX, xOffset);
+		AddAtomic(g_MouseDeltaY, yOffset);
+		return;
+	}
+
+	// move the 3D camera according to the calculated offsets
+	g_pCamera->ProcessMouseMovement(xOffset, yOffset);
+}
+/***********************************************************
+ *  Mouse_Scroll_Wheel_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the mouse wheel is scrolled within the active GLFW display window.
+ ***********************************************************/
+void ViewManager::Mouse_Scroll_Wheel_Callback(GLFWwindow* window, double x, double yScrollDistance)
+{
+	NoteInputTime();
+
+	if (g_bSimulationInput.load(std::memory_order_relaxed) == true)
+	{
+		AddAtomic(g_ScrollDelta, static_cast<float>(yScrollDistance));
+		return;
+	}
+
+	// mouse scroll: speed up or slow down camera movement
+	g_pCamera->ProcessMouseScroll(static_cast<float>(yScrollDistance));
+}
+
+/***********************************************************
+ *  Key_Callback()
+ *
+ *  This method is automatically called from GLFW whenever a
+ *  key is pressed or released.  The key state is kept in
+ *  atomics for the simulation thread, which cannot poll GLFW
+ *  itself.  Presses are latched so taps shorter than one
+ *  simulation step are not lost.
+ ***********************************************************/
+void ViewManager::Key_Callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	// the escape key is handled right away on the main thread
+	if ((key == GLFW_KEY_ESCAPE) && (action == GLFW_PRESS))
+	{
+		glfwSetWindowShouldClose(window, true);
+		return;
+	}
+
+	uint32_t keyBit = 0;
+	switch (key)
+	{
+	case GLFW_KEY_W: keyBit = key_forward; break;
+	case GLFW_KEY_S: keyBit = key_backward; break;
+	case GLFW_KEY_A: keyBit = key_left; break;
+	case GLFW_KEY_D: keyBit = key_right; break;
+	case GLFW_KEY_Q: keyBit = key_up; break;
+	case GLFW_KEY_E: keyBit = key_down; break;
+	case GLFW_KEY_O: keyBit = key_orthographic; break;
+	case GLFW_KEY_P: keyBit = key_perspective; break;
+	default: return;
+	}
+
+	NoteInputTime();
+
+	if (action == GLFW_PRESS)
+	{
+		g_KeysDown.fetch_or(keyBit, std::memory_order_relaxed);
+		g_KeysPressed.fetch_or(keyBit, std::memory_order_relaxed);
+	}
+	else if (action == GLFW_RELEASE)
+	{
+		g_KeysDown.fetch_and(~keyBit, std::memory_order_relaxed);
+	}
+}
+
+/***********************************************************
+ *  Window_Refresh_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the contents of the window need to be drawn again, for
+ *  example after it was uncovered or resized.
+ ***********************************************************/
+void ViewManager::Window_Refresh_Callback(GLFWwindow* window)
+{
+	g_bWindowDamaged.store(true, std::memory_order_relaxed);
+}
+
+/***********************************************************
+ *  Framebuffer_Size_Callback()
+ *
+ *  This method is called by GLFW when the framebuffer of the
+ *  window changes size.  The projection follows on the next
+ *  frame, which is drawn even when nothing else changed.
+ ***********************************************************/
+void ViewManager::Framebuffer_Size_Callback(GLFWwindow* window, int width, int height)
+{
+	g_FramebufferWidth = width;
+	g_FramebufferHeight = height;
+	if ((width > 0) && (height > 0))
+	{
+		g_FramebufferAspect = (float)width / (float)height;
+	}
+	g_bWindowDamaged.store(true, std::memory_order_relaxed);
+}
+
+/***********************************************************
+ *  ProcessKeyboardEvents()
+ *
+ *  This method is called to process any keyboard events
+ *  that may be waiting in the event queue.
+ ***********************************************************/
+void ViewManager::ProcessKeyboardEvents()
+{
+	CPU_PROFILE_ZONE("ViewManager::ProcessKeyboardEvents");
+
+	// close the window if the escape key has been pressed
+	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	{
+		glfwSetWindowShouldClose(m_pWindow, true);
+	}
+
+	// process camera zooming in and out
+	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
+	{
+		g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime);
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
+	{
+		g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime);
+	}
+
+	// process camera panning left and right
+	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
+	{
+		g_pCamera->ProcessKeyboard(LEFT, gDeltaTime);
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
+	{
+		g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime);
+	}
+	// *** I added up and down for Q and E
+	// process camera panning up and down
+	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
+	{
+		g_pCamera->ProcessKeyboard(UP, gDeltaTime);
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
+	{
+		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime);
+	}
+
+	//*** Added from Mod 1 openGL Sample
+	// Changed 1 to O, 4 to P.
+	// change between different projection views
+	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
+	{
+		// change to a multi-view orthographic projection
+		bOrthographicProjection = true;
+
+		// change the camera settings to show a front orthographic view
+		g_pCamera->Position = glm::vec3(0.0f, 4.0f, 10.0f);
+		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+		g_pCamera->Front = glm::vec3(0.0f, 0.0f, -1.0f);
+	}
+
+	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
+	{
+		// change to perspective projection
+		bOrthographicProjection = false;
+
+		// change the camera settings to show a perspective view
+		g_pCamera->Position = glm::vec3(0.0f, 5.5f, 8.0f);
+		g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+		g_pCamera->Zoom = 80;
+	}
+}
+
+/***********************************************************
+ *  PrepareSceneView()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering
+ ***********************************************************/
+void ViewManager::PrepareSceneView()
+{
+	CPU_PROFILE_ZONE("ViewManager::PrepareSceneView");
+
+	glm::mat4 view;
+	glm::mat4 projection;
+
+	// per-frame timing - a fixed step keeps playback deterministic
+	if (m_fixedTimestep > 0.0f)
+	{
+		gDeltaTime = m_fixedTimestep;
+	}
+	else
+	{
+		float currentFrame = glfwGetTime();
+		gDeltaTime = currentFrame - gLastFrame;
+		gLastFrame = currentFrame;
+	}
+
+	CAMERA_STATE camera;
+	// input older than this is reflected in the camera
+	double inputCutoff = NowSeconds();
+	if (NULL != m_pPlaybackPath)
+	{
+		// the camera follows the path - only the escape key is
+		// still honored so playback can be interrupted
+		if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		{
+			glfwSetWindowShouldClose(m_pWindow, true);
+		}
+
+		CameraPath::CAMERA_KEYFRAME keyframe = m_pPlaybackPath->Sample(m_pathTime);
+		g_pCamera->Position = keyframe.position;
+		g_pCamera->Front = keyframe.front;
+		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+		g_pCamera->Zoom = keyframe.zoom;
+		bOrthographicProjection = keyframe.bOrthographic;
+		camera = CaptureCameraState();
+	}
+	else if (m_bSimulationRunning == true)
+	{
+		// the simulation thread owns the camera - blend its last
+		// two steps by how far the clock is past the latest one
+		m_simulationFrames.Update();
+		const SIMULATION_FRAME& frame = m_simulationFrames.GetReadBuffer();
+		float alpha = (float)((NowSeconds() - frame.stepTime) / m_simulationStep);
+		camera = InterpolateCameraState(frame.previous, frame.current, alpha);
+		inputCutoff = frame.stepTime;
+	}
+	else
+	{
+		// process any keyboard events that may be waiting in the 
+		// event queue
+		ProcessKeyboardEvents();
+		camera = CaptureCameraState();
+	}
+
+	// remember what this frame shows for change tracking
+	m_lastCamera = camera;
+	m_bHasLastCamera = true;
+	g_bWindowDamaged.store(false, std::memory_order_relaxed);
+
+	// the oldest pending input is shown from this frame on
+	m_frameInputTime = 0.0;
+	double inputTime = g_PendingInputTime.load(std::memory_order_relaxed);
+	if ((NULL == m_pPlaybackPath) && (inputTime > 0.0) && (inputTime <= inputCutoff))
+	{
+		m_frameInputTime = g_PendingInputTime.exchange(0.0, std::memory_order_relaxed);
+	}
+
+	// record the resulting camera state for later playback
+	if (NULL != m_pRecordPath)
+	{
+		CameraPath::CAMERA_KEYFRAME keyframe;
+		keyframe.time = m_pathTime;
+		keyframe.position = camera.position;
+		keyframe.front = camera.front;
+		keyframe.zoom = camera.zoom;
+		keyframe.bOrthographic = camera.bOrthographic;
+		m_pRecordPath->AddKeyframe(keyframe);
+	}
+	m_pathTime += gDeltaTime;
+
+	// get the current view matrix from the camera
+	if (m_bSimulationRunning == true)
+	{
+		view = glm::lookAt(camera.position, camera.position + camera.front, camera.up);
+	}
+	else
+	{
+		view = g_pCamera->GetViewMatrix();
+	}
+
+	// define the current projection matrix
+	projection = ComputeProjection(camera, g_FramebufferAspect);
+	m_unjitteredProjection = projection;
+	// move the image by the jitter after the perspective divide,
+	// so every depth shifts by the same part of a pixel
+	if ((m_projectionJitter.x != 0.0f) || (m_projectionJitter.y != 0.0f))
+	{
+		projection = glm::translate(glm::vec3(m_projectionJitter.x, m_projectionJitter.y, 0.0f)) * projection;
+	}
+	// keep the matrices for culling and other per-frame users
+	m_viewMatrix = view;
+	m_projectionMatrix = projection;
+
+	// if the shader manager object is valid
+	if (NULL != m_pShaderManager)
+	{
+		// set the view matrix into the shader for proper rendering
+		m_pShaderManager->setMat4Value(g_ViewName, view);
+		// set the view matrix into the shader for proper rendering
+		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
+		// set the view position of the camera into the shader for proper rendering
+		m_pShaderManager->setVec3Value("viewPosition", camera.position);
+	}
+}
+
+/***********************************************************
+ *  ComputeProjection()
+ *
+ *  This method is used for getting the perspective or
+ *  front-view orthographic projection of a camera for a
+ *  viewport of the aspect ratio, width over height.
+ *
+ *  With reverse depth the near plane maps to a depth of one
+ *  and the far plane to zero, in the zero to one clip range
+ *  set with glClipControl().  Floating point depth values are
+ *  densest near zero, which then cancels the perspective
+ *  divide bunching the depths up at the near plane, so the
+ *  precision is almost even over the whole range.  This
+ *  also allows a perspective far plane at infinity.
+ ***********************************************************/
+glm::mat4 ViewManager::ComputeProjection(const CAMERA_STATE& camera, float aspect) const
+{
+	const float NEAR_PLANE = 0.1f;
+
+	glm::mat4 projection;
+	if (camera.bOrthographic == false)
+	{
+		//***Added from OpenGL Sample
+		// perspective projection
+		projection = glm::perspective(glm::radians(camera.zoom), aspect, NEAR_PLANE, m_farPlane);
+		if (m_bReverseDepth == true)
+		{
+			// clip z = near * (far / (far - near)) - z * (near /
+			// (far - near)) over -z, or just near over -z for an
+			// infinite far plane
+			float depthScale = 0.0f;
+			float depthOffset = NEAR_PLANE;
+			if (m_bInfiniteFar == false)
+			{
+				depthScale = NEAR_PLANE / (m_farPlane - NEAR_PLANE);
+				depthOffset = m_farPlane * NEAR_PLANE / (m_farPlane - NEAR_PLANE);
+			}
+			projection[2][2] = depthScale;
+			projection[3][2] = depthOffset;
+		}
+		return(projection);
+	}
+
+	// front-view orthographic projection with correct aspect
+	// ratio - its depth is linear, so the far plane only moves
+	// out to a longer camera range and is never infinite
+	float farPlane = std::max(m_farPlane, 200.0f);
+	if (aspect > 1.0f)
+	{
+		projection = glm::ortho(-12.0f, 12.0f, -12.0f / aspect, 12.0f / aspect, NEAR_PLANE, farPlane);
+	}
+	else
+	{
+		projection = glm::ortho(-12.0f * aspect, 12.0f * aspect, -12.0f, 12.0f, NEAR_PLANE, farPlane);
+	}
+	if (m_bReverseDepth == true)
+	{
+		// depth = (far + z) / (far - near), one at the near plane
+		projection[2][2] = 1.0f / (farPlane - NEAR_PLANE);
+		projection[3][2] = farPlane / (farPlane - NEAR_PLANE);
+	}
+	return(projection);
+}
+
+/***********************************************************
+ *  GetFramebufferSize()
+ *
+ *  This method is used for getting the size of the window's
+ *  framebuffer in pixels, as of the last resize.
+ ***********************************************************/
+void ViewManager::GetFramebufferSize(int& width, int& height) const
+{
+	width = g_FramebufferWidth;
+	height = g_FramebufferHeight;
+}
+
+/***********************************************************
+ *  IsWindowMinimized()
+ *
+ *  This method is used for checking whether the framebuffer
+ *  has no pixels to draw into.
+ ***********************************************************/
+bool ViewManager::IsWindowMinimized() const
+{
+	return((g_FramebufferWidth <= 0) || (g_FramebufferHeight <= 0));
+}
+
+/***********************************************************
+ *  SetDepthRange()
+ *
+ *  This method is used for choosing how the projections map
+ *  distance to depth.  Reverse depth needs the clip range of
+ *  zero to one, a floating point depth buffer, a depth clear
+ *  value of zero and the greater depth test - the caller
+ *  sets those up.  An infinite far plane needs reverse depth
+ *  and makes the far distance only apply to the orthographic
+ *  projection.
+ ***********************************************************/
+void ViewManager::SetDepthRange(bool bReverseDepth, bool bInfiniteFar, float farPlane)
+{
+	m_bReverseDepth = bReverseDepth;
+	m_bInfiniteFar = bInfiniteFar && bReverseDepth;
+	m_farPlane = farPlane;
+}
+
+/***********************************************************
+ *  GetCameraView()
+ *
+ *  This method is used for getting the camera of the last
+ *  prepared frame projected for a viewport of another aspect
+ *  ratio, width over height.
+ ***********************************************************/
+void ViewManager::GetCameraView(float aspect, glm::mat4& view, glm::mat4& projection, glm::vec3& position) const
+{
+	view = m_viewMatrix;
+	projection = ComputeProjection(m_lastCamera, aspect);
+	position = m_lastCamera.position;
+}
+
+/***********************************************************
+ *  GetFrontView()
+ *
+ *  This method is used for getting the fixed orthographic
+ *  front view that the O key switches the camera to, for a
+ *  viewport of the aspect ratio, width over height.
+ ***********************************************************/
+void ViewManager::GetFrontView(float aspect, glm::mat4& view, glm::mat4& projection, glm::vec3& position) const
+{
+	CAMERA_STATE camera;
+	camera.position = glm::vec3(0.0f, 4.0f, 10.0f);
+	camera.front = glm::vec3(0.0f, 0.0f, -1.0f);
+	camera.up = glm::vec3(0.0f, 1.0f, 0.0f);
+	camera.zoom = 80.0f;
+	camera.bOrthographic = true;
+
+	view = glm::lookAt(camera.position, camera.position + camera.front, camera.up);
+	projection = ComputeProjection(camera, aspect);
+	position = camera.position;
+}
+
+/***********************************************************
+ *  SetFixedTimestep()
+ *
+ *  This method is used for advancing time by a fixed step on
+ *  every frame instead of measuring the wall clock.  Passing
+ *  zero restores wall clock timing.
+ ***********************************************************/
+void ViewManager::SetFixedTimestep(float timestep)
+{
+	m_fixedTimestep = timestep;
+}
+
+/***********************************************************
+ *  SetPlaybackPath()
+ *
+ *  This method is used for replaying the camera from a path
+ *  instead of the live keyboard and mouse input.
+ ***********************************************************/
+void ViewManager::SetPlaybackPath(CameraPath* pPath)
+{
+	m_pPlaybackPath = pPath;
+	m_pathTime = 0.0f;
+}
+
+/***********************************************************
+ *  SetRecordPath()
+ *
+ *  This method is used for recording the live camera into a
+ *  path that can be saved and replayed later.
+ ***********************************************************/
+void ViewManager::SetRecordPath(CameraPath* pPath)
+{
+	m_pRecordPath = pPath;
+	m_pathTime = 0.0f;
+}
+
+
+/***********************************************************
+ *  StartSimulation()
+ *
+ *  This method is used for moving the input handling and
+ *  camera updates onto a thread of their own that steps at a
+ *  fixed rate.  Each step is published through a triple
+ *  buffer and the renderer interpolates between the last two
+ *  steps, so camera motion stays smooth and responsive no
+ *  matter how long a frame takes to render or present.
+ ***********************************************************/
+bool ViewManager::StartSimulation(float stepsPerSecond)
+{
+	if ((m_bSimulationRunning == true) || (stepsPerSecond <= 0.0f))
+	{
+		return(false);
+	}
+
+	m_simulationStep = 1.0 / (double)stepsPerSecond;
+
+	// start from the current camera so the first frames are still
+	SIMULATION_FRAME frame;
+	frame.previous = CaptureCameraState();
+	frame.current = frame.previous;
+	frame.stepTime = NowSeconds();
+	m_simulationFrames.Reset(frame);
+
+	g_KeysDown.store(0);
+	g_KeysPressed.store(0);
+	g_MouseDeltaX.store(0.0f);
+	g_MouseDeltaY.store(0.0f);
+	g_ScrollDelta.store(0.0f);
+	g_bSimulationInput.store(true);
+
+	m_bStopSimulation = false;
+	m_simulationThread = std::thread(&ViewManager::SimulationLoop, this);
+	m_bSimulationRunning = true;
+
+	std::cout << "INFO: Simulation running at " << stepsPerSecond << " steps per second" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  StopSimulation()
+ *
+ *  This method is used for stopping the simulation thread.
+ *  Input and camera updates return to PrepareSceneView().
+ ***********************************************************/
+void ViewManager::StopSimulation()
+{
+	if (m_bSimulationRunning == false)
+	{
+		return;
+	}
+
+	m_bStopSimulation = true;
+	m_simulationThread.join();
+	g_bSimulationInput.store(false);
+	m_bSimulationRunning = false;
+}
+
+/***********************************************************
+ *  SimulationLoop()
+ *
+ *  This method is the entry point of the simulation thread.
+ *  Steps are scheduled on a fixed grid; after a long hitch
+ *  the grid is moved forward instead of running a burst of
+ *  catch-up steps.
+ ***********************************************************/
+void ViewManager::SimulationLoop()
+{
+	CPU_PROFILE_THREAD("Simulation");
+
+	CAMERA_STATE lastState = CaptureCameraState();
+	double nextStep = NowSeconds();
+
+	while (m_bStopSimulation.load() == false)
+	{
+		nextStep += m_simulationStep;
+
+		double now = NowSeconds();
+		if (nextStep > now)
+		{
+			std::this_thread::sleep_for(std::chrono::duration<double>(nextStep - now));
+		}
+		else if (now - nextStep > 0.25)
+		{
+			nextStep = now;
+		}
+
+		CPU_PROFILE_ZONE("ViewManager::SimulationStep");
+
+		SimulationStep((float)m_simulationStep);
+
+		SIMULATION_FRAME& frame = m_simulationFrames.GetWriteBuffer();
+		frame.previous = lastState;
+		frame.current = CaptureCameraState();
+		frame.stepTime = nextStep;
+		lastState = frame.current;
+		m_simulationFrames.Publish();
+	}
+}
+
+/***********************************************************
+ *  SimulationStep()
+ *
+ *  This method is used for applying the input gathered by
+ *  the GLFW callbacks since the last step to the camera.  It
+ *  mirrors ProcessKeyboardEvents() for the held keys.
+ ***********************************************************/
+void ViewManager::SimulationStep(float deltaTime)
+{
+	uint32_t pressed = g_KeysPressed.exchange(0, std::memory_order_relaxed);
+	// a key tapped between two steps still moves the camera once
+	uint32_t keys = g_KeysDown.load(std::memory_order_relaxed) | pressed;
+
+	float xOffset = g_MouseDeltaX.exchange(0.0f, std::memory_order_relaxed);
+	float yOffset = g_MouseDeltaY.exchange(0.0f, std::memory_order_relaxed);
+	if ((xOffset != 0.0f) || (yOffset != 0.0f))
+	{
+		g_pCamera->ProcessMouseMovement(xOffset, yOffset);
+	}
+	float scroll = g_ScrollDelta.exchange(0.0f, std::memory_order_relaxed);
+	if (scroll != 0.0f)
+	{
+		g_pCamera->ProcessMouseScroll(scroll);
+	}
+
+	// process camera zooming in and out
+	if (keys & key_forward)
+	{
+		g_pCamera->ProcessKeyboard(FORWARD, deltaTime);
+	}
+	if (keys & key_backward)
+	{
+		g_pCamera->ProcessKeyboard(BACKWARD, deltaTime);
+	}
+	// process camera panning left and right
+	if (keys & key_left)
+	{
+		g_pCamera->ProcessKeyboard(LEFT, deltaTime);
+	}
+	if (keys & key_right)
+	{
+		g_pCamera->ProcessKeyboard(RIGHT, deltaTime);
+	}
+	// process camera panning up and down
+	if (keys & key_up)
+	{
+		g_pCamera->ProcessKeyboard(UP, deltaTime);
+	}
+	if (keys & key_down)
+	{
+		g_pCamera->ProcessKeyboard(DOWN, deltaTime);
+	}
+
+	// change between different projection views
+	if (pressed & key_orthographic)
+	{
+		bOrthographicProjection = true;
+		g_pCamera->Position = glm::vec3(0.0f, 4.0f, 10.0f);
+		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+		g_pCamera->Front = glm::vec3(0.0f, 0.0f, -1.0f);
+	}
+	if (pressed & key_perspective)
+	{
+		bOrthographicProjection = false;
+		g_pCamera->Position = glm::vec3(0.0f, 5.5f, 8.0f);
+		g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+		g_pCamera->Zoom = 80;
+	}
+}
+
+/***********************************************************
+ *  CaptureCameraState()
+ *
+ *  This method is used for copying the camera values needed
+ *  for rendering.
+ ***********************************************************/
+ViewManager::CAMERA_STATE ViewManager::CaptureCameraState()
+{
+	CAMERA_STATE state;
+	state.position = g_pCamera->Position;
+	state.front = g_pCamera->Front;
+	state.up = g_pCamera->Up;
+	state.zoom = g_pCamera->Zoom;
+	state.bOrthographic = bOrthographicProjection;
+
+	return(state);
+}
+
+/***********************************************************
+ *  InterpolateCameraState()
+ *
+ *  This method is used for blending two camera states.  A
+ *  switch between projections is a cut, so it is never
+ *  blended across.
+ ***********************************************************/
+ViewManager::CAMERA_STATE ViewManager::InterpolateCameraState(
+	const CAMERA_STATE& previous,
+	const CAMERA_STATE& current,
+	float alpha)
+{
+	if ((previous.bOrthographic != current.bOrthographic) || (alpha >= 1.0f))
+	{
+		return(current);
+	}
+	if (alpha < 0.0f)
+	{
+		alpha = 0.0f;
+	}
+
+	CAMERA_STATE state;
+	state.position = glm::mix(previous.position, current.position, alpha);
+	state.front = glm::normalize(glm::mix(previous.front, current.front, alpha));
+	state.up = glm::normalize(glm::mix(previous.up, current.up, alpha));
+	state.zoom = previous.zoom + (current.zoom - previous.zoom) * alpha;
+	state.bOrthographic = current.bOrthographic;
+
+	return(state);
+}
+
+/***********************************************************
+ *  NeedsRedraw()
+ *
+ *  This method is used for deciding whether the last frame
+ *  is still correct.  A new frame is needed while a path is
+ *  played back, while input is pending or a movement key is
+ *  held, when the window was damaged, and when the camera
+ *  differs from the one last drawn - which also covers the
+ *  simulation thread still easing towards its latest step.
+ ***********************************************************/
+bool ViewManager::NeedsRedraw()
+{
+	if ((NULL != m_pPlaybackPath) || (m_bHasLastCamera == false) ||
+		(g_bWindowDamaged.load(std::memory_order_relaxed) == true) ||
+		(g_PendingInputTime.load(std::memory_order_relaxed) > 0.0) ||
+		(g_KeysDown.load(std::memory_order_relaxed) != 0))
+	{
+		return(true);
+	}
+
+	if (m_bSimulationRunning == true)
+	{
+		m_simulationFrames.Update();
+		return(IsSameCameraState(m_simulationFrames.GetReadBuffer().current, m_lastCamera) == false);
+	}
+
+	return(IsSameCameraState(CaptureCameraState(), m_lastCamera) == false);
+}
+
+/***********************************************************
+ *  IsSameCameraState()
+ *
+ *  This method is used for comparing two camera states.
+ ***********************************************************/
+bool ViewManager::IsSameCameraState(const CAMERA_STATE& a, const CAMERA_STATE& b)
+{
+	return((a.position == b.position) && (a.front == b.front) && (a.up == b.up) &&
+		(a.zoom == b.zoom) && (a.bOrthographic == b.bOrthographic));
+}
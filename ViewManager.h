@@ -1,49 +1,177 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport - camera, projection
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "camera.h"
-
-// GLFW library
-#include "GLFW/glfw3.h" 
-
-class ViewManager
-{
-public:
-	// constructor
-	ViewManager(
-		ShaderManager* pShaderManager);
-	// destructor
-	~ViewManager();
-
-	// mouse position callback for mouse interaction with the 3D scene
-	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
-
-	//*** Added
-	// mouse scroll callback to speed up or slow down camera movement
-	static void Mouse_Scroll_Wheel_Callback(GLFWwindow* window, double x, double yScrollDistance);
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// active OpenGL display window
-	GLFWwindow* m_pWindow;
-
-	// process keyboard events for interaction with the 3D scene
-	void ProcessKeyboardEvents();
-
-public:
-	// create the initial OpenGL display window
-	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
-	
-	// prepare the conversion from 3D object display to 2D scene display
-	void PrepareSceneView();
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport - camera, projection
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "CameraPath.h"
+#include "TripleBuffer.h"
+#include "camera.h"
+
+// GLFW library
+#include "GLFW/glfw3.h" 
+
+#include <atomic>
+#include <thread>
+
+class ViewManager
+{
+public:
+	// constructor
+	ViewManager(
+		ShaderManager* pShaderManager);
+	// destructor
+	~ViewManager();
+
+	// mouse position callback for mouse interaction with the 3D scene
+	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
+
+	//*** Added
+	// mouse scroll callback to speed up or slow down camera movement
+	static void Mouse_Scroll_Wheel_Callback(GLFWwindow* window, double x, double yScrollDistance);
+
+	// key callback for feeding key presses to the simulation thread
+	static void Key_Callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+
+	// refresh callback for redrawing after the window was uncovered
+	static void Window_Refresh_Callback(GLFWwindow* window);
+
+	// framebuffer size callback for following window resizes
+	static void Framebuffer_Size_Callback(GLFWwindow* window, int width, int height);
+
+	// camera values needed to render a frame
+	struct CAMERA_STATE
+	{
+		glm::vec3 position;
+		glm::vec3 front;
+		glm::vec3 up;
+		float zoom;
+		bool bOrthographic;
+	};
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// active OpenGL display window
+	GLFWwindow* m_pWindow;
+	// camera path replayed instead of live input, if any
+	CameraPath* m_pPlaybackPath;
+	// camera path that live input is recorded into, if any
+	CameraPath* m_pRecordPath;
+	// fixed time step in seconds, or zero to use the wall clock
+	float m_fixedTimestep;
+	// accumulated time used for camera path playback and recording
+	float m_pathTime;
+	// view and projection matrices of the last prepared frame
+	glm::mat4 m_viewMatrix;
+	glm::mat4 m_projectionMatrix;
+	// projection of the last prepared frame before the jitter,
+	// and the jitter applied to the next one
+	glm::mat4 m_unjitteredProjection;
+	glm::vec2 m_projectionJitter;
+
+	// the two latest simulation steps, handed to the renderer
+	struct SIMULATION_FRAME
+	{
+		CAMERA_STATE previous;
+		CAMERA_STATE current;
+		// clock time in seconds the current step belongs to
+		double stepTime;
+	};
+
+	// fixed rate simulation thread - owns the camera while running
+	std::thread m_simulationThread;
+	std::atomic<bool> m_bStopSimulation;
+	bool m_bSimulationRunning;
+	double m_simulationStep;
+	TripleBuffer<SIMULATION_FRAME> m_simulationFrames;
+	// steady clock time of the oldest input shown by the last
+	// prepared frame, or zero
+	double m_frameInputTime;
+	// camera of the last prepared frame
+	CAMERA_STATE m_lastCamera;
+	bool m_bHasLastCamera;
+	// depth mapping of the projections
+	bool m_bReverseDepth;
+	bool m_bInfiniteFar;
+	float m_farPlane;
+
+	// process keyboard events for interaction with the 3D scene
+	void ProcessKeyboardEvents();
+	// simulation thread entry point
+	void SimulationLoop();
+	// apply the input gathered by the callbacks to the camera
+	void SimulationStep(float deltaTime);
+	// copy the current camera values
+	static CAMERA_STATE CaptureCameraState();
+	// true when two camera states show the same view
+	static bool IsSameCameraState(const CAMERA_STATE& a, const CAMERA_STATE& b);
+	// projection of a camera for a viewport aspect ratio
+	glm::mat4 ComputeProjection(const CAMERA_STATE& camera, float aspect) const;
+	// blend between two camera states
+	static CAMERA_STATE InterpolateCameraState(
+		const CAMERA_STATE& previous,
+		const CAMERA_STATE& current,
+		float alpha);
+
+public:
+	// create the initial OpenGL display window
+	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
+	
+	// prepare the conversion from 3D object display to 2D scene display
+	void PrepareSceneView();
+
+	// advance time by a fixed step each frame instead of the wall clock
+	void SetFixedTimestep(float timestep);
+	// replay the camera from a path instead of live input
+	void SetPlaybackPath(CameraPath* pPath);
+	// record the live camera into a path
+	void SetRecordPath(CameraPath* pPath);
+	// map the near plane to depth one and the far plane to
+	// zero, with the far plane at infinity if requested
+	void SetDepthRange(bool bReverseDepth, bool bInfiniteFar, float farPlane);
+	bool IsReverseDepth() const { return(m_bReverseDepth); }
+	// shift the projected image of the next prepared frames,
+	// in normalized device units - two over the width is one
+	// pixel across
+	void SetProjectionJitter(const glm::vec2& jitter) { m_projectionJitter = jitter; }
+
+	// move input handling and camera updates to a thread that
+	// steps at a fixed rate, independent of the frame rate
+	bool StartSimulation(float stepsPerSecond);
+	// stop the simulation thread and return the camera to the
+	// render thread
+	void StopSimulation();
+
+	// true when the camera moved, input arrived or the window
+	// needs repainting since the last prepared frame
+	bool NeedsRedraw();
+
+	// get the size of the window's framebuffer in pixels
+	void GetFramebufferSize(int& width, int& height) const;
+	// true while the window is minimized and nothing is drawn
+	bool IsWindowMinimized() const;
+
+	// get the view matrix of the last prepared frame
+	const glm::mat4& GetViewMatrix() const { return(m_viewMatrix); }
+	// get the projection matrix of the last prepared frame
+	const glm::mat4& GetProjectionMatrix() const { return(m_projectionMatrix); }
+	// get the projection matrix of the last prepared frame
+	// without its jitter
+	const glm::mat4& GetUnjitteredProjectionMatrix() const { return(m_unjitteredProjection); }
+	// get the camera of the last prepared frame for a viewport
+	// of the aspect ratio, width over height
+	void GetCameraView(float aspect, glm::mat4& view, glm::mat4& projection, glm::vec3& position) const;
+	// get the orthographic front view the O key switches to,
+	// for a viewport of the aspect ratio
+	void GetFrontView(float aspect, glm::mat4& view, glm::mat4& projection, glm::vec3& position) const;
+	// get the time of the oldest input the last prepared frame
+	// shows, for latency measurement - zero if it shows none
+	double GetFrameInputTime() const { return(m_frameInputTime); }
 };
\ No newline at end of file